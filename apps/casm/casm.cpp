@@ -16,6 +16,7 @@
 #include "casm/core"
 
 #include "casm/app/DirectoryStructure.hh"
+#include "casm/misc/Profile.hh"
 
 // include new casm tool header files here:
 #include "casm_functions.hh"
@@ -36,13 +37,14 @@
 #include "query.hh"
 #include "run.hh"
 #include "import.hh"
+#include "groundstate.hh"
 
 using namespace CASM;
 
 int print_casm_help(std::ostream &out) {
   out << "\n*** casm usage ***" << std::endl << std::endl;
 
-  out << "casm [--version] <command> [options] [args]" << std::endl << std::endl;
+  out << "casm [--version] [--profile[=file.json]] <command> [options] [args]" << std::endl << std::endl;
   out << "available commands:" << std::endl;
   std::vector<std::string> subcom = {
     "  status",
@@ -61,7 +63,8 @@ int print_casm_help(std::ostream &out) {
     "  run",
     "  fit",
     "  query",
-    "  import"
+    "  import",
+    "  groundstate"
   };
 
   std::sort(subcom.begin(), subcom.end());
@@ -73,6 +76,9 @@ int print_casm_help(std::ostream &out) {
   out << "For help using a command: 'casm <command> --help'" << std::endl << std::endl;
   out << "For step by step help use: 'casm status -n'" << std::endl << std::endl;
 
+  out << "To print where a command spends its time: 'casm --profile <command> ...'" << std::endl;
+  out << "  or, to also write the profile as JSON: 'casm --profile=file.json <command> ...'" << std::endl << std::endl;
+
   return 0;
 };
 
@@ -82,6 +88,25 @@ int print_casm_help(std::ostream &out) {
 
 int main(int argc, char *argv[]) {
 
+  // 'casm --profile[=file.json] <command> ...': enable profiling, and then remove the option so
+  //   the command sees its usual arguments
+  bool profile = false;
+  std::string profile_path;
+  if(argc > 1 && std::string(argv[1]).compare(0, 9, "--profile") == 0) {
+    std::string opt(argv[1]);
+    if(opt != "--profile" && opt.compare(0, 10, "--profile=") != 0) {
+      print_casm_help(std::cout);
+      return 1;
+    }
+    profile = true;
+    if(opt.size() > 10)
+      profile_path = opt.substr(10);
+    argv[1] = argv[0];
+    argv++;
+    argc--;
+    Profiler::enable();
+  }
+
   // Collect command line arguments
   Array<std::string> args;
   bool help = false;
@@ -206,6 +231,9 @@ int main(int argc, char *argv[]) {
   else if(args[1] == "import") {
     retcode = import_command(argc, argv);
   }
+  else if(args[1] == "groundstate") {
+    retcode = groundstate_command(argc, argv);
+  }
   else {
     print_casm_help(std::cout);
     retcode = 1;
@@ -219,6 +247,16 @@ int main(int argc, char *argv[]) {
     log.close();
   }
 
+  if(profile) {
+    std::cout << "\n";
+    Profiler::print(std::cout);
+    if(!profile_path.empty()) {
+      jsonParser json;
+      Profiler::to_json(json).write(profile_path);
+      std::cout << "Wrote profile: " << profile_path << "\n";
+    }
+  }
+
   return retcode;
 }
 
@@ -241,6 +279,7 @@ int main(int argc, char *argv[]) {
 #include "fit.cc"
 #include "query.cc"
 #include "import.cc"
+#include "groundstate.cc"
 
 
 
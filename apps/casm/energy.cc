@@ -146,9 +146,7 @@ namespace CASM {
     justgroundstate.push_back("NOT");
 
     bool selection;
-    for(auto it = primclex.config_begin(); it != primclex.config_end(); ++it) {
-      it->set_selected(get_selection(justgroundstate, *it, it->selected()));
-    }
+    set_selection(SelectionCriteria(justgroundstate, primclex), primclex);
 
     ConfigPrintStream cpstreamhull(target);
     cpstreamhull.add_printer("energy");
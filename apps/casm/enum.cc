@@ -7,6 +7,148 @@
 
 namespace CASM {
 
+  /// \brief Parse 'casm enum --comp' arguments
+  ///
+  /// Each argument is 'NAME=X', the fraction 'X' of the sites of every sublattice that allows occupant 'NAME',
+  /// or 'B:NAME=X', for sublattice (prim basis site) 'B' only.
+  ///
+  /// \returns sublat_frac[b][occ], the fraction of sublattice 'b' occupied by 'occ', or -1.0 if not given
+  Array<Array<double> > parse_composition(const std::vector<std::string> &comp, const Structure &prim) {
+    Array<Array<double> > sublat_frac;
+    for(Index b = 0; b < prim.basis.size(); b++)
+      sublat_frac.push_back(Array<double>(prim.basis[b].site_occupant().size(), -1.0));
+
+    for(Index i = 0; i < comp.size(); i++) {
+      std::string::size_type eq = comp[i].find('=');
+      if(eq == std::string::npos)
+        throw std::runtime_error("Expected 'NAME=X' or 'B:NAME=X' in --comp, found '" + comp[i] + "'");
+      std::string name = comp[i].substr(0, eq);
+      double x;
+      try {
+        x = std::stod(comp[i].substr(eq + 1));
+      }
+      catch(std::exception &e) {
+        throw std::runtime_error("Could not read the fraction in --comp '" + comp[i] + "'");
+      }
+      if(x < -TOL || x > 1.0 + TOL)
+        throw std::runtime_error("Fraction not in [0, 1] in --comp '" + comp[i] + "'");
+
+      Index b_begin = 0, b_end = prim.basis.size();
+      std::string::size_type colon = name.find(':');
+      if(colon != std::string::npos) {
+        try {
+          b_begin = std::stoul(name.substr(0, colon));
+        }
+        catch(std::exception &e) {
+          throw std::runtime_error("Could not read the sublattice in --comp '" + comp[i] + "'");
+        }
+        if(b_begin >= prim.basis.size())
+          throw std::runtime_error("Sublattice out of range in --comp '" + comp[i] + "'");
+        b_end = b_begin + 1;
+        name = name.substr(colon + 1);
+      }
+
+      bool found = false;
+      for(Index b = b_begin; b < b_end; b++) {
+        for(Index occ = 0; occ < prim.basis[b].site_occupant().size(); occ++) {
+          if(prim.basis[b].site_occupant()[occ].name == name) {
+            sublat_frac[b][occ] = x;
+            found = true;
+          }
+        }
+      }
+      if(!found)
+        throw std::runtime_error("'" + name + "' is not an allowed occupant in --comp '" + comp[i] + "'");
+    }
+    return sublat_frac;
+  }
+
+  /// \brief Number of each occupant on each sublattice for the compositions 'sublat_frac' in a supercell of volume 'vol'
+  ///
+  /// The occupants without a given fraction share the rest of their sublattice in all possible ways. Nothing is returned
+  /// if the given fractions do not correspond to a whole number of sites.
+  std::vector<Array<Array<int> > > composition_counts(const Array<Array<double> > &sublat_frac, Index vol) {
+    std::vector<Array<Array<int> > > result;
+    Array<Array<int> > fixed;
+    Array<Index> free_sublat;
+    MultiCounter<IsoCounter<Array<int> > > counter;
+
+    for(Index b = 0; b < sublat_frac.size(); b++) {
+      fixed.push_back(Array<int>());
+      int remainder = vol;
+      int N_free = 0;
+      for(Index occ = 0; occ < sublat_frac[b].size(); occ++) {
+        if(sublat_frac[b][occ] < 0.0) {
+          fixed[b].push_back(0);
+          N_free++;
+          continue;
+        }
+        double n = sublat_frac[b][occ] * vol;
+        int n_int = round(n);
+        if(!almost_equal(n, double(n_int)))
+          return result;
+        fixed[b].push_back(n_int);
+        remainder -= n_int;
+      }
+      if(remainder < 0 || (N_free == 0 && remainder != 0))
+        return result;
+      if(N_free != 0) {
+        free_sublat.push_back(b);
+        counter.push_back(IsoCounter<Array<int> >(Array<int>(N_free, 0), Array<int>(N_free, remainder), 1, remainder));
+      }
+    }
+
+    if(counter.size() == 0) {
+      result.push_back(fixed);
+      return result;
+    }
+
+    do {
+      Array<Array<int> > counts(fixed);
+      for(Index k = 0; k < free_sublat.size(); k++) {
+        Index b = free_sublat[k];
+        Index i = 0;
+        for(Index occ = 0; occ < counts[b].size(); occ++) {
+          if(sublat_frac[b][occ] < 0.0)
+            counts[b][occ] = counter[k]()[i++];
+        }
+      }
+      result.push_back(counts);
+    }
+    while((++counter).valid());
+
+    return result;
+  }
+
+  /// \brief Enumerate the configurations of 'scel', at the compositions 'sublat_frac' if given
+  ///
+  /// If 'N_samples' > 0, draw 'N_samples' random configurations instead, for each set of sublattice counts
+  void enumerate_configurations(Supercell &scel,
+                                const Array<Array<double> > &sublat_frac,
+                                Index N_samples,
+                                RandomSampling &sampling,
+                                unsigned long seed,
+                                Index N_streams) {
+    if(sublat_frac.size() == 0) {
+      if(N_samples == 0)
+        scel.enumerate_all_occupation_configurations();
+      else {
+        sampling.sublat_num_each.clear();
+        scel.sample_configurations(sampling, N_samples, seed, N_streams);
+      }
+      return;
+    }
+    std::vector<Array<Array<int> > > counts = composition_counts(sublat_frac, scel.volume());
+    for(Index i = 0; i < counts.size(); i++) {
+      if(N_samples == 0)
+        scel.enumerate_composition_configurations(counts[i]);
+      else {
+        sampling.sublat_num_each = counts[i];
+        scel.sample_configurations(sampling, N_samples, seed + i, N_streams);
+      }
+    }
+  }
+
 
   // ///////////////////////////////////////
   // 'enum' function for casm
@@ -19,6 +161,11 @@ namespace CASM {
 
     int min_vol = 1, max_vol;
     std::vector<std::string> scellname_list;
+    std::vector<std::string> comp;
+    Index N_samples = 0, N_streams = 1, sweeps = 10;
+    unsigned long seed = 0;
+    double T = 0.0;
+    std::string clex_name;
     //double tol;
     COORD_TYPE coordtype = CASM::CART;
     po::variables_map vm;
@@ -33,7 +180,14 @@ namespace CASM {
     ("scellname,n", po::value<std::vector<std::string> >(&scellname_list)->multitoken(), "Enumerate configs for given supercells")
     ("all,a", "Enumerate configurations for all supercells")
     ("supercells,s", "Enumerate supercells")
-    ("configs,c", "Enumerate configurations");
+    ("configs,c", "Enumerate configurations")
+    ("comp", po::value<std::vector<std::string> >(&comp)->multitoken(), "Only enumerate configurations with these compositions. Ex: --comp Ni=0.25, or --comp 0:A=0.5 1:B=0.25")
+    ("sample", po::value<Index>(&N_samples), "Draw this many random configurations per supercell, instead of enumerating all")
+    ("seed", po::value<unsigned long>(&seed), "Random number seed for --sample (default: from the time)")
+    ("streams", po::value<Index>(&N_streams)->default_value(1), "Number of independent random number streams for --sample, run in parallel")
+    ("T", po::value<double>(&T), "Sample from Monte Carlo at this temperature (K), using the cluster expansion")
+    ("sweeps", po::value<Index>(&sweeps)->default_value(10), "Monte Carlo passes over the sites between samples, with --T")
+    ("clex", po::value<std::string>(&clex_name)->default_value("formation_energy"), "Cluster expansion used with --T");
 
     // currently unused...
     //("tol", po::value<double>(&tol)->default_value(CASM::TOL), "Tolerance used for checking symmetry")
@@ -53,6 +207,15 @@ namespace CASM {
         std::cout << "    Enumerate supercells and configurations\n";
         std::cout << "    - expects a PRIM file in the project root directory \n";
         std::cout << "    - if --min is given, then --max must be given \n";
+        std::cout << "    - with --configs, --comp NAME=X enumerates only configurations with the fraction X of\n";
+        std::cout << "      the sites of each sublattice that allows NAME occupied by NAME, and B:NAME=X\n";
+        std::cout << "      only configurations with the fraction X of sublattice B occupied by NAME. Occupants\n";
+        std::cout << "      not given share the rest of their sublattice in all possible ways.\n";
+        std::cout << "    - with --configs, --sample N draws N random configurations per supercell (and per set of\n";
+        std::cout << "      sublattice compositions allowed by --comp), and adds the new ones. The same --seed and\n";
+        std::cout << "      --streams give the same configurations. With --T, samples are taken every --sweeps\n";
+        std::cout << "      passes of a Metropolis Monte Carlo run, which swaps sites of a sublattice if --comp is\n";
+        std::cout << "      given, and changes single sites otherwise.\n";
 
 
         return 0;
@@ -71,6 +234,16 @@ namespace CASM {
         std::cerr << "Error in 'casm enum'. Either --supercells or --configs must be given." << std::endl;
         return 1;
       }
+      if(N_streams < 1) {
+        std::cerr << "\n" << desc << "\n" << std::endl;
+        std::cerr << "Error in 'casm enum'. --streams must be at least 1." << std::endl;
+        return 1;
+      }
+      if((vm.count("T") || vm.count("seed")) && !vm.count("sample")) {
+        std::cerr << "\n" << desc << "\n" << std::endl;
+        std::cerr << "Error in 'casm enum'. --T and --seed require --sample." << std::endl;
+        return 1;
+      }
       if(vm.count("supercells") && !vm.count("max")) {
         std::cerr << "\n" << desc << "\n" << std::endl;
         std::cerr << "Error in 'casm enum'. If --supercells is given, --max must be given." << std::endl;
@@ -106,6 +279,41 @@ namespace CASM {
     PrimClex primclex(root, std::cout);
     std::cout << "  DONE." << std::endl << std::endl;
 
+    Array<Array<double> > sublat_frac;
+    if(vm.count("comp")) {
+      try {
+        sublat_frac = parse_composition(comp, primclex.get_prim());
+      }
+      catch(std::exception &e) {
+        std::cerr << "Error in 'casm enum'. " << e.what() << std::endl;
+        return 1;
+      }
+    }
+
+    RandomSampling sampling;
+    if(vm.count("sample")) {
+      if(!vm.count("seed"))
+        seed = time(nullptr);
+      std::cout << "Random number seed: " << seed << "  streams: " << N_streams << std::endl << std::endl;
+    }
+    if(vm.count("T")) {
+      const DirectoryStructure &dir = primclex.dir();
+      ProjectSettings &set = primclex.settings();
+      try {
+        sampling.clexulator = primclex.global_clexulator();
+        sampling.eci = primclex.global_eci(clex_name);
+      }
+      catch(std::exception &e) {
+        std::cerr << "Error in 'casm enum'. " << e.what() << std::endl;
+        return 1;
+      }
+      primclex.read_global_orbitree(dir.clust(set.bset()));
+      primclex.generate_full_nlist();
+      primclex.generate_supercell_nlists();
+      sampling.kT = KB * T;
+      sampling.sweeps = sweeps;
+    }
+
     if(vm.count("supercells")) {
       std::cout << "\n***************************\n" << std::endl;
 
@@ -124,7 +332,7 @@ namespace CASM {
         std::cout << "Enumerate all configurations" << std::endl << std::endl;
         for(int j = 0; j < primclex.get_supercell_list().size(); j++) {
           std::cout << "  Enumerate configurations for " << primclex.get_supercell(j).get_name() << " ... " << std::flush;
-          primclex.get_supercell(j).enumerate_all_occupation_configurations();
+          enumerate_configurations(primclex.get_supercell(j), sublat_frac, N_samples, sampling, seed, N_streams);
           std::cout << primclex.get_supercell(j).get_config_list().size() << " configs." << std::endl;
         }
         std::cout << "  DONE." << std::endl << std::endl;
@@ -140,7 +348,7 @@ namespace CASM {
               found_any = true;
 
               std::cout << "  Enumerate configurations for " << primclex.get_supercell(j).get_name() << " ... " << std::flush;
-              primclex.get_supercell(j).enumerate_all_occupation_configurations();
+              enumerate_configurations(primclex.get_supercell(j), sublat_frac, N_samples, sampling, seed, N_streams);
               std::cout << primclex.get_supercell(j).get_config_list().size() << " configs." << std::endl;
             }
           }
@@ -158,7 +366,7 @@ namespace CASM {
             found_any = true;
 
             std::cout << "  Enumerate configurations for " << primclex.get_supercell(index).get_name() << " ... " << std::flush;
-            primclex.get_supercell(index).enumerate_all_occupation_configurations();
+            enumerate_configurations(primclex.get_supercell(index), sublat_frac, N_samples, sampling, seed, N_streams);
             std::cout << primclex.get_supercell(index).get_config_list().size() << " configs." << std::endl;
           }
         }
@@ -162,8 +162,13 @@ namespace CASM {
 
     // -- write 'corr.in' file ----
     {
+      // evaluate the correlations of all the training configurations at once, in parallel
+      Array<const Configuration *> training;
+      for(auto it = config_select.selected_config_cbegin(); it != config_select.selected_config_cend(); ++it)
+        training.push_back(&(*it));
+
       DataFormatter<Configuration> formatter;
-      formatter.push_back(ConfigIO::corr(clexulator));
+      formatter.push_back(ConfigIO::corr(clexulator, training));
 
       fs::ofstream sout;
       sout.open(corr_in_file);
@@ -0,0 +1,272 @@
+#include "groundstate.hh"
+
+#include <cstring>
+
+#include "casm_functions.hh"
+#include "casm/CASM_classes.hh"
+#include "casm/clex/GroundStateSearch.hh"
+
+namespace CASM {
+
+
+  // ///////////////////////////////////////
+  // 'groundstate' function for casm
+  //    (add an 'if-else' statement in casm.cpp to call this)
+
+  int groundstate_command(int argc, char *argv[]) {
+
+    int min_vol = 1, max_vol;
+    std::vector<std::string> scellname_list;
+    Index runs, sweeps;
+    double T_init, T_final, tol;
+    unsigned long seed = 0;
+    std::string clex_name;
+    fs::path out_path;
+    po::variables_map vm;
+
+
+    /// Set command line options using boost program_options
+    po::options_description desc("'casm groundstate' usage");
+    desc.add_options()
+    ("help,h", "Write help documentation")
+    ("min", po::value<int>(&min_vol), "Min volume")
+    ("max", po::value<int>(&max_vol), "Max volume")
+    ("scellname,n", po::value<std::vector<std::string> >(&scellname_list)->multitoken(), "Search the given supercells")
+    ("anneal", "Search with simulated annealing, instead of evaluating every configuration")
+    ("runs", po::value<Index>(&runs)->default_value(20), "Number of simulated annealing runs per supercell, with --anneal")
+    ("sweeps", po::value<Index>(&sweeps)->default_value(100), "Monte Carlo passes over the sites per run, with --anneal")
+    ("T-init", po::value<double>(&T_init)->default_value(1000.0), "Initial temperature (K), with --anneal")
+    ("T-final", po::value<double>(&T_final)->default_value(10.0), "Final temperature (K), with --anneal")
+    ("seed", po::value<unsigned long>(&seed), "Random number seed for --anneal (default: from the time)")
+    ("clex", po::value<std::string>(&clex_name)->default_value("formation_energy"), "Cluster expansion to find the ground states of")
+    ("tol", po::value<double>(&tol)->default_value(1e-8), "Configurations within this energy of the hull are not ground states")
+    ("add", "Add the ground states found to the configuration list")
+    ("output,o", po::value<fs::path>(&out_path), "Write the ground states found to this JSON file");
+
+    try {
+      po::store(po::parse_command_line(argc, argv, desc), vm); // can throw
+
+      /** --help option
+       */
+      if(vm.count("help")) {
+        std::cout << "\n";
+        std::cout << desc << std::endl;
+
+
+        std::cout << "DESCRIPTION" << std::endl;
+        std::cout << "    Find the ground states of a cluster expansion in the enumerated supercells, without\n";
+        std::cout << "    enumerating and storing configurations.\n";
+        std::cout << "    - expects a basis set, ECI and composition axes\n";
+        std::cout << "    - searches all supercells, unless --max or --scellname is given. If --min is given,\n";
+        std::cout << "      then --max must be given.\n";
+        std::cout << "    - by default every configuration of each supercell is evaluated. This is exact, but the\n";
+        std::cout << "      number of configurations grows exponentially with supercell size.\n";
+        std::cout << "    - with --anneal, --runs simulated annealing runs are made per supercell, each at random\n";
+        std::cout << "      sublattice compositions, swapping the occupants of sites on the same sublattice while\n";
+        std::cout << "      cooling from --T-init to --T-final over --sweeps passes. This is heuristic. The same\n";
+        std::cout << "      --seed gives the same results.\n";
+        std::cout << "    - only configurations on the lower convex hull of the cluster expansion values are\n";
+        std::cout << "      kept, using the parametric composition.\n";
+
+
+        return 0;
+      }
+
+      po::notify(vm); // throws on error, so do after help in case
+      // there are any problems
+
+      if(vm.count("min") && !vm.count("max")) {
+        std::cerr << "\n" << desc << "\n" << std::endl;
+        std::cerr << "Error in 'casm groundstate'. If --min is given, --max must also be given." << std::endl;
+        return 1;
+      }
+      if(!vm.count("anneal") && (!vm["runs"].defaulted() || !vm["sweeps"].defaulted() || !vm["T-init"].defaulted() ||
+                                 !vm["T-final"].defaulted() || vm.count("seed"))) {
+        std::cerr << "\n" << desc << "\n" << std::endl;
+        std::cerr << "Error in 'casm groundstate'. --runs, --sweeps, --T-init, --T-final and --seed require --anneal." << std::endl;
+        return 1;
+      }
+      if(T_init <= 0.0 || T_final <= 0.0) {
+        std::cerr << "\n" << desc << "\n" << std::endl;
+        std::cerr << "Error in 'casm groundstate'. --T-init and --T-final must be positive." << std::endl;
+        return 1;
+      }
+    }
+    catch(po::error &e) {
+      std::cerr << desc << std::endl;
+      std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+      return 1;
+    }
+    catch(std::exception &e) {
+      std::cerr << desc << std::endl;
+      std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+      return 1;
+
+    }
+
+    fs::path root = find_casmroot(fs::current_path());
+    if(root.empty()) {
+      std::cerr << "Error in 'casm groundstate': No casm project found." << std::endl;
+      return 1;
+    }
+    if(vm.count("output"))
+      out_path = fs::absolute(out_path);
+    fs::current_path(root);
+
+
+    std::cout << "\n***************************\n" << std::endl;
+
+    // initialize primclex
+    std::cout << "Initialize primclex: " << root << std::endl << std::endl;
+    PrimClex primclex(root, std::cout);
+    std::cout << "  DONE." << std::endl << std::endl;
+
+    if(!primclex.has_composition_axes()) {
+      std::cerr << "Error in 'casm groundstate'. No composition axes selected. Please use 'casm composition' first." << std::endl;
+      return 1;
+    }
+
+    const DirectoryStructure &dir = primclex.dir();
+    ProjectSettings &set = primclex.settings();
+
+    GroundStateSearch search;
+    try {
+      search.clexulator = primclex.global_clexulator();
+      search.eci = primclex.global_eci(clex_name);
+    }
+    catch(std::exception &e) {
+      std::cerr << "Error in 'casm groundstate'. " << e.what() << std::endl;
+      return 1;
+    }
+    primclex.read_global_orbitree(dir.clust(set.bset()));
+    primclex.generate_full_nlist();
+    primclex.generate_supercell_nlists();
+
+    search.tol = tol;
+    if(vm.count("anneal")) {
+      if(!vm.count("seed"))
+        seed = time(nullptr);
+      search.anneal = true;
+      search.runs = runs;
+      search.sweeps = sweeps;
+      search.kT_init = KB * T_init;
+      search.kT_final = KB * T_final;
+      search.seed = seed;
+      std::cout << "Random number seed: " << seed << std::endl << std::endl;
+    }
+
+    // collect the supercells to search
+    Array<Supercell *> scel;
+    if(vm.count("max") || vm.count("scellname")) {
+      if(vm.count("max")) {
+        for(Index j = 0; j < primclex.get_supercell_list().size(); j++) {
+          if(primclex.get_supercell(j).volume() >= min_vol && primclex.get_supercell(j).volume() <= max_vol)
+            scel.push_back(&primclex.get_supercell(j));
+        }
+      }
+
+      Index index;
+      for(Index i = 0; i < scellname_list.size(); i++) {
+        if(!primclex.contains_supercell(scellname_list[i], index)) {
+          std::cerr << "Error in 'casm groundstate'. Did not find supercell: " << scellname_list[i] << std::endl;
+          return 1;
+        }
+        if(!scel.contains(&primclex.get_supercell(index)))
+          scel.push_back(&primclex.get_supercell(index));
+      }
+    }
+    else {
+      for(Index j = 0; j < primclex.get_supercell_list().size(); j++)
+        scel.push_back(&primclex.get_supercell(j));
+    }
+
+    if(scel.size() == 0) {
+      std::cout << "Did not find any supercells. Make sure to 'casm enum --supercells' first!" << std::endl << std::endl;
+      return 1;
+    }
+
+    std::cout << "Search " << scel.size() << " supercells for ground states of '" << clex_name << "'"
+              << (search.anneal ? ", with simulated annealing" : "") << " ... " << std::flush;
+    GroundStateHull hull;
+    try {
+      hull = search_ground_states(scel, search);
+    }
+    catch(std::exception &e) {
+      std::cerr << "\nError in 'casm groundstate'. " << e.what() << std::endl;
+      return 1;
+    }
+    std::cout << hull.size() << " ground states." << std::endl << std::endl;
+
+    // order by composition for printing
+    std::vector<GroundStateCandidate> gs(hull.candidates());
+    std::sort(gs.begin(), gs.end(), [](const GroundStateCandidate & A, const GroundStateCandidate & B) {
+      for(Index k = 0; k < A.comp.size(); k++) {
+        if(!almost_equal(A.comp(k), B.comp(k)))
+          return A.comp(k) < B.comp(k);
+      }
+      return false;
+    });
+
+    Array<std::string> configname(gs.size());
+    if(vm.count("add")) {
+      jsonParser src;
+      src = "groundstate_search";
+      Index index;
+      Supercell::permute_const_iterator permute_it;
+      for(Index i = 0; i < gs.size(); i++) {
+        Configuration config(*gs[i].scel, src);
+        config.set_occupation(gs[i].occupation);
+        gs[i].scel->add_config(config, index, permute_it);
+        configname[i] = gs[i].scel->get_config(index).name();
+      }
+    }
+
+    int clex_width = std::max(16, int(clex_name.size()) + 8);
+    std::cout << "#" << std::setw(19) << "scelname";
+    for(Index k = 0; k < primclex.composition_axes().independent_compositions(); k++)
+      std::cout << std::setw(16) << std::string("comp(") + char('a' + k) + ")";
+    std::cout << std::setw(clex_width) << "clex(" + clex_name + ")";
+    if(vm.count("add"))
+      std::cout << "  configname";
+    std::cout << "\n";
+    for(Index i = 0; i < gs.size(); i++) {
+      std::cout << std::setw(20) << gs[i].scel->get_name();
+      std::cout.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
+      std::cout.precision(8);
+      for(Index k = 0; k < gs[i].comp.size(); k++)
+        std::cout << std::setw(16) << gs[i].comp(k);
+      std::cout << std::setw(clex_width) << gs[i].energy;
+      if(vm.count("add"))
+        std::cout << "  " << configname[i];
+      std::cout << "\n";
+    }
+    std::cout << std::endl;
+
+    if(vm.count("output")) {
+      jsonParser json = jsonParser::array();
+      for(Index i = 0; i < gs.size(); i++) {
+        jsonParser tjson;
+        tjson["scelname"] = gs[i].scel->get_name();
+        if(vm.count("add"))
+          tjson["configname"] = configname[i];
+        tjson["occupation"] = gs[i].occupation;
+        tjson["param_composition"] = gs[i].comp;
+        tjson["clex"] = gs[i].energy;
+        json.push_back(tjson);
+      }
+      json.write(out_path);
+      std::cout << "Wrote: " << out_path << "\n" << std::endl;
+    }
+
+    if(vm.count("add")) {
+      std::cout << "Writing config_list..." << std::endl;
+      primclex.write_config_list();
+      std::cout << "  DONE" << std::endl;
+    }
+
+    std::cout << std::endl;
+
+    return 0;
+  };
+
+}
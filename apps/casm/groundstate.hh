@@ -0,0 +1,10 @@
+#ifndef GROUNDSTATE_HH
+#define GROUNDSTATE_HH
+
+namespace CASM {
+
+  int groundstate_command(int argc, char *argv[]);
+
+}
+
+#endif
@@ -7,13 +7,28 @@
 #include "casm/app/ProjectSettings.hh"
 
 namespace CASM {
+
+  /// Write the data for configurations [begin, end) to '_stream' in the binary ColumnDataStream format
+  template<typename IteratorType>
+  void write_column_data(const DataFormatter<Configuration> &formatter, IteratorType begin, IteratorType end, std::ostream &_stream) {
+    ColumnDataStream data;
+    if(begin != end)
+      data.set_col_names(formatter.col_header(*begin));
+    formatter.stream_inject(begin, end, data);
+    data.write(_stream);
+  }
+
   void query_help(std::ostream &_stream) {
     _stream << "Prints the properties for a set of configurations for the set of currently selected" << std::endl
             << "configurations or for a set of configurations specifed by a selection file." << std::endl
             << std::endl
-            << "Property values are output in column-separated (default) or JSON format.  By default, " << std::endl
+            << "Property values are output in column-separated (default) or JSON format, or in a binary" << std::endl
+            << "columnar format if the output file extension is .bin.  By default, " << std::endl
             << "entries for 'name' and 'selected' values are included in the output. " << std::endl
             << std::endl
+            << "Configurations are evaluated in parallel, using the number of threads given by the" << std::endl
+            << "environment variable CASM_NUM_THREADS, or all available cores if it is not set." << std::endl
+            << std::endl
             << "Available property tags are currently:" << std::endl;
     ConfigIOParser::print_help(_stream);
     _stream << std::endl;
@@ -34,7 +49,7 @@ namespace CASM {
     ("columns,k", po::value<std::vector<std::string> >(&columns)->multitoken()->required(), "List of values you want printed as columns")
     ("json,j", po::value(&json_flag)->zero_tokens(), "Print in JSON format (CSV otherwise, unless output extension is .json or .JSON)")
     ("verbatim,v", po::value(&verbatim_flag)->zero_tokens(), "Print exact properties specified, without prepending 'name' and 'selected' entries")
-    ("output,o", po::value<fs::path>(&out_path), "Name for output file")
+    ("output,o", po::value<fs::path>(&out_path), "Name for output file. Use extension .json for JSON, or .bin for binary columnar output")
     //("force,f", po::value(&force)->zero_tokens(), "Overrwrite output file")
     ("no-header,n", po::value(&no_header)->zero_tokens(), "Print without header (CSV only)");
 
@@ -98,9 +113,14 @@ namespace CASM {
     if(vm.count("config"))
       std::cout << "to " << out_path << std::endl << std::endl;
 
+    bool binary_flag = (out_path.extension() == ".bin");
     std::ofstream output_file;
-    if(vm.count("output"))
-      output_file.open(out_path.string().c_str());
+    if(vm.count("output")) {
+      if(binary_flag)
+        output_file.open(out_path.string().c_str(), std::ios::out | std::ios::binary);
+      else
+        output_file.open(out_path.string().c_str());
+    }
 
     const DirectoryStructure &dir = primclex.dir();
     ProjectSettings &set = primclex.settings();
@@ -128,30 +148,40 @@ namespace CASM {
     }
     all_columns.insert(all_columns.end(), it, columns.cend());
 
-    // JSON output block
+    // Rows are evaluated in parallel chunks and written as they are completed
     try {
-      if(json_flag || out_path.extension() == ".json" || out_path.extension() == ".JSON") {
-        jsonParser json;
+      // data shared by the formatters, such as hulls, is constructed for this query only
+      DataFormatterCache::Scope cache_scope(ConfigIOParser::cache());
+      DataFormatter<Configuration> formatter(ConfigIOParser::parse(all_columns));
+
+      // binary columnar output block
+      if(binary_flag) {
         if(vm.count("config")) {
           ConstConfigSelection selection(primclex, fs::absolute(config_path));
-          //std::cout << "Read in config selection... it is:\n" << selection;
-
-          json = ConfigIOParser::parse(all_columns)(selection.selected_config_begin(), selection.selected_config_end());
+          write_column_data(formatter, selection.selected_config_cbegin(), selection.selected_config_cend(), output_stream);
+        }
+        else {
+          write_column_data(formatter, primclex.selected_config_cbegin(), primclex.selected_config_cend(), output_stream);
+        }
+      }
+      // JSON output block
+      else if(json_flag || out_path.extension() == ".json" || out_path.extension() == ".JSON") {
+        if(vm.count("config")) {
+          ConstConfigSelection selection(primclex, fs::absolute(config_path));
+          formatter.stream_json(selection.selected_config_cbegin(), selection.selected_config_cend(), output_stream);
         }
         else {
-          json =  ConfigIOParser::parse(all_columns)(primclex.selected_config_begin(), primclex.selected_config_end());
+          formatter.stream_json(primclex.selected_config_cbegin(), primclex.selected_config_cend(), output_stream);
         }
-        output_stream << json;
       }
       // CSV output block
       else {
         if(vm.count("config")) {
           ConstConfigSelection selection(primclex, fs::absolute(config_path));
-          //std::cout << "Read in config selection... it is:\n" << selection;
-          output_stream << ConfigIOParser::parse(all_columns)(selection.selected_config_begin(), selection.selected_config_end());
+          formatter.stream_print(selection.selected_config_cbegin(), selection.selected_config_cend(), output_stream);
         }
         else {
-          output_stream << ConfigIOParser::parse(all_columns)(primclex.selected_config_begin(), primclex.selected_config_end());
+          formatter.stream_print(primclex.selected_config_cbegin(), primclex.selected_config_cend(), output_stream);
         }
       }
     }
@@ -16,7 +16,7 @@ namespace CASM {
     std::cout  << "Writing selection: " << out_path << std::endl;
     if(write_json || out_path.extension() == ".json" || out_path.extension() == ".JSON") {
       jsonParser json;
-      config_select.to_json(json);
+      config_select.to_json(json, only_selected);
       SafeOfstream sout;
       sout.open(out_path);
       json.print(sout.ofstream(), only_selected);
@@ -243,12 +243,12 @@ namespace CASM {
 
       }
 
+      SelectionCriteria compiled_criteria(criteria, primclex);
+
       if(!vm.count("config") || (selection.size() == 1 && selection[0] == "MASTER")) {
 
         if(!vm.count("output")) {
-          for(auto it = primclex.config_begin(); it != primclex.config_end(); ++it) {
-            it->set_selected(get_selection(criteria, *it, it->selected()));
-          }
+          set_selection(compiled_criteria, primclex);
 
           std::cout << "  DONE." << std::endl << std::endl;
 
@@ -259,9 +259,7 @@ namespace CASM {
         }
         else {
           ConfigSelection<true> config_select(primclex);
-          for(auto it = config_select.config_begin(); it != config_select.config_end(); ++it) {
-            it.set_selected(get_selection(criteria, *it, it.selected()));
-          }
+          set_selection(compiled_criteria, config_select);
 
           std::cout << "  DONE." << std::endl << std::endl;
 
@@ -271,9 +269,7 @@ namespace CASM {
       }
       else {
         ConfigSelection<true> config_select(primclex, selection[0]);
-        for(auto it = config_select.config_begin(); it != config_select.config_end(); ++it) {
-          it.set_selected(get_selection(criteria, *it, it.selected()));
-        }
+        set_selection(compiled_criteria, config_select);
 
         bool force = vm.count("force");
         if(!vm.count("output")) {
@@ -314,30 +310,13 @@ namespace CASM {
         config_select = ConfigSelection<true>(primclex, selection[0]);
       }
 
-      // remove unselected configurations
-      auto it = config_select.config_cbegin();
-      while(it != config_select.config_cend()) {
-        if(!it.selected()) {
-          it = config_select.erase(it);
-        }
-        else {
-          ++it;
-        }
-      }
-
-      // loop through other lists, inserting all selected configurations
+      // loop through other lists, selecting all configurations selected in any list
       for(int i = 1; i < selection.size(); i++) {
-        ConfigSelection<true> tselect;
         if(selection[i] == "MASTER") {
-          tselect = ConfigSelection<true>(primclex);
+          config_select |= ConfigSelection<true>(primclex);
         }
         else {
-          tselect = ConfigSelection<true>(primclex, selection[i]);
-        }
-        for(auto it = tselect.config_cbegin(); it != tselect.config_cend(); ++it) {
-          if(it.selected()) {
-            config_select.insert(std::make_pair(it.name(), it.selected()));
-          }
+          config_select |= ConfigSelection<true>(primclex, selection[i]);
         }
       }
 
@@ -361,38 +340,13 @@ namespace CASM {
         config_select = ConfigSelection<true>(primclex, selection[0]);
       }
 
-      // remove unselected configurations
-      auto it = config_select.config_cbegin();
-      while(it != config_select.config_cend()) {
-        if(!it.selected()) {
-          it = config_select.erase(it);
-        }
-        else {
-          ++it;
-        }
-      }
-
       // loop through other lists, keeping only configurations selected in the other lists
       for(int i = 1; i < selection.size(); i++) {
-        ConfigSelection<true> tselect;
         if(selection[i] == "MASTER") {
-          tselect = ConfigSelection<true>(primclex);
+          config_select &= ConfigSelection<true>(primclex);
         }
         else {
-          tselect = ConfigSelection<true>(primclex, selection[i]);
-        }
-        auto it = config_select.config_cbegin();
-        while(it != config_select.config_cend()) {
-          auto find_it = tselect.find(it.name());
-          if(find_it == tselect.config_end()) {
-            it = config_select.erase(it);
-          }
-          else if(!find_it.selected()) {
-            it = config_select.erase(it);
-          }
-          else {
-            ++it;
-          }
+          config_select &= ConfigSelection<true>(primclex, selection[i]);
         }
       }
 
@@ -13,6 +13,7 @@
 
 // json IO
 #include "casm/casm_io/jsonParser.hh"
+#include "casm/casm_io/jsonStream.hh"
 
 // system
 #include "casm/system/RuntimeLibrary.hh"
@@ -35,6 +36,7 @@
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/casm_io/DataStream.hh"
 #include "casm/casm_io/EigenDataStream.hh"
+#include "casm/casm_io/ColumnDataStream.hh"
 #include "casm/casm_io/Args.hh"
 
 
@@ -100,6 +102,8 @@
 #include "casm/clex/ConfigEnumIterator.hh"
 #include "casm/clex/ConfigEnumInterpolation.hh"
 #include "casm/clex/ConfigEnumAllOccupations.hh"
+#include "casm/clex/ConfigEnumByComposition.hh"
+#include "casm/clex/ConfigEnumRandom.hh"
 #include "casm/clex/Configuration.hh"
 #include "casm/clex/ParamComposition.hh"
 #include "casm/clex/CompositionConverter.hh"
@@ -107,10 +111,12 @@
 #include "casm/clex/Supercell.hh"
 #include "casm/clex/PrimClex.hh"
 #include "casm/clex/ConfigIterator.hh"
+#include "casm/clex/GroundStateSearch.hh"
 #include "clex/ConfigSelection.hh"
 #include "clex/ConfigIO.hh"
 
 // Hull
+#include "casm/hull/LowerHull.hh"
 #include "casm/hull/GeometryPieces.hh"
 #include "casm/hull/Hull.hh"
 
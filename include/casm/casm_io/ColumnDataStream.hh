@@ -0,0 +1,156 @@
+#ifndef COLUMNDATASTREAM_HH
+#define COLUMNDATASTREAM_HH
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "casm/CASM_global_definitions.hh"
+#include "casm/casm_io/DataStream.hh"
+
+namespace CASM {
+
+  /// \brief Collects streamed data by column, and writes it as a binary, columnar file
+  ///
+  /// - Each row must have the same number of values. The type of each column is the type of its
+  ///   value in the first row. long and bool values may be streamed to a double column, and bool
+  ///   values to a long column; other mismatches throw std::runtime_error.
+  /// - Strings are stored as codes into a dictionary of the distinct strings in the column
+  /// - If the skipfail trait is set, rows for which the failbit is set are discarded
+  ///
+  /// File format (version 1):
+  /// - All integers are unsigned 64-bit, except string codes, which are unsigned 32-bit. Integers
+  ///   and doubles are written in the byte order of the host; the version number can be used to
+  ///   check the byte order when reading.
+  /// - Every section starts at a multiple of 8 bytes from the start of the file, so that columns
+  ///   can be used in place from a memory-mapped file.
+  ///
+  ///       char[8]     "CASMCOLS"
+  ///       uint64      version (1)
+  ///       uint64      number of rows, R
+  ///       uint64      number of columns, C
+  ///       C x column descriptor:
+  ///         uint64    type (0: double, 1: long, 2: bool, 3: char, 4: string)
+  ///         uint64    offset of the column data, in bytes from the start of the file
+  ///         uint64    size of the column data, in bytes
+  ///         uint64    length of the column name, L
+  ///         char[L]   column name, padded to a multiple of 8 bytes
+  ///       C x column data:
+  ///         double:   double[R]
+  ///         long:     int64[R]
+  ///         bool:     uint8[R], padded
+  ///         char:     char[R], padded
+  ///         string:   uint64 dictionary size D, uint64[D+1] offsets of each dictionary string in
+  ///                   the character block, char[offsets[D]] character block (padded),
+  ///                   uint32[R] dictionary codes (padded)
+  ///
+  class ColumnDataStream : public DataStream {
+  public:
+
+    enum ColumnType {DOUBLE = 0, LONG = 1, BOOL = 2, CHAR = 3, STRING = 4};
+
+    ColumnDataStream(DataStreamTraits _traits = none) :
+      DataStream(_traits), m_rows(0), m_col(0) {}
+
+    DataStream &operator<<(const std::string &val);
+
+    DataStream &operator<<(long val);
+
+    DataStream &operator<<(double val);
+
+    DataStream &operator<<(bool val);
+
+    DataStream &operator<<(char val);
+
+    DataStream &newline();
+
+    /// \brief Set column names
+    ///
+    /// - Columns without a name are named "col(i)", where i is the column index
+    void set_col_names(const std::vector<std::string> &_names) {
+      m_names = _names;
+    }
+
+    /// Number of completed rows
+    Index rows() const {
+      return m_rows;
+    }
+
+    Index cols() const {
+      return m_columns.size();
+    }
+
+    ColumnType type(Index col) const {
+      return m_columns[col].type;
+    }
+
+    std::string col_name(Index col) const;
+
+    /// \brief Write the completed rows in the binary columnar format
+    ///
+    /// - '_stream' should be opened in binary mode
+    void write(std::ostream &_stream) const;
+
+  private:
+
+    struct Column {
+
+      Column(ColumnType _type) : type(_type) {}
+
+      ColumnType type;
+
+      /// DOUBLE values
+      std::vector<double> d;
+
+      /// LONG values
+      std::vector<std::int64_t> l;
+
+      /// BOOL and CHAR values
+      std::vector<char> c;
+
+      /// STRING dictionary codes
+      std::vector<std::uint32_t> code;
+
+      /// STRING dictionary
+      std::vector<std::string> dict;
+      std::unordered_map<std::string, std::uint32_t> dict_index;
+
+      /// Set the number of values, to discard a partial row
+      void resize(Index N);
+
+      /// Size of the column data in the file, in bytes
+      std::uint64_t data_size(Index N) const;
+
+      /// Write the first N values
+      void write(std::ostream &_stream, Index N) const;
+
+    };
+
+    /// Column for the next value, adding it if this is the first row
+    Column &_next(ColumnType _type);
+
+    void _type_error(const Column &col, const std::string &value_type) const;
+
+    /// N rounded up to a multiple of 8
+    static std::uint64_t _padded(std::uint64_t N);
+
+    static void _write_u64(std::ostream &_stream, std::uint64_t val);
+
+    /// Write zeros to pad N bytes to _padded(N) bytes
+    static void _write_padding(std::ostream &_stream, std::uint64_t N);
+
+    std::vector<Column> m_columns;
+
+    std::vector<std::string> m_names;
+
+    Index m_rows;
+
+    /// Column index of the next value in the current row
+    Index m_col;
+
+  };
+
+}
+
+#endif
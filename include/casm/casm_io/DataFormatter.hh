@@ -2,8 +2,11 @@
 #define DATAFORMATTER_HH
 
 #include <iostream>
+#include <map>
+#include <memory>
 #include <string>
 #include <sstream>
+#include <typeinfo>
 #include <vector>
 #include <functional>
 #include <boost/tokenizer.hpp>
@@ -12,6 +15,7 @@
 #include "casm/casm_io/jsonParser.hh"
 #include "casm/casm_io/DataStream.hh"
 #include "casm/casm_io/FormatFlag.hh"
+#include "casm/system/Parallel.hh"
 
 
 namespace CASM {
@@ -61,7 +65,7 @@ namespace CASM {
       push_back(formatters...);
     }
     DataFormatter(const DataFormatter<DataObject> &RHS) :
-      m_initialized(false), m_col_sep(RHS.m_col_sep), m_col_width(RHS.m_col_width),
+      m_initialized(RHS.m_initialized), m_col_sep(RHS.m_col_sep), m_col_width(RHS.m_col_width),
       m_prec(RHS.m_prec), m_sep(RHS.m_sep), m_indent(0), m_comment(RHS.m_comment) {
 
       auto it(RHS.m_data_formatters.cbegin()), it_end(RHS.m_data_formatters.cend());
@@ -78,6 +82,7 @@ namespace CASM {
         return *this;
 
       clear();
+      m_initialized = RHS.m_initialized;
       m_indent = RHS.m_indent;
       m_col_sep = RHS.m_col_sep;
       m_col_width = RHS.m_col_width;
@@ -128,6 +133,38 @@ namespace CASM {
     ///Manually define header
     void print_header(const DataObject &_tmplt_obj, std::ostream &_stream) const;
 
+    /// Returns true if all DatumFormatters are parallel_safe()
+    bool parallel_safe() const;
+
+    /// \brief Print formatted data for each object in [begin, end), in order
+    ///
+    /// - Gives the same output as '_stream << (*this)(begin, end)'
+    /// - Objects are evaluated in chunks, so only one chunk of rows is held in memory at a time
+    /// - If parallel_safe(), the objects in a chunk are evaluated in parallel by copies of *this
+    template<typename IteratorType>
+    void stream_print(IteratorType begin, IteratorType end, std::ostream &_stream,
+                      Index num_threads = default_num_threads()) const;
+
+    /// \brief Print a JSON array with the formatted data for each object in [begin, end), in order
+    ///
+    /// - Gives the same output as printing the jsonParser constructed from (*this)(begin, end),
+    ///   without constructing it
+    /// - Objects are evaluated as in stream_print()
+    template<typename IteratorType>
+    void stream_json(IteratorType begin, IteratorType end, std::ostream &_stream,
+                     Index num_threads = default_num_threads()) const;
+
+    /// \brief Stream data for each object in [begin, end) to '_stream', in order
+    ///
+    /// - Gives the same values as '_stream << (*this)(begin, end)'
+    /// - Objects are evaluated as in stream_print()
+    template<typename IteratorType>
+    void stream_inject(IteratorType begin, IteratorType end, DataStream &_stream,
+                       Index num_threads = default_num_threads()) const;
+
+    /// \brief Header for each scalar column, obtained by splitting the long_header of each DatumFormatter
+    std::vector<std::string> col_header(const DataObject &_template_obj) const;
+
     /// Add a particular BaseDatumFormatter to *this
     /// If the previous Formatter matches the new formatter, try to just parse the new args into it
     void push_back(const BaseDatumFormatter<DataObject> &new_formatter, const std::string &args) {
@@ -181,6 +218,11 @@ namespace CASM {
     std::string m_comment;
 
     void _initialize(const DataObject &_tmplt) const;
+
+    /// Call eval(formatter, obj, row) for each object in [begin, end), and write(row) for each row, in order
+    template<typename RowType, typename IteratorType, typename EvalFunction, typename WriteFunction>
+    void _stream_rows(IteratorType begin, IteratorType end, EvalFunction eval, WriteFunction write,
+                      Index num_threads) const;
   };
 
   /*
@@ -244,6 +286,14 @@ namespace CASM {
       return name();
     };
 
+    /// \brief Returns true if separate clones of this formatter, once initialized, may be used
+    /// concurrently on different objects
+    ///
+    /// Override to return false if evaluation modifies state shared between clones
+    virtual bool parallel_safe() const {
+      return true;
+    }
+
     /// If data must be printed on multiple rows, returns number of rows needed to output all data from _data_obj
     /// DataFormatter class will subsequently pass over _data_obj multiple times to complete printing (if necessary)
     virtual Index num_passes(const DataObject &_data_obj) const {
@@ -395,6 +445,64 @@ namespace CASM {
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+  /// \brief Data shared by DatumFormatters during a run, such as the convex hull that several
+  /// hull formatters with the same arguments would otherwise each construct
+  ///
+  /// - Values are stored by key and type, and constructed by the first formatter that needs them
+  /// - Keys should include every argument that the value depends on, including the PrimClex
+  /// - Values live for one query: use a DataFormatterCache::Scope around each query so that
+  ///   values are not reused after the data they were constructed from has changed
+  /// - Not thread safe: values should be obtained in BaseDatumFormatter::init, or by formatters
+  ///   that are not parallel_safe()
+  class DataFormatterCache {
+  public:
+
+    /// Clears the cache on construction and on destruction
+    class Scope {
+    public:
+      explicit Scope(DataFormatterCache &_cache) :
+        m_cache(_cache) {
+        m_cache.clear();
+      }
+
+      ~Scope() {
+        m_cache.clear();
+      }
+
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+
+    private:
+      DataFormatterCache &m_cache;
+    };
+
+    /// \brief Returns the value of type T stored with 'key', constructing it with 'make' if
+    /// it does not exist
+    template<typename T>
+    std::shared_ptr<T> get(const std::string &key, const std::function<std::shared_ptr<T>()> &make) {
+      std::string full_key = std::string(typeid(T).name()) + ":" + key;
+      auto it = m_data.find(full_key);
+      if(it != m_data.end())
+        return std::static_pointer_cast<T>(it->second);
+
+      // 'make' may itself use the cache
+      std::shared_ptr<T> result = make();
+      m_data[full_key] = result;
+      return result;
+    }
+
+    /// Discard all values, for instance if the data they were constructed from has changed
+    void clear() {
+      m_data.clear();
+    }
+
+  private:
+    std::map<std::string, std::shared_ptr<void> > m_data;
+  };
+
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
   /// Parsing dictionary for constructing a DataFormatter<DataObject> object.
   template<typename DataObject>
   class DataFormatterDictionary {
@@ -473,9 +581,15 @@ namespace CASM {
     Index size() const {
       return m_formatter_map.size();
     }
+
+    /// Data shared by the formatters parsed from this dictionary
+    DataFormatterCache &cache() const {
+      return m_cache;
+    }
   private:
     typedef std::map<std::string, std::unique_ptr<BaseDatumFormatter<DataObject> > > container;
     container m_formatter_map;
+    mutable DataFormatterCache m_cache;
     static void _parse(const std::string &input, std::vector<std::string> &format_tags, std::vector<std::string> &format_args);
   };
 
@@ -500,6 +614,11 @@ namespace CASM {
     static void print_help(std::ostream &_stream, int width = 60, int separation = 8) {
       dictionary().print_help(_stream, width, separation);
     }
+
+    /// Data shared by DatumFormatters during a run
+    static DataFormatterCache &cache() {
+      return dictionary().cache();
+    }
   private:
     static DataFormatterDictionary<DataObject> &dictionary();
 
@@ -165,6 +165,172 @@ namespace CASM {
     return;
   }
 
+  //******************************************************************************
+
+  template<typename DataObject>
+  bool DataFormatter<DataObject>::parallel_safe() const {
+    for(Index i = 0; i < m_data_formatters.size(); i++)
+      if(!m_data_formatters[i]->parallel_safe())
+        return false;
+    return true;
+  }
+
+  //******************************************************************************
+
+  template<typename DataObject>
+  template<typename IteratorType>
+  void DataFormatter<DataObject>::stream_print(IteratorType begin, IteratorType end, std::ostream &_stream,
+                                               Index num_threads) const {
+    if(begin == end)
+      return;
+
+    FormatFlag format(_stream);
+    if(format.print_header()) {
+      print_header(*begin, _stream);
+    }
+    else { // always print header to initialize things, like Clexulator, but in this case throw it away
+      std::stringstream _ss;
+      print_header(*begin, _ss);
+    }
+    format.print_header(false);
+    _stream << format;
+
+    auto eval = [](const DataFormatter & f, const DataObject & obj, std::string & row) {
+      std::stringstream t_ss;
+      f.print(obj, t_ss);
+      row = t_ss.str();
+    };
+    auto write = [&](const std::string & row) {
+      _stream << row;
+    };
+    _stream_rows<std::string>(begin, end, eval, write, num_threads);
+  }
+
+  //******************************************************************************
+
+  template<typename DataObject>
+  template<typename IteratorType>
+  void DataFormatter<DataObject>::stream_json(IteratorType begin, IteratorType end, std::ostream &_stream,
+                                              Index num_threads) const {
+    if(begin == end) {
+      _stream << jsonParser::array();
+      return;
+    }
+
+    if(!m_initialized)
+      _initialize(*begin);
+
+    // each object is printed as it would be as an element of the array: indented one level
+    auto eval = [](const DataFormatter & f, const DataObject & obj, std::string & row) {
+      jsonParser json;
+      f.to_json(obj, json);
+      std::stringstream t_ss, row_ss;
+      json.print(t_ss);
+      std::string line;
+      bool first = true;
+      while(std::getline(t_ss, line)) {
+        if(!first)
+          row_ss << "\n";
+        row_ss << "  " << line;
+        first = false;
+      }
+      row = row_ss.str();
+    };
+
+    bool first = true;
+    auto write = [&](const std::string & row) {
+      if(!first)
+        _stream << ",\n";
+      _stream << row;
+      first = false;
+    };
+
+    _stream << "[\n";
+    _stream_rows<std::string>(begin, end, eval, write, num_threads);
+    _stream << "\n]";
+  }
+
+  //******************************************************************************
+
+  template<typename DataObject>
+  template<typename IteratorType>
+  void DataFormatter<DataObject>::stream_inject(IteratorType begin, IteratorType end, DataStream &_stream,
+                                                Index num_threads) const {
+    if(begin == end)
+      return;
+
+    if(!m_initialized)
+      _initialize(*begin);
+
+    auto eval = [](const DataFormatter & f, const DataObject & obj, RecordDataStream & row) {
+      row.clear();
+      f.inject(obj, row);
+    };
+    auto write = [&](const RecordDataStream & row) {
+      row.replay(_stream);
+    };
+    _stream_rows<RecordDataStream>(begin, end, eval, write, num_threads);
+  }
+
+  //******************************************************************************
+
+  template<typename DataObject>
+  std::vector<std::string> DataFormatter<DataObject>::col_header(const DataObject &_template_obj) const {
+    if(!m_initialized)
+      _initialize(_template_obj);
+    std::vector<std::string> _col;
+    std::string word;
+    for(Index i = 0; i < m_data_formatters.size(); i++) {
+      std::stringstream t_ss(m_data_formatters[i]->long_header(_template_obj));
+      while(t_ss >> word)
+        _col.push_back(word);
+    }
+    return _col;
+  }
+
+  //******************************************************************************
+
+  template<typename DataObject>
+  template<typename RowType, typename IteratorType, typename EvalFunction, typename WriteFunction>
+  void DataFormatter<DataObject>::_stream_rows(IteratorType begin, IteratorType end, EvalFunction eval,
+                                               WriteFunction write, Index num_threads) const {
+    if(!parallel_safe())
+      num_threads = 1;
+
+    // serial: write each row as it is evaluated
+    if(num_threads <= 1) {
+      RowType row;
+      for(IteratorType it(begin); it != end; ++it) {
+        eval(*this, *it, row);
+        write(row);
+      }
+      return;
+    }
+
+    // parallel: each thread has its own copy of the (initialized) formatter, and evaluates
+    // every num_threads-th object of a chunk; rows are written in order after each chunk
+    std::vector<DataFormatter> formatter(num_threads, *this);
+    Index chunk_size = 256 * num_threads;
+    std::vector<const DataObject *> obj;
+    std::vector<RowType> rows(chunk_size);
+    obj.reserve(chunk_size);
+
+    IteratorType it(begin);
+    while(it != end) {
+      obj.clear();
+      for(; it != end && obj.size() < chunk_size; ++it)
+        obj.push_back(&(*it));
+
+      parallel_for(0, num_threads, [&](Index t) {
+        for(Index i = t; i < obj.size(); i += num_threads)
+          eval(formatter[t], *obj[i], rows[i]);
+      }, num_threads);
+
+      for(Index i = 0; i < obj.size(); i++)
+        write(rows[i]);
+    }
+  }
+
   //******************************************************************************
   template<typename DataObject>
   void DataFormatter<DataObject>::_initialize(const DataObject &_template_obj)const {
@@ -1,5 +1,6 @@
 #ifndef DATASTREAM_HH
 #define DATASTREAM_HH
+#include <string>
 #include <vector>
 namespace CASM {
 
@@ -118,6 +119,102 @@ namespace CASM {
 
   };
 
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+  // Record the values streamed, so that they can be streamed to another DataStream later
+  //   - If the failbit is set when newline() is called, it is set on the other DataStream
+  //     before its newline() is called, and cleared here
+  class RecordDataStream : public DataStream {
+  public:
+    RecordDataStream() :
+      DataStream(none) {}
+
+    DataStream &operator<<(const std::string &val) {
+      m_entry.push_back(Entry(Entry::STRING));
+      m_entry.back().s = val;
+      return *this;
+    }
+
+    DataStream &operator<<(long val) {
+      m_entry.push_back(Entry(Entry::LONG));
+      m_entry.back().l = val;
+      return *this;
+    }
+
+    DataStream &operator<<(double val) {
+      m_entry.push_back(Entry(Entry::DOUBLE));
+      m_entry.back().d = val;
+      return *this;
+    }
+
+    DataStream &operator<<(bool val) {
+      m_entry.push_back(Entry(Entry::BOOL));
+      m_entry.back().l = val;
+      return *this;
+    }
+
+    DataStream &operator<<(char val) {
+      m_entry.push_back(Entry(Entry::CHAR));
+      m_entry.back().l = val;
+      return *this;
+    }
+
+    DataStream &newline() {
+      m_entry.push_back(Entry(Entry::NEWLINE));
+      m_entry.back().l = fail();
+      clear_fail();
+      return *this;
+    }
+
+    /// Stream the recorded values to '_stream'
+    void replay(DataStream &_stream) const {
+      for(auto it = m_entry.cbegin(); it != m_entry.cend(); ++it) {
+        switch(it->type) {
+        case Entry::STRING:
+          _stream << it->s;
+          break;
+        case Entry::LONG:
+          _stream << it->l;
+          break;
+        case Entry::DOUBLE:
+          _stream << it->d;
+          break;
+        case Entry::BOOL:
+          _stream << bool(it->l);
+          break;
+        case Entry::CHAR:
+          _stream << char(it->l);
+          break;
+        case Entry::NEWLINE:
+          if(it->l)
+            _stream << failbit;
+          _stream.newline();
+          break;
+        }
+      }
+    }
+
+    void clear() {
+      m_entry.clear();
+      clear_fail();
+    }
+
+  private:
+    struct Entry {
+      enum Type {STRING, LONG, DOUBLE, BOOL, CHAR, NEWLINE};
+
+      Entry(Type _type) : type(_type), l(0), d(0.0) {}
+
+      Type type;
+      long l;
+      double d;
+      std::string s;
+    };
+
+    std::vector<Entry> m_entry;
+
+  };
+
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   namespace ArrayDataStream_impl {
@@ -0,0 +1,255 @@
+#ifndef CASM_JSONSTREAM_HH
+#define CASM_JSONSTREAM_HH
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/external/json_spirit/json_spirit_value.h"
+
+namespace CASM {
+
+  /// \brief Interface for receiving JSON parsing events from jsonReader
+  ///
+  /// - Object members are reported as key(name) followed by the events for the value
+  /// - Integers are reported as int_value, unless they only fit in an unsigned 64-bit integer
+  /// - Numbers with a decimal point or exponent are reported as double_value
+  class jsonHandler {
+  public:
+
+    virtual ~jsonHandler() {}
+
+    virtual void null_value() = 0;
+
+    virtual void bool_value(bool val) = 0;
+
+    virtual void int_value(std::int64_t val) = 0;
+
+    virtual void uint_value(std::uint64_t val) = 0;
+
+    virtual void double_value(double val) = 0;
+
+    virtual void string_value(const std::string &val) = 0;
+
+    virtual void begin_object() = 0;
+
+    virtual void key(const std::string &name) = 0;
+
+    virtual void end_object() = 0;
+
+    virtual void begin_array() = 0;
+
+    virtual void end_array() = 0;
+
+  };
+
+  /// \brief Event driven JSON parser
+  ///
+  /// - Accepts the same input as json_spirit::read_stream: whitespace and '//' or '/* */'
+  ///   comments between tokens, and content after the first complete value is ignored
+  /// - String escapes are substituted as by json_spirit
+  /// - Invalid input throws std::runtime_error, with the line and column of the error
+  class jsonReader {
+  public:
+
+    /// Parse the characters in [begin, end), which must be followed by a null character
+    jsonReader(const char *begin, const char *end);
+
+    /// Parse a JSON value, sending the events to 'handler'
+    void parse(jsonHandler &handler);
+
+    /// Read all of 'stream' and parse it, sending the events to 'handler'
+    ///
+    /// - Returns false if the input is not valid JSON
+    static bool read(std::istream &stream, jsonHandler &handler);
+
+  private:
+
+    void _value(jsonHandler &handler);
+
+    void _object(jsonHandler &handler);
+
+    void _array(jsonHandler &handler);
+
+    void _number(jsonHandler &handler);
+
+    void _string(std::string &str);
+
+    void _literal(const char *word);
+
+    /// Skip whitespace and comments
+    void _skip();
+
+    void _error(const std::string &what) const;
+
+    static int _hex(char c);
+
+    const char *m_begin;
+
+    const char *m_pos;
+
+    const char *m_end;
+
+    /// Reused for strings and keys
+    std::string m_str;
+
+  };
+
+  /// \brief jsonHandler that builds a json_spirit::mValue tree
+  class jsonTreeHandler : public jsonHandler {
+  public:
+
+    /// Build the tree in 'value', replacing its contents
+    jsonTreeHandler(json_spirit::mValue &value) :
+      m_value(&value) {}
+
+    void null_value();
+
+    void bool_value(bool val);
+
+    void int_value(std::int64_t val);
+
+    void uint_value(std::uint64_t val);
+
+    void double_value(double val);
+
+    void string_value(const std::string &val);
+
+    void begin_object();
+
+    void key(const std::string &name);
+
+    void end_object();
+
+    void begin_array();
+
+    void end_array();
+
+  private:
+
+    /// Location for the next value
+    json_spirit::mValue &_next();
+
+    json_spirit::mValue *m_value;
+
+    /// Objects and arrays being filled
+    std::vector<json_spirit::mValue *> m_stack;
+
+    std::string m_key;
+
+  };
+
+  /// \brief Streaming JSON writer
+  ///
+  /// - Writes the same text as jsonParser::print, which uses it: objects and arrays are written
+  ///   one element per line, or on a single line when 'single_line' is true, and doubles are
+  ///   written in fixed notation with 'prec' digits after the decimal point
+  /// - Output is buffered, and written to the stream by flush() or the destructor
+  ///
+  /// Example:
+  /// \code
+  /// jsonWriter writer(std::cout);
+  /// writer.begin_object();
+  /// writer.key("name").value("SCEL1_1_1_1_0_0_0");
+  /// writer.key("corr").begin_array();
+  /// for(Index i = 0; i < corr.size(); i++)
+  ///   writer.value(corr[i]);
+  /// writer.end_array();
+  /// writer.end_object();
+  /// \endcode
+  class jsonWriter {
+  public:
+
+    jsonWriter(std::ostream &stream, unsigned int indent = 2, unsigned int prec = 12);
+
+    ~jsonWriter();
+
+    jsonWriter &begin_object(bool single_line = false);
+
+    jsonWriter &end_object();
+
+    jsonWriter &begin_array(bool single_line = true);
+
+    jsonWriter &end_array();
+
+    /// Begin an object member; must be followed by its value
+    jsonWriter &key(const std::string &name);
+
+    jsonWriter &null_value();
+
+    jsonWriter &value(bool val);
+
+    jsonWriter &value(int val) {
+      return value(std::int64_t(val));
+    }
+
+    jsonWriter &value(std::int64_t val);
+
+    jsonWriter &value(std::uint64_t val);
+
+    /// Write 'val' in fixed notation; with 'remove_trailing_zeros', "1.200000" is written as "1.2"
+    jsonWriter &value(double val, bool remove_trailing_zeros = false);
+
+    jsonWriter &value(const std::string &val);
+
+    jsonWriter &value(const char *val) {
+      return value(std::string(val));
+    }
+
+    /// Write a json_spirit::mValue tree, respecting its force_row, force_column and
+    /// remove_trailing_zeros options
+    jsonWriter &value(const json_spirit::mValue &val);
+
+    /// Write buffered output to the stream
+    void flush();
+
+    /// Write 'val' to 'buf' in fixed notation with 'prec' digits after the decimal point, as
+    /// std::fixed and std::showpoint do; returns a pointer past the last character written
+    ///
+    /// - 'buf' must have room for 320 + prec characters
+    static char *format_fixed(double val, unsigned int prec, char *buf);
+
+  private:
+
+    struct Frame {
+      bool single_line;
+      Index size;
+    };
+
+    /// Write the separator before the next value
+    void _begin_value();
+
+    void _newline();
+
+    void _string(const std::string &str);
+
+    void _uint(std::uint64_t val);
+
+    static bool _has_composite(const json_spirit::mArray &arr);
+
+    std::ostream &m_stream;
+
+    std::string m_buf;
+
+    unsigned int m_indent;
+
+    unsigned int m_prec;
+
+    std::vector<Frame> m_stack;
+
+    /// Number of open multi-line objects and arrays
+    Index m_level;
+
+    /// Buffer for format_fixed
+    std::vector<char> m_num;
+
+    /// True after key(), until the member value is written
+    bool m_after_key;
+
+  };
+
+}
+
+#endif
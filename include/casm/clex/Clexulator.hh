@@ -6,6 +6,7 @@
 #define BOOST_NO_CXX11_SCOPED_ENUMS
 #include <boost/filesystem.hpp>
 #include "casm/system/RuntimeLibrary.hh"
+#include "casm/misc/Profile.hh"
 
 namespace CASM {
 
@@ -232,6 +233,8 @@ namespace CASM {
 
       namespace fs = boost::filesystem;
 
+      ProfileScope prof("Clexulator::Clexulator");
+
       try {
 
         // Construct the RuntimeLibrary that will store the loaded clexulator library
@@ -329,6 +332,14 @@ namespace CASM {
       return m_name;
     }
 
+    /// \brief Loaded runtime library, which is shared by copies of this Clexulator
+    ///
+    /// Clexulators constructed separately have distinct libraries, even if they have the same
+    /// name, so the library identifies the basis set that correlations were calculated with
+    std::shared_ptr<const RuntimeLibrary> library() const {
+      return m_lib;
+    }
+
     /// \brief Neighbor list size
     size_type nlist_size() const {
       return m_clex->nlist_size();
@@ -196,6 +196,13 @@ namespace CASM {
   /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
   Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator);
 
+  /// \brief Writes correlations using 'clexulator' to corr_begin[0, clexulator.corr_size()), without allocating
+  ///
+  /// - tcorr_begin[0, clexulator.corr_size()) is used as scratch space for the contribution of each unit cell
+  /// - Supercell needs a correctly populated neighbor list
+  void calc_correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator,
+                         double *corr_begin, double *tcorr_begin);
+
 }
 
 #endif
@@ -58,6 +58,9 @@ namespace CASM {
     };
 
     iterator begin() {
+      // an enumerator of unknown length that found nothing is already at its end
+      if(num_steps() == -1 && step() == -1)
+        return end();
       return iterator(*this, 0);
     }
 
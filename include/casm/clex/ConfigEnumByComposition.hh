@@ -0,0 +1,96 @@
+#ifndef CONFIGENUMBYCOMPOSITION_HH
+#define CONFIGENUMBYCOMPOSITION_HH
+
+#include "casm/clex/ConfigEnum.hh"
+#include "casm/symmetry/PermuteIterator.hh"
+
+namespace CASM {
+
+  /// \brief Enumerate the occupation configurations of a supercell that have a fixed composition
+  ///        on each sublattice
+  ///
+  /// 'sublat_num_each[b][occ]' is the number of sites on sublattice 'b' (prim basis site 'b') with
+  /// occupant 'occ', ordered as in the prim's site_occupant list. For each sublattice the counts must
+  /// sum to the supercell volume; otherwise nothing is enumerated.
+  ///
+  /// Only the distinct arrangements of each sublattice are visited (next_permutation on each
+  /// sublattice, with the first sublattice as the inner loop), instead of the full Counter range used
+  /// by ConfigEnumAllOccupations. As there, only primitive configurations are kept, and one
+  /// configuration in canonical form is returned per orbit.
+  ///
+  /// If a symmetry operation maps sublattices with different requested compositions onto each other,
+  /// the canonical form of a configuration may not itself have the requested sublattice compositions.
+  /// Orbits are then identified using only the operations that preserve the requested compositions,
+  /// and the canonical form of the equivalent configuration is returned.
+  template <typename ConfigType>
+  class ConfigEnumByComposition : public ConfigEnum<ConfigType> {
+  public:
+    typedef typename ConfigEnum<ConfigType>::step_type step_type;
+
+    // ConfigType is either Configurations or ConfigDoF
+    typedef typename ConfigEnum<ConfigType>::value_type value_type;
+
+    typedef typename ConfigEnum<ConfigType>::iterator iterator;
+
+    using ConfigEnum<ConfigType>::initial;
+    using ConfigEnum<ConfigType>::final;
+    using ConfigEnum<ConfigType>::current;
+    using ConfigEnum<ConfigType>::num_steps;
+    using ConfigEnum<ConfigType>::step;
+  private:
+    Array<Array<int> > m_sublat_num_each;
+
+    /// occupation being enumerated, m_occ[b*volume + i] for sublattice 'b'
+    Array<int> m_occ;
+    Index m_volume;
+    bool m_valid;
+
+    PermuteIterator m_perm_begin, m_perm_end;
+
+    /// true if every permutation preserves the requested sublattice compositions
+    bool m_preserve_all;
+
+    /// permutations that preserve the requested sublattice compositions, if !m_preserve_all
+    Array<PermuteIterator> m_preserving;
+
+    using ConfigEnum<ConfigType>::_current;
+    using ConfigEnum<ConfigType>::_step;
+    using ConfigEnum<ConfigType>::_source;
+
+    const PermuteIterator &_perm_begin() {
+      return m_perm_begin;
+    }
+    const PermuteIterator &_perm_end() {
+      return m_perm_end;
+    }
+
+    /// Go to the next arrangement of m_occ, returns false after the last one
+    bool _next_occupation();
+
+    /// Check m_occ for being primitive and canonical, and set current() if it is
+    bool _check_current();
+
+    /// Check that m_occ is greatest among its images by m_preserving
+    bool _is_canonical_among_preserving() const;
+
+  public:
+    ConfigEnumByComposition(const value_type &_initial, const Array<Array<int> > &_sublat_num_each, PermuteIterator perm_begin, PermuteIterator perm_end);
+
+    const Array<Array<int> > &sublat_num_each() const {
+      return m_sublat_num_each;
+    }
+
+    // **** Mutators ****
+    // increment m_current and return a reference to it
+    const value_type &increment();
+
+    // set m_current to correct value at specified step and return a reference to it
+    const value_type &goto_step(step_type _step);
+
+  };
+
+}
+
+#include "casm/clex/ConfigEnumByComposition_impl.hh"
+
+#endif
@@ -0,0 +1,148 @@
+#include <algorithm>
+
+namespace CASM {
+  template<typename ConfigType>
+  ConfigEnumByComposition<ConfigType>::ConfigEnumByComposition(const ConfigEnumByComposition<ConfigType>::value_type &_initial,
+                                                               const Array<Array<int> > &_sublat_num_each,
+                                                               PermuteIterator _perm_begin, PermuteIterator _perm_end) :
+    ConfigEnum<ConfigType>(_initial, _initial, -1),
+    m_sublat_num_each(_sublat_num_each),
+    m_volume(0),
+    m_valid(false),
+    m_perm_begin(_perm_begin), m_perm_end(_perm_end),
+    m_preserve_all(true) {
+
+    _source() = "composition_enumeration";
+
+    // Check that the counts fill each sublattice, and fill m_occ with the first (sorted) arrangement
+    Index N_sublat = m_sublat_num_each.size();
+    if(N_sublat != 0 && _initial.size() % N_sublat == 0) {
+      m_volume = _initial.size() / N_sublat;
+      m_valid = true;
+    }
+    for(Index b = 0; b < N_sublat && m_valid; b++) {
+      for(Index occ = 0; occ < m_sublat_num_each[b].size(); occ++) {
+        if(m_sublat_num_each[b][occ] < 0) {
+          m_valid = false;
+          break;
+        }
+        m_occ.append(Array<int>(m_sublat_num_each[b][occ], occ));
+      }
+      if(m_occ.size() != (b + 1) * m_volume)
+        m_valid = false;
+    }
+
+    if(!m_valid) {
+      _step() = -1;
+      return;
+    }
+
+    // The sublattice that ends up at sublattice 'b' after a permutation is the same for all the
+    // translations of a factor group operation, so check only the first of each
+    PermuteIterator it = m_perm_begin;
+    while(it != m_perm_end) {
+      PermuteIterator it_next_fg = it.begin_next_fg_op();
+      bool preserve = true;
+      for(Index b = 0; b < N_sublat; b++) {
+        if(m_sublat_num_each[it.permute_ind(b * m_volume) / m_volume] != m_sublat_num_each[b]) {
+          preserve = false;
+          break;
+        }
+      }
+      if(!preserve)
+        m_preserve_all = false;
+      for(; it != it_next_fg; ++it) {
+        if(preserve)
+          m_preserving.push_back(it);
+      }
+    }
+    if(m_preserve_all)
+      m_preserving.clear();
+
+    // Make sure that current() has primitive canonical config
+    if(!_check_current())
+      increment();
+
+    if(!m_valid)
+      _step() = -1;
+    else
+      _step() = 0;
+
+  }
+
+  //*******************************************************************************************
+  // **** Mutators ****
+  // increment m_current and return a reference to it
+  template<typename ConfigType>
+  const typename ConfigEnumByComposition<ConfigType>::value_type &ConfigEnumByComposition<ConfigType>::increment() {
+    bool is_valid_config(false);
+    while(!is_valid_config && m_valid) {
+      m_valid = _next_occupation();
+      if(m_valid)
+        is_valid_config = _check_current();
+    }
+
+    if(m_valid)
+      _step()++;
+    else
+      _step() = -1;
+    return current();
+  }
+
+  //*******************************************************************************************
+  // set m_current to correct value at specified step and return a reference to it
+  template<typename ConfigType>
+  const typename ConfigEnumByComposition<ConfigType>::value_type &ConfigEnumByComposition<ConfigType>::goto_step(step_type _step) {
+    std::cerr << "CRITICAL ERROR: Class ConfigEnumByComposition does not implement a goto_step() method. \n"
+              << "                You may be using a ConfigEnumIterator in an unsafe way!\n"
+              << "                Exiting...\n";
+    assert(0);
+    exit(1);
+    return current();
+  };
+
+  //*******************************************************************************************
+  /// The first sublattice is the inner loop. std::next_permutation returns false, after sorting
+  /// the range back to the first arrangement, when it wraps around.
+  template<typename ConfigType>
+  bool ConfigEnumByComposition<ConfigType>::_next_occupation() {
+    for(Index b = 0; b < m_sublat_num_each.size(); b++) {
+      if(std::next_permutation(m_occ.begin() + b * m_volume, m_occ.begin() + (b + 1) * m_volume))
+        return true;
+    }
+    return false;
+  }
+
+  //*******************************************************************************************
+  template<typename ConfigType>
+  bool ConfigEnumByComposition<ConfigType>::_check_current() {
+    _current().set_occupation(m_occ);
+    if(!current().is_primitive(_perm_begin()))
+      return false;
+
+    if(m_preserve_all)
+      return current().is_canonical(_perm_begin(), _perm_end());
+
+    if(!_is_canonical_among_preserving())
+      return false;
+
+    PermuteIterator it_canon;
+    _current().set_occupation(current().canonical_form(_perm_begin(), _perm_end(), it_canon).occupation());
+    return true;
+  }
+
+  //*******************************************************************************************
+  template<typename ConfigType>
+  bool ConfigEnumByComposition<ConfigType>::_is_canonical_among_preserving() const {
+    for(Index p = 0; p < m_preserving.size(); p++) {
+      for(Index i = 0; i < m_occ.size(); i++) {
+        int permuted = m_occ[m_preserving[p].permute_ind(i)];
+        if(permuted > m_occ[i])
+          return false;
+        if(permuted < m_occ[i])
+          break;
+      }
+    }
+    return true;
+  }
+}
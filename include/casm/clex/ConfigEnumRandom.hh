@@ -0,0 +1,97 @@
+#ifndef CONFIGENUMRANDOM_HH
+#define CONFIGENUMRANDOM_HH
+
+#include "casm/clex/ConfigEnum.hh"
+#include "casm/clex/Clexulator.hh"
+#include "casm/clex/ECIContainer.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+namespace CASM {
+
+  class Supercell;
+
+  /// \brief How ConfigEnumRandom draws occupations
+  struct RandomSampling {
+
+    RandomSampling() :
+      kT(0.0), sweeps(1) {}
+
+    /// If not empty, the number of each occupant on each sublattice, as for ConfigEnumByComposition.
+    /// Otherwise each site is occupied independently.
+    Array<Array<int> > sublat_num_each;
+
+    /// If kT > 0.0, occupations are sampled from a Metropolis Monte Carlo run at temperature kT
+    /// (in the units of 'eci'), taking one sample every 'sweeps' passes over the sites. Moves swap
+    /// two sites of a sublattice if 'sublat_num_each' is given, and change one site otherwise.
+    /// If kT == 0.0, every occupation is drawn uniformly.
+    double kT;
+    Index sweeps;
+    Clexulator clexulator;
+    ECIContainer eci;
+
+  };
+
+  /// \brief Enumerate 'N_samples' random occupation configurations of a supercell
+  ///
+  /// Samples are not canonicalized or checked for duplicates, so that each random number stream
+  /// can run on its own. Use Supercell::sample_configurations to add them to a Supercell.
+  ///
+  /// Using kT > 0.0 requires the Supercell neighbor lists.
+  template <typename ConfigType>
+  class ConfigEnumRandom : public ConfigEnum<ConfigType> {
+  public:
+    typedef typename ConfigEnum<ConfigType>::step_type step_type;
+
+    // ConfigType is either Configurations or ConfigDoF
+    typedef typename ConfigEnum<ConfigType>::value_type value_type;
+
+    typedef typename ConfigEnum<ConfigType>::iterator iterator;
+
+    using ConfigEnum<ConfigType>::initial;
+    using ConfigEnum<ConfigType>::final;
+    using ConfigEnum<ConfigType>::current;
+    using ConfigEnum<ConfigType>::num_steps;
+    using ConfigEnum<ConfigType>::step;
+  private:
+    const Supercell *m_scel;
+    RandomSampling m_sampling;
+    MTRand &m_mtrand;
+
+    Array<int> m_max_occ;
+
+    /// occupation being sampled, Monte Carlo state if m_sampling.kT > 0.0
+    Array<int> m_occ;
+
+    /// for the energy change of Monte Carlo moves
+    std::vector<double> m_delta_corr;
+
+    using ConfigEnum<ConfigType>::_current;
+    using ConfigEnum<ConfigType>::_step;
+    using ConfigEnum<ConfigType>::_source;
+
+    /// Set m_occ to a uniformly random occupation
+    void _draw();
+
+    /// Change in energy if site 'l' changes from 'occ_i' to 'occ_f', with the current m_occ
+    double _delta_energy(Index l, int occ_i, int occ_f);
+
+    /// Attempt one Monte Carlo move per site
+    void _sweep();
+
+  public:
+    ConfigEnumRandom(const value_type &_initial, const Supercell &_scel, const RandomSampling &_sampling, Index _N_samples, MTRand &_mtrand);
+
+    // **** Mutators ****
+    // increment m_current and return a reference to it
+    const value_type &increment();
+
+    // set m_current to correct value at specified step and return a reference to it
+    const value_type &goto_step(step_type _step);
+
+  };
+
+}
+
+#include "casm/clex/ConfigEnumRandom_impl.hh"
+
+#endif
@@ -0,0 +1,159 @@
+#include <cmath>
+#include <stdexcept>
+
+#include "casm/clex/Supercell.hh"
+
+namespace CASM {
+  template<typename ConfigType>
+  ConfigEnumRandom<ConfigType>::ConfigEnumRandom(const ConfigEnumRandom<ConfigType>::value_type &_initial,
+                                                 const Supercell &_scel,
+                                                 const RandomSampling &_sampling,
+                                                 Index _N_samples,
+                                                 MTRand &_mtrand) :
+    ConfigEnum<ConfigType>(_initial, _initial, _N_samples),
+    m_scel(&_scel),
+    m_sampling(_sampling),
+    m_mtrand(_mtrand),
+    m_max_occ(_scel.max_allowed_occupation()) {
+
+    _source() = "random_sampling";
+
+    const Array<Array<int> > &sublat_num_each = m_sampling.sublat_num_each;
+    if(sublat_num_each.size()) {
+      if(sublat_num_each.size() != _scel.get_prim().basis.size()) {
+        throw std::runtime_error("Error in ConfigEnumRandom: sublat_num_each.size() is not the number of sublattices");
+      }
+      for(Index b = 0; b < sublat_num_each.size(); b++) {
+        if(sublat_num_each[b].size() != m_max_occ[b * _scel.volume()] + 1 || sublat_num_each[b].sum() != _scel.volume()) {
+          throw std::runtime_error("Error in ConfigEnumRandom: sublat_num_each does not fill the supercell");
+        }
+      }
+    }
+
+    if(m_sampling.kT > 0.0 && !m_sampling.clexulator.initialized()) {
+      throw std::runtime_error("Error in ConfigEnumRandom: Monte Carlo sampling requires a Clexulator");
+    }
+
+    _draw();
+
+    if(m_sampling.kT > 0.0) {
+      m_delta_corr.resize(m_sampling.clexulator.corr_size(), 0.0);
+      m_sampling.clexulator.set_config_occ(m_occ.begin());
+
+      // equilibrate before the first sample
+      for(Index s = 0; s < m_sampling.sweeps; s++)
+        _sweep();
+    }
+
+    _current().set_occupation(m_occ);
+    _step() = 0;
+  }
+
+  //*******************************************************************************************
+  // **** Mutators ****
+  // increment m_current and return a reference to it
+  template<typename ConfigType>
+  const typename ConfigEnumRandom<ConfigType>::value_type &ConfigEnumRandom<ConfigType>::increment() {
+    // don't draw past the last sample
+    if(step() + 1 < num_steps()) {
+      if(m_sampling.kT > 0.0) {
+        for(Index s = 0; s < m_sampling.sweeps; s++)
+          _sweep();
+      }
+      else
+        _draw();
+      _current().set_occupation(m_occ);
+    }
+    _step()++;
+    return current();
+  }
+
+  //*******************************************************************************************
+  // set m_current to correct value at specified step and return a reference to it
+  template<typename ConfigType>
+  const typename ConfigEnumRandom<ConfigType>::value_type &ConfigEnumRandom<ConfigType>::goto_step(step_type _step) {
+    std::cerr << "CRITICAL ERROR: Class ConfigEnumRandom does not implement a goto_step() method. \n"
+              << "                You may be using a ConfigEnumIterator in an unsafe way!\n"
+              << "                Exiting...\n";
+    assert(0);
+    exit(1);
+    return current();
+  };
+
+  //*******************************************************************************************
+  template<typename ConfigType>
+  void ConfigEnumRandom<ConfigType>::_draw() {
+    const Array<Array<int> > &sublat_num_each = m_sampling.sublat_num_each;
+
+    if(!sublat_num_each.size()) {
+      m_occ.resize(m_max_occ.size());
+      for(Index l = 0; l < m_occ.size(); l++)
+        m_occ[l] = m_mtrand.randInt(m_max_occ[l]);
+      return;
+    }
+
+    // fill each sublattice, then shuffle it (Fisher-Yates)
+    Index V = m_scel->volume();
+    m_occ.clear();
+    for(Index b = 0; b < sublat_num_each.size(); b++) {
+      for(Index occ = 0; occ < sublat_num_each[b].size(); occ++)
+        m_occ.append(Array<int>(sublat_num_each[b][occ], occ));
+      for(Index i = V - 1; i > 0; i--)
+        std::swap(m_occ[b * V + i], m_occ[b * V + m_mtrand.randInt(i)]);
+    }
+  }
+
+  //*******************************************************************************************
+  /// Uses the Clexulator point correlations, so that the cost does not grow with the supercell size
+  template<typename ConfigType>
+  double ConfigEnumRandom<ConfigType>::_delta_energy(Index l, int occ_i, int occ_f) {
+    Clexulator &clexulator = m_sampling.clexulator;
+    clexulator.set_nlist(m_scel->get_nlist(l).begin());
+    clexulator.calc_delta_point_corr(m_scel->get_b(l), occ_i, occ_f, m_delta_corr.data());
+
+    const ECIContainer &eci = m_sampling.eci;
+    double dE = 0.0;
+    for(Index k = 0; k < eci.eci_list().size(); k++)
+      dE += eci.eci_list()[k] * m_delta_corr[eci.eci_index_list()[k]];
+    return dE;
+  }
+
+  //*******************************************************************************************
+  template<typename ConfigType>
+  void ConfigEnumRandom<ConfigType>::_sweep() {
+    Index N = m_occ.size();
+    Index V = m_scel->volume();
+    double beta = 1.0 / m_sampling.kT;
+
+    for(Index attempt = 0; attempt < N; attempt++) {
+      Index l = m_mtrand.randInt(N - 1);
+      int occ_i = m_occ[l];
+
+      // change the occupant of site 'l'
+      if(!m_sampling.sublat_num_each.size()) {
+        if(m_max_occ[l] == 0)
+          continue;
+        int occ_f = m_mtrand.randInt(m_max_occ[l] - 1);
+        if(occ_f >= occ_i)
+          occ_f++;
+        double dE = _delta_energy(l, occ_i, occ_f);
+        if(dE <= 0.0 || m_mtrand.randExc() < std::exp(-beta * dE))
+          m_occ[l] = occ_f;
+        continue;
+      }
+
+      // swap the occupants of site 'l' and another site of the same sublattice
+      Index l2 = (l / V) * V + m_mtrand.randInt(V - 1);
+      int occ_f = m_occ[l2];
+      if(occ_f == occ_i)
+        continue;
+      double dE = _delta_energy(l, occ_i, occ_f);
+      m_occ[l] = occ_f;
+      dE += _delta_energy(l2, occ_f, occ_i);
+      if(dE <= 0.0 || m_mtrand.randExc() < std::exp(-beta * dE))
+        m_occ[l2] = occ_i;
+      else
+        m_occ[l] = occ_i;
+    }
+  }
+}
@@ -1,6 +1,8 @@
 #ifndef CONFIGIO_HH
 #define CONFIGIO_HH
 
+#include <map>
+#include <memory>
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/casm_io/DataFormatterTools.hh"
 #include "casm/clex/Clexulator.hh"
@@ -143,9 +145,22 @@ namespace CASM {
         return true;
       }
 
+      /// Evaluates the correlations of all 'config' at once, in parallel, so that they are looked up,
+      /// rather than evaluated, when each of 'config' is formatted
+      void precompute(const Array<const Configuration *> &config);
+
     private:
 
+      /// Evaluates correlations into m_corr, reusing this formatter's scratch space
+      const Correlation &_correlations(const Configuration &_config) const;
+
       mutable Clexulator m_clexulator;
+      mutable Correlation m_corr;
+      mutable std::vector<double> m_tcorr;
+
+      /// Correlations found by precompute(), column m_bulk_index[&config], shared by copies of this formatter
+      std::shared_ptr<const Eigen::MatrixXd> m_bulk_corr;
+      std::shared_ptr<const std::map<const Configuration *, Index> > m_bulk_index;
 
     };
 
@@ -172,9 +187,15 @@ namespace CASM {
 
       bool parse_args(const std::string &args);
     private:
+
+      /// Evaluates correlations into m_corr, reusing this formatter's scratch space
+      const Correlation &_correlations(const Configuration &_config) const;
+
       mutable std::string m_clex_name;
       mutable Clexulator m_clexulator;
       mutable ECIContainer m_eci;
+      mutable Correlation m_corr;
+      mutable std::vector<double> m_tcorr;
 
     };
 
@@ -202,6 +223,14 @@ namespace CASM {
       return ConfigIO_impl::CorrConfigFormatter(clex);
     }
 
+    /// Correlations of all 'config' are evaluated at once, in parallel, before formatting
+    inline
+    ConfigIO_impl::CorrConfigFormatter corr(const Clexulator &clex, const Array<const Configuration *> &config) {
+      ConfigIO_impl::CorrConfigFormatter tfmt(clex);
+      tfmt.precompute(config);
+      return tfmt;
+    }
+
     template< typename ValueType >
     ConstantValueFormatter<ValueType, Configuration> constant_value(const std::string &header, ValueType value) {
       return ConstantValueFormatter<ValueType, Configuration>(header, value);
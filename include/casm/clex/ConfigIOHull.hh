@@ -1,6 +1,7 @@
 #ifndef CONFIGIOHULL_HH
 #define CONFIGIOHULL_HH
 
+#include <memory>
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/clex/Clexulator.hh"
 #include "casm/clex/ECIContainer.hh"
@@ -19,10 +20,17 @@ namespace CASM {
         BaseDatumFormatter<Configuration>(_name, _desc), m_dependent_prop(_dependent_prop) {}
 
       /// Initialize the convex hull and determine on-hull configurations
+      ///  - The hull is constructed once per run for each set of arguments, and shared by all
+      ///    hull formatters that use them, such as 'on_hull' and 'hull_dist'
       void init(const Configuration &_tmplt) const override;
 
       std::string short_header(const Configuration &_config) const override;
 
+      /// The hull is only read during evaluation, so this depends on the formatter for the hull axes
+      bool parallel_safe() const override {
+        return _format().parallel_safe();
+      }
+
       //void inject(const Configuration &_config, DataStream &_stream, Index) const override;
 
       //void print(const Configuration &_config, std::ostream &_stream, Index) const override;
@@ -31,32 +39,53 @@ namespace CASM {
 
       bool parse_args(const std::string &args);
     protected:
-      const BP::Geo &_hull() const {
-        return m_hull;
+      const LowerHull &_hull() const {
+        return m_hull_data->hull;
       }
       const DataFormatter<Configuration> &_format() const {
         return m_format;
       }
       const std::map<std::string, bool> &_on_hull() const {
-        return m_on_hull;
+        return m_hull_data->on_hull;
       }
       const std::vector<std::string> &_independent_props() const {
         return m_independent_props;
       }
       const Eigen::MatrixXd &_projection() const {
-        return m_projection;
+        return m_hull_data->projection;
       }
+      /// Distance from the hull of a row of data, as formatted by _format()
+      double _hull_dist(const Eigen::MatrixXd &data) const;
+
+      /// Distance from the hull of '_config'; returns false if data is missing
+      bool _hull_dist(const Configuration &_config, double &result) const;
       //const std::string &_dependent_prop const{ return m_dependent_prop;}
       //void _parse_args(const std::string &args, const std::string &_dep_prop);
     private:
+
+      /// Hull data that is shared, via ConfigIOParser::cache(), by all hull formatters with
+      /// the same selection, independent properties and dependent property
+      struct HullData {
+        LowerHull hull;
+
+        // Matrix that describes subspace spanned by data
+        Eigen::MatrixXd projection;
+
+        // names of on-hull configurations, all the bools are true--just used for fast access
+        std::map<std::string, bool> on_hull;
+
+        // distance from the hull of each configuration used to construct it
+        std::map<std::string, double> hull_dist;
+      };
+
+      /// Construct the hull from the configurations in the selection
+      std::shared_ptr<HullData> _make_hull_data(const Configuration &_tmplt) const;
+
       // specifies the dependent property to use (e.g., formation_energy or clex(formation_energy) )
       const std::string m_dependent_prop;
-      mutable BP::Geo m_hull;
 
-      // Matrix that describes subspace spanned by data
-      mutable Eigen::MatrixXd m_projection;
-      // names of on-hull configurations, all the bools are true--just used for fast access
-      mutable std::map<std::string, bool> m_on_hull;
+      mutable std::shared_ptr<const HullData> m_hull_data;
+
       // used to extract data from configurations for determining hull distance
       mutable DataFormatter<Configuration> m_format;
 
@@ -91,7 +120,7 @@ namespace CASM {
 
     protected:
       //inherits:
-      // const BP::Geo& _hull() const{ return m_hull;}
+      // const LowerHull& _hull() const{ return m_hull;}
       // const std::map<std::string, bool> &_on_hull() const{ return m_on_hull;}
       // const std::vector<std::string> &_independent_props const{ return m_independent_props;}
     };
@@ -117,7 +146,7 @@ namespace CASM {
 
     protected:
       //inherits:
-      // const BP::Geo& _hull() const{ return m_hull;}
+      // const LowerHull& _hull() const{ return m_hull;}
       // const std::map<std::string, bool> &_on_hull() const{ return m_on_hull;}
       // const std::vector<std::string> &_independent_props const{ return m_independent_props;}
     };
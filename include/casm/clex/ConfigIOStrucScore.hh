@@ -1,6 +1,8 @@
 #ifndef CONFIGIOSTRUCSCORE_HH
 #define CONFIGIOSTRUCSCORE_HH
 
+#include <map>
+#include <memory>
 #include "casm/casm_io/DataFormatter.hh"
 #include "casm/clex/PrimClex.hh"
 
@@ -17,15 +19,24 @@ namespace CASM {
     public:
       StrucScoreConfigFormatter() :
         BaseDatumFormatter<Configuration>("struc_score", "Evaluates the mapping of a configuration onto an arbitrary primitive structure, specified by it's path. Allowed options are 'basis_score', which is the mean-square displacement and 'lattice_score' which is a lattice deformation metric having units Angstr.^2. Ex: struc_score(path/to/PRIM, basis_score)"),
-        m_lattice_weight(0.5),
-        m_altprimclex(Structure()) {};
+        m_lattice_weight(0.5) {};
 
       BaseDatumFormatter<Configuration> *clone()const {
         return new StrucScoreConfigFormatter(*this);
       }
 
+      /// Get the PrimClex and mapping scores shared with other struc_score formatters
+      ///  - The PrimClex for the structure at m_prim_path is constructed once per run, and
+      ///    configurations are mapped once per run for each lattice weight
+      void init(const Configuration &_tmplt) const override;
+
       bool validate(const Configuration &_config) const override;
 
+      /// Mapping may add supercells to m_altprimclex, and adds to m_scores
+      bool parallel_safe() const override {
+        return false;
+      }
+
       std::string short_header(const Configuration &_config) const override;
 
       std::string long_header(const Configuration &_config) const override;
@@ -38,12 +49,19 @@ namespace CASM {
 
       bool parse_args(const std::string &args);
     protected:
+      /// {basis_score, lattice_score} of each mapped configuration, by name
+      typedef std::map<std::string, std::vector<double> > ScoreMap;
+
       double m_lattice_weight;
-      mutable PrimClex m_altprimclex;
+      mutable std::shared_ptr<PrimClex> m_altprimclex;
+      mutable std::shared_ptr<ScoreMap> m_scores;
       fs::path m_prim_path;
       std::vector<std::string> m_prop_names;
 
       std::vector<double> _evaluate(const Configuration &_config) const;
+
+      /// Map '_config' onto m_altprimclex, unless it has already been mapped
+      const std::vector<double> &_scores(const Configuration &_config) const;
     };
 
   }
@@ -2,7 +2,13 @@
 #define ConfigSelection_HH
 
 #include <limits>
+#include <map>
+#include <memory>
+#include <regex>
+#include <boost/dynamic_bitset.hpp>
 #include "casm/clex/Configuration.hh"
+#include "casm/clex/Clexulator.hh"
+#include "casm/clex/ECIContainer.hh"
 
 namespace CASM {
 
@@ -15,6 +21,9 @@ namespace CASM {
   typedef ConfigSelection<true> ConstConfigSelection;
 
 
+  /// \brief Iterates over the configurations in a ConfigSelection, in order of ordinal
+  ///
+  /// - If 'selected_only', only the selected configurations are visited
   template <bool IsConst, bool IsConstIterator>
   class ConfigSelectionIterator : public std::iterator <std::bidirectional_iterator_tag,
     typename std::conditional<IsConstIterator, const Configuration, CASM_TMP::ConstSwitch<IsConst, Configuration> >::type > {
@@ -26,8 +35,8 @@ namespace CASM {
   public:
 
     typedef typename std::conditional<IsConstIterator,
-            std::map<std::string, bool>::const_iterator,
-            std::map<std::string, bool>::iterator>::type MapIterator;
+            const ConfigSelection<IsConst>,
+            ConfigSelection<IsConst> >::type SelectionType;
     typedef CASM_TMP::ConstSwitch<IsConst, PrimClex> PrimClexType;
     typedef typename std_iterator_type::reference reference;
     typedef typename std_iterator_type::pointer pointer;
@@ -35,10 +44,8 @@ namespace CASM {
 
     ConfigSelectionIterator();
 
-    ConfigSelectionIterator(const MapIterator &it,
-                            const MapIterator &begin,
-                            const MapIterator &end,
-                            PrimClexType *prim,
+    ConfigSelectionIterator(SelectionType *selection,
+                            Index ordinal,
                             bool _selected_only = false);
 
     template<bool ArgIsConst, bool ArgIsConstIterator>
@@ -48,7 +55,12 @@ namespace CASM {
 
     void set_selected(bool is_selected);
 
-    const std::string &name() const;
+    std::string name() const;
+
+    /// \brief Ordinal of the current configuration, see ConfigSelection
+    Index ordinal() const {
+      return m_ord;
+    }
 
     bool operator==(const ConfigSelectionIterator &_it) const;
 
@@ -67,16 +79,23 @@ namespace CASM {
     ConfigSelectionIterator operator--(int);
 
   private:
-    friend class ConfigSelectionIterator < IsConst, !IsConstIterator >;
+    template<bool, bool> friend class ConfigSelectionIterator;
     friend class ConfigSelection<IsConst>;
 
-    PrimClexType *m_primclex;
-    MapIterator m_it;
-    MapIterator m_begin;
-    MapIterator m_end;
+    SelectionType *m_selection;
+    Index m_ord;
     bool m_selected_only;
   };
 
+  /// \brief A set of configurations, and the 'selected' state of each
+  ///
+  /// - Configurations are identified by an ordinal: the index of the configuration in its supercell
+  ///   plus the number of configurations in all preceding supercells, as of construction of the
+  ///   selection. Ordinals are invalidated if configurations are added to the PrimClex.
+  /// - The configurations in the selection, and the selected configurations, are stored as bitsets,
+  ///   so set operations and size() cost O(N/64) for N configurations in the PrimClex
+  /// - Iteration is in order of ordinal, which is the PrimClex::config_begin() order
+  /// - Configuration names are only used for input and output. Files are written in order of name.
   template <bool IsConst = false>
   class ConfigSelection {
   public:
@@ -87,7 +106,7 @@ namespace CASM {
 
 
     /// \brief Default constructor
-    ConfigSelection() {};
+    ConfigSelection() : m_primclex(nullptr) {};
 
     /// \brief Construct a configuration selection from all configurations
     explicit ConfigSelection(PrimClexType &_primclex);
@@ -102,16 +121,22 @@ namespace CASM {
     ///
     ConfigSelection(PrimClexType &_primclex, const fs::path &selection_path);
 
+    /// \brief Number of configurations in the selection
     Index size() const {
-      return m_config.size();
+      return m_listed.count();
+    }
+
+    /// \brief Number of selected configurations
+    Index selected_size() const {
+      return m_selected.count();
     }
 
     iterator find(const std::string &configname) {
-      return iterator(m_config.find(configname), m_config.begin(), m_config.end(), m_primclex);
+      return iterator(this, _find(configname));
     }
 
     const_iterator find(const std::string &configname) const {
-      return const_iterator(m_config.find(configname), m_config.begin(), m_config.end(), m_primclex);
+      return const_iterator(this, _find(configname));
     }
 
     value_type &operator[](const std::string &configname) const;
@@ -123,59 +148,93 @@ namespace CASM {
     jsonParser &to_json(jsonParser &_json, bool only_selected = false) const;
 
     bool selected(const std::string &configname) const {
-      return m_config.find(configname)->second;
+      Index ord = _find(configname);
+      return ord != _end() && m_selected[ord];
     }
 
+    /// \brief Set the selected state of 'configname', adding it to the selection if necessary
     void set_selected(const std::string &configname, bool is_selected) {
-      m_config[configname] = is_selected;
+      Index ord = _ordinal(configname);
+      m_listed[ord] = true;
+      m_selected[ord] = is_selected;
     }
 
     iterator config_begin() {
-      return iterator(m_config.begin(), m_config.begin(), m_config.end(), m_primclex);
+      return iterator(this, m_listed.find_first());
     }
 
     iterator config_end() {
-      return iterator(m_config.end(), m_config.begin(), m_config.end(), m_primclex);
+      return iterator(this, _end());
     }
 
     const_iterator config_cbegin() const {
-      return const_iterator(m_config.cbegin(), m_config.cbegin(), m_config.cend(), m_primclex);
+      return const_iterator(this, m_listed.find_first());
     }
 
     const_iterator config_cend() const {
-      return const_iterator(m_config.cend(), m_config.cbegin(), m_config.cend(), m_primclex);
+      return const_iterator(this, _end());
     }
 
     iterator selected_config_begin() {
-      return iterator(m_config.begin(), m_config.begin(), m_config.end(), m_primclex, true);
+      return iterator(this, m_selected.find_first(), true);
     }
 
     iterator selected_config_end() {
-      return iterator(m_config.end(), m_config.begin(), m_config.end(), m_primclex, true);
+      return iterator(this, _end(), true);
     }
 
     const_iterator selected_config_cbegin() const {
-      return const_iterator(m_config.cbegin(), m_config.cbegin(), m_config.cend(), m_primclex, true);
+      return const_iterator(this, m_selected.find_first(), true);
     }
 
     const_iterator selected_config_cend() const {
-      return const_iterator(m_config.cend(), m_config.cbegin(), m_config.cend(), m_primclex, true);
+      return const_iterator(this, _end(), true);
     }
 
     std::pair<iterator, bool> insert(const std::pair<std::string, bool> &value) {
-      auto res = m_config.insert(value);
-      return std::make_pair(iterator(res.first,  m_config.begin(), m_config.end(), m_primclex), res.second);
+      Index ord = _ordinal(value.first);
+      if(m_listed[ord])
+        return std::make_pair(iterator(this, ord), false);
+      m_listed[ord] = true;
+      m_selected[ord] = value.second;
+      return std::make_pair(iterator(this, ord), true);
     }
 
     const_iterator erase(const const_iterator &it) {
-      bool selected_only = it.m_selected_only;
-      return const_iterator(m_config.erase(it.m_it), m_config.cbegin(), m_config.cend(), m_primclex, selected_only);
+      const_iterator next(it);
+      ++next;
+      m_listed[it.m_ord] = false;
+      m_selected[it.m_ord] = false;
+      return next;
     }
 
     int erase(const std::string &configname) {
-      return m_config.erase(configname);
+      Index ord = _find(configname);
+      if(ord == _end())
+        return 0;
+      m_listed[ord] = false;
+      m_selected[ord] = false;
+      return 1;
     }
 
+    /// \brief Select the configurations that are selected in both this and 'RHS'
+    ///
+    /// - Configurations in 'RHS' that are not in this are added, unselected
+    ConfigSelection &operator&=(const ConfigSelection &RHS);
+
+    /// \brief Select the configurations that are selected in this or 'RHS'
+    ///
+    /// - Configurations in 'RHS' that are not in this are added
+    ConfigSelection &operator|=(const ConfigSelection &RHS);
+
+    /// \brief Select the configurations that are selected in exactly one of this and 'RHS'
+    ///
+    /// - Configurations in 'RHS' that are not in this are added
+    ConfigSelection &operator^=(const ConfigSelection &RHS);
+
+    /// \brief Invert the selected state of all configurations in the selection
+    ConfigSelection &flip();
+
     const std::vector<std::string> &col_headers() const {
       return m_col_headers;
     }
@@ -183,94 +242,99 @@ namespace CASM {
     void print(std::ostream &_out, bool only_selected = false) const;
 
   private:
+    friend class ConfigSelectionIterator<IsConst, false>;
+    friend class ConfigSelectionIterator<IsConst, true>;
+
     PrimClexType *m_primclex;
 
-    std::map<std::string, bool> m_config;
+    /// m_scel_offset[i] is the ordinal of the first configuration in supercell i,
+    /// and m_scel_offset.back() is the total number of configurations
+    std::vector<Index> m_scel_offset;
+
+    /// supercell name -> supercell index, for reading configuration names
+    std::map<std::string, Index> m_scel_index;
+
+    /// m_listed[ord] is true if configuration 'ord' is in the selection
+    boost::dynamic_bitset<> m_listed;
+
+    /// m_selected[ord] is true if configuration 'ord' is selected (a subset of m_listed)
+    boost::dynamic_bitset<> m_selected;
+
     std::vector<std::string> m_col_headers;
 
+    /// \brief Set m_primclex and the ordinals, and clear the selection
+    void _init(PrimClexType &_primclex);
+
+    /// \brief One past the last ordinal
+    Index _end() const {
+      return m_listed.size();
+    }
+
+    /// \brief The configuration with ordinal 'ord'
+    value_type &_config(Index ord) const;
+
+    /// \brief Ordinal of the configuration named 'configname', or _end() if it does not exist
+    Index _lookup(const std::string &configname) const;
+
+    /// \brief Ordinal of the configuration named 'configname', exits if it does not exist
+    Index _ordinal(const std::string &configname) const;
+
+    /// \brief Ordinal of 'configname' if it is in the selection, else _end()
+    Index _find(const std::string &configname) const {
+      Index ord = _lookup(configname);
+      return (ord != _end() && m_listed[ord]) ? ord : _end();
+    }
+
+    /// \brief Names and ordinals of the configurations to be written, sorted by name
+    std::vector<std::pair<std::string, Index> > _sorted_by_name(bool only_selected) const;
+
+    /// \brief Throws if 'RHS' does not have the same ordinals as this
+    void _check_compatible(const ConfigSelection &RHS) const;
+
   };
 
   template<bool IsConst, bool IsConstIterator>
-  ConfigSelectionIterator<IsConst, IsConstIterator>::ConfigSelectionIterator() { }
+  ConfigSelectionIterator<IsConst, IsConstIterator>::ConfigSelectionIterator() :
+    m_selection(nullptr), m_ord(0), m_selected_only(false) { }
 
   template<bool IsConst, bool IsConstIterator>
   ConfigSelectionIterator<IsConst, IsConstIterator>::ConfigSelectionIterator(
-    const typename ConfigSelectionIterator<IsConst, IsConstIterator>::MapIterator &it,
-    const typename ConfigSelectionIterator<IsConst, IsConstIterator>::MapIterator &begin,
-    const typename ConfigSelectionIterator<IsConst, IsConstIterator>::MapIterator &end,
-    typename ConfigSelectionIterator<IsConst, IsConstIterator>::PrimClexType *prim,
+    typename ConfigSelectionIterator<IsConst, IsConstIterator>::SelectionType *selection,
+    Index ordinal,
     bool _selected_only) :
-    m_it(it), m_begin(begin), m_end(end), m_primclex(prim), m_selected_only(_selected_only) {
+    m_selection(selection), m_ord(ordinal), m_selected_only(_selected_only) {
 
-    while(m_selected_only && m_begin != m_end && !m_begin->second)
-      ++m_begin;
-
-    while(m_selected_only && m_it != m_end && !m_it->second)
-      ++m_it;
+    // boost::dynamic_bitset<>::npos, from find_first() on an empty selection, converts to -1
+    if(m_ord < 0 || m_ord > m_selection->_end())
+      m_ord = m_selection->_end();
   }
 
-  /*
-  template<>
-  ConfigSelectionIterator<true, true>::ConfigSelectionIterator(const ConfigSelectionIterator<true, true> &iter) :
-    m_it(iter.m_it),
-    m_begin(iter.m_begin),
-    m_end(iter.m_end),
-    m_primclex(iter.m_primclex),
-    m_selected_only(iter.m_selected_only) {}
-
-  template<>
-  ConfigSelectionIterator<true, true>::ConfigSelectionIterator(const ConfigSelectionIterator<true, false> &iter) :
-    m_it(iter.m_it),
-    m_begin(iter.m_begin),
-    m_end(iter.m_end),
-    m_primclex(iter.m_primclex),
-    m_selected_only(iter.m_selected_only) {}
-
-  template<>
-  ConfigSelectionIterator<false, false>::ConfigSelectionIterator(const ConfigSelectionIterator<false, false> &iter) :
-    m_it(iter.m_it),
-    m_begin(iter.m_begin),
-    m_end(iter.m_end),
-    m_primclex(iter.m_primclex),
-    m_selected_only(iter.m_selected_only) {}
-
-  template<>
-  ConfigSelectionIterator<false, true>::ConfigSelectionIterator(const ConfigSelectionIterator<false, false> &iter) :
-    m_it(iter.m_it),
-    m_begin(iter.m_begin),
-    m_end(iter.m_end),
-    m_primclex(iter.m_primclex),
-    m_selected_only(iter.m_selected_only) {}
-  */
-
   template<bool IsConst, bool IsConstIterator>
   template<bool ArgIsConst, bool ArgIsConstIterator>
   ConfigSelectionIterator<IsConst, IsConstIterator>::ConfigSelectionIterator(const ConfigSelectionIterator<ArgIsConst, ArgIsConstIterator> &iter) :
-    m_it(iter.m_it),
-    m_begin(iter.m_begin),
-    m_end(iter.m_end),
-    m_primclex(iter.m_primclex),
+    m_selection(iter.m_selection),
+    m_ord(iter.m_ord),
     m_selected_only(iter.m_selected_only) {}
 
 
   template<bool IsConst, bool IsConstIterator>
   bool ConfigSelectionIterator<IsConst, IsConstIterator>::selected() const {
-    return m_it->second;
+    return m_selection->m_selected[m_ord];
   }
 
   template<bool IsConst, bool IsConstIterator>
   void ConfigSelectionIterator<IsConst, IsConstIterator>::set_selected(bool is_selected) {
-    m_it->second = is_selected;
+    m_selection->m_selected[m_ord] = is_selected;
   }
 
   template<bool IsConst, bool IsConstIterator>
-  const std::string &ConfigSelectionIterator<IsConst, IsConstIterator>::name() const {
-    return m_it->first;
+  std::string ConfigSelectionIterator<IsConst, IsConstIterator>::name() const {
+    return m_selection->_config(m_ord).name();
   }
 
   template<bool IsConst, bool IsConstIterator>
   bool ConfigSelectionIterator<IsConst, IsConstIterator>::operator==(const ConfigSelectionIterator &_it) const {
-    return (m_it == _it.m_it);
+    return (m_ord == _it.m_ord);
   }
 
   template<bool IsConst, bool IsConstIterator>
@@ -280,19 +344,19 @@ namespace CASM {
 
   template<bool IsConst, bool IsConstIterator>
   typename ConfigSelectionIterator<IsConst, IsConstIterator>::reference ConfigSelectionIterator<IsConst, IsConstIterator>::operator*() const {
-    return m_primclex->configuration(m_it->first);
+    return m_selection->_config(m_ord);
   }
 
   template<bool IsConst, bool IsConstIterator>
   typename ConfigSelectionIterator<IsConst, IsConstIterator>::pointer ConfigSelectionIterator<IsConst, IsConstIterator>::operator->() const {
-    return &(m_primclex->configuration(m_it->first));
+    return &(m_selection->_config(m_ord));
   }
 
   template<bool IsConst, bool IsConstIterator>
   ConfigSelectionIterator<IsConst, IsConstIterator> &ConfigSelectionIterator<IsConst, IsConstIterator>::operator++() {
-    ++m_it;
-    while(m_selected_only && m_it != m_end && !selected())
-      ++m_it;
+    const boost::dynamic_bitset<> &bits = m_selected_only ? m_selection->m_selected : m_selection->m_listed;
+    boost::dynamic_bitset<>::size_type next = bits.find_next(m_ord);
+    m_ord = (next == bits.npos) ? m_selection->_end() : next;
     return (*this);
   }
 
@@ -305,9 +369,10 @@ namespace CASM {
 
   template<bool IsConst, bool IsConstIterator>
   ConfigSelectionIterator<IsConst, IsConstIterator> &ConfigSelectionIterator<IsConst, IsConstIterator>::operator--() {
-    --m_it;
-    while(m_selected_only && m_it != m_begin && !selected())
-      --m_it;
+    const boost::dynamic_bitset<> &bits = m_selected_only ? m_selection->m_selected : m_selection->m_listed;
+    --m_ord;
+    while(m_ord > 0 && !bits[m_ord])
+      --m_ord;
     return (*this);
   }
 
@@ -325,20 +390,148 @@ namespace CASM {
     return _stream;
   }
 
-  bool get_selection(const Array<std::string> &criteria, const Configuration &config, bool is_selected);
+  /// \brief 'casm select --set' criteria, compiled for evaluation on many configurations
+  ///
+  /// The criteria list (see get_selection) is parsed once:
+  /// - operators and variables are resolved to typed nodes
+  /// - literal values are converted to numbers once
+  /// - 'comp(x)', 'site_frac(x)', and 'atom_frac(x)' are resolved to composition and molecule indices
+  /// - for 'clex(x)', the global Clexulator and the ECI are loaded
+  /// - regular expressions given as literals are constructed
+  ///
+  /// Evaluation gives the same result as the string-based evaluation it replaces: numeric values
+  /// are rounded to 6 decimal places, as they were when converted with std::to_string, and
+  /// 'eq', 'ne', 're', and 'rs' compare string representations.
+  ///
+  /// Each SelectionCriteria has its own copy of the Clexulator, so separate copies may be
+  /// evaluated concurrently, but a single SelectionCriteria may not.
+  class SelectionCriteria {
+  public:
 
-  namespace ConfigSelection_impl {
+    /// \brief Compile 'criteria'
+    SelectionCriteria(const Array<std::string> &criteria, const PrimClex &primclex);
 
-    bool is_operator(const std::string &q);
+    /// \brief Returns the selection state of 'config', given its current state 'is_selected'
+    bool operator()(const Configuration &config, bool is_selected) const;
 
-    std::string operate(const std::string &q, const std::string &A);
+    /// \brief Evaluate the criteria without reporting errors
+    ///
+    /// - Returns false if the criteria do not evaluate to "1" or "0" for 'config'
+    bool evaluate(const Configuration &config, bool is_selected, bool &result) const;
 
-    std::string operate(const std::string &q, const std::string &A, const std::string &B);
+    const Array<std::string> &criteria() const {
+      return m_criteria;
+    }
 
-    bool is_unary(const std::string &q);
+  private:
 
-    std::string convert_variable(const std::string &q, const Configuration &config);
-  }
+    /// Typed value on the evaluation stack
+    struct Value {
+
+      enum Type {BOOL, INT, DOUBLE, STRING};
+
+      Value() : type(STRING), num(0.0), has_num(false) {}
+
+      Type type;
+
+      /// value for BOOL, INT, DOUBLE, and for STRING if 'has_num'
+      double num;
+
+      /// value for STRING
+      std::string str;
+
+      /// for STRING, true if 'str' has been converted to 'num'
+      bool has_num;
+
+    };
+
+    enum class NodeType {
+      LITERAL, SCELNAME, CONFIGNAME, SCEL_SIZE, IS_GROUNDSTATE, IS_CALCULATED, DIST_FROM_HULL,
+      FORMATION_ENERGY, CLEX, COMP, SITE_FRAC, ATOM_FRAC,
+      NOT, AND, OR, XOR, RE, RS, EQ, NE, LT, LE, GT, GE, ADD, SUB, DIV, MULT, POW
+    };
+
+    struct Node {
+
+      Node(NodeType _type) : type(_type), index(0) {}
+
+      NodeType type;
+
+      /// criteria string
+      std::string name;
+
+      /// value of a LITERAL
+      Value value;
+
+      /// composition or molecule index for COMP, SITE_FRAC, ATOM_FRAC; index into m_eci for CLEX
+      Index index;
+
+      /// for RE and RS, if the pattern is a literal
+      std::shared_ptr<std::regex> regex;
+
+    };
+
+    Array<std::string> m_criteria;
+
+    const PrimClex *m_primclex;
+
+    /// true if criteria[0] == "on"
+    bool m_mk;
+
+    /// criteria[1:] in reverse polish notation
+    std::vector<Node> m_program;
+
+    /// largest stack size during evaluation
+    Index m_max_depth;
+
+    Array<ECIContainer> m_eci;
+
+    mutable Clexulator m_clexulator;
+
+    Node _compile_variable(const std::string &q);
+
+    /// Evaluate m_program for 'config', and return the last value on the stack
+    Value _evaluate(const Configuration &config) const;
+
+    void _binary(const Node &node, Value &A, const Value &B) const;
+
+    static Value _bool(bool val);
+
+    static Value _int(long val);
+
+    static Value _double(double val);
+
+    static Value _string(const std::string &val);
+
+    /// true if the string representation of A is "0"
+    static bool _is_zero(const Value &A);
+
+    /// true if the string representation of A is "1"
+    static bool _is_one(const Value &A);
+
+    /// string representation of A
+    static std::string _str(const Value &A);
+
+    /// numeric value of A, throws std::invalid_argument if A is a string that is not a number
+    static double _num(const Value &A);
+
+  };
+
+  /// \brief Returns the selection state of 'config', given its current state 'is_selected'
+  bool get_selection(const Array<std::string> &criteria, const Configuration &config, bool is_selected);
+
+  /// \brief Evaluate 'criteria' for many configurations, in parallel chunks
+  ///
+  /// - On input, is_selected[i] is the current selection state of *config[i], and on output it is the
+  ///   selection state determined by 'criteria'
+  void get_selection(const SelectionCriteria &criteria, const Array<const Configuration *> &config, Array<bool> &is_selected);
+
+  /// \brief Set the selection state of all configurations in 'primclex' using 'criteria'
+  void set_selection(const SelectionCriteria &criteria, PrimClex &primclex);
+
+  /// \brief Set the selection state of all configurations in 'selection' using 'criteria'
+  template<bool IsConst>
+  void set_selection(const SelectionCriteria &criteria, ConfigSelection<IsConst> &selection);
 
 }
 #include "casm/clex/ConfigSelection_impl.hh"
@@ -1,12 +1,14 @@
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include "casm/clex/ConfigIO.hh"
 namespace CASM {
 
 
 
   template <bool IsConst>
-  ConfigSelection<IsConst>::ConfigSelection(typename ConfigSelection<IsConst>::PrimClexType &_primclex, const fs::path &selection_path)
-    : m_primclex(&_primclex) {
+  ConfigSelection<IsConst>::ConfigSelection(typename ConfigSelection<IsConst>::PrimClexType &_primclex, const fs::path &selection_path) {
+    _init(_primclex);
     if(selection_path.extension() == ".json" || selection_path.extension() == ".JSON")
       from_json(jsonParser(selection_path));
     else {
@@ -34,7 +36,7 @@ namespace CASM {
       //_input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
     while(_input >> tname >> tselect) {
-      m_config[tname] = tselect;
+      set_selected(tname, tselect);
       _input.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
     }
   }
@@ -49,12 +51,12 @@ namespace CASM {
                 << "                Exiting..." << std::endl;
       exit(1);
     }
-    bool tselect;
     std::map<std::string, bool> prop_map;
     std::string tname;
     bool tselected;
     bool contains_name;
-    m_config.clear();
+    m_listed.reset();
+    m_selected.reset();
     for(Index i = 0; i < _json.size(); i++) {
       auto it(_json[i].cbegin()), it_end(_json[i].cend());
 
@@ -81,7 +83,7 @@ namespace CASM {
           " This field is required.");
       }
 
-      m_config[tname] = tselected;
+      set_selected(tname, tselected);
 
     }
 
@@ -97,64 +99,198 @@ namespace CASM {
   jsonParser &ConfigSelection<IsConst>::to_json(jsonParser &_json, bool only_selected) const {
     _json.put_array();
 
+    DataFormatterCache::Scope cache_scope(ConfigIOParser::cache());
     DataFormatter<Configuration> tformat(ConfigIOParser::parse(m_col_headers));
 
-    const_iterator it, it_end;
-
-    if(only_selected) {
-      it = selected_config_cbegin();
-      it_end = selected_config_cend();
-    }
-    else {
-      it = config_cbegin();
-      it_end = config_cend();
-    }
+    std::vector<std::pair<std::string, Index> > named = _sorted_by_name(only_selected);
 
-    for(; it != it_end; ++it) {
-      _json.push_back(tformat(*it));
-      _json[_json.size() - 1]["name"] = it.name();
-      _json[_json.size() - 1]["selected"] = it.selected();
+    for(Index i = 0; i < named.size(); i++) {
+      _json.push_back(tformat(_config(named[i].second)));
+      _json[_json.size() - 1]["name"] = named[i].first;
+      _json[_json.size() - 1]["selected"] = bool(m_selected[named[i].second]);
     }
     return _json;
   }
   //******************************************************************************
   template <bool IsConst>
   void ConfigSelection<IsConst>::print(std::ostream &_out, bool only_selected) const {
+    DataFormatterCache::Scope cache_scope(ConfigIOParser::cache());
     DataFormatter<Configuration> tformat(ConfigIOParser::parse(m_col_headers));
     tformat.set_header_prefix("                  name     selected");
     _out << FormatFlag(_out).print_header(false);
 
-    const_iterator it, it_end;
+    std::vector<std::pair<std::string, Index> > named = _sorted_by_name(only_selected);
+
+    if(!named.size())
+      return;
+
+    tformat.print_header(_config(named[0].second), _out);
+    tformat.set_indent(-30);
+    for(Index i = 0; i < named.size(); i++) {
+      _out << "    " << named[i].first << "        " << m_selected[named[i].second] << "  ";
 
-    if(only_selected) {
-      it = selected_config_cbegin();
-      it_end = selected_config_cend();
+      _out << tformat(_config(named[i].second));
     }
-    else {
-      it = config_cbegin();
-      it_end = config_cend();
+  }
+  //******************************************************************************
+
+  template< bool IsConst>
+  typename ConfigSelection<IsConst>::value_type &ConfigSelection<IsConst>::operator[](const std::string &configname) const {
+    return _config(_ordinal(configname));
+  }
+
+  //******************************************************************************
+
+  template<bool IsConst>
+  ConfigSelection<IsConst> &ConfigSelection<IsConst>::operator&=(const ConfigSelection &RHS) {
+    _check_compatible(RHS);
+    m_listed |= RHS.m_listed;
+    m_selected &= RHS.m_selected;
+    return *this;
+  }
+
+  //******************************************************************************
+
+  template<bool IsConst>
+  ConfigSelection<IsConst> &ConfigSelection<IsConst>::operator|=(const ConfigSelection &RHS) {
+    _check_compatible(RHS);
+    m_listed |= RHS.m_listed;
+    m_selected |= RHS.m_selected;
+    return *this;
+  }
+
+  //******************************************************************************
+
+  template<bool IsConst>
+  ConfigSelection<IsConst> &ConfigSelection<IsConst>::operator^=(const ConfigSelection &RHS) {
+    _check_compatible(RHS);
+    m_listed |= RHS.m_listed;
+    m_selected ^= RHS.m_selected;
+    return *this;
+  }
+
+  //******************************************************************************
+
+  template<bool IsConst>
+  ConfigSelection<IsConst> &ConfigSelection<IsConst>::flip() {
+    // m_selected is a subset of m_listed
+    m_selected ^= m_listed;
+    return *this;
+  }
+
+  //******************************************************************************
+
+  template<bool IsConst>
+  void ConfigSelection<IsConst>::_init(typename ConfigSelection<IsConst>::PrimClexType &_primclex) {
+    m_primclex = &_primclex;
+    m_scel_offset.clear();
+    m_scel_index.clear();
+    m_scel_offset.reserve(_primclex.get_supercell_list().size() + 1);
+
+    Index N = 0;
+    for(Index i = 0; i < _primclex.get_supercell_list().size(); i++) {
+      const auto &scel = _primclex.get_supercell(i);
+      m_scel_offset.push_back(N);
+      m_scel_index[scel.get_name()] = i;
+      N += scel.get_config_list().size();
     }
+    m_scel_offset.push_back(N);
 
-    if(it == it_end)
-      return;
+    m_listed.clear();
+    m_listed.resize(N);
+    m_selected.clear();
+    m_selected.resize(N);
+  }
 
-    tformat.print_header(*it, _out);
-    std::ostream::streampos pos;
-    tformat.set_indent(-30);
-    for(; it != it_end; ++it) {
+  //******************************************************************************
+
+  template<bool IsConst>
+  typename ConfigSelection<IsConst>::value_type &ConfigSelection<IsConst>::_config(Index ord) const {
+    Index scel = std::upper_bound(m_scel_offset.begin(), m_scel_offset.end(), ord) - m_scel_offset.begin() - 1;
+    return m_primclex->get_supercell(scel).get_config(ord - m_scel_offset[scel]);
+  }
+
+  //******************************************************************************
 
+  template<bool IsConst>
+  Index ConfigSelection<IsConst>::_lookup(const std::string &configname) const {
+    std::string::size_type pos = configname.find('/');
+    if(pos == std::string::npos)
+      return _end();
 
-      pos = _out.tellp();
-      _out << "    " << it.name() << "        " << it.selected() << "  ";
+    auto it = m_scel_index.find(configname.substr(0, pos));
+    if(it == m_scel_index.end())
+      return _end();
 
-      _out << tformat(*it);
+    Index config_ind;
+    try {
+      config_ind = boost::lexical_cast<Index>(configname.substr(pos + 1));
     }
+    catch(boost::bad_lexical_cast &) {
+      return _end();
+    }
+
+    if(config_ind < 0 || m_scel_offset[it->second] + config_ind >= m_scel_offset[it->second + 1])
+      return _end();
+    return m_scel_offset[it->second] + config_ind;
   }
+
   //******************************************************************************
 
-  template< bool IsConst>
-  typename ConfigSelection<IsConst>::value_type &ConfigSelection<IsConst>::operator[](const std::string &configname) const {
-    return m_primclex->configuration(configname);
+  template<bool IsConst>
+  Index ConfigSelection<IsConst>::_ordinal(const std::string &configname) const {
+    Index ord = _lookup(configname);
+    if(ord == _end()) {
+      std::cerr << "CRITICAL ERROR: In ConfigSelection, cannot locate configuration " << configname << "\n"
+                << "                Exiting...\n";
+      exit(1);
+    }
+    return ord;
+  }
+
+  //******************************************************************************
+
+  template<bool IsConst>
+  std::vector<std::pair<std::string, Index> > ConfigSelection<IsConst>::_sorted_by_name(bool only_selected) const {
+    const boost::dynamic_bitset<> &bits = only_selected ? m_selected : m_listed;
+    std::vector<std::pair<std::string, Index> > named;
+    named.reserve(bits.count());
+    for(auto ord = bits.find_first(); ord != bits.npos; ord = bits.find_next(ord)) {
+      named.push_back(std::make_pair(_config(ord).name(), Index(ord)));
+    }
+    std::sort(named.begin(), named.end());
+    return named;
+  }
+
+  //******************************************************************************
+
+  template<bool IsConst>
+  void ConfigSelection<IsConst>::_check_compatible(const ConfigSelection &RHS) const {
+    if(m_scel_offset != RHS.m_scel_offset) {
+      throw std::runtime_error(
+        "CRITICAL ERROR: In ConfigSelection, cannot combine selections constructed with different configuration lists.");
+    }
+  }
+
+  //******************************************************************************
+
+  template<bool IsConst>
+  void set_selection(const SelectionCriteria &criteria, ConfigSelection<IsConst> &selection) {
+    Array<const Configuration *> config;
+    Array<bool> is_selected;
+    config.reserve(selection.size());
+    is_selected.reserve(selection.size());
+    for(auto it = selection.config_begin(); it != selection.config_end(); ++it) {
+      config.push_back(&(*it));
+      is_selected.push_back(it.selected());
+    }
+
+    get_selection(criteria, config, is_selected);
+
+    Index i = 0;
+    for(auto it = selection.config_begin(); it != selection.config_end(); ++it, ++i) {
+      it.set_selected(is_selected[i]);
+    }
   }
 }
 
@@ -2,6 +2,7 @@
 #define CONFIGURATION_HH
 
 #include <map>
+#include <memory>
 
 #define BOOST_NO_SCOPED_ENUMS
 #define BOOST_NO_CXX11_SCOPED_ENUMS
@@ -21,6 +22,7 @@ namespace CASM {
   class Supercell;
   class UnitCellCoord;
   class Clexulator;
+  class RuntimeLibrary;
 
   class Configuration {
   private:
@@ -94,6 +96,14 @@ namespace CASM {
     DeltaProperties delta;  //calculated-reference
     Properties generated;   //Everything else you came up with through casm
 
+    /// Cached result of num_each_molecule(), empty if not yet counted
+    /// - kept up to date by set_occ
+    mutable Array<int> m_num_each_molecule;
+
+    /// Structure factors, as stored in generated["sublat_struct_fact"] and generated["struct_fact"]
+    Eigen::MatrixXcd m_sublat_struct_fact;
+    Eigen::MatrixXd m_struct_fact;
+
 
     /// Composition -- calculated on-the-fly, see functions below
 
@@ -109,8 +119,25 @@ namespace CASM {
     // correlations can be used for multiple CLEX, if basis functions are the same
     Correlation correlations;
 
+    /// Library of the Clexulator that 'correlations' were set with, see Clexulator::library()
+    /// - set_occ only updates 'correlations' incrementally with the same Clexulator, or a copy
+    std::weak_ptr<const RuntimeLibrary> m_corr_library;
+
     bool m_selected;
 
+    /// Change the occupant of site 'site_l', keeping m_num_each_molecule up to date
+    void _set_occ(Index site_l, int val);
+
+    /// True if 'correlations' were set using 'clexulator', or a copy of it
+    bool _has_correlations(const Clexulator &clexulator) const;
+
+    /// True if changing the occupant of site 'site_l' can be done with calc_delta_point_corr
+    bool _has_local_delta_corr(Index site_l) const;
+
+    /// Change the occupant of site 'site_l', adding the change in correlations to 'correlations'
+    /// - 'delta_corr' is scratch space of size clexulator.corr_size()
+    void _set_occ(Index site_l, int val, Clexulator &clexulator, double *delta_corr);
+
   public:
     typedef ConfigDoF::displacement_matrix_t displacement_matrix_t;
     typedef ConfigDoF::displacement_t displacement_t;
@@ -148,11 +175,26 @@ namespace CASM {
     //
     // ** Note: Properties and correlations are not automatically updated when dof are changed, **
     // **       nor are the written records automatically updated                               **
+    // **       Changing the occupation clears correlations, unless a Clexulator is given to     **
+    // **       update them                                                                      **
 
     void set_occupation(const Array<int> &newoccupation);
 
     void set_occ(Index site_l, int val);
 
+    /// \brief Set the occupant of site 'site_l', and update correlations incrementally using 'clexulator'
+    ///
+    /// - If correlations are not yet set for 'clexulator', or the Supercell is smaller than the
+    ///   'clexulator' neighborhood, they are calculated in full
+    void set_occ(Index site_l, int val, Clexulator &clexulator);
+
+    /// \brief Set the occupants of sites 'site_l', and update correlations incrementally using 'clexulator'
+    ///
+    /// - Sites are changed one at a time, in order, so 'site_l' may contain neighboring sites
+    /// - If correlations are not yet set for 'clexulator', or the Supercell is smaller than the
+    ///   'clexulator' neighborhood, they are calculated in full
+    void set_occ(const Array<Index> &site_l, const Array<int> &val, Clexulator &clexulator);
+
     void set_displacement(const displacement_matrix_t &_disp);
 
     void set_deformation(const Eigen::Matrix3d &_deformation);
@@ -281,7 +323,8 @@ namespace CASM {
     const Properties &generated_properties() const;
 
 
-    //const Correlation &get_correlations() const;
+    /// Correlations, as set by set_correlations or updated by set_occ; empty if not set
+    const Correlation &get_correlations() const;
 
 
     // Returns composition on each sublattice: sublat_comp[ prim basis site / sublattice][ molecule_type]
@@ -304,6 +347,10 @@ namespace CASM {
     /// Returns num_each_molecule[ molecule_type], where 'molecule_type' is ordered as Structure::get_struc_molecule()
     ReturnArray<int> get_num_each_molecule() const;
 
+    /// Same as get_num_each_molecule(), but counted only once and then cached until the occupation changes.
+    ///   Filling the cache is not thread safe, use Supercell::populate_composition before sharing a Configuration between threads
+    const Array<int> &num_each_molecule() const;
+
     /// Returns parametric composition, as calculated using PrimClex::param_comp
     Eigen::VectorXd get_param_composition() const;
 
@@ -321,8 +368,8 @@ namespace CASM {
     void calc_sublat_struct_fact(const Eigen::VectorXd &intensities);
     void calc_struct_fact(const Eigen::VectorXd &intensities);
 
-    Eigen::MatrixXcd sublat_struct_fact();
-    Eigen::MatrixXd struct_fact();
+    const Eigen::MatrixXcd &sublat_struct_fact();
+    const Eigen::MatrixXd &struct_fact();
 
     //********* IO ************
 
@@ -356,6 +403,7 @@ namespace CASM {
   private:
     /// Convenience accessors:
     int &_occ(Index site_l) {
+      m_num_each_molecule.clear();
       return m_configdof.occ(site_l);
     }
 
@@ -397,6 +445,11 @@ namespace CASM {
   /// \brief Returns correlations using 'clexulator'.
   Correlation correlations(const Configuration &config, Clexulator &clexulator);
 
+  /// \brief Returns correlations of all 'config' using 'clexulator', evaluated in parallel
+  ///
+  /// - Result is clexulator.corr_size() x config.size(); column 'i' holds the correlations of config[i]
+  Eigen::MatrixXd correlations(const Array<const Configuration *> &config, const Clexulator &clexulator);
+
 }
 
 #endif
@@ -0,0 +1,131 @@
+#ifndef CASM_GROUNDSTATESEARCH_HH
+#define CASM_GROUNDSTATESEARCH_HH
+
+#include <vector>
+
+#include "casm/container/Array.hh"
+#include "casm/clex/Clexulator.hh"
+#include "casm/clex/ECIContainer.hh"
+#include "casm/hull/LowerHull.hh"
+
+namespace CASM {
+
+  class Supercell;
+
+  /// \brief A configuration that may be a ground state of a cluster expansion
+  struct GroundStateCandidate {
+
+    Supercell *scel;
+
+    Array<int> occupation;
+
+    /// parametric composition
+    Eigen::VectorXd comp;
+
+    /// cluster expansion value, per primitive cell
+    double energy;
+
+  };
+
+  /// \brief The lower hull of a stream of GroundStateCandidate, keeping only the candidates that are its vertices
+  ///
+  /// A point that is not a vertex of the lower hull of a set of points is not a vertex of the lower hull of any
+  /// larger set, so candidates on or above the hull are discarded as they are inserted, and memory grows with the
+  /// size of the hull rather than the number of candidates inserted.
+  ///
+  /// Until the candidates span the composition space, and a hull can be constructed, the lowest energy
+  /// candidate at each composition is kept.
+  class GroundStateHull {
+  public:
+
+    /// Candidates within 'tol' of the hull are not kept
+    explicit GroundStateHull(double tol = 1e-8);
+
+    /// True if a candidate with composition 'comp' and energy 'energy' would be kept by insert()
+    ///  - Use this before constructing a GroundStateCandidate, to avoid copying the occupation
+    bool is_candidate(const Eigen::VectorXd &comp, double energy) const;
+
+    /// Add 'candidate', and discard the candidates that are no longer hull vertices
+    ///  - Returns true if 'candidate' was kept
+    bool insert(const GroundStateCandidate &candidate);
+
+    /// Add all the candidates of 'other', in order
+    void insert(const GroundStateHull &other);
+
+    /// Candidates kept, in the order they were inserted
+    const std::vector<GroundStateCandidate> &candidates() const {
+      return m_candidates;
+    }
+
+    Index size() const {
+      return m_candidates.size();
+    }
+
+    /// True if the candidates span the composition space, so that hull() is constructed
+    bool hull_found() const {
+      return m_hull_found;
+    }
+
+    const LowerHull &hull() const {
+      return m_hull;
+    }
+
+  private:
+
+    /// Construct the hull of m_candidates, and keep only its vertices
+    void _update();
+
+    /// Construct m_hull from m_candidates
+    bool _reset_hull();
+
+    double m_tol;
+
+    std::vector<GroundStateCandidate> m_candidates;
+
+    LowerHull m_hull;
+
+    bool m_hull_found;
+
+  };
+
+  /// \brief How search_ground_states searches each supercell
+  struct GroundStateSearch {
+
+    GroundStateSearch() :
+      anneal(false), runs(20), sweeps(100), kT_init(0.1), kT_final(0.001), seed(0), tol(1e-8) {}
+
+    /// If false, the cluster expansion is evaluated for every occupation of each supercell, using the
+    /// change in correlations from one occupation to the next.
+    ///
+    /// If true, 'runs' simulated annealing runs are made in each supercell. Each run starts from a random
+    /// occupation, at random sublattice compositions, and makes 'sweeps' passes over the sites swapping
+    /// the occupants of sites on the same sublattice, with the temperature decreasing geometrically from
+    /// 'kT_init' to 'kT_final' (in the units of 'eci'). The lowest energy occupation of each run is a
+    /// candidate.
+    bool anneal;
+    Index runs;
+    Index sweeps;
+    double kT_init;
+    double kT_final;
+    unsigned long seed;
+
+    /// Tolerance for GroundStateHull
+    double tol;
+
+    Clexulator clexulator;
+    ECIContainer eci;
+
+  };
+
+  /// \brief Search the supercells 'scel' for ground states of the cluster expansion given by 'search'
+  ///
+  /// The supercells are split into independent pieces of work, which run in parallel and each stream their
+  /// candidates into their own GroundStateHull. These are then combined in order, so that the result does
+  /// not depend on the number of threads.
+  ///
+  /// Requires the composition axes and the Supercell neighbor lists.
+  GroundStateHull search_ground_states(const Array<Supercell *> &scel, const GroundStateSearch &search);
+
+}
+
+#endif
@@ -217,6 +217,10 @@ namespace CASM {
       return components;
     };
 
+    const Eigen::MatrixXd &get_prim_end_members() const {
+      return prim_end_members;
+    };
+
     std::string get_composition_formula() const;
 
     const Array<ParamComposition> &get_allowed_list() const {
@@ -245,5 +249,24 @@ namespace CASM {
     };
   };
 
+  namespace ParamComposition_impl {
+
+    /// \brief Returns false if the columns 'chosen' of 'directions' are dependent, or give another column in their span negative coordinates
+    bool is_positive_in_span(const Eigen::MatrixXd &directions, const Array<Index> &chosen);
+
+    /// \brief Depth-first search for sets of 'N_spanning' columns of 'directions' that pass is_positive_in_span
+    void search_spanning_sets(const Eigen::MatrixXd &directions,
+                              Index N_spanning,
+                              Index pos,
+                              Array<Index> &chosen,
+                              Array< Array<Index> > &result);
+
+    /// \brief Returns true if 'v' is a nonnegative combination of the columns of 'generators'
+    bool is_nonnegative_combination(const Eigen::MatrixXd &generators, const Eigen::VectorXd &v);
+
+    /// \brief Returns true if column 'j' of 'directions' is a nonnegative combination of the columns that are not positive multiples of it
+    bool is_redundant_direction(const Eigen::MatrixXd &directions, EigenIndex j);
+  }
+
 }
 #endif
@@ -3,6 +3,7 @@
 
 #define BOOST_NO_SCOPED_ENUMS
 #define BOOST_NO_CXX11_SCOPED_ENUMS
+#include <mutex>
 #include <boost/filesystem.hpp>
 
 #include "casm/BP_C++/BP_Parse.hh"
@@ -61,12 +62,30 @@ namespace CASM {
     /// Contains all the supercells that were involved in the enumeration.
     boost::container::stable_vector< Supercell > supercell_list;
 
+    /// SupercellSymInfo shared by the Supercells (including temporary ones) with the same transformation
+    /// matrix, keyed by the elements of the transformation matrix. Entries expire when the last Supercell
+    /// using them is destroyed, and are erased by supercell_sym_info(), which locks m_supercell_sym_info_mutex
+    mutable std::map<std::vector<int>, std::weak_ptr<SupercellSymInfo> > m_supercell_sym_info;
+    mutable std::mutex m_supercell_sym_info_mutex;
+
 
     /// CompositionConverter specifies parameteric composition axes and converts between
     ///   parametric composition and mol composition
     bool m_has_composition_axes = false;
     CompositionConverter m_comp_converter;
 
+    /// Lookup tables for counting molecules and components, see _generate_composition_index():
+    ///   m_struc_molecule = prim.get_struc_molecule()
+    ///   m_struc_molecule_index[basis_site][site_occupant_index] is the index into m_struc_molecule
+    ///   m_component_index[struc_molecule_index] is the index into composition_axes().components(),
+    ///     or -1 if there are no composition axes or the molecule is not a component
+    Array<Molecule> m_struc_molecule;
+    Array< Array<int> > m_struc_molecule_index;
+    Array<int> m_component_index;
+
+    /// Generate the composition lookup tables, for the current prim and composition axes
+    void _generate_composition_index();
+
 
     /// Stores the 'delta' UnitCellCoord needed to determine all the
     ///   sites in the neighborhood of a given primitive cell according to:
@@ -169,6 +188,17 @@ namespace CASM {
     /// const Access CompositionConverter object
     const CompositionConverter &composition_axes() const;
 
+    /// const Access to prim.get_struc_molecule(), without generating it each time
+    const Array<Molecule> &get_struc_molecule() const;
+
+    /// Converts prim Site::site_occupant indices to get_struc_molecule() indices:
+    ///   struc_molecule_index = get_struc_molecule_index()[basis_site][site_occupant_index]
+    const Array< Array<int> > &get_struc_molecule_index() const;
+
+    /// Converts get_struc_molecule() indices to composition_axes().components() indices:
+    ///   component_index = get_component_index()[struc_molecule_index], or -1 if not a component
+    const Array<int> &get_component_index() const;
+
 
     // ** Prim and Orbitree accessors **
 
@@ -199,6 +229,10 @@ namespace CASM {
     /// Access supercell by name
     Supercell &get_supercell(std::string scellname);
 
+    /// Symmetry data for Supercells with transformation matrix 'transf_mat', shared with any
+    /// other Supercell with the same transformation matrix. Thread safe
+    std::shared_ptr<SupercellSymInfo> supercell_sym_info(const Matrix3<int> &transf_mat) const;
+
     /// access configuration by name (of the form "scellname/[NUMBER]", e.g., ("SCEL1_1_1_1_0_0_0/0")
     const Configuration &configuration(const std::string &configname) const;
     Configuration &configuration(const std::string &configname);
@@ -329,6 +363,9 @@ namespace CASM {
     void populate_structure_factor(const Index &scell_index);
     void populate_structure_factor(const Index &scell_index, const Index &config_index);
 
+    ///Count the molecules of all the configurations that belong to this primclex, see Supercell::populate_composition
+    void populate_composition() const;
+
     /*
         ///Use global orbitree to populate global correlations of the configuration specified by the index of the supercell
         void populate_global_correlations(const Index &scell_index, const Index &config_index);
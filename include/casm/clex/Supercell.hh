@@ -1,6 +1,8 @@
 #ifndef SUPERCELL_HH
 #define SUPERCELL_HH
 
+#include <memory>
+
 #include "casm/crystallography/PrimGrid.hh"
 #include "casm/crystallography/BasicStructure.hh"
 #include "casm/crystallography/Structure.hh"
@@ -16,6 +18,26 @@ namespace CASM {
   class PermuteIterator;
   class PrimClex;
   class Clexulator;
+  class PeriodicSiteHash;
+  struct RandomSampling;
+
+  /// \brief Symmetry data of a Supercell that depends only on its transformation matrix
+  ///
+  /// Supercells with the same transformation matrix share one SupercellSymInfo, through
+  /// PrimClex::supercell_sym_info. See Supercell::factor_group() and Supercell::permutation_symrep_ID().
+  struct SupercellSymInfo {
+
+    SupercellSymInfo() :
+      perm_symrep_ID(-1) {}
+
+    /// Removes the permutation representation from the prim factor group, when the last Supercell
+    /// using it is destroyed
+    ~SupercellSymInfo();
+
+    SymGroup factor_group;
+    Index perm_symrep_ID;
+
+  };
 
   class Supercell {
 
@@ -45,6 +67,9 @@ namespace CASM {
     //the prim cell
     PrimGrid recip_grid;
 
+    // m_sym_info holds m_factor_group and m_perm_symrep_ID, shared with all other Supercells with the
+    // same transf_mat. It is obtained from the PrimClex the first time it is needed.
+    //
     // m_perm_symrep_ID is the ID of the SymGroupRep of get_prim().factor_group() that describes how
     // operations of m_factor_group permute sites of the Supercell.
     // NOTE: The permutation representation is for (*this).get_prim().factor_group(), which may contain
@@ -52,8 +77,7 @@ namespace CASM {
     //       operations that aren't in m_factor_group. You should access elements of the SymGroupRep using
     //       the the Supercel::factor_group_permute(int) method, so that you don't encounter the gaps
     //       OR, see note for Supercell::permutation_symrep() below.
-    mutable Index m_perm_symrep_ID;
-
+    //
     // m_factor_group is factor group of the super cell, found by identifying the subgroup of
     // (*this).get_prim().factor_group() that leaves the supercell lattice vectors unchanged
     // if (*this).get_prim() is actually primitive, then m_factor_group.size() <= 48
@@ -65,15 +89,27 @@ namespace CASM {
     //       m_displacement(init_config.get_displacement()),
     //       m_strain(init_config.get_supercell().strain
     //       (*this).superstruc().factor_group() is the group formed by the cosets of Tsuper in the supercell space group
-    mutable SymGroup m_factor_group;
+    mutable std::shared_ptr<SupercellSymInfo> m_sym_info;
 
     // m_trans_permute describes how translations by a primitive lattice translation permutes the sites
     // of the Supercell. m_trans_permute[i] is the effect of translating all sites by (*this).uccoord[i]
     // and mapping them back within the Supercell. m_trans_permute.size() == (*this).volume()
     // NOTE: m_trans_permute can be thought of as the translational factor group formed by the the cosets
     //       of the group Tsuper in the group Tprim, as they are defined above
+    // NOTE: m_trans_permute is not stored. PrimGrid::translation_permute_ind finds its elements from the
+    //       Smith normal form coordinates of the sites
     //mutable Array<Permutation> m_trans_permute;
 
+    /// Returns *m_sym_info, getting it from the PrimClex if needed
+    SupercellSymInfo &_sym_info() const;
+
+    // m_site_hash is a spatial hash of the positions of all sites in the Supercell, in order of
+    // linear index, used by get_linear_index(). It is constructed the first time it is needed.
+    mutable std::shared_ptr<PeriodicSiteHash> m_site_hash;
+
+    /// Returns m_site_hash, constructing it if necessary so that it can be used with 'tol'
+    std::shared_ptr<PeriodicSiteHash> _site_hash(double tol) const;
+
     //Indices that map the linear index to the bijk point in real space
     //  Generate in void Supercell::fill_supercell() which is called in constructors
     //  This always exists and is populated
@@ -95,34 +131,37 @@ namespace CASM {
 
     ///************************************************************************************************
     /// STRUCTURE FACTOR ROUTINES
-    /// Fourier matrix is arranged as :
-    ///           [exp(-i k1 r1)  exp(- k2 r1) ... exp(-i kn r1)]
-    ///           [exp(-i k1 r2)  exp(- k2 r2) ... exp(-i kn r2)]
-    ///           ...
-    ///           [exp(-i k1 rn)  exp(- k2 rn) ... exp(-i kn rn)]
-    /// r_{i} are the real space coordinates of the prim grid points
-    /// k_{i} are k-points commensurate with the supercell
-    Eigen::MatrixXcd m_fourier_matrix;
-
-    /// The phase factor matrix is arranged as:
-    ///           [exp(-i k1 tau1)  exp(-i k2 tau1) ... exp(-i kn tau1)]
-    ///           [exp(-i k1 tau2)  exp(-i k2 tau2) ... exp(-i kn tau2)]
-    ///           ...
-    ///           [exp(-i k1 taun)  exp(-i k2 taun) ... exp(-i kn taun)]
-    /// tau_{i} is the shift vector for the ith basis atom
+    /// The translations of the Supercell are a product of cyclic groups, Z_S0 x Z_S1 x Z_S2, where S is the
+    /// Smith normal form of the transformation matrix (see PrimGrid). Prim grid point 'l' has canonical
+    /// coordinates (m0,m1,m2) and position r = m0*r0 + m1*r1 + m2*r2, where r_j = prim_lattice*U.col(j).
+    /// For a k-point commensurate with the Supercell, k.r_j = 2*pi*n_j/S_j for integers n_j, so that
+    ///           exp(-i k r) = exp(-2*pi*i*(m0*n0/S0 + m1*n1/S1 + m2*n2/S2))
+    /// and a sum over the prim grid is one element of the 3D discrete Fourier transform (see fft_3d).
+    ///
+    /// m_k_index[i] is the linear index, n0 + n1*S0 + n2*S0*S1, of k-point i in that transform,
+    /// or -1 if k-point i is not commensurate with the Supercell
+    Array<Index> m_k_index;
+
+    /// The k-points that are not commensurate with the Supercell, if generate_kpoint_index was called
+    /// with override == true, and exp(-i k r) for each prim grid point (rows) and each of those k-points
+    /// (columns). Their structure factors are summed directly, in O(volume()) per k-point.
+    Array<Index> m_incommensurate_k;
+    Eigen::MatrixXcd m_incommensurate_fourier;
+
     Eigen::MatrixXcd m_phase_factor;
 
     /// Calculating the structure factor:
     ///    vectors you need : Eigen::VectorXd intensities //this needs to be as long
     ///                                                   //as the number of sites in the supercell
-    ///    Calculations (these are done in Configuration):
-    ///       intensities.segment<volume()>(i*volume()) * fourier_matrix = Q.column(i)
+    ///    Calculations (see sublat_struct_fact and Configuration::calc_struct_fact):
+    ///       Q(k,i) = sum_r intensities[i*volume() + l(r)] * exp(-i k r) / volume(), using fft_3d
+    ///       (or m_incommensurate_fourier, for incommensurate k-points with override == true)
     ///       Q is arranged as: [Q1(k1) Q2(k1) ... Qn(k1)]
     ///                         [Q1(k2) Q2(k2) ... Qn(k2)]
     ///                         ...
     ///                         [Q1(kn) Q2(kn) ... Qn(kn)]
-    ///       Structure factors are then calculated as S:
-    ///       S = Q * m_phase_factor
+    ///       Structure factors are then calculated as S, the diagonal of Q * m_phase_factor:
+    ///       S(k) = sum_i Q(k,i) * m_phase_factor(i,k)
     ///       S is arranged as: [S(k1) S(k2) ... S(kn)]
     ///       In the code: Q is called sublat_sf
 
@@ -132,8 +171,10 @@ namespace CASM {
     Eigen::MatrixXd m_k_mesh;
 
     /// Structure factor calculation routines -> Use only the public versions of these functions
-    /// The calculations, and math is explained as comments above m_fourier_matrix and m_phase_factor
-    void generate_fourier_matrix(const Eigen::MatrixXd &real_coordinates, const Eigen::MatrixXd &recip_coordinates, const bool &override);
+    /// The calculations, and math is explained as comments above m_k_index and m_phase_factor
+    /// - If 'override' is false, the structure factors of incommensurate k-points are zero
+    /// - If 'override' is true, they are summed directly over the Supercell (see real_coordinates)
+    void generate_kpoint_index(const Eigen::MatrixXd &recip_coordinates, const bool &override);
     void generate_phase_factor(const Eigen::MatrixXd &shift_vectors, const Array<bool> &is_commensurate, const bool &override);
     ///************************************************************************************************
 
@@ -172,6 +213,8 @@ namespace CASM {
     Index get_linear_index(const Site &site, double tol = TOL) const;
     Index get_linear_index(const Coordinate &coord, double tol = TOL) const;
     Index find(const UnitCellCoord &bijk) const;
+    /// find(bijk[i]) for each 'i'
+    ReturnArray<Index> find(const Array<UnitCellCoord> &bijk) const;
     Coordinate coord(const UnitCellCoord &bijk) const;
     Coordinate coord(Index linear_ind) const;
 
@@ -232,8 +275,8 @@ namespace CASM {
       t_bijk[0] = get_b(i);
       return t_bijk;
     };
-    const Eigen::MatrixXcd &fourier_matrix() const {
-      return m_fourier_matrix;
+    const Array<Index> &k_index() const {
+      return m_k_index;
     }
 
     const Eigen::MatrixXcd &phase_factor() const {
@@ -252,11 +295,7 @@ namespace CASM {
     //       SymGroupRep::get_representation(m_factor_group[i]) or SymGroupRep::get_permutation(m_factor_group[i]),
     //       so that you don't encounter the gaps (i.e., the representation can be indexed using the
     //       SymOps of m_factor_group
-    Index permutation_symrep_ID()const {
-      if(m_perm_symrep_ID == Index(-1))
-        generate_permutations();
-      return m_perm_symrep_ID;
-    }
+    Index permutation_symrep_ID()const;
 
     SymGroupRep const *permutation_symrep() const {
       return get_prim().factor_group().representation(permutation_symrep_ID());
@@ -351,12 +390,10 @@ namespace CASM {
     const Permutation &factor_group_permute(Index i) const;
 
     // Returns the i'th element of m_trans_permute
-    // Populates m_trans_permute if needed
-    const Permutation &translation_permute(Index i) const;
+    Permutation translation_permute(Index i) const;
 
-    // Const access of m_trans_permute
-    // Populates m_trans_permute if needed
-    const Array<Permutation> &translation_permute() const;
+    // Returns m_trans_permute
+    ReturnArray<Permutation> translation_permute() const;
 
     // begin and end iterators for iterating over translation and factor group permutations
     permute_const_iterator permute_begin() const;
@@ -407,12 +444,17 @@ namespace CASM {
     void generate_all_delta_config_props();
 
     /// Structure Factor
-    void generate_fourier_matrix();
-    void generate_fourier_matrix(const Eigen::MatrixXd &real_coordinates, const Eigen::MatrixXd &recip_coordinates);
+    void generate_kpoint_index();
+    void generate_kpoint_index(const Eigen::MatrixXd &recip_coordinates);
+    /// Sublattice structure factors, Q, for the k-points of k_mesh() (see comments above m_k_index)
+    Eigen::MatrixXcd sublat_struct_fact(const Eigen::VectorXd &intensities) const;
     Array< bool > is_commensurate_kpoint(const Eigen::MatrixXd &recip_coordinates, double tol = TOL);
     void populate_structure_factor();
     void populate_structure_factor(const Index &config_index);
 
+    /// Count the molecules of every Configuration in config_list, in parallel (see Configuration::num_each_molecule)
+    void populate_composition() const;
+
     // **** Enumerating functions ****
 
     /// Loop over all configurations enumerated by 'enumerator' and add them to the Supercell, if they are not already present
@@ -424,6 +466,16 @@ namespace CASM {
     /// Enumerate all possible occupation configurations that are symmetrically equivalent and fit inside this supercell (but cannot be described by a smaller supercell)
     void enumerate_all_occupation_configurations();
 
+    /// Enumerate the occupation configurations with 'sublat_num_each[b][occ]' sites of sublattice 'b' occupied by 'occ', like enumerate_all_occupation_configurations
+    void enumerate_composition_configurations(const Array<Array<int> > &sublat_num_each);
+
+    /// Draw 'N_samples' configurations with ConfigEnumRandom, and add the new ones with add_config
+    ///
+    /// The samples come from 'N_streams' random number streams, seeded with 'seed', the supercell id and the stream index,
+    /// which run in parallel. Results depend only on the arguments, not on the number of threads. Returns the number of
+    /// configurations added.
+    Index sample_configurations(const RandomSampling &sampling, Index N_samples, unsigned long seed, Index N_streams = 1);
+
     /// Enumerate 'Nstep' configurations that linearly interpolate deformation and displacement from 'initial' configuration to 'final' configuration
     /// 'initial' and 'final' must either have the same occupation or have unspecified occupation
     /// The range can be adjusted using 'being_delta' and 'end_delta' (which can be positive or negative). begin_delta<0 indicates interpolation starts
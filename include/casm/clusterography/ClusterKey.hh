@@ -0,0 +1,155 @@
+#ifndef CLUSTERKEY_HH
+#define CLUSTERKEY_HH
+
+#include <vector>
+#include <unordered_set>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/container/Array.hh"
+#include "casm/container/LinearAlgebra.hh"
+#include "casm/crystallography/PeriodicSiteHash.hh"
+
+namespace CASM {
+
+  /**
+   * ClusterKey is an integer description of a cluster, used to look up clusters by
+   * hashing rather than by comparing them site by site.
+   *
+   * Each site is described by its basis index 'b' and the lattice translation (i,j,k)
+   * of its unit cell. After canonicalize(), the sites are sorted, and for periodic
+   * clusters the key is also translated to the smallest such description over all
+   * lattice translations, so that two clusters have the same key if and only if they
+   * are related by a lattice translation (or are equal, for local clusters).
+   */
+
+  class ClusterKey {
+  public:
+
+    ClusterKey() {}
+
+    /// Number of sites
+    Index size() const {
+      return m_val.size() / 4;
+    }
+
+    void clear() {
+      m_val.clear();
+    }
+
+    void reserve(Index N) {
+      m_val.reserve(4 * N);
+    }
+
+    /// Add site on basis site 'b', in the unit cell at lattice translation 'ijk'
+    void push_back(Index b, const Vector3<int> &ijk) {
+      m_val.push_back(b);
+      m_val.push_back(ijk[0]);
+      m_val.push_back(ijk[1]);
+      m_val.push_back(ijk[2]);
+    }
+
+    /// Put key in canonical form
+    ///  - sites are sorted
+    ///  - if 'periodic', the sites are translated to minimize the key lexicographically
+    void canonicalize(bool periodic);
+
+    bool operator==(const ClusterKey &RHS) const {
+      return m_val == RHS.m_val;
+    }
+
+    bool operator<(const ClusterKey &RHS) const {
+      return m_val < RHS.m_val;
+    }
+
+    std::size_t hash() const;
+
+  private:
+
+    /// (b, i, j, k) for each site
+    std::vector<long> m_val;
+
+    /// sort sites lexicographically
+    static void _sort(std::vector<long> &val);
+
+  };
+
+  struct ClusterKeyHash {
+    std::size_t operator()(const ClusterKey &key) const {
+      return key.hash();
+    }
+  };
+
+  typedef std::unordered_set<ClusterKey, ClusterKeyHash> ClusterKeySet;
+
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  /**
+   * ClusterKeyMaker finds the ClusterKey of clusters whose sites are lattice translations
+   * of a given list of basis sites, using a PeriodicSiteHash for the site lookup.
+   */
+
+  class ClusterKeyMaker {
+  public:
+
+    /// Construct from the basis sites and the lattice that defines the lattice translations
+    template<typename CoordType>
+    ClusterKeyMaker(const Array<CoordType> &basis, const Lattice &lat, double tol = TOL);
+
+    /// Number of basis sites
+    Index size() const {
+      return m_hash.size();
+    }
+
+    /// Fractional coordinates of basis site 'b'
+    Vector3<double> basis_frac(Index b) const {
+      return m_hash.batch().frac(b);
+    }
+
+    /// Cartesian coordinates of basis site 'b', translated by 'ijk'
+    Vector3<double> cart(Index b, const Vector3<int> &ijk) const;
+
+    /// Find basis index 'b' and lattice translation 'ijk' of a site
+    /// Returns false if the site is not a lattice translation of a basis site
+    bool find(const Coordinate &site, Index &b, Vector3<int> &ijk) const;
+
+    /// Set 'key' to the canonical key of 'clust'
+    /// Returns false if any site of 'clust' is not a lattice translation of a basis site
+    template<typename ClustType>
+    bool make_key(const ClustType &clust, ClusterKey &key, bool periodic) const;
+
+  private:
+
+    PeriodicSiteHash m_hash;
+
+  };
+
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  template<typename CoordType>
+  ClusterKeyMaker::ClusterKeyMaker(const Array<CoordType> &basis, const Lattice &lat, double tol) :
+    m_hash(lat, tol) {
+    m_hash.reserve(basis.size());
+    for(Index b = 0; b < basis.size(); b++) {
+      m_hash.push_back(basis[b]);
+    }
+  }
+
+  //*******************************************************************************************
+
+  template<typename ClustType>
+  bool ClusterKeyMaker::make_key(const ClustType &clust, ClusterKey &key, bool periodic) const {
+    Index b;
+    Vector3<int> ijk;
+    key.clear();
+    key.reserve(clust.size());
+    for(Index i = 0; i < clust.size(); i++) {
+      if(!find(clust[i], b, ijk))
+        return false;
+      key.push_back(b, ijk);
+    }
+    key.canonicalize(periodic);
+    return true;
+  }
+
+}
+#endif
@@ -1,6 +1,9 @@
 #include "casm/BP_C++/BP_Vec.hh"
 #include "casm/BP_C++/BP_Parse.hh"
 #include "casm/crystallography/Structure.hh"
+#include "casm/crystallography/CoordinateBatch.hh"
+#include "casm/clusterography/ClusterKey.hh"
+#include "casm/system/Parallel.hh"
 
 namespace CASM {
 
@@ -421,7 +424,7 @@ namespace CASM {
 
     Index i, j, np, no;
     Vector3<int> dim; //size of gridstruc
-    double dist, min_dist;
+    double min_dist;
     Array<typename ClustType::WhichCoordType> basis, gridstruc;
     std::string clean(80, ' ');
 
@@ -445,21 +448,43 @@ namespace CASM {
     Counter<Vector3<int> > grid_count(-dim, dim, Vector3<int>(1));
     if(verbose) std::cout << "dim is " << dim << '\n';
     if(verbose) std::cout << "\n Finding Grid_struc:\n";
-    do {
-      lat_point(FRAC) = grid_count();
 
+    // fractional coordinates of the basis, for batched distance evaluation
+    CoordinateBatch basis_batch(lattice);
+    for(i = 0; i < basis.size(); i++) {
+      basis_batch.push_back(basis[i](FRAC));
+    }
+    std::vector<double> dist_sq(basis.size());
+    double max_radius_sq = max_radius * max_radius;
+    Vector3<double> tfrac;
+
+    // integer description (basis index, lattice translation) and Cartesian coordinates of
+    // the gridstruc sites, used to check candidate clusters without constructing them
+    ClusterKeyMaker key_maker(basis, lattice);
+    Array<Index> grid_b;
+    Array<Vector3<int> > grid_ijk;
+    Array<Vector3<double> > grid_cart;
+
+    do {
       for(i = 0; i < basis.size(); i++) {
-        typename ClustType::WhichCoordType tatom(basis[i] + lat_point);
-        //get distance to closest basis site in the unit cell at the origin
+        tfrac = basis_batch.frac(i);
+        for(j = 0; j < 3; j++) {
+          tfrac[j] += grid_count()[j];
+        }
 
+        //get distance to closest basis site in the unit cell at the origin
+        basis_batch.dist_sq(tfrac, dist_sq.data());
         min_dist = 1e20;
         for(j = 0; j < basis.size(); j++) {
-          dist = tatom.dist(basis[j]);
-          if(dist < min_dist)
-            min_dist = dist;
+          if(dist_sq[j] < min_dist)
+            min_dist = dist_sq[j];
         }
-        if(min_dist < max_radius) {
-          gridstruc.push_back(tatom);
+        if(min_dist < max_radius_sq) {
+          lat_point(FRAC) = grid_count();
+          gridstruc.push_back(basis[i] + lat_point);
+          grid_b.push_back(i);
+          grid_ijk.push_back(grid_count());
+          grid_cart.push_back(key_maker.cart(i, grid_count()));
         }
       }
     }
@@ -482,8 +507,16 @@ namespace CASM {
 
     //for each cluster of the previous size, add points from gridstruc
     //   - see if the new cluster satisfies the size requirements
-    //   - see if it is new
+    //   - see if it is new, by looking up its ClusterKey among the keys of all equivalent
+    //     clusters found so far
     //   - generate all its equivalents
+    //
+    //The first two steps only need the integer and Cartesian descriptions of the prototype
+    //and gridstruc sites, so they are done in parallel, for a chunk of candidates at a time. The
+    //orbits are then constructed serially, in the same order as the candidates.
+
+    bool periodic = !PERIODICITY_MODE::IS_LOCAL();
+    Index Ngrid = gridstruc.size();
 
     if(verbose) std::cout << "About to begin construction of non-empty clusters\n";
     else std::cout << clean << '\r' << "About to begin construction of non-empty clusters\r" << std::flush;
@@ -498,38 +531,109 @@ namespace CASM {
         exit(1);
       }
 
-      for(no = 0; no < size(np - 1); no++) {
-        if(verbose) std::cout << "Adding sites to orbit " << no << " of " << size(np - 1) << "\n";
-        else std::cout << clean << '\r' << "Adding sites to orbit " << no << " of " << size(np - 1) << " in branch " << np - 1 << '\r' << std::flush;
+      // integer and Cartesian description of the prototypes of the previous branch
+      Index Nproto = size(np - 1);
+      Array<Array<Index> > proto_b(Nproto);
+      Array<Array<Vector3<int> > > proto_ijk(Nproto);
+      Array<Array<Vector3<double> > > proto_cart(Nproto);
+      bool use_keys = true;
+      for(no = 0; no < Nproto; no++) {
+        const ClustType &proto(orbit(np - 1, no).prototype);
+        proto_b[no].resize(proto.size());
+        proto_ijk[no].resize(proto.size());
+        proto_cart[no].resize(proto.size());
+        for(i = 0; i < proto.size(); i++) {
+          if(!key_maker.find(proto[i], proto_b[no][i], proto_ijk[no][i]))
+            use_keys = false;
+          proto_cart[no][i] = proto[i](CART);
+        }
+      }
 
-        ClustType tclust(lattice);
-        for(i = 0; i < orbit(np - 1, no).prototype.size(); i++)
-          tclust.push_back(orbit(np - 1, no).prototype[i]);
+      // keys of all clusters in orbits of branch np; if some cluster can't be described by
+      // a ClusterKey, fall back to 'contains'
+      ClusterKeySet found;
+      ClusterKey tkey;
+
+      // The prototypes are done in chunks, so that at most about 'max_chunk' candidates, and their
+      // keys, are stored at once. Each chunk is added to 'found' before the next is started.
+      const Index max_chunk = 65536;
+      Index chunk_size = std::max(Index(1), max_chunk / std::max(Ngrid, Index(1)));
+      std::vector<char> candidate;
+      std::vector<ClusterKey> key;
+      for(Index chunk_begin = 0; chunk_begin < Nproto; chunk_begin += chunk_size) {
+        Index chunk_end = std::min(Nproto, chunk_begin + chunk_size);
+
+        // candidate[k] is true if prototype 'chunk_begin + k / Ngrid' plus gridstruc site 'k % Ngrid'
+        // may satisfy the length criteria, in which case key[k] is the ClusterKey of the new cluster
+        Index Ncand = (chunk_end - chunk_begin) * Ngrid;
+        candidate.assign(Ncand, false);
+        key.clear();
+        key.resize(use_keys ? Ncand : 0);
+        parallel_for(0, Ncand, [&](Index k) {
+          Index tno = chunk_begin + k / Ngrid, ti = k % Ngrid;
+          const Array<Vector3<double> > &cart(proto_cart[tno]);
+
+          if(np > 1) {
+            // lengths are checked with some slack; the exact check is done on the constructed cluster
+            double tmax = 0.0, tmin = 1e20, tlength;
+            for(Index s = 0; s < cart.size(); s++) {
+              tlength = (grid_cart[ti] - cart[s]).norm();
+              tmax = std::max(tmax, tlength);
+              tmin = std::min(tmin, tlength);
+              for(Index t = s + 1; t < cart.size(); t++) {
+                tlength = (cart[t] - cart[s]).norm();
+                tmax = std::max(tmax, tlength);
+                tmin = std::min(tmin, tlength);
+              }
+            }
+            if(!(tmax < max_length[np] + TOL && tmin > min_length - TOL))
+              return;
+          }
+          candidate[k] = true;
+
+          if(use_keys) {
+            key[k].reserve(np);
+            for(Index s = 0; s < cart.size(); s++)
+              key[k].push_back(proto_b[tno][s], proto_ijk[tno][s]);
+            key[k].push_back(grid_b[ti], grid_ijk[ti]);
+            key[k].canonicalize(periodic);
+          }
+        });
 
-        for(i = 0; i < gridstruc.size(); i++) {
+        for(no = chunk_begin; no < chunk_end; no++) {
+          if(verbose) std::cout << "Adding sites to orbit " << no << " of " << size(np - 1) << "\n";
+          else std::cout << clean << '\r' << "Adding sites to orbit " << no << " of " << size(np - 1) << " in branch " << np - 1 << '\r' << std::flush;
 
-          //if(orbit(np-1,no).prototype.contains(gridstruc[i])) continue;
+          ClustType tclust(lattice);
+          for(i = 0; i < orbit(np - 1, no).prototype.size(); i++)
+            tclust.push_back(orbit(np - 1, no).prototype[i]);
 
-          //tclust = orbit(np - 1, no).prototype;
-          tclust.push_back(gridstruc[i]);
+          for(i = 0; i < Ngrid; i++) {
+            Index k = (no - chunk_begin) * Ngrid + i;
+            if(!candidate[k] || (use_keys && found.count(key[k])))
+              continue;
 
-          tclust.within();
-          tclust.calc_properties();
+            tclust.push_back(gridstruc[i]);
 
-          if(np == 1 && !contains(tclust)) {
-            at(np).push_back(GenericOrbit<ClustType>(tclust));
-            at(np).back().get_equivalent(prim.factor_group());
-            at(np).back().get_cluster_symmetry();
-            //at(np).back().get_tensor_basis(np); //temporarily works as rank = np
-          }
-          else if(tclust.max_length() < max_length[np] && tclust.min_length() > min_length && !contains(tclust)) {
-            at(np).push_back(GenericOrbit<ClustType>(tclust));
+            tclust.within();
+            tclust.calc_properties();
 
-            at(np).back().get_equivalent(prim.factor_group());
-            at(np).back().get_cluster_symmetry();
-            //at(np).back().get_tensor_basis(np); //temporarily works as rank = np
+            if((np == 1 || (tclust.max_length() < max_length[np] && tclust.min_length() > min_length))
+               && (use_keys || !contains(tclust))) {
+              at(np).push_back(GenericOrbit<ClustType>(tclust));
+              at(np).back().get_equivalent(prim.factor_group());
+              at(np).back().get_cluster_symmetry();
+              //at(np).back().get_tensor_basis(np); //temporarily works as rank = np
+
+              for(j = 0; use_keys && j < at(np).back().size(); j++) {
+                if(key_maker.make_key(at(np).back()[j], tkey, periodic))
+                  found.insert(tkey);
+                else
+                  use_keys = false;
+              }
+            }
+            tclust.pop_back();
           }
-          tclust.pop_back();
         }
       }
     }
@@ -2,10 +2,14 @@
 #ifndef ARRAY_HH
 #define ARRAY_HH
 
+#include <algorithm>
 #include <iostream>
 #include <cassert>
+#include <cstring>
 #include <new>
 #include <stdlib.h>
+#include <type_traits>
+#include <utility>
 
 #include "casm/CASM_global_definitions.hh"
 #include "casm/casm_io/jsonParser.hh"
@@ -18,6 +22,13 @@ namespace CASM {
   class ReturnArray;
 
 
+  /// \brief Dynamic array
+  ///
+  /// - Capacity grows geometrically, by ARRAY_EXTENSION_FACTOR(), so push_back is amortized O(1)
+  /// - Arrays may be moved, which transfers the storage without copying elements, and elements
+  ///   are moved rather than copied when the storage is reallocated
+  /// - Elements of trivially copyable type are copied and relocated with memcpy
+  /// - Storage is allocated and released only by _allocate and _deallocate
   template<class T>
   class Array {
   private:
@@ -25,12 +36,58 @@ namespace CASM {
       return 2;
     }
     static double ARRAY_EXTENSION_FACTOR() {
-      return 1.1;
+      return 1.5;
     }
 
-    //static const int min_extra_space = 2;
-    //static const double percent_extra_space = 0.1;
+    /// True if elements may be copied and relocated with memcpy
+    static bool _trivial() {
+      return std::is_trivially_copyable<T>::value;
+    }
+
+    static T *_allocate(Index n) {
+      return static_cast<T *>(operator new(n * sizeof(T)));
+    }
+
+    static void _deallocate(T *ptr) {
+      if(ptr)
+        operator delete(ptr);
+    }
+
+    /// Capacity after growing from the current capacity
+    Index _grown_capacity() const {
+      return (NMax * ARRAY_EXTENSION_FACTOR() > NMax + ARRAY_MIN_EXTRA_SPACE()) ?
+             (Index)(NMax * ARRAY_EXTENSION_FACTOR()) : NMax + ARRAY_MIN_EXTRA_SPACE();
+    }
+
+    /// Move the 'n' elements beginning at 'src' to uninitialized memory beginning at 'dest'
+    static void _relocate(T *src, Index n, T *dest) {
+      if(_trivial()) {
+        if(n)
+          std::memcpy(static_cast<void *>(dest), static_cast<const void *>(src), n * sizeof(T));
+        return;
+      }
+      for(Index i = 0; i < n; i++) {
+        new(dest + i) T(std::move(src[i]));
+        src[i].~T();
+      }
+    }
+
+    /// Copy the 'n' elements beginning at 'src' to uninitialized memory beginning at 'dest'
+    static void _uninitialized_copy(const T *src, Index n, T *dest) {
+      if(_trivial()) {
+        if(n)
+          std::memcpy(static_cast<void *>(dest), static_cast<const void *>(src), n * sizeof(T));
+        return;
+      }
+      for(Index i = 0; i < n; i++)
+        new(dest + i) T(src[i]);
+    }
 
+    /// Add an element constructed from 'args' when the storage is full
+    ///  - The new element is constructed before the existing elements are moved, so 'args' may
+    ///    refer to elements of *this
+    template<typename... Args>
+    void _grow_and_emplace_back(Args &&... args);
 
     Index N;
     Index NMax;
@@ -69,9 +126,20 @@ namespace CASM {
     //*******************************************************************************************
 
     Array(const Array &RHS) : N(0), NMax(0), Vals(NULL) {
-      reserve(RHS.size());
-      for(Index i = 0; i < RHS.size(); i++)
-        push_back(RHS[i]);
+      if(RHS.size()) {
+        Vals = _allocate(RHS.size());
+        NMax = RHS.size();
+        _uninitialized_copy(RHS.Vals, RHS.size(), Vals);
+        N = RHS.size();
+      }
+    }
+
+    //*******************************************************************************************
+
+    Array(Array &&RHS) noexcept : N(RHS.N), NMax(RHS.NMax), Vals(RHS.Vals) {
+      RHS.N = 0;
+      RHS.NMax = 0;
+      RHS.Vals = NULL;
     }
 
     //*******************************************************************************************
@@ -81,8 +149,7 @@ namespace CASM {
 
     ~Array() {
       clear();
-      if(Vals)
-        operator delete(Vals);
+      _deallocate(Vals);
     }
 
     /// Returns an array with the sequence (initial, ++initial, ..., final), inclusive
@@ -100,6 +167,7 @@ namespace CASM {
 
     // ASSIGN/REASSIGN
     Array &operator=(const Array &RHS);
+    Array &operator=(Array &&RHS) noexcept;
     Array &operator=(ReturnArray<T> &RHS);
     void swap(Array<T> &RHS);
 
@@ -159,7 +227,24 @@ namespace CASM {
 
 
     //MUTATORS
-    void push_back(const T &toPush);
+    void push_back(const T &toPush) {
+      emplace_back(toPush);
+    }
+
+    void push_back(T &&toPush) {
+      emplace_back(std::move(toPush));
+    }
+
+    /// Add an element constructed in place from 'args'
+    template<typename... Args>
+    void emplace_back(Args &&... args) {
+      if(N == NMax) {
+        _grow_and_emplace_back(std::forward<Args>(args)...);
+        return;
+      }
+      new(Vals + N) T(std::forward<Args>(args)...);
+      N++;
+    }
 
     void pop_back() {
       if(N) Vals[--N].~T();
@@ -266,6 +351,8 @@ namespace CASM {
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
   //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 
+  /// ReturnArray takes the storage of an Array, by swapping. It predates move semantics; Arrays
+  /// may now be returned by value equally cheaply.
   template<typename T>
   class ReturnArray : public Array<T> {
   public:
@@ -369,9 +456,18 @@ namespace CASM {
     Index i;
     if(NMax < RHS.size()) {
       clear();
-      reserve(RHS.size());
-      for(i = 0; i < RHS.size(); i++)
-        push_back(RHS[i]);
+      _deallocate(Vals);
+      Vals = _allocate(RHS.size());
+      NMax = RHS.size();
+      _uninitialized_copy(RHS.Vals, RHS.size(), Vals);
+      N = RHS.size();
+      return *this;
+    }
+
+    if(_trivial()) {
+      if(RHS.size())
+        std::memcpy(static_cast<void *>(Vals), static_cast<const void *>(RHS.Vals), RHS.size() * sizeof(T));
+      N = RHS.size();
       return *this;
     }
 
@@ -391,9 +487,32 @@ namespace CASM {
 
   //*******************************************************************************************
 
+  template<typename T>
+  Array<T> &Array<T>::operator=(Array<T> &&RHS) noexcept {
+    if(this == &RHS) {
+      return *this;
+    }
+
+    clear();
+    _deallocate(Vals);
+
+    N = RHS.N;
+    NMax = RHS.NMax;
+    Vals = RHS.Vals;
+
+    RHS.N = 0;
+    RHS.NMax = 0;
+    RHS.Vals = NULL;
+
+    return *this;
+  }
+
+  //*******************************************************************************************
+
   template<typename T>
   Array<T> &Array<T>::operator=(ReturnArray<T> &RHS) {
     swap(RHS);
+    return *this;
   }
 
   //*******************************************************************************************
@@ -446,14 +565,10 @@ namespace CASM {
 
     T *tVal(NULL);
     if(new_max) {
-      tVal = static_cast<T *>(operator new(new_max * sizeof(T)));
-      for(Index i = 0; i < N; i++) {
-        new(tVal + i) T(Vals[i]);
-        Vals[i].~T();
-      }
+      tVal = _allocate(new_max);
+      _relocate(Vals, N, tVal);
     }
-    if(Vals)
-      operator delete(Vals);
+    _deallocate(Vals);
     Vals = tVal;
     NMax = new_max;
     return;
@@ -462,35 +577,20 @@ namespace CASM {
   //*******************************************************************************************
 
   template<typename T>
-  void Array<T>::push_back(const T &toPush) {
-    //If N==NMax, we must reallocate memory.  This is not done via Array::reserve.
-    //Instead, we do it within Array::push_back
-    if(N == NMax) {
-      Index new_Max = (N * ARRAY_EXTENSION_FACTOR() > N + ARRAY_MIN_EXTRA_SPACE()) ?
-                      (Index)(N * ARRAY_EXTENSION_FACTOR()) : N + ARRAY_MIN_EXTRA_SPACE();
-
-      T *tVal(NULL);
-
-      tVal = static_cast<T *>(operator new(new_Max * sizeof(T)));
-
-      //first, add the new element; this prevents aliasing problems
-      new(tVal + N) T(toPush);
-      for(Index i = 0; i < N; i++) {
-        new(tVal + i) T(Vals[i]);
-        Vals[i].~T();
-      }
+  template<typename... Args>
+  void Array<T>::_grow_and_emplace_back(Args &&... args) {
+    Index new_Max = _grown_capacity();
+    T *tVal = _allocate(new_Max);
 
-      if(Vals)
-        operator delete(Vals);
-      Vals = tVal;
-      NMax = new_Max;
+    //first, add the new element; this prevents aliasing problems
+    new(tVal + N) T(std::forward<Args>(args)...);
+    _relocate(Vals, N, tVal);
 
-      N++;
-    }
-    else {
-      new(Vals + (N++)) T(toPush);
-    }
+    _deallocate(Vals);
+    Vals = tVal;
+    NMax = new_Max;
 
+    N++;
   }
 
   //*******************************************************************************************
@@ -498,7 +598,7 @@ namespace CASM {
   void Array<T>::remove(Index ind) {
 
     for(Index i = ind + 1; i < N; i++)
-      at(i - 1) = at(i);
+      at(i - 1) = std::move(at(i));
 
     Vals[--N].~T();
 
@@ -847,7 +947,8 @@ namespace CASM {
   //*******************************************************************************************
   template<typename T>
   Array<T> &Array<T>::append(const Array<T> &new_tail) {
-    reserve(size() + new_tail.size());
+    if(size() + new_tail.size() > NMax)
+      reserve(std::max(size() + new_tail.size(), _grown_capacity()));
     Index Nadd(new_tail.size());
     for(Index i = 0; i < Nadd; i++)
       push_back(new_tail[i]);
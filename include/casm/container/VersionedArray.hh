@@ -0,0 +1,190 @@
+#ifndef VERSIONEDARRAY_HH
+#define VERSIONEDARRAY_HH
+
+#include "casm/container/Array.hh"
+
+namespace CASM {
+
+  /// \brief Array that counts the changes that may have modified its existing elements
+  ///
+  /// - version() changes whenever an element may have been modified, removed, or reordered,
+  ///   i.e. on every non-const element access and every mutator except push_back, emplace_back,
+  ///   append, append_unique, and reserve, which only add elements
+  /// - Used to tell when data derived from the elements, such as a spatial hash of sites, is out
+  ///   of date, in O(1), without requiring every modification to be followed by an explicit reset
+  /// - Modifications made through a reference to the base Array<T> are not counted
+  template<class T>
+  class VersionedArray : public Array<T> {
+  public:
+    using Array<T>::at;
+    using Array<T>::operator[];
+    using Array<T>::back;
+    using Array<T>::begin;
+    using Array<T>::end;
+
+    VersionedArray() : m_version(0) {}
+
+    VersionedArray(const Array<T> &RHS) : Array<T>(RHS), m_version(0) {}
+
+    VersionedArray(const VersionedArray &RHS) : Array<T>(RHS), m_version(0) {}
+
+    VersionedArray(VersionedArray &&RHS) noexcept : Array<T>(std::move(RHS)), m_version(0) {
+      RHS._modified();
+    }
+
+    /// Incremented whenever existing elements may have been modified
+    Index version() const {
+      return m_version;
+    }
+
+    // ASSIGN/REASSIGN
+    VersionedArray &operator=(const VersionedArray &RHS) {
+      return *this = static_cast<const Array<T> &>(RHS);
+    }
+
+    VersionedArray &operator=(VersionedArray &&RHS) noexcept {
+      RHS._modified();
+      return *this = static_cast<Array<T> &&>(RHS);
+    }
+
+    VersionedArray &operator=(const Array<T> &RHS) {
+      _modified();
+      Array<T>::operator=(RHS);
+      return *this;
+    }
+
+    VersionedArray &operator=(Array<T> &&RHS) noexcept {
+      _modified();
+      Array<T>::operator=(std::move(RHS));
+      return *this;
+    }
+
+    VersionedArray &operator=(ReturnArray<T> &RHS) {
+      _modified();
+      Array<T>::operator=(RHS);
+      return *this;
+    }
+
+    void swap(Array<T> &RHS) {
+      _modified();
+      Array<T>::swap(RHS);
+    }
+
+    void swap(VersionedArray &RHS) {
+      RHS._modified();
+      swap(static_cast<Array<T> &>(RHS));
+    }
+
+    // ACCESSORS
+
+    T &at(Index ind) {
+      _modified();
+      return Array<T>::at(ind);
+    }
+
+    T &operator[](Index ind) {
+      _modified();
+      return Array<T>::operator[](ind);
+    }
+
+    T &back() {
+      _modified();
+      return Array<T>::back();
+    }
+
+    T *begin() {
+      _modified();
+      return Array<T>::begin();
+    }
+
+    T *end() {
+      _modified();
+      return Array<T>::end();
+    }
+
+    // MUTATORS
+
+    void pop_back() {
+      _modified();
+      Array<T>::pop_back();
+    }
+
+    void remove(Index ind) {
+      _modified();
+      Array<T>::remove(ind);
+    }
+
+    void clear() {
+      _modified();
+      Array<T>::clear();
+    }
+
+    void resize(Index new_N) {
+      _modified();
+      Array<T>::resize(new_N);
+    }
+
+    void resize(Index new_N, const T &fill_val) {
+      _modified();
+      Array<T>::resize(new_N, fill_val);
+    }
+
+    template <typename CompareType>
+    void sort(const CompareType &comp) {
+      _modified();
+      Array<T>::sort(comp);
+    }
+
+    void sort(Array<Index> &ind_order) {
+      _modified();
+      Array<T>::sort(ind_order);
+    }
+
+    void sort() {
+      _modified();
+      Array<T>::sort();
+    }
+
+    VersionedArray &append(const Array<T> &new_tail) {
+      Array<T>::append(new_tail);
+      return *this;
+    }
+
+    VersionedArray &append_unique(const Array<T> &new_tail) {
+      Array<T>::append_unique(new_tail);
+      return *this;
+    }
+
+    void swap_elem(Index i, Index j) {
+      _modified();
+      Array<T>::swap_elem(i, j);
+    }
+
+    VersionedArray &permute(const Array<Index> &perm_array) {
+      _modified();
+      Array<T>::permute(perm_array);
+      return *this;
+    }
+
+    VersionedArray &ipermute(const Array<Index> &perm_array) {
+      _modified();
+      Array<T>::ipermute(perm_array);
+      return *this;
+    }
+
+    bool next_permute() {
+      _modified();
+      return Array<T>::next_permute();
+    }
+
+  private:
+    void _modified() {
+      m_version++;
+    }
+
+    Index m_version;
+  };
+
+}
+
+#endif
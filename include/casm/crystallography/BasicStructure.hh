@@ -4,7 +4,9 @@
 #include <iostream>
 #include <cstdlib>
 #include <cmath>
+#include <memory>
 
+#include "casm/container/VersionedArray.hh"
 #include "casm/crystallography/Lattice.hh"
 
 namespace CASM {
@@ -14,6 +16,7 @@ namespace CASM {
   class Coordinate;
   class UnitCellCoord;
   class SiteCluster;
+  class PeriodicSiteHash;
   class MasterSymGroup;
   template<typename ClustType> class GenericOrbitree;
   typedef GenericOrbitree<SiteCluster> SiteOrbitree;
@@ -25,18 +28,43 @@ namespace CASM {
   protected:
     Lattice m_lattice;
 
+    /// Spatial hash of basis site positions, and the basis.version() it was built for
+    struct SiteHashCache;
+
+    /// Used by find(). It is constructed when needed, extended when sites are appended to basis,
+    /// and rebuilt when basis is otherwise modified or the lattice changes
+    mutable std::shared_ptr<SiteHashCache> m_site_hash;
+
   public: // PUBLIC DATA MEMBERS -- (long-term, at least lattice should be made private and only updated via Structure::set_lattice)
     /// User-specified name of this Structure
     std::string title;
 
     /// Lattice vectors that specifies periodicity of the crystal
-    Array<CoordType> basis;
+    /// Changes to basis are counted by basis.version(), which find() uses to detect a stale hash
+    VersionedArray<CoordType> basis;
 
 
   private: // PRIVATE METHODS
 
     void main_print(std::ostream &stream, COORD_TYPE mode, bool version5, int option);
 
+    /// Returns m_site_hash, after making sure that it is up to date and usable with 'tol'
+    std::shared_ptr<PeriodicSiteHash> _site_hash(double tol) const;
+
+    /// Spatial hash of the basis, with sites labeled as by type_labels(basis)
+    PeriodicSiteHash _typed_site_hash(double tol) const;
+
+    /// Translations (fractional, including zero) that map the basis onto itself, found using 'basis_hash'
+    ReturnArray<Vector3<double> > _internal_translations(const PeriodicSiteHash &basis_hash, double tol) const;
+
+    /// Implements is_primitive(new_prim, prim_tol), given the result of _internal_translations()
+    bool _is_primitive(BasicStructure &new_prim, const PeriodicSiteHash &basis_hash,
+                       const Array<Vector3<double> > &internal_trans, double prim_tol) const;
+
+    /// Implements generate_factor_group_slow(), given the result of _internal_translations()
+    void _generate_factor_group_slow(SymGroup &factor_group, const PeriodicSiteHash &basis_hash,
+                                     const Array<Vector3<double> > &internal_trans, double map_tol) const;
+
   public: // PUBLIC METHODS
 
     // ****Constructors****
@@ -5,6 +5,8 @@
 
 #include "casm/crystallography/UnitCellCoord.hh"
 #include "casm/crystallography/PrimGrid.hh"
+#include "casm/crystallography/CoordinateBatch.hh"
+#include "casm/crystallography/PeriodicSiteHash.hh"
 #include "casm/symmetry/SymPermutation.hh"
 #include "casm/symmetry/SymBasisPermute.hh"
 #include "casm/symmetry/SymGroupRep.hh"
@@ -99,13 +101,23 @@ namespace CASM {
 
   template<typename CoordType>
   void BasicStructure<CoordType>::generate_factor_group_slow(SymGroup &factor_group, double map_tol) const {
+    PeriodicSiteHash basis_hash(_typed_site_hash(map_tol));
+    Array<Vector3<double> > internal_trans(_internal_translations(basis_hash, map_tol));
+    _generate_factor_group_slow(factor_group, basis_hash, internal_trans, map_tol);
+  }
+
+  //************************************************************
+
+  template<typename CoordType>
+  void BasicStructure<CoordType>::_generate_factor_group_slow(SymGroup &factor_group,
+                                                              const PeriodicSiteHash &basis_hash,
+                                                              const Array<Vector3<double> > &internal_trans,
+                                                              double map_tol) const {
     //std::cout << "SLOW GENERATION OF FACTOR GROUP " << &factor_group << "\n";
     //std::cout << "begin generate_factor_group_slow() " << this << std::endl;
 
-    Array<CoordType> tsite;
-    Index pg, b0, b1, b2;
+    Index pg, b0, i;
     Coordinate t_tau(lattice());
-    Index num_suc_maps;
 
     SymGroup point_group;
     //reset();
@@ -117,52 +129,51 @@ namespace CASM {
       factor_group.clear();
     }
 
+    const CoordinateBatch &basis_batch(basis_hash.batch());
+    CoordinateBatch tsite_batch(lattice());
+    Array<Vector3<double> > trans;
+    Array<double> trans_error;
+
+    // index of the first basis site with each type label
+    Array<Index> type_rep;
+    for(b0 = 0; b0 < basis.size(); b0++) {
+      if(basis_batch.type(b0) == type_rep.size())
+        type_rep.push_back(b0);
+    }
+
     //Loop over all point group ops of the lattice
     for(pg = 0; pg < point_group.size(); pg++) {
-      tsite.clear();
+      tsite_batch.clear();
       //First, generate the symmetrically transformed basis sites
       //Loop over all sites in basis
       for(b0 = 0; b0 < basis.size(); b0++) {
-        tsite.push_back(point_group[pg]*basis[b0]);
+        CoordType tsite(point_group[pg]*basis[b0]);
+
+        //the operation may change the occupants of the site (e.g., orientation of molecules),
+        //so the type label is determined for the transformed site. If it matches no basis site,
+        //it gets label type_rep.size(), which is not the label of any basis site
+        Index t = 0;
+        while(t < type_rep.size() && !basis[type_rep[t]].compare_type(tsite))
+          t++;
+        tsite_batch.push_back(tsite_batch.frac_from_cart(tsite(CART)), t);
       }
 
-      //Using the symmetrically transformed basis, find all possible translations
-      //that MIGHT map the symmetrically transformed basis onto the original basis
-      for(b0 = 0; b0 < tsite.size(); b0++) {
-
-        if(!basis[0].compare_type(tsite[b0]))
-          continue;
+      //Find one translation that maps the symmetrically transformed basis onto the original
+      //basis. Candidates only come from the sites of the least common type.
+      basis_hash.find_translations(tsite_batch, map_tol, trans, trans_error, true);
+      if(!trans.size())
+        continue;
 
-        t_tau = basis[0] - tsite[b0];
+      //All others differ from it by a translation that maps the basis onto itself
+      for(i = 0; i < internal_trans.size(); i++) {
+        t_tau(FRAC) = trans[0] + internal_trans[i];
 
         t_tau.within();
-        num_suc_maps = 0; //Keeps track of number of old->new basis site mappings that are found
-
-        double tdist = 0.0;
-        double max_error = 0.0;
-        for(b1 = 0; b1 < basis.size(); b1++) { //Loop over original basis sites
-          for(b2 = 0; b2 < tsite.size(); b2++) { //Loop over symmetrically transformed basis sites
-
-            //see if translation successfully maps the two sites
-            if(basis[b1].compare(tsite[b2], t_tau, map_tol)) {
-              tdist = basis[b1].min_dist(tsite[b2], t_tau);
-              if(tdist > max_error) {
-                max_error = tdist;
-              }
-              num_suc_maps++;
-              break;
-            }
-          }
-
-          //break out of outer loop if inner loop finds no successful map
-          if(b2 == tsite.size()) {
-            break;
-          }
-        }
 
         //If all atoms in the basis are mapped successfully, try to add the corresponding
         //symmetry operation to the factor_group
-        if(num_suc_maps == basis.size()) {
+        double max_error = 0.0;
+        if(basis_hash.match(tsite_batch, t_tau(FRAC), map_tol, max_error)) {
           SymOp tSym(SymOp(t_tau)*point_group[pg]);
           tSym.set_map_error(max_error);
 
@@ -188,9 +199,14 @@ namespace CASM {
     BasicStructure<CoordType> tprim;
     factor_group.clear();
 
+    // The translations that map the basis onto itself are used both to check
+    // if the structure is primitive and to construct the factor group
+    PeriodicSiteHash basis_hash(_typed_site_hash(map_tol));
+    Array<Vector3<double> > internal_trans(_internal_translations(basis_hash, map_tol));
+
     // CASE 1: Structure is primitive
-    if(is_primitive(tprim, map_tol)) {
-      generate_factor_group_slow(factor_group, map_tol);
+    if(_is_primitive(tprim, basis_hash, internal_trans, map_tol)) {
+      _generate_factor_group_slow(factor_group, basis_hash, internal_trans, map_tol);
       return;
     }
 
@@ -417,19 +433,18 @@ namespace CASM {
       //loop over prim_grid points
       for(i = 0; i < prim_grid.size(); i++) {
 
-        //push back translated basis site of prim onto superstructure basis
-        basis.push_back(prim.basis[j] + prim_grid.coord(i, PRIM));
+        //translated basis site of prim
+        CoordType tsite(prim.basis[j] + prim_grid.coord(i, PRIM));
 
-        //reset lattice for most recent superstructure CoordType
+        //reset lattice for the translated site
         //set_lattice() converts fractional coordinates to be compatible with new lattice
-        basis.back().set_lattice(lattice(), CART);
+        tsite.set_lattice(lattice(), CART);
 
-        basis.back().within();
-        for(Index k = 0; k + 1 < basis.size(); k++) {
-          if(basis[k].compare(basis.back(), map_tol)) {
-            basis.pop_back();
-            break;
-          }
+        tsite.within();
+
+        //push back onto superstructure basis, unless an equivalent site is already there
+        if(find(tsite, map_tol) == basis.size()) {
+          basis.push_back(tsite);
         }
       }
     }
@@ -466,36 +481,8 @@ namespace CASM {
 
   template<typename CoordType>
   bool BasicStructure<CoordType>::is_primitive(double prim_tol) const {
-    Coordinate tshift(lattice());//, bshift(lattice);
-    Index b1, b2, b3, num_suc_maps;
-
-    for(b1 = 1; b1 < basis.size(); b1++) {
-      if(!basis[0].compare_type(basis[b1])) {
-        continue;
-      }
-
-      tshift = basis[0] - basis[b1];
-      num_suc_maps = 0;
-      for(b2 = 0; b2 < basis.size(); b2++) {
-        for(b3 = 0; b3 < basis.size(); b3++) {
-          //if(basis[b3].compare_type(basis[b2], bshift) && tshift.min_dist(bshift) < prim_tol) {
-          if(basis[b3].compare(basis[b2], tshift, prim_tol)) {
-            num_suc_maps++;
-            break;
-          }
-        }
-        if(b3 == basis.size()) {
-          break;
-        }
-      }
-
-      if(num_suc_maps == basis.size()) {
-        return false;
-      }
-
-    }
-
-    return true;
+    PeriodicSiteHash basis_hash(_typed_site_hash(prim_tol));
+    return _internal_translations(basis_hash, prim_tol).size() <= 1;
   }
 
 
@@ -508,33 +495,28 @@ namespace CASM {
 
   template<typename CoordType>
   bool BasicStructure<CoordType>::is_primitive(BasicStructure<CoordType> &new_prim, double prim_tol) const {
-    Coordinate tshift(lattice());//, bshift(lattice);
+    PeriodicSiteHash basis_hash(_typed_site_hash(prim_tol));
+    return _is_primitive(new_prim, basis_hash, _internal_translations(basis_hash, prim_tol), prim_tol);
+  }
+
+  //***********************************************************
+
+  template<typename CoordType>
+  bool BasicStructure<CoordType>::_is_primitive(BasicStructure<CoordType> &new_prim,
+                                                const PeriodicSiteHash &basis_hash,
+                                                const Array<Vector3<double> > &internal_trans,
+                                                double prim_tol) const {
     Vector3<double> prim_vec0(lattice()[0]), prim_vec1(lattice()[1]), prim_vec2(lattice()[2]);
     Array<Vector3< double > > shift;
-    Index b1, b2, b3, sh, sh1, sh2;
-    Index num_suc_maps;
+    Index sh, sh1, sh2;
     double tvol, min_vol;
     bool prim_flag = true;
     double prim_vol_tol = std::abs(0.5 * lattice().vol() / double(basis.size())); //sets a hard lower bound for the minimum value of the volume of the primitive cell
 
-    for(b1 = 1; b1 < basis.size(); b1++) {
-      tshift = basis[0] - basis[b1];
-      num_suc_maps = 0;
-      for(b2 = 0; b2 < basis.size(); b2++) {
-        for(b3 = 0; b3 < basis.size(); b3++) {
-          if(basis[b3].compare(basis[b2], tshift, prim_tol)) {
-            num_suc_maps++;
-            break;
-          }
-        }
-        if(b3 == basis.size()) {
-          break;
-        }
-      }
-      if(num_suc_maps == basis.size()) {
-        prim_flag = false;
-        shift.push_back(tshift(CART));
-      }
+    //internal_trans[0] is the zero translation
+    for(Index i = 1; i < internal_trans.size(); i++) {
+      prim_flag = false;
+      shift.push_back(basis_hash.batch().cart_from_frac(internal_trans[i]));
     }
 
     if(prim_flag) {
@@ -698,26 +680,91 @@ namespace CASM {
 
   //***********************************************************
 
+  /// Candidate basis sites are found using a spatial hash of the basis (see PeriodicSiteHash),
+  /// and then checked using compare()
   template<typename CoordType> template<typename CoordType2>
   Index BasicStructure<CoordType>::find(const CoordType2 &test_site, double tol) const {
-    for(Index i = 0; i < basis.size(); i++) {
-      if(basis[i].compare(test_site, tol)) {
-        return i;
-      }
-    }
-    return basis.size();
+    std::shared_ptr<PeriodicSiteHash> hash = _site_hash(tol);
+    return hash->find_if(hash->batch().frac_from_cart(test_site(CART)), [&](Index i) {
+      return basis[i].compare(test_site, tol);
+    });
   }
 
   //***********************************************************
 
   template<typename CoordType> template<typename CoordType2>
   Index BasicStructure<CoordType>::find(const CoordType2 &test_site, const Coordinate &shift, double tol) const {
-    for(Index i = 0; i < basis.size(); i++) {
-      if(basis[i].compare(test_site, shift, tol)) {
-        return i;
-      }
+    std::shared_ptr<PeriodicSiteHash> hash = _site_hash(tol);
+    return hash->find_if(hash->batch().frac_from_cart(test_site(CART) + shift(CART)), [&](Index i) {
+      return basis[i].compare(test_site, shift, tol);
+    });
+  }
+
+  //***********************************************************
+
+  template<typename CoordType>
+  struct BasicStructure<CoordType>::SiteHashCache {
+    SiteHashCache(const PeriodicSiteHash &_hash, Index _basis_version) :
+      hash(_hash), basis_version(_basis_version) {}
+
+    PeriodicSiteHash hash;
+    Index basis_version;
+  };
+
+  //***********************************************************
+  /// The hash is rebuilt if it does not exist, if basis.version() or the lattice has changed
+  /// since it was built, or if 'tol' is larger than the tolerance it was built for. Sites that
+  /// have been appended to basis, which does not change basis.version(), are added to a copy of
+  /// the existing hash, so that a hash is never changed after it is published.
+  ///
+  /// Concurrent calls to find() are safe as long as no thread is modifying *this
+
+  template<typename CoordType>
+  std::shared_ptr<PeriodicSiteHash> BasicStructure<CoordType>::_site_hash(double tol) const {
+    std::shared_ptr<SiteHashCache> cache = std::atomic_load(&m_site_hash);
+    bool usable = cache && cache->basis_version == basis.version() && tol <= cache->hash.tol()
+                  && cache->hash.size() <= basis.size() && cache->hash.batch().has_home(lattice());
+    if(usable && cache->hash.size() == basis.size()) {
+      return std::shared_ptr<PeriodicSiteHash>(cache, &cache->hash);
+    }
+
+    if(usable) {
+      cache = std::make_shared<SiteHashCache>(cache->hash, basis.version());
+    }
+    else {
+      cache = std::make_shared<SiteHashCache>(PeriodicSiteHash(lattice(), std::max(tol, TOL)), basis.version());
+    }
+    PeriodicSiteHash &hash(cache->hash);
+    hash.reserve(basis.size());
+    for(Index i = hash.size(); i < basis.size(); i++) {
+      hash.push_back(basis[i]);
     }
-    return basis.size();
+    std::atomic_store(&m_site_hash, cache);
+    return std::shared_ptr<PeriodicSiteHash>(cache, &hash);
+  }
+
+  //***********************************************************
+
+  template<typename CoordType>
+  PeriodicSiteHash BasicStructure<CoordType>::_typed_site_hash(double tol) const {
+    CoordinateBatch basis_batch(basis, lattice());
+    PeriodicSiteHash hash(lattice(), std::max(tol, TOL));
+    hash.reserve(basis.size());
+    for(Index i = 0; i < basis_batch.size(); i++) {
+      hash.push_back(basis_batch.frac(i), basis_batch.type(i));
+    }
+    return hash;
+  }
+
+  //***********************************************************
+  /// The first translation is always zero; structure is primitive if it is the only one
+
+  template<typename CoordType>
+  ReturnArray<Vector3<double> > BasicStructure<CoordType>::_internal_translations(const PeriodicSiteHash &basis_hash, double tol) const {
+    Array<Vector3<double> > trans;
+    Array<double> max_error;
+    basis_hash.find_translations(basis_hash.batch(), tol, trans, max_error);
+    return trans;
   }
 
   //John G 070713
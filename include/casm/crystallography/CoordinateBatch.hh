@@ -0,0 +1,172 @@
+#ifndef COORDINATEBATCH_HH
+#define COORDINATEBATCH_HH
+
+#include <iostream>
+#include <vector>
+#include <cmath>
+
+#include "casm/container/Array.hh"
+#include "casm/container/LinearAlgebra.hh"
+
+namespace CASM {
+
+  class Lattice;
+  class Coordinate;
+
+  /**
+   * CoordinateBatch stores a set of positions as contiguous arrays of fractional
+   * coordinates (one array per lattice direction) relative to a single home lattice.
+   *
+   * It is meant for the inner loops that compare one position against many others
+   * (factor group search, site lookup, mapping cost matrices). Distance kernels work
+   * directly on the fractional arrays using the metric tensor of the home lattice, so
+   * that no Coordinate temporaries or FRAC<->CART conversions are needed, and the
+   * loops are simple enough for the compiler to vectorize.
+   *
+   * Each position may carry an integer type label (see type_labels()), which the
+   * matching routines use in place of Site::compare_type.
+   *
+   * Minimum-image distances have the same meaning as Coordinate::min_dist, i.e., each
+   * fractional component of the difference vector is wrapped into [-0.5, 0.5].
+   */
+
+  class CoordinateBatch {
+  public:
+
+    /// Construct an empty CoordinateBatch that uses 'home' to define fractional coordinates
+    /// CoordinateBatch keeps a copy of the conversion matrices, not a reference to 'home'
+    explicit CoordinateBatch(const Lattice &home);
+
+    /// Construct from an Array of Coordinate, Site, etc. Positions are converted
+    /// to fractional coordinates of 'home' using their Cartesian coordinates.
+    /// Type labels are set using type_labels(coords)
+    template<typename CoordType>
+    CoordinateBatch(const Array<CoordType> &coords, const Lattice &home);
+
+    Index size() const {
+      return m_type.size();
+    }
+
+    void clear();
+
+    void reserve(Index N);
+
+    /// Add position, specified by fractional coordinates of the home lattice
+    void push_back(const Vector3<double> &frac, Index type = 0);
+
+    /// Add position of a Coordinate, using its Cartesian representation
+    void push_back(const Coordinate &coord, Index type = 0);
+
+    /// Change position 'i', specified by fractional coordinates of the home lattice
+    void set(Index i, const Vector3<double> &frac);
+
+    /// Fractional coordinates of position 'i'
+    Vector3<double> frac(Index i) const;
+
+    /// Type label of position 'i'
+    Index type(Index i) const {
+      return m_type[i];
+    }
+
+    /// Convert Cartesian coordinates to fractional coordinates of the home lattice
+    Vector3<double> frac_from_cart(const Vector3<double> &cart) const;
+
+    /// Convert fractional coordinates of the home lattice to Cartesian coordinates
+    Vector3<double> cart_from_frac(const Vector3<double> &frac) const;
+
+    /// True if 'home' is the home lattice, exactly
+    bool has_home(const Lattice &home) const;
+
+    /// Squared length of the fractional vector 'dfrac'
+    double length_sq(const Vector3<double> &dfrac) const;
+
+    /// Squared length of the shortest periodic image of the fractional vector 'dfrac'
+    double min_image_length_sq(const Vector3<double> &dfrac) const;
+
+    /// dist_sq[i] = squared distance between position 'i' and 'pos' (no periodic images)
+    /// 'pos' is in fractional coordinates, and 'dist_sq' must have room for size() values
+    void dist_sq(const Vector3<double> &pos, double *dist_sq) const;
+
+    /// dist_sq[i] = squared distance between the closest periodic images of position 'i' and 'pos'
+    /// 'pos' is in fractional coordinates, and 'dist_sq' must have room for size() values
+    void min_image_dist_sq(const Vector3<double> &pos, double *dist_sq) const;
+
+    /// Index of first position that is a periodic image of 'pos' within distance 'tol'
+    /// If 'type' is a valid index, only positions with matching type label are considered
+    /// Returns size() if no match is found
+    Index find(const Vector3<double> &pos, double tol, Index type = -1) const;
+
+    /// Same as find(pos, tol, type), but also returns minimum-image distance to the match
+    Index find(const Vector3<double> &pos, double tol, Index type, double &dist) const;
+
+    /// Index of position whose periodic image is nearest to 'pos', and the distance to it
+    /// Returns size() if *this is empty
+    Index nearest(const Vector3<double> &pos, double &dist) const;
+
+    /// Check whether translating every position of *this by 'shift' (fractional) maps it
+    /// onto a periodic image of a position in 'other' with matching type.
+    ///  - on success, perm[i] is the index in 'other' that position 'i' maps onto,
+    ///    and 'max_error' is the largest mapping distance
+    ///  - 'other' must use the same home lattice as *this
+    bool match(const CoordinateBatch &other, const Vector3<double> &shift, double tol,
+               Array<Index> &perm, double &max_error) const;
+
+  private:
+
+    /// lattice column matrix (FRAC->CART) and its inverse (CART->FRAC), row major
+    double m_lat[9], m_inv_lat[9];
+
+    /// metric tensor G = L^T * L, stored as G00, G11, G22, G01, G02, G12
+    double m_metric[6];
+
+    /// fractional coordinates, one array per lattice direction
+    std::vector<double> m_frac[3];
+
+    std::vector<Index> m_type;
+
+    /// scratch space for distance kernels
+    mutable std::vector<double> m_dist_sq;
+
+    void _set_home(const Lattice &home);
+
+    double _wrap(double x) const {
+      return x - std::floor(x + 0.5);
+    }
+
+  };
+
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  /// Assign integer labels to a list of sites such that labels[i] == labels[j]
+  /// if and only if sites[i].compare_type(sites[j])
+  template<typename CoordType>
+  ReturnArray<Index> type_labels(const Array<CoordType> &sites) {
+    Array<Index> labels, prototypes;
+    labels.reserve(sites.size());
+    for(Index i = 0; i < sites.size(); i++) {
+      Index t = 0;
+      for(; t < prototypes.size(); t++) {
+        if(sites[prototypes[t]].compare_type(sites[i]))
+          break;
+      }
+      if(t == prototypes.size())
+        prototypes.push_back(i);
+      labels.push_back(t);
+    }
+    return labels;
+  }
+
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  template<typename CoordType>
+  CoordinateBatch::CoordinateBatch(const Array<CoordType> &coords, const Lattice &home) {
+    _set_home(home);
+    Array<Index> labels(type_labels(coords));
+    reserve(coords.size());
+    for(Index i = 0; i < coords.size(); i++) {
+      push_back(coords[i], labels[i]);
+    }
+  }
+
+}
+#endif
@@ -0,0 +1,154 @@
+#ifndef PERIODICSITEHASH_HH
+#define PERIODICSITEHASH_HH
+
+#include <vector>
+
+#include "casm/crystallography/CoordinateBatch.hh"
+
+namespace CASM {
+
+  /**
+   * PeriodicSiteHash is a tolerance-aware spatial hash of a set of positions in a
+   * periodic cell, used for position -> index lookup in O(1) average time.
+   *
+   * The unit cell of the home lattice is divided into a grid of bins that are at
+   * least 'tol' wide in every direction. A query position is compared only against
+   * positions in its own bin and the neighboring bins (with periodic wrapping), so that
+   * every position with a periodic image within 'tol' of the query is a candidate.
+   *
+   * PeriodicSiteHash stores copies of the positions, not references, so it must be
+   * rebuilt if the positions or the lattice change. Positions may be appended with
+   * push_back(), and the bins are resized as needed.
+   */
+
+  class PeriodicSiteHash {
+  public:
+
+    /// Construct an empty hash, in the unit cube
+    PeriodicSiteHash();
+
+    /// Construct an empty hash for positions in the unit cell of 'home', for lookup with tolerance up to 'tol'
+    explicit PeriodicSiteHash(const Lattice &home, double tol = TOL);
+
+    /// Number of hashed positions
+    Index size() const {
+      return m_batch.size();
+    }
+
+    /// Largest tolerance that can be used for lookup
+    double tol() const {
+      return m_tol;
+    }
+
+    /// Hashed positions
+    const CoordinateBatch &batch() const {
+      return m_batch;
+    }
+
+    /// Remove all positions; size() becomes 0
+    void clear();
+
+    void reserve(Index N) {
+      m_batch.reserve(N);
+    }
+
+    /// Add a position, specified by fractional coordinates of the home lattice
+    void push_back(const Vector3<double> &frac, Index type = 0);
+
+    /// Add position of a Coordinate, using its Cartesian representation
+    void push_back(const Coordinate &coord, Index type = 0);
+
+    /// Returns the smallest index 'i' of a position that is near 'frac' and for which pred(i) is true
+    ///  - 'frac' is in fractional coordinates of the home lattice
+    ///  - every position with a periodic image within tol() of 'frac' is tested; others may be tested
+    ///  - returns size() if pred is false for all tested positions
+    template<typename UnaryPredicate>
+    Index find_if(const Vector3<double> &frac, UnaryPredicate pred) const;
+
+    /// Index of first position whose periodic image lies within 'tol' of 'frac', with matching type
+    /// If 'type' is not a valid index, type is ignored. 'tol' must not be larger than tol()
+    /// Returns size() if no match is found
+    Index find(const Vector3<double> &frac, double tol, Index type = -1) const;
+
+    /// Check whether translating every position of 'sites' by 'shift' (fractional) maps it onto
+    /// a hashed position with matching type, within distance 'tol'
+    ///  - 'sites' must use the same home lattice as *this, and have the same size
+    ///  - on success, 'max_error' is the largest mapping distance
+    bool match(const CoordinateBatch &sites, const Vector3<double> &shift, double tol, double &max_error) const;
+
+    /// Find the translations that map every position of 'sites' onto a hashed position with matching type
+    ///  - Candidates are the differences between the first hashed position with the least common type
+    ///    label and each position in 'sites' with that label, so that only as many candidates as
+    ///    there are sites of the rarest type need to be checked
+    ///  - Translations are in fractional coordinates, and are not wrapped into the unit cell
+    ///  - max_error[i] is the largest mapping distance for trans[i]
+    ///  - If 'first_only' is true, the search stops at the first successful translation
+    void find_translations(const CoordinateBatch &sites, double tol,
+                           Array<Vector3<double> > &trans, Array<double> &max_error,
+                           bool first_only = false) const;
+
+  private:
+
+    CoordinateBatch m_batch;
+
+    double m_tol;
+
+    /// distance between lattice planes, along each lattice direction, and cell volume
+    double m_height[3], m_vol;
+
+    /// number of bins along each lattice direction
+    int m_N[3];
+
+    /// distinct bin offsets to search along each direction ({0,1,-1}, or fewer for small m_N)
+    std::vector<int> m_offset[3];
+
+    /// m_bin[n] lists the indices of positions in bin n
+    std::vector<std::vector<Index> > m_bin;
+
+    /// number of positions for which the bin grid was chosen
+    Index m_capacity;
+
+    void _set_home(const Lattice &home);
+
+    /// Choose the bin grid for the current number of positions, and re-bin all positions
+    void _rebin();
+
+    int _bin(double frac, int dir) const {
+      int b = int(std::floor((frac - std::floor(frac)) * m_N[dir]));
+      return b < m_N[dir] ? b : m_N[dir] - 1;
+    }
+
+    Index _bin_index(const Vector3<double> &frac) const {
+      return _bin(frac[0], 0) + m_N[0] * (_bin(frac[1], 1) + m_N[1] * _bin(frac[2], 2));
+    }
+
+  };
+
+  //~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+
+  template<typename UnaryPredicate>
+  Index PeriodicSiteHash::find_if(const Vector3<double> &frac, UnaryPredicate pred) const {
+    Index result = size();
+    if(!size())
+      return result;
+
+    int b0 = _bin(frac[0], 0), b1 = _bin(frac[1], 1), b2 = _bin(frac[2], 2);
+    for(Index i = 0; i < m_offset[0].size(); i++) {
+      int n0 = (b0 + m_offset[0][i] + m_N[0]) % m_N[0];
+      for(Index j = 0; j < m_offset[1].size(); j++) {
+        int n1 = (b1 + m_offset[1][j] + m_N[1]) % m_N[1];
+        for(Index k = 0; k < m_offset[2].size(); k++) {
+          int n2 = (b2 + m_offset[2][k] + m_N[2]) % m_N[2];
+          const std::vector<Index> &bin(m_bin[n0 + m_N[0] * (n1 + m_N[1] * n2)]);
+          for(Index s = 0; s < bin.size(); s++) {
+            if(bin[s] < result && pred(bin[s]))
+              result = bin[s];
+          }
+        }
+      }
+    }
+    return result;
+  }
+
+}
+#endif
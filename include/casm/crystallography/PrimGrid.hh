@@ -8,12 +8,12 @@
 
 #include "casm/container/LinearAlgebra.hh"
 #include "casm/container/Permutation.hh"
+#include "casm/crystallography/UnitCellCoord.hh"
 
 
 namespace CASM {
 
   class Lattice;
-  class UnitCellCoord;
   class Coordinate;
   class SymOp;
   class SymGroup;
@@ -40,8 +40,23 @@ namespace CASM {
     /// The Smith Normal Form decomposition is: trans_mat = U*S*V, with det(U)=det(V)=1; S is diagonal
     Matrix3<int> m_U, m_invU;
 
-    /// Permutations that describe how translation permutes sites of the supercell
-    mutable Array<Permutation> m_trans_permutations;
+    /// m_uccoords[l] is uccoord(l), the UnitCellCoord of translation 'l' within the supercell
+    Array<UnitCellCoord> m_uccoords;
+
+    /// m_site_mnp[i] is the canonical (m,n,p) of site 'i' of the supercell, for all m_NB*m_N_vol sites
+    Array<Vector3<int> > m_site_mnp;
+
+    /// Integer arithmetic for combining operations of the group passed to make_permutation_representation()
+    /// with the lattice translations of the PrimGrid (used by PermuteIterator):
+    ///   m_op_mnp[ng] is the rotation part of (*m_op_group)[ng] acting on canonical (m,n,p) coordinates
+    ///   m_op_cart[ng] is the Cartesian rotation matrix of (*m_op_group)[ng]
+    ///   m_op_tau[ng] is the Cartesian translation of (*m_op_group)[ng]
+    ///   m_prod_trans[ng1*m_op_group->size()+ng2] and m_inv_trans[ng] are filled when first needed
+    mutable SymGroup const *m_op_group;
+    mutable Array<Matrix3<int> > m_op_mnp;
+    mutable Array<Eigen::Matrix3d> m_op_cart;
+    mutable Array<Eigen::Vector3d> m_op_tau;
+    mutable Array<Index> m_prod_trans, m_inv_trans;
 
     ///==============================================================================================
     /// Because
@@ -87,6 +102,35 @@ namespace CASM {
     /// U*mnp = ijk
     UnitCellCoord from_canonical(const UnitCellCoord &bmnp) const;
 
+    /// Canonical (m,n,p) of translation 'l'
+    Vector3<int> _mnp(Index l) const {
+      return Vector3<int>((l % m_stride[1]) % m_stride[0], (l % m_stride[1]) / m_stride[0], l / m_stride[1]);
+    }
+
+    /// Canonical (m,n,p) of the lattice translation of 'bijk', not mapped within bounds
+    Vector3<int> _mnp(const UnitCellCoord &bijk) const {
+      return m_invU * Vector3<int>(bijk[1], bijk[2], bijk[3]);
+    }
+
+    /// Index of translation with canonical coordinates (m,n,p), after mapping (m,n,p) within bounds
+    Index _mnp_index(Vector3<int> mnp) const {
+      for(int i = 0; i < 3; i++)
+        mnp[i] = ((mnp[i] % m_S[i]) + m_S[i]) % m_S[i];
+      return mnp[0] + mnp[1] * m_stride[0] + mnp[2] * m_stride[1];
+    }
+
+    /// Index of the translation that takes Cartesian vector 'from' to Cartesian vector 'to',
+    /// where 'to' - 'from' is a primitive lattice translation
+    Index _lattice_trans(const Eigen::Vector3d &from, const Eigen::Vector3d &to) const;
+
+    /// Fill m_uccoords and m_site_mnp
+    void _generate_index_tables();
+
+    /// Fill m_prod_trans or m_inv_trans, if not yet filled. Entries are -1 if the multiplication
+    /// table of m_op_group is not available
+    void _calc_prod_trans() const;
+    void _calc_inv_trans() const;
+
 
   public:
     PrimGrid(const Lattice &p_lat, const Lattice &s_lat, Index NB = 1);
@@ -109,7 +153,15 @@ namespace CASM {
 
     // find linear index that is translational equivalent to Coordinate or UnitCellCoord
     Index find(const Coordinate &_coord) const;
-    Index find(const UnitCellCoord &_coord) const;
+    Index find(const UnitCellCoord &_coord) const {
+      return _mnp_index(_mnp(_coord));
+    }
+
+    /// find(bijk[i]) for each 'i', using only integer arithmetic
+    ReturnArray<Index> find(const Array<UnitCellCoord> &bijk) const;
+
+    /// For each linear index 'l', the linear index that is translational equivalent to uccoord(l) + delta
+    ReturnArray<Index> find_translated(const UnitCellCoord &delta) const;
 
     // map a UnitCellCoord inside the supercell
     UnitCellCoord get_within(const UnitCellCoord &_uccoord)const;
@@ -117,7 +169,15 @@ namespace CASM {
     // get Coordinate or UnitCellCoord from linear index
     Coordinate coord(Index l, CELL_TYPE lat_mode)const;
     Coordinate coord(const UnitCellCoord &bijk, CELL_TYPE lat_mode)const;
-    UnitCellCoord uccoord(Index i)const;
+    const UnitCellCoord &uccoord(Index i) const {
+      assert(i >= 0 && i < m_N_vol && "PrimGrid::uccoord(Index i) -> index 'i' out of range!");
+      return m_uccoords[i];
+    }
+
+    /// uccoord(l) for all linear indices 'l', with bijk[0] == -1
+    const Array<UnitCellCoord> &uccoords() const {
+      return m_uccoords;
+    }
 
     Index make_permutation_representation(const SymGroup &group, Index basis_permute_rep)const;
 
@@ -125,18 +185,71 @@ namespace CASM {
     // to the origin.  NB is the number of primitive-cell basis sites. -- keep public for now
     ReturnArray<Permutation > make_translation_permutations(Index NB)const;
 
-    /// const access to m_trans_permutations. Generates permutations if they don't already exist.
-    const Array<Permutation> &translation_permutations() const {
-      if(m_trans_permutations.size() != m_NB * m_N_vol)
-        m_trans_permutations = make_translation_permutations(m_NB);
-      return m_trans_permutations;
-    }
+    /// Permutation 'l' of make_translation_permutations(NB), for the NB passed to the constructor
+    Permutation translation_permutation(Index l) const;
 
-    const Permutation &translation_permutation(Index i) const {
-      return translation_permutations()[i];
+    /// translation_permutation(l)[i], found from the canonical (m,n,p) of site 'i' and translation 'l',
+    /// so that the translation permutations never need to be stored
+    Index translation_permute_ind(Index l, Index i) const {
+      const Vector3<int> &site = m_site_mnp[i];
+      const Vector3<int> &shift = m_site_mnp[l];
+      int m = site[0] - shift[0];
+      int n = site[1] - shift[1];
+      int p = site[2] - shift[2];
+      if(m < 0)
+        m += m_S[0];
+      if(n < 0)
+        n += m_S[1];
+      if(p < 0)
+        p += m_S[2];
+      return i - (site[0] + site[1] * m_stride[0] + site[2] * m_stride[1]) + (m + n * m_stride[0] + p * m_stride[1]);
     }
 
     SymOp sym_op(Index l) const;
+
+    //  Integer arithmetic for the group passed to the most recent call of make_permutation_representation(),
+    //  so that products and inverses of (group operation, translation) pairs can be found without SymOp
+
+    /// Group for which op_matrix(), op_trans(), prod_trans(), and inverse_trans() are available, or NULL
+    SymGroup const *op_group() const;
+
+    /// Set up integer arithmetic for 'group' without making its permutation representation, as when
+    /// it was already made by another PrimGrid of the same lattices
+    void set_op_group(const SymGroup &group) const;
+
+    /// Cartesian rotation matrix of (*op_group())[ng]
+    const Eigen::Matrix3d &op_matrix(Index ng) const {
+      return m_op_cart[ng];
+    }
+
+    /// Index of translation that results from applying the rotation part of (*op_group())[ng] to translation 'l'
+    Index op_trans(Index ng, Index l) const {
+      return _mnp_index(m_op_mnp[ng] * _mnp(l));
+    }
+
+    /// Index of translation that is the sum of translations 'l1' and 'l2'
+    Index trans_sum(Index l1, Index l2) const {
+      return _mnp_index(_mnp(l1) + _mnp(l2));
+    }
+
+    /// Index of translation that is the inverse of translation 'l'
+    Index trans_inverse(Index l) const {
+      return _mnp_index(-_mnp(l));
+    }
+
+    /// Index of translation 't' such that (*op_group())[ng1]*(*op_group())[ng2] == sym_op(t)*(*op_group())[op_group()->ind_prod(ng1, ng2)]
+    /// Returns -1 if the multiplication table of op_group() is not available
+    Index prod_trans(Index ng1, Index ng2) const {
+      _calc_prod_trans();
+      return m_prod_trans[ng1 * m_op_mnp.size() + ng2];
+    }
+
+    /// Index of translation 't' such that (*op_group())[ng].inverse() == sym_op(t)*(*op_group())[op_group()->ind_inverse(ng)]
+    /// Returns -1 if the multiplication table of op_group() is not available
+    Index inverse_trans(Index ng) const {
+      _calc_inv_trans();
+      return m_inv_trans[ng];
+    }
   };
 
 }
@@ -112,6 +112,10 @@ namespace CASM {
       return m_type_prototypes;
     }
 
+    /// Type prototypes outlive the structures that they are copied from, so they
+    /// refer to this lattice instead of the lattice of the original Site
+    static const Lattice &_type_prototype_lattice();
+
     //Index into PrimClex neighbor list
     Index m_nlist_ind;     //John G 230913
     mutable Index m_type_ID;
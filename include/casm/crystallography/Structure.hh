@@ -51,9 +51,9 @@ namespace CASM {
   public: //PUBLIC METHODS
 
     //  ****Constructors****
-    Structure() : BasicStructure<Site>(), perm_rep_ID(-1), basis_perm_rep_ID(-1) {}
-    explicit Structure(const Lattice &init_lat) : BasicStructure<Site>(init_lat), perm_rep_ID(-1), basis_perm_rep_ID(-1) {}
-    explicit Structure(const BasicStructure<Site> &base) : BasicStructure<Site>(base), perm_rep_ID(-1), basis_perm_rep_ID(-1) {}
+    Structure() : BasicStructure<Site>(), perm_rep_ID(-1), basis_perm_rep_ID(-1), SD_flag(false) {}
+    explicit Structure(const Lattice &init_lat) : BasicStructure<Site>(init_lat), perm_rep_ID(-1), basis_perm_rep_ID(-1), SD_flag(false) {}
+    explicit Structure(const BasicStructure<Site> &base) : BasicStructure<Site>(base), perm_rep_ID(-1), basis_perm_rep_ID(-1), SD_flag(false) {}
     explicit Structure(const fs::path &filepath);
 
     /// Have to explicitly define the copy constructor so that factor_group
@@ -1,23 +1,17 @@
 #ifndef GEOMETRYPIECES_HH
 #define GEOMETRYPIECES_HH
 
-namespace BP {
-  class Geo;
-  template<class T> class BP_Vec;
-}
+#include "casm/CASM_global_definitions.hh"
 
 namespace CASM {
   class jsonParser;
-  template<class T> class Array;
+  class LowerHull;
 
   ///Collect all the interesting things from your hull and give it back in json format
-  jsonParser hull_data(BP::Geo &hull);
+  jsonParser hull_data(const LowerHull &hull);
   ///Collect all the interesting things from a facet on the hull and give it back in json format
-  jsonParser facet_data(BP::Geo &hull, int index);
+  jsonParser facet_data(const LowerHull &hull, Index findex);
   ///Collect all the interesting things from a index on the hull and give it back in json format
-  jsonParser vertex_data(BP::Geo &hull, int index);
-
-  ///This is horrible and should never be used
-  Array<int> BP_to_CASM(const BP::BP_Vec<int> &value);
+  jsonParser vertex_data(const LowerHull &hull, Index vindex);
 }
 #endif
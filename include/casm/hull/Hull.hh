@@ -1,14 +1,14 @@
 #ifndef CASM_Hull
 #define CASM_Hull
 
-#include "casm/BP_C++/BP_Geo.hh"
+#include "casm/hull/LowerHull.hh"
 #include "casm/clex/ConfigSelection.hh"
 
 namespace CASM {
 
   ///Run through configurations, and make a hull out of them, keeping track of the valid configurations.
   template<typename ConSelectOutputIterator>
-  bool populate_convex_hull(BP::Geo &hull,
+  bool populate_convex_hull(LowerHull &hull,
                             ConfigSelectionIterator<false, false> begin,
                             ConfigSelectionIterator<false, false> end,
                             ConSelectOutputIterator valid_config);
@@ -28,7 +28,7 @@ namespace CASM {
    * and configurations that were used to make hull.
    */
   template<typename ConSelectOutputIterator>
-  bool populate_convex_hull(BP::Geo &hull,
+  bool populate_convex_hull(LowerHull &hull,
                             ConfigSelectionIterator<false, false> begin,
                             ConfigSelectionIterator<false, false> end,
                             ConSelectOutputIterator valid_config) {
@@ -65,36 +65,19 @@ namespace CASM {
       exit(323);
     }
 
-    //We have all the energies and compositions now, which we load into a matrix (unsigned long seems overkill but w/e)
-    Index rows = compositions[0].size() + 1; //we have number of compositions + energy rows
-    Index cols = compositions.size();     //we have how ever many configurations columns
-    Eigen::MatrixXd enercomps(rows, cols);
-
-    //The matrix is sized correctly, but is empty. Now we fill in values
-    //Loop over every configuration (columns)
+    //We have all the energies and compositions now, which we load into a matrix, with
+    //one column per configuration
+    Index rows = compositions[0].size();
+    Index cols = compositions.size();
+    Eigen::MatrixXd comps(rows, cols);
+    Eigen::VectorXd enervec(cols);
     for(Index i = 0; i < cols; i++) {
-      //First stick the energy (0th row value)
-      enercomps(0, i) = energies[i];
-      //Loop over the compositions (rows after energy, start at 1th row)
-      for(Index j = 1; j < rows; j++) {
-        //Fill in composition values (all the rows after the first energy row)
-        enercomps(j, i) = compositions[i](j - 1);
-      }
+      comps.col(i) = compositions[i];
+      enervec(i) = energies[i];
     }
 
-    //Your matrix looks something like:
-    //
-    //    conf0 conf1 conf2 conf3  ...
-    //E    ...   ...   ...   ...   ...
-    //x0   ...   ...   ...   ...   ...
-    //x1   ...   ...   ...   ...   ...
-    //x2   ...   ...   ...   ...   ...
-    //...  ...   ...   ...   ...   ...
-
-    //Let the BP magic begin
-    //We start by making a BP::Geo object for our hull
-    hull.reset_points(enercomps, true); //Check for repeats is good?
-    bool hull_found = hull.calc_CH();
+    //Find the lower hull
+    bool hull_found = hull.reset(comps, enervec);
 
     return hull_found;
   }
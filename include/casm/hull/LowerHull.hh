@@ -0,0 +1,210 @@
+#ifndef CASM_LOWERHULL_HH
+#define CASM_LOWERHULL_HH
+
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/external/Eigen/Dense"
+
+namespace CASM {
+
+  /**
+   * LowerHull is the lower convex hull of a set of points in (composition, energy) space,
+   * used to find ground states and distances from the hull.
+   *
+   * Only the lower envelope is constructed:
+   *  - Of the points with the same composition, only the lowest in energy can be on the
+   *    lower hull, so the others are discarded before the hull is built.
+   *  - With one composition axis, the hull is found with a monotone chain in O(N log N).
+   *  - With more axes, large sets of points are first pruned using the hull of the lowest
+   *    energy points: only its vertices and the points below it can be vertices of the full
+   *    hull. BP::Geo then finds the hull of the remaining points, with compositions slightly
+   *    joggled to avoid degenerate vertical facets, and only the facets facing down are kept.
+   *
+   * Every facet is a simplex, stored as a plane, energy = offset + gradient.dot(comp), and the
+   * inverse of its matrix of edge vectors in composition space. The hull energy at a composition
+   * is the energy of the facet whose projection contains it, which is found by walking across
+   * neighboring facets from the nearest of a set of seed facets. Outside the composition range
+   * spanned by the hull, the hull energy is the maximum over all facet planes.
+   *
+   * Points may be added with insert(); the hull is rebuilt from the current vertices only if
+   * the new point is below the hull or outside its composition range.
+   */
+
+  class LowerHull {
+  public:
+
+    /// Construct an empty hull
+    ///  - Points within 'tol' of a facet are not vertices
+    explicit LowerHull(double tol = 1e-14);
+
+    /// Construct the lower hull of points with compositions given by the columns of 'comp',
+    /// and energies 'energy'
+    ///  - Returns false if no hull could be constructed, for instance because the points do
+    ///    not span the composition space
+    bool reset(const Eigen::MatrixXd &comp, const Eigen::VectorXd &energy);
+
+    /// Add a point, updating the hull if necessary
+    ///  - Returns false if no hull could be constructed
+    bool insert(const Eigen::VectorXd &comp, double energy);
+
+    /// Number of points
+    Index size() const {
+      return m_energy.size();
+    }
+
+    /// Number of composition axes
+    Index dim() const {
+      return m_dim;
+    }
+
+    double tol() const {
+      return m_tol;
+    }
+
+    /// Composition of point 'i'
+    Eigen::VectorXd comp(Index i) const {
+      return Eigen::Map<const Eigen::VectorXd>(m_comp.data() + m_dim * i, m_dim);
+    }
+
+    /// Energy of point 'i'
+    double energy(Index i) const {
+      return m_energy[i];
+    }
+
+    /// Indices of the points that are vertices of the hull, in increasing order
+    const std::vector<Index> &vertices() const {
+      return m_vertices;
+    }
+
+    bool is_vertex(Index i) const {
+      return m_is_vertex[i];
+    }
+
+    /// Number of facets
+    Index facets_size() const {
+      return m_facets.size();
+    }
+
+    /// Indices of the points that are the vertices of facet 'f'
+    const std::vector<Index> &facet(Index f) const {
+      return m_facets[f].verts;
+    }
+
+    /// Outward unit normal of facet 'f', as (comp, energy)
+    Eigen::VectorXd facet_normal(Index f) const;
+
+    /// True if 'comp' is within the composition range spanned by the hull
+    bool contains(const Eigen::VectorXd &comp) const {
+      return _locate(comp) >= 0;
+    }
+
+    /// Energy of the hull at composition 'comp'
+    double hull_energy(const Eigen::VectorXd &comp) const;
+
+    /// Energy above the hull of a point at composition 'comp' (negative if below the hull)
+    double dist_to_hull(const Eigen::VectorXd &comp, double energy) const {
+      return energy - hull_energy(comp);
+    }
+
+    /// Energy above the hull of point 'i'
+    ///  - 0.0 for vertices, and never negative
+    double dist_to_hull(Index i) const;
+
+  private:
+
+    struct Facet {
+
+      /// point indices
+      std::vector<Index> verts;
+
+      /// energy = offset + gradient.dot(comp)
+      Eigen::VectorXd gradient;
+      double offset;
+
+      /// barycentric coordinates of 'comp', except the first, are inv * (comp - origin)
+      Eigen::VectorXd origin;
+      Eigen::MatrixXd inv;
+
+      /// center of the projection onto composition space
+      Eigen::VectorXd center;
+
+      /// nbors[k] is the index of the facet opposite verts[k], or -1
+      std::vector<Index> nbors;
+
+      double plane(const Eigen::VectorXd &comp) const {
+        return offset + gradient.dot(comp);
+      }
+
+      /// Minimum barycentric coordinate of 'comp' in the projection onto composition space,
+      /// and in 'k' the index into 'verts' of the vertex it belongs to
+      double min_bary(const Eigen::VectorXd &comp, Index &k) const;
+
+    };
+
+    /// Of the points in 'indices', the lowest in energy at each composition
+    std::vector<Index> _lowest_by_comp(const std::vector<Index> &indices) const;
+
+    /// Of the points in 'indices', the lowest in energy in each cell of a grid with the given
+    /// origin and cell widths (a width of 0.0 puts all points in the same cell along that axis)
+    std::vector<Index> _lowest_by_cell(const std::vector<Index> &indices,
+                                       const Eigen::VectorXd &origin,
+                                       const Eigen::VectorXd &width) const;
+
+    /// Build the hull of the points in 'candidates', which must have distinct compositions
+    bool _build(const std::vector<Index> &candidates);
+
+    /// Of the points in 'candidates', those that may be vertices of their hull
+    std::vector<Index> _prune(const std::vector<Index> &candidates);
+
+    bool _build_hull(const std::vector<Index> &candidates);
+
+    bool _build_chain(std::vector<Index> candidates);
+
+    bool _build_geo(const std::vector<Index> &candidates);
+
+    /// Add a facet with vertices 'verts'
+    ///  - Returns false, and does not add it, if its projection onto composition space is degenerate
+    bool _add_facet(const std::vector<Index> &verts);
+
+    /// Find facet neighbors, and choose the seed facets for point location
+    void _connect();
+
+    /// Index of a facet whose projection contains 'comp', or -1
+    Index _locate(const Eigen::VectorXd &comp) const;
+
+    double m_tol;
+
+    Index m_dim;
+
+    /// compositions of all points, m_dim values per point
+    std::vector<double> m_comp;
+
+    std::vector<double> m_energy;
+
+    std::vector<Index> m_vertices;
+
+    std::vector<bool> m_is_vertex;
+
+    std::vector<Facet> m_facets;
+
+    /// facets where point location starts
+    std::vector<Index> m_seeds;
+
+    /// width of the composition bins used to find points with the same composition
+    static const double comp_bin;
+
+    /// tolerance for point location, in barycentric coordinates
+    static const double locate_tol;
+
+    /// size of the perturbation of compositions passed to BP::Geo, relative to the composition range
+    static const double joggle;
+
+    /// number of points used to prune large sets of candidates
+    static const Index sample_size;
+
+  };
+
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef CASM_FFT_HH
+#define CASM_FFT_HH
+
+#include <complex>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  /// \brief Discrete Fourier transform of 'n' values, data[0], data[stride], ..., data[(n-1)*stride], in place:
+  ///
+  ///   data[k*stride] <- sum_j data[j*stride] * exp(-2*pi*i*j*k/n)
+  ///
+  /// Uses mixed-radix Cooley-Tukey for the small prime factors of 'n', and Bluestein's algorithm for large
+  /// prime factors, so that the cost is O(n log n) for any 'n'.
+  void fft(std::complex<double> *data, Index n, Index stride = 1);
+
+  /// \brief Discrete Fourier transform of a 3D grid of S[0]*S[1]*S[2] values, in place:
+  ///
+  ///   data[n0 + n1*S[0] + n2*S[0]*S[1]] <- sum_m data[m0 + m1*S[0] + m2*S[0]*S[1]] * exp(-2*pi*i*(m0*n0/S[0] + m1*n1/S[1] + m2*n2/S[2]))
+  ///
+  /// This is the layout of PrimGrid linear indices in terms of Smith normal form coordinates (m,n,p)
+  void fft_3d(std::complex<double> *data, const int S[3]);
+
+}
+
+#endif
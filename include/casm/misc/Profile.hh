@@ -0,0 +1,97 @@
+#ifndef CASM_Profile_HH
+#define CASM_Profile_HH
+
+#include <iostream>
+#include <string>
+
+namespace CASM {
+
+  class jsonParser;
+
+  /// \brief Hierarchical wall-time timers and counters for profiling
+  ///
+  /// Profiling is off by default, and then a ProfileScope costs one check of a flag. When it is
+  /// on, each ProfileScope adds its wall time to a node of the same name, which is a child of the
+  /// node of the enclosing ProfileScope, so that time is reported by phase:
+  /// \code
+  /// void PrimClex::generate_supercells(int volStart, int volEnd, bool verbose) {
+  ///   ProfileScope prof("PrimClex::generate_supercells");
+  ///   ...
+  /// }
+  /// \endcode
+  ///
+  /// - Counters, incremented with Profiler::count, belong to the node of the enclosing scope
+  /// - In threads other than the one that enabled profiling, outermost scopes are children of
+  ///   the root node, and their times are summed over threads
+  /// - The root node, "total", is timed from Profiler::enable until the profile is printed
+  ///
+  /// 'casm --profile <command>' enables profiling and prints the profile when the command returns.
+  ///
+  class Profiler {
+
+  public:
+
+    static bool enabled() {
+      return m_enabled;
+    }
+
+    /// \brief Turn profiling on or off
+    ///
+    /// - Turning profiling on clears any existing profile and starts timing the root node
+    /// - Must not be called while a ProfileScope is active
+    static void enable(bool _enabled = true);
+
+    /// \brief Start timing a child of the current node, named 'name', and make it the current node
+    static void start(const std::string &name);
+
+    /// \brief Stop timing the current node, and make its parent the current node
+    static void stop();
+
+    /// \brief Add 'n' to the counter 'name' of the current node
+    static void count(const std::string &name, long n = 1);
+
+    /// \brief Print the profile as an indented table
+    static void print(std::ostream &sout);
+
+    /// \brief Write the profile as JSON
+    ///
+    /// Each node is written as:
+    /// \code
+    /// {"name": "...", "time": <seconds>, "calls": <int>, "counters": {...}, "children": [...]}
+    /// \endcode
+    static jsonParser &to_json(jsonParser &json);
+
+  private:
+
+    static bool m_enabled;
+
+  };
+
+  /// \brief Time the enclosing scope with Profiler, if profiling is enabled
+  class ProfileScope {
+
+  public:
+
+    explicit ProfileScope(const char *name) :
+      m_active(Profiler::enabled()) {
+      if(m_active)
+        Profiler::start(name);
+    }
+
+    ~ProfileScope() {
+      if(m_active)
+        Profiler::stop();
+    }
+
+  private:
+
+    ProfileScope(const ProfileScope &);
+    ProfileScope &operator=(const ProfileScope &);
+
+    bool m_active;
+
+  };
+
+}
+
+#endif
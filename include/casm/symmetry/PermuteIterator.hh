@@ -33,12 +33,9 @@ namespace CASM {
     /// permutation representation of factor group acting on sites of the supercell
     SymGroupRep::RemoteHandle m_fg_permute_rep;
 
-    /// m_prim_grid holds permutation representation of lattice translations acting on sites of the supercell
+    /// m_prim_grid provides the permutation of sites of the supercell by lattice translations
     PrimGrid const *m_prim_grid;
 
-    /// m_trans_permute points to the Array<Permutation> of translation permutations inside of m_prim_grid (to provide faster access)
-    Array<Permutation> const *m_trans_permute;
-
     Index m_factor_group_index;
     Index m_translation_index;
 
@@ -72,12 +69,15 @@ namespace CASM {
     const Permutation &factor_group_permute() const;
 
     /// Return the translation permutation being pointed at
-    const Permutation &translation_permute() const;
+    Permutation translation_permute() const;
 
     /// gets the SymOp for the current operation, defined by translation_op[trans_index]*factor_group_op[fg_index]
     /// i.e, equivalent to application of the factor group operation, FOLLOWED BY application of the translation operation
     SymOp sym_op()const;
 
+    /// Cartesian matrix of sym_op(), without constructing the SymOp
+    Eigen::Matrix3d sym_op_matrix() const;
+
     /// Index-wise permutation defined via:
     ///    after_permutation[i] = before_permutation[permutat_iterator.permute_ind(i)];
     Index permute_ind(Index i) const;
@@ -115,6 +115,11 @@ namespace CASM {
 
     friend void swap(PermuteIterator &a, PermuteIterator &b);
 
+  private:
+
+    /// True if m_prim_grid provides integer arithmetic for the factor group of m_fg_permute_rep
+    bool _has_op_arithmetic() const;
+
   };
 
   jsonParser &to_json(const PermuteIterator &clust, jsonParser &json);
@@ -4,6 +4,7 @@
 #include <iostream>
 #include <string>
 #include <iomanip>
+#include <vector>
 
 #include "casm/symmetry/SymOp.hh"
 
@@ -38,6 +39,10 @@ namespace CASM {
     /// alt_multi_table[i][j] gives index of operation that is result of at(i).inverse()*at(j)
     mutable Array<Array<Index> > alt_multi_table;
 
+    /// Dense copies of multi_table (row-major, size()*size()) and of the inverse of each operation,
+    /// used by ind_prod() and ind_inverse(). USHRT_MAX marks an invalid entry.
+    mutable std::vector<unsigned short> m_prod_table, m_inv_table;
+
     // information about conjugacy classes
     // conjugacy_classes[i][j] gives index of SymOp 'j' in class 'i'
     mutable Array<Array<Index> > conjugacy_classes;
@@ -88,6 +93,8 @@ namespace CASM {
     void generate_irrep_names() const;
     bool calc_multi_table() const;
     void calc_alt_multi_table() const;
+    bool calc_dense_prod_table() const;
+    bool calc_dense_inv_table() const;
     void calc_small_subgroups() const;
     void calc_large_subgroups() const;
 
@@ -279,6 +286,9 @@ namespace CASM {
 
     /// Add a new representation by passing a reference.  SymGroup will store a copy
     Index add_representation(const SymGroupRep &new_rep) const;
+
+    /// Delete the representation with ID 'i', if it exists. Afterwards representation(i) returns NULL
+    void remove_representation(Index i) const;
     Index get_reg_rep_ID() const;
     Index get_coord_rep_ID() const;
     SymGroupRep const *get_reg_rep() const;
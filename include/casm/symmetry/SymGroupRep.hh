@@ -186,6 +186,10 @@ namespace CASM {
       return (*m_head_group)[i];
     }
 
+    const SymGroup &head_group() const {
+      return *m_head_group;
+    }
+
     Index ind_inverse(Index i) const {
       return m_head_group->ind_inverse(i);
     }
@@ -0,0 +1,84 @@
+#ifndef Parallel_HH
+#define Parallel_HH
+
+#include <atomic>
+#include <cstdlib>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+
+namespace CASM {
+
+  /// \brief Number of threads to use for parallel loops
+  ///
+  /// - Uses the environment variable CASM_NUM_THREADS, if it is set to a positive integer
+  /// - Otherwise uses std::thread::hardware_concurrency(), or 1 if that is unknown
+  inline Index default_num_threads() {
+    const char *env = std::getenv("CASM_NUM_THREADS");
+    if(env != nullptr) {
+      long n = std::atol(env);
+      if(n > 0)
+        return n;
+    }
+    unsigned int n = std::thread::hardware_concurrency();
+    return n > 0 ? n : 1;
+  }
+
+  /// \brief Call f(i) for every i in [begin, end), distributing the calls over 'num_threads' threads
+  ///
+  /// - Thread 't' handles i = begin + t, begin + t + num_threads, ..., so that work that grows with i
+  ///   is spread evenly
+  /// - f(i) may be called concurrently for different i, so it must not modify shared state,
+  ///   except for writing to its own result slot
+  /// - If num_threads <= 1, the loop runs in the calling thread, in order
+  /// - If f(i) throws, no f(j) with j > i is started, and once all threads have finished the
+  ///   exception thrown for the smallest i is rethrown in the calling thread, as it would be by
+  ///   the serial loop
+  template<typename Function>
+  void parallel_for(Index begin, Index end, Function f, Index num_threads = default_num_threads()) {
+    if(num_threads > end - begin)
+      num_threads = end - begin;
+
+    if(num_threads <= 1) {
+      for(Index i = begin; i < end; i++)
+        f(i);
+      return;
+    }
+
+    // smallest i for which f(i) has thrown so far, and the exception thrown by each thread
+    std::atomic<Index> first_error(end);
+    std::vector<std::exception_ptr> error(num_threads);
+    std::vector<Index> error_i(num_threads, end);
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for(Index t = 0; t < num_threads; t++) {
+      threads.push_back(std::thread([ =, &f, &first_error, &error, &error_i]() {
+        for(Index i = begin + t; i < first_error.load(); i += num_threads) {
+          try {
+            f(i);
+          }
+          catch(...) {
+            error[t] = std::current_exception();
+            error_i[t] = i;
+            Index curr = first_error.load();
+            while(i < curr && !first_error.compare_exchange_weak(curr, i)) {}
+            return;
+          }
+        }
+      }));
+    }
+    for(Index t = 0; t < num_threads; t++)
+      threads[t].join();
+
+    for(Index t = 0; t < num_threads; t++) {
+      if(error[t] && error_i[t] == first_error.load())
+        std::rethrow_exception(error[t]);
+    }
+  }
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <functional>
 #include <dlfcn.h>
 #include "casm/system/Popen.hh"
+#include "casm/misc/Profile.hh"
 
 namespace CASM {
 
@@ -66,6 +67,7 @@ namespace CASM {
       file.close();
 
       // compile the source code into a dynamic library
+      ProfileScope prof("RuntimeLibrary::compile");
       Popen p;
       p.popen(m_compile_options + " -o " + m_filename_base + ".o" + " -c " + m_filename_base + ".cc");
       p.popen(m_so_options + " -o " + m_filename_base + ".so" + " " + m_filename_base + ".o");
@@ -90,6 +92,7 @@ namespace CASM {
       m_filename_base = _filename_base;
 
       // compile the source code into a dynamic library
+      ProfileScope prof("RuntimeLibrary::compile");
       Popen p;
       p.popen(m_compile_options + " -o " + m_filename_base + ".o" + " -c " + m_filename_base + ".cc");
       p.popen(m_so_options + " -o " + m_filename_base + ".so" + " " + m_filename_base + ".o");
@@ -108,6 +111,7 @@ namespace CASM {
 
       m_filename_base = _filename_base;
 
+      ProfileScope prof("RuntimeLibrary::load");
       m_handle = dlopen((m_filename_base + ".so").c_str(), RTLD_NOW);
       if(!m_handle) {
         throw std::runtime_error(std::string("Cannot open library: ") + m_filename_base + ".so");;
@@ -137,9 +141,12 @@ namespace CASM {
     /// \brief Close the current library
     ///
     /// This is also done on destruction.
-    void close() const {
+    void close() {
       // close
-      dlclose(m_handle);
+      if(m_handle != nullptr) {
+        dlclose(m_handle);
+        m_handle = nullptr;
+      }
     }
 
     /// \brief Remove the current library and source code
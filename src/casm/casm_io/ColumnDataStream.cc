@@ -0,0 +1,244 @@
+#include "casm/casm_io/ColumnDataStream.hh"
+
+#include <stdexcept>
+
+namespace CASM {
+
+  //*******************************************************************************************
+
+  DataStream &ColumnDataStream::operator<<(const std::string &val) {
+    Column &col = _next(STRING);
+    if(col.type != STRING)
+      _type_error(col, "string");
+
+    auto it = col.dict_index.find(val);
+    if(it == col.dict_index.end()) {
+      it = col.dict_index.insert(std::make_pair(val, std::uint32_t(col.dict.size()))).first;
+      col.dict.push_back(val);
+    }
+    col.code.push_back(it->second);
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  DataStream &ColumnDataStream::operator<<(long val) {
+    Column &col = _next(LONG);
+    if(col.type == LONG)
+      col.l.push_back(val);
+    else if(col.type == DOUBLE)
+      col.d.push_back(val);
+    else
+      _type_error(col, "long");
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  DataStream &ColumnDataStream::operator<<(double val) {
+    Column &col = _next(DOUBLE);
+    if(col.type != DOUBLE)
+      _type_error(col, "double");
+    col.d.push_back(val);
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  DataStream &ColumnDataStream::operator<<(bool val) {
+    Column &col = _next(BOOL);
+    if(col.type == BOOL)
+      col.c.push_back(val);
+    else if(col.type == LONG)
+      col.l.push_back(val);
+    else if(col.type == DOUBLE)
+      col.d.push_back(val);
+    else
+      _type_error(col, "bool");
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  DataStream &ColumnDataStream::operator<<(char val) {
+    Column &col = _next(CHAR);
+    if(col.type != CHAR)
+      _type_error(col, "char");
+    col.c.push_back(val);
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  DataStream &ColumnDataStream::newline() {
+    if(fail() && _skipfail()) {
+      for(Index i = 0; i < m_columns.size(); i++)
+        m_columns[i].resize(m_rows);
+      clear_fail();
+    }
+    else {
+      if(m_col != m_columns.size()) {
+        throw std::runtime_error("Attempting to stream non-rectangular data to ColumnDataStream, at row="
+                                 + std::to_string(m_rows) + ", which has " + std::to_string(m_col)
+                                 + " values, expected " + std::to_string(m_columns.size()) + "\n");
+      }
+      ++m_rows;
+    }
+    m_col = 0;
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  std::string ColumnDataStream::col_name(Index col) const {
+    if(col < m_names.size())
+      return m_names[col];
+    return "col(" + std::to_string(col) + ")";
+  }
+
+  //*******************************************************************************************
+
+  void ColumnDataStream::write(std::ostream &_stream) const {
+
+    // header and column descriptors
+    std::uint64_t offset = 32;
+    for(Index i = 0; i < m_columns.size(); i++)
+      offset += 32 + _padded(col_name(i).size());
+
+    _stream.write("CASMCOLS", 8);
+    _write_u64(_stream, 1);
+    _write_u64(_stream, m_rows);
+    _write_u64(_stream, m_columns.size());
+    for(Index i = 0; i < m_columns.size(); i++) {
+      std::string name = col_name(i);
+      std::uint64_t size = m_columns[i].data_size(m_rows);
+      _write_u64(_stream, m_columns[i].type);
+      _write_u64(_stream, offset);
+      _write_u64(_stream, size);
+      _write_u64(_stream, name.size());
+      _stream.write(name.data(), name.size());
+      _write_padding(_stream, name.size());
+      offset += size;
+    }
+
+    // column data
+    for(Index i = 0; i < m_columns.size(); i++)
+      m_columns[i].write(_stream, m_rows);
+  }
+
+  //*******************************************************************************************
+
+  void ColumnDataStream::Column::resize(Index N) {
+    switch(type) {
+    case DOUBLE:
+      d.resize(N);
+      break;
+    case LONG:
+      l.resize(N);
+      break;
+    case BOOL:
+    case CHAR:
+      c.resize(N);
+      break;
+    case STRING:
+      // unused dictionary entries are harmless
+      code.resize(N);
+      break;
+    }
+  }
+
+  //*******************************************************************************************
+
+  std::uint64_t ColumnDataStream::Column::data_size(Index N) const {
+    switch(type) {
+    case DOUBLE:
+    case LONG:
+      return 8 * N;
+    case BOOL:
+    case CHAR:
+      return _padded(N);
+    case STRING: {
+      std::uint64_t chars = 0;
+      for(Index i = 0; i < dict.size(); i++)
+        chars += dict[i].size();
+      return 8 + 8 * (dict.size() + 1) + _padded(chars) + _padded(4 * N);
+    }
+    }
+    return 0;
+  }
+
+  //*******************************************************************************************
+
+  void ColumnDataStream::Column::write(std::ostream &_stream, Index N) const {
+    switch(type) {
+    case DOUBLE:
+      _stream.write(reinterpret_cast<const char *>(d.data()), 8 * N);
+      break;
+    case LONG:
+      _stream.write(reinterpret_cast<const char *>(l.data()), 8 * N);
+      break;
+    case BOOL:
+    case CHAR:
+      _stream.write(c.data(), N);
+      _write_padding(_stream, N);
+      break;
+    case STRING: {
+      std::uint64_t chars = 0;
+      _write_u64(_stream, dict.size());
+      _write_u64(_stream, 0);
+      for(Index i = 0; i < dict.size(); i++) {
+        chars += dict[i].size();
+        _write_u64(_stream, chars);
+      }
+      for(Index i = 0; i < dict.size(); i++)
+        _stream.write(dict[i].data(), dict[i].size());
+      _write_padding(_stream, chars);
+      _stream.write(reinterpret_cast<const char *>(code.data()), 4 * N);
+      _write_padding(_stream, 4 * N);
+      break;
+    }
+    }
+  }
+
+  //*******************************************************************************************
+
+  ColumnDataStream::Column &ColumnDataStream::_next(ColumnType _type) {
+    if(m_col == m_columns.size()) {
+      if(m_rows > 0) {
+        throw std::runtime_error("Attempting to stream non-rectangular data to ColumnDataStream, at row="
+                                 + std::to_string(m_rows) + ", col=" + std::to_string(m_col) + "\n");
+      }
+      m_columns.push_back(Column(_type));
+    }
+    return m_columns[m_col++];
+  }
+
+  //*******************************************************************************************
+
+  void ColumnDataStream::_type_error(const Column &col, const std::string &value_type) const {
+    const char *type_name[] = {"double", "long", "bool", "char", "string"};
+    throw std::runtime_error("Attempting to stream a " + value_type + " value to ColumnDataStream column '"
+                             + col_name(m_col - 1) + "' of type " + type_name[col.type] + ", at row="
+                             + std::to_string(m_rows) + "\n");
+  }
+
+  //*******************************************************************************************
+
+  std::uint64_t ColumnDataStream::_padded(std::uint64_t N) {
+    return (N + 7) / 8 * 8;
+  }
+
+  //*******************************************************************************************
+
+  void ColumnDataStream::_write_u64(std::ostream &_stream, std::uint64_t val) {
+    _stream.write(reinterpret_cast<const char *>(&val), sizeof(val));
+  }
+
+  //*******************************************************************************************
+
+  void ColumnDataStream::_write_padding(std::ostream &_stream, std::uint64_t N) {
+    static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    _stream.write(zeros, _padded(N) - N);
+  }
+
+}
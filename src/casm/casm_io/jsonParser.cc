@@ -1,4 +1,6 @@
 #include "casm/casm_io/jsonParser.hh"
+#include "casm/casm_io/jsonStream.hh"
+#include "casm/misc/Profile.hh"
 
 namespace CASM {
 
@@ -247,7 +249,9 @@ namespace CASM {
   // ---- Read/Print JSON  ----------------------------------
 
   bool jsonParser::read(std::istream &stream) {
-    return json_spirit::read_stream(stream, (json_spirit::mValue &) * this);
+    ProfileScope prof("jsonParser::read");
+    jsonTreeHandler handler(*this);
+    return jsonReader::read(stream, handler);
   }
 
   bool jsonParser::read(const boost::filesystem::path &file_path) {
@@ -267,12 +271,13 @@ namespace CASM {
 
   /// Writes json to stream
   void jsonParser::print(std::ostream &stream, unsigned int indent, unsigned int prec) const {
-    json_spirit::write_stream((json_spirit::mValue &) *this, stream, indent, prec,
-                              json_spirit::pretty_print | json_spirit::single_line_arrays);
+    jsonWriter writer(stream, indent, prec);
+    writer.value(*this);
   };
 
   /// Write json to file
   void jsonParser::write(const std::string &file_name, unsigned int indent, unsigned int prec) const {
+    ProfileScope prof("jsonParser::write");
     std::ofstream file(file_name.c_str());
     print(file, indent, prec);
     file.close();
@@ -281,6 +286,7 @@ namespace CASM {
 
   /// Write json to file
   void jsonParser::write(const boost::filesystem::path &file_path, unsigned int indent, unsigned int prec) const {
+    ProfileScope prof("jsonParser::write");
     boost::filesystem::ofstream file(file_path);
     print(file, indent, prec);
     file.close();
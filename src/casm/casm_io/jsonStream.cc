@@ -0,0 +1,762 @@
+#include "casm/casm_io/jsonStream.hh"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cwctype>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace CASM {
+
+  jsonReader::jsonReader(const char *begin, const char *end) :
+    m_begin(begin), m_pos(begin), m_end(end) {}
+
+  //*******************************************************************************************
+
+  void jsonReader::parse(jsonHandler &handler) {
+    _value(handler);
+  }
+
+  //*******************************************************************************************
+
+  bool jsonReader::read(std::istream &stream, jsonHandler &handler) {
+    std::string text;
+    {
+      std::ostringstream ss;
+      ss << stream.rdbuf();
+      text = ss.str();
+    }
+    try {
+      jsonReader(text.data(), text.data() + text.size()).parse(handler);
+    }
+    catch(std::runtime_error &) {
+      return false;
+    }
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  void jsonReader::_value(jsonHandler &handler) {
+    _skip();
+    if(m_pos == m_end)
+      _error("not a value");
+
+    switch(*m_pos) {
+    case '"':
+      _string(m_str);
+      handler.string_value(m_str);
+      return;
+    case '{':
+      _object(handler);
+      return;
+    case '[':
+      _array(handler);
+      return;
+    case 't':
+      _literal("true");
+      handler.bool_value(true);
+      return;
+    case 'f':
+      _literal("false");
+      handler.bool_value(false);
+      return;
+    case 'n':
+      _literal("null");
+      handler.null_value();
+      return;
+    default:
+      _number(handler);
+      return;
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonReader::_object(jsonHandler &handler) {
+    ++m_pos;
+    handler.begin_object();
+    _skip();
+    if(m_pos != m_end && *m_pos == '}') {
+      ++m_pos;
+      handler.end_object();
+      return;
+    }
+    while(true) {
+      _skip();
+      if(m_pos == m_end || *m_pos != '"')
+        _error("not an object");
+      _string(m_str);
+      handler.key(m_str);
+      _skip();
+      if(m_pos == m_end || *m_pos != ':')
+        _error("no colon in pair");
+      ++m_pos;
+      _value(handler);
+      _skip();
+      if(m_pos != m_end && *m_pos == ',') {
+        ++m_pos;
+        continue;
+      }
+      if(m_pos != m_end && *m_pos == '}') {
+        ++m_pos;
+        handler.end_object();
+        return;
+      }
+      _error("not an object");
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonReader::_array(jsonHandler &handler) {
+    ++m_pos;
+    handler.begin_array();
+    _skip();
+    if(m_pos != m_end && *m_pos == ']') {
+      ++m_pos;
+      handler.end_array();
+      return;
+    }
+    while(true) {
+      _value(handler);
+      _skip();
+      if(m_pos != m_end && *m_pos == ',') {
+        ++m_pos;
+        continue;
+      }
+      if(m_pos != m_end && *m_pos == ']') {
+        ++m_pos;
+        handler.end_array();
+        return;
+      }
+      _error("not an array");
+    }
+  }
+
+  //*******************************************************************************************
+
+  /// Numbers with a decimal point or an exponent are doubles, others are 64-bit integers, as
+  /// for json_spirit. Unlike json_spirit, doubles are converted with strtod, so they are
+  /// correctly rounded.
+  void jsonReader::_number(jsonHandler &handler) {
+    const char *start = m_pos;
+    const char *p = m_pos;
+
+    bool neg = false;
+    bool sign = (*p == '-' || *p == '+');
+    if(sign) {
+      neg = (*p == '-');
+      ++p;
+    }
+
+    const char *digits = p;
+    std::uint64_t n = 0;
+    bool overflow = false;
+    while(p != m_end && std::isdigit((unsigned char) *p)) {
+      unsigned int d = *p - '0';
+      if(n > (std::numeric_limits<std::uint64_t>::max() - d) / 10)
+        overflow = true;
+      n = 10 * n + d;
+      ++p;
+    }
+    bool got_digits = (p != digits);
+
+    // real numbers
+    bool is_real = false;
+    if(p != m_end && *p == '.') {
+      ++p;
+      const char *frac = p;
+      while(p != m_end && std::isdigit((unsigned char) *p))
+        ++p;
+      if(p == frac && !got_digits)
+        _error("not a value");
+      is_real = true;
+    }
+    if(got_digits || is_real) {
+      if(p != m_end && (*p == 'e' || *p == 'E')) {
+        const char *exp = p + 1;
+        if(exp != m_end && (*exp == '-' || *exp == '+'))
+          ++exp;
+        const char *exp_digits = exp;
+        while(exp != m_end && std::isdigit((unsigned char) *exp))
+          ++exp;
+        if(exp != exp_digits) {
+          p = exp;
+          is_real = true;
+        }
+        else if(is_real) {
+          _error("not a value");
+        }
+      }
+    }
+
+    if(is_real) {
+      handler.double_value(std::strtod(start, nullptr));
+      m_pos = p;
+      return;
+    }
+
+    if(!got_digits)
+      _error("not a value");
+
+    if(!overflow) {
+      if(neg && n <= std::uint64_t(std::numeric_limits<std::int64_t>::max()) + 1) {
+        handler.int_value(-std::int64_t(n - 1) - 1);
+        m_pos = p;
+        return;
+      }
+      if(!neg && n <= std::uint64_t(std::numeric_limits<std::int64_t>::max())) {
+        handler.int_value(std::int64_t(n));
+        m_pos = p;
+        return;
+      }
+      if(!sign) {
+        handler.uint_value(n);
+        m_pos = p;
+        return;
+      }
+    }
+    _error("number out of range");
+  }
+
+  //*******************************************************************************************
+
+  void jsonReader::_string(std::string &str) {
+    str.clear();
+    const char *p = ++m_pos;
+    while(true) {
+
+      // copy unescaped characters in blocks
+      const char *q = p;
+      while(q != m_end && *q != '"' && *q != '\\')
+        ++q;
+      str.append(p, q);
+      p = q;
+
+      if(p == m_end) {
+        m_pos = p;
+        _error("not a string");
+      }
+      if(*p == '"') {
+        m_pos = p + 1;
+        return;
+      }
+
+      // escape sequence
+      ++p;
+      if(p == m_end) {
+        m_pos = p;
+        _error("not a string");
+      }
+      switch(*p) {
+      case 't':
+        str += '\t';
+        break;
+      case 'b':
+        str += '\b';
+        break;
+      case 'f':
+        str += '\f';
+        break;
+      case 'n':
+        str += '\n';
+        break;
+      case 'r':
+        str += '\r';
+        break;
+      case '\\':
+        str += '\\';
+        break;
+      case '/':
+        str += '/';
+        break;
+      case '"':
+        str += '"';
+        break;
+      case 'x':
+        if(m_end - p >= 3 && p[1] != '"' && p[2] != '"') {
+          str += char((_hex(p[1]) << 4) + _hex(p[2]));
+          p += 2;
+        }
+        break;
+      case 'u':
+        if(m_end - p >= 5 && std::find(p + 1, p + 5, '"') == p + 5) {
+          str += char((_hex(p[1]) << 12) + (_hex(p[2]) << 8) + (_hex(p[3]) << 4) + _hex(p[4]));
+          p += 4;
+        }
+        break;
+      default:
+        // json_spirit drops unknown escape sequences
+        break;
+      }
+      ++p;
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonReader::_literal(const char *word) {
+    Index len = std::strlen(word);
+    if(m_end - m_pos < len || std::strncmp(m_pos, word, len) != 0)
+      _error("not a value");
+    m_pos += len;
+  }
+
+  //*******************************************************************************************
+
+  void jsonReader::_skip() {
+    while(m_pos != m_end) {
+      if(std::isspace((unsigned char) * m_pos)) {
+        ++m_pos;
+      }
+      else if(*m_pos == '/' && m_end - m_pos >= 2 && m_pos[1] == '/') {
+        while(m_pos != m_end && *m_pos != '\n')
+          ++m_pos;
+      }
+      else if(*m_pos == '/' && m_end - m_pos >= 2 && m_pos[1] == '*') {
+        const char *close = std::strstr(m_pos + 2, "*/");
+        if(close == nullptr || close >= m_end)
+          return;
+        m_pos = close + 2;
+      }
+      else {
+        return;
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  void jsonReader::_error(const std::string &what) const {
+    Index line = 1;
+    const char *line_begin = m_begin;
+    for(const char *p = m_begin; p != m_pos; ++p) {
+      if(*p == '\n') {
+        ++line;
+        line_begin = p + 1;
+      }
+    }
+    throw std::runtime_error("Error reading JSON, line " + std::to_string(line) + ", column "
+                             + std::to_string(m_pos - line_begin + 1) + ": " + what);
+  }
+
+  //*******************************************************************************************
+
+  int jsonReader::_hex(char c) {
+    if(c >= '0' && c <= '9')
+      return c - '0';
+    if(c >= 'a' && c <= 'f')
+      return c - 'a' + 10;
+    if(c >= 'A' && c <= 'F')
+      return c - 'A' + 10;
+    return 0;
+  }
+
+  //*******************************************************************************************
+
+  json_spirit::mValue &jsonTreeHandler::_next() {
+    if(m_stack.empty())
+      return *m_value;
+
+    json_spirit::mValue &top = *m_stack.back();
+    if(top.type() == json_spirit::obj_type)
+      return top.get_obj()[m_key];
+
+    json_spirit::mArray &arr = top.get_array();
+    arr.push_back(json_spirit::mValue());
+    return arr.back();
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::null_value() {
+    _next() = json_spirit::mValue();
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::bool_value(bool val) {
+    _next() = json_spirit::mValue(val);
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::int_value(std::int64_t val) {
+    _next() = json_spirit::mValue(boost::int64_t(val));
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::uint_value(std::uint64_t val) {
+    _next() = json_spirit::mValue(boost::uint64_t(val));
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::double_value(double val) {
+    _next() = json_spirit::mValue(val);
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::string_value(const std::string &val) {
+    _next() = json_spirit::mValue(val);
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::begin_object() {
+    json_spirit::mValue &val = _next();
+    val = json_spirit::mValue(json_spirit::mObject());
+    m_stack.push_back(&val);
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::key(const std::string &name) {
+    m_key = name;
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::end_object() {
+    m_stack.pop_back();
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::begin_array() {
+    json_spirit::mValue &val = _next();
+    val = json_spirit::mValue(json_spirit::mArray());
+    m_stack.push_back(&val);
+  }
+
+  //*******************************************************************************************
+
+  void jsonTreeHandler::end_array() {
+    m_stack.pop_back();
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter::jsonWriter(std::ostream &stream, unsigned int indent, unsigned int prec) :
+    m_stream(stream),
+    m_indent(indent),
+    m_prec(prec),
+    m_level(0),
+    m_num(320 + prec),
+    m_after_key(false) {
+    m_buf.reserve(1 << 16);
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter::~jsonWriter() {
+    flush();
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::begin_object(bool single_line) {
+    _begin_value();
+    m_buf += '{';
+    m_stack.push_back(Frame {single_line, 0});
+    if(!single_line)
+      m_level++;
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::end_object() {
+    Frame f = m_stack.back();
+    m_stack.pop_back();
+    if(f.single_line) {
+      m_buf += " }";
+    }
+    else {
+      m_level--;
+      _newline();
+      m_buf += '}';
+    }
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::begin_array(bool single_line) {
+    _begin_value();
+    m_buf += '[';
+    m_stack.push_back(Frame {single_line, 0});
+    if(!single_line)
+      m_level++;
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::end_array() {
+    Frame f = m_stack.back();
+    m_stack.pop_back();
+    if(f.single_line) {
+      m_buf += " ]";
+    }
+    else {
+      m_level--;
+      _newline();
+      m_buf += ']';
+    }
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::key(const std::string &name) {
+    _begin_value();
+    _string(name);
+    m_buf += " : ";
+    m_after_key = true;
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::null_value() {
+    _begin_value();
+    m_buf += "null";
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::value(bool val) {
+    _begin_value();
+    m_buf += (val ? "true" : "false");
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::value(std::int64_t val) {
+    _begin_value();
+    if(val < 0) {
+      m_buf += '-';
+      _uint(std::uint64_t(-(val + 1)) + 1);
+    }
+    else {
+      _uint(val);
+    }
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::value(std::uint64_t val) {
+    _begin_value();
+    _uint(val);
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::value(double val, bool remove_trailing_zeros) {
+    _begin_value();
+    char *begin = m_num.data();
+    char *end = format_fixed(val, m_prec, begin);
+
+    // as json_spirit: keep one zero after the decimal point, "1.000" -> "1.0"
+    if(remove_trailing_zeros) {
+      Index last = end - begin - 1;
+      while(last > 0 && begin[last] == '0')
+        --last;
+      if(last != 0)
+        end = std::min(end, begin + last + (begin[last] == '.' ? 2 : 1));
+    }
+
+    m_buf.append(begin, end);
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::value(const std::string &val) {
+    _begin_value();
+    _string(val);
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  jsonWriter &jsonWriter::value(const json_spirit::mValue &val) {
+    switch(val.type()) {
+    case json_spirit::obj_type: {
+      const json_spirit::mObject &obj = val.get_obj();
+      begin_object(!val.get_force_column() && val.get_force_row());
+      for(auto it = obj.begin(); it != obj.end(); ++it) {
+        key(it->first);
+        value(it->second);
+      }
+      return end_object();
+    }
+    case json_spirit::array_type: {
+      const json_spirit::mArray &arr = val.get_array();
+      begin_array(!val.get_force_column() && (val.get_force_row() || !_has_composite(arr)));
+      for(auto it = arr.begin(); it != arr.end(); ++it)
+        value(*it);
+      return end_array();
+    }
+    case json_spirit::str_type:
+      return value(val.get_str());
+    case json_spirit::bool_type:
+      return value(val.get_bool());
+    case json_spirit::real_type:
+      return value(val.get_real(), val.get_remove_trailing_zeros());
+    case json_spirit::int_type:
+      if(val.is_uint64())
+        return value(std::uint64_t(val.get_uint64()));
+      return value(std::int64_t(val.get_int64()));
+    case json_spirit::null_type:
+      return null_value();
+    }
+    return *this;
+  }
+
+  //*******************************************************************************************
+
+  void jsonWriter::flush() {
+    m_stream.write(m_buf.data(), m_buf.size());
+    m_buf.clear();
+  }
+
+  //*******************************************************************************************
+
+  /// Integer values, the most common case for many properties, are written without snprintf
+  char *jsonWriter::format_fixed(double val, unsigned int prec, char *buf) {
+    if(std::fabs(val) < 1e15 && val == std::floor(val)) {
+      char *p = buf;
+      if(std::signbit(val))
+        *p++ = '-';
+
+      char digits[24];
+      char *d = digits;
+      std::uint64_t n = std::fabs(val);
+      do {
+        *d++ = '0' + n % 10;
+        n /= 10;
+      }
+      while(n != 0);
+      while(d != digits)
+        *p++ = *--d;
+
+      *p++ = '.';
+      std::memset(p, '0', prec);
+      return p + prec;
+    }
+    return buf + std::sprintf(buf, "%#.*f", int(prec), val);
+  }
+
+  //*******************************************************************************************
+
+  void jsonWriter::_begin_value() {
+    if(m_after_key) {
+      m_after_key = false;
+      return;
+    }
+    if(m_stack.empty())
+      return;
+
+    if(m_buf.size() >= (1 << 16))
+      flush();
+
+    Frame &f = m_stack.back();
+    if(f.size++ > 0)
+      m_buf += ',';
+    if(f.single_line)
+      m_buf += ' ';
+    else
+      _newline();
+  }
+
+  //*******************************************************************************************
+
+  void jsonWriter::_newline() {
+    m_buf += '\n';
+    m_buf.append(m_indent * m_level, ' ');
+  }
+
+  //*******************************************************************************************
+
+  /// Escapes characters as json_spirit does by default: non-printable characters are written
+  /// as "\uXXXX"
+  void jsonWriter::_string(const std::string &str) {
+    static const char hex[] = "0123456789ABCDEF";
+    m_buf += '"';
+    for(auto it = str.begin(); it != str.end(); ++it) {
+      char c = *it;
+      switch(c) {
+      case '"':
+        m_buf += "\\\"";
+        continue;
+      case '\\':
+        m_buf += "\\\\";
+        continue;
+      case '\b':
+        m_buf += "\\b";
+        continue;
+      case '\f':
+        m_buf += "\\f";
+        continue;
+      case '\n':
+        m_buf += "\\n";
+        continue;
+      case '\r':
+        m_buf += "\\r";
+        continue;
+      case '\t':
+        m_buf += "\\t";
+        continue;
+      }
+      unsigned int u = (unsigned char) c;
+      if((u >= 0x20 && u < 0x7F) || std::iswprint(u)) {
+        m_buf += c;
+      }
+      else {
+        m_buf += "\\u00";
+        m_buf += hex[u >> 4];
+        m_buf += hex[u & 0xF];
+      }
+    }
+    m_buf += '"';
+  }
+
+  //*******************************************************************************************
+
+  void jsonWriter::_uint(std::uint64_t val) {
+    char digits[24];
+    char *d = digits;
+    do {
+      *d++ = '0' + val % 10;
+      val /= 10;
+    }
+    while(val != 0);
+    while(d != digits)
+      m_buf += *--d;
+  }
+
+  //*******************************************************************************************
+
+  bool jsonWriter::_has_composite(const json_spirit::mArray &arr) {
+    for(auto it = arr.begin(); it != arr.end(); ++it) {
+      if(it->type() == json_spirit::obj_type || it->type() == json_spirit::array_type)
+        return true;
+    }
+    return false;
+  }
+
+}
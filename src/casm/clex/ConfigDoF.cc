@@ -4,6 +4,7 @@
 #include "casm/clex/Correlation.hh"
 #include "casm/clex/Clexulator.hh"
 #include "casm/clex/Supercell.hh"
+#include "casm/misc/Profile.hh"
 
 
 namespace CASM {
@@ -201,7 +202,7 @@ namespace CASM {
     displacement_matrix_t new_disp;
 
     while(it_begin != it_end) {
-      fg_cart_op = it_begin.sym_op().get_matrix(CART);
+      fg_cart_op = it_begin.sym_op_matrix();
       it_next_fg = it_begin.begin_next_fg_op();
 
       bool proceed_to_next = false;
@@ -367,6 +368,7 @@ namespace CASM {
   /// This version calculates the factor group of the configuration, but only if it is canonical (i.e., returns true), since loop terminates
   /// early otherwise.  This private method uses the pointer fg_ptr so that we only need one implementation for the various different public methods above
   bool ConfigDoF::_is_canonical(PermuteIterator it_begin, PermuteIterator it_end, Array<PermuteIterator> *fg_ptr, double tol) const {
+    ProfileScope prof("ConfigDoF::is_canonical");
 
     if(fg_ptr)
       fg_ptr->clear();
@@ -381,7 +383,7 @@ namespace CASM {
 
     while(it_begin != it_end) {
       bool skip_to_next_op = false;
-      fg_cart_op = it_begin.sym_op().get_matrix(CART);
+      fg_cart_op = it_begin.sym_op_matrix();
       it_next_fg = it_begin.begin_next_fg_op();
 
       // check for canonical strain first, since it is fastest
@@ -479,6 +481,7 @@ namespace CASM {
 
   ConfigDoF ConfigDoF::_canonical_form(PermuteIterator it_begin, PermuteIterator it_end,
                                        PermuteIterator &it_canon, Array<PermuteIterator> *fg_ptr, double tol) const {
+    ProfileScope prof("ConfigDoF::canonical_form");
     // canonical form is 'largest-valued' configuration bitstring
     if(fg_ptr)
       fg_ptr->clear();
@@ -495,7 +498,7 @@ namespace CASM {
     displacement_matrix_t new_disp;
 
     while(it_begin != it_end) {
-      fg_cart_op = it_begin.sym_op().get_matrix(CART);
+      fg_cart_op = it_begin.sym_op_matrix();
       it_next_fg = it_begin.begin_next_fg_op();
 
       bool skip_to_next_op = false;
@@ -672,7 +675,7 @@ namespace CASM {
 
   ConfigDoF operator*(const PermuteIterator &it, const ConfigDoF &dof) {
     ConfigDoF tconfig(dof.size());
-    Eigen::Matrix3d fg_cart_op = it.sym_op().get_matrix(CART);
+    Eigen::Matrix3d fg_cart_op = it.sym_op_matrix();
     if(dof.is_strained())
       tconfig.set_deformation(fg_cart_op * dof.deformation() * fg_cart_op.transpose());
 
@@ -698,11 +701,28 @@ namespace CASM {
 
   /// \brief Returns correlations using 'clexulator'. Supercell needs a correctly populated neighbor list.
   Correlation correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator) {
+    Correlation correlations(clexulator.corr_size(), 0.0);
+
+    //Holds contribution to global correlations from a particular neighborhood
+    std::vector<double> tcorr(clexulator.corr_size(), 0.0);
+
+    calc_correlations(configdof, scel, clexulator, correlations.begin(), tcorr.data());
+
+    return correlations;
+  }
+
+  //*******************************************************************************
+
+  void calc_correlations(const ConfigDoF &configdof, const Supercell &scel, Clexulator &clexulator,
+                         double *corr_begin, double *tcorr_begin) {
+    ProfileScope prof("correlations");
 
     //Size of the supercell will be used for normalizing correlations to a per primitive cell value
     int scel_vol = scel.volume();
+    Index corr_size = clexulator.corr_size();
 
-    Correlation correlations(clexulator.corr_size(), 0.0);
+    for(Index i = 0; i < corr_size; i++)
+      corr_begin[i] = 0.0;
 
     //Inform Clexulator of the bitstring
 
@@ -711,31 +731,25 @@ namespace CASM {
     //mc_clexor.set_config_disp(mc_confdof.m_displacements.begin());   //or whatever
     //mc_clexor.set_config_strain(mc_confdof.m_strain.begin());   //or whatever
 
-    //Holds contribution to global correlations from a particular neighborhood
-    std::vector<double> tcorr(clexulator.corr_size(), 0.0);
-    //std::vector<double> corr(clexulator.corr_size(), 0.0);
-
     for(int v = 0; v < scel_vol; v++) {
 
       //Point the Clexulator to the right neighborhood
       clexulator.set_nlist(scel.get_nlist(v).begin());
 
       //Fill up contributions
-      clexulator.calc_global_corr_contribution(&tcorr[0]);
+      clexulator.calc_global_corr_contribution(tcorr_begin);
 
       //Add contributions to total correlations
-      for(int i = 0; i < tcorr.size(); i++) {
-        correlations[i] += tcorr[i];
+      for(Index i = 0; i < corr_size; i++) {
+        corr_begin[i] += tcorr_begin[i];
       }
 
     }
 
     // normalize by supercell volume
-    for(int i = 0; i < clexulator.corr_size(); i++) {
-      correlations[i] /= (double) scel_vol;
+    for(Index i = 0; i < corr_size; i++) {
+      corr_begin[i] /= (double) scel_vol;
     }
-
-    return correlations;
   }
 
 
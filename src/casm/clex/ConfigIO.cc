@@ -114,7 +114,7 @@ namespace CASM {
 
     void CorrConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
 
-      Correlation corr = correlations(_config, m_clexulator);
+      const Correlation &corr = _correlations(_config);
 
       //Cases
       if(_index_rules().size() == 0) {
@@ -138,7 +138,7 @@ namespace CASM {
 
     void CorrConfigFormatter::print(const Configuration &_config, std::ostream &_stream, Index) const {
 
-      Correlation corr = correlations(_config, m_clexulator);
+      const Correlation &corr = _correlations(_config);
 
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
@@ -164,7 +164,7 @@ namespace CASM {
     //****************************************************************************************
 
     jsonParser &CorrConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = correlations(_config, m_clexulator);
+      json = _correlations(_config);
       return json;
     }
 
@@ -175,6 +175,36 @@ namespace CASM {
       }
     };
 
+    //****************************************************************************************
+
+    void CorrConfigFormatter::precompute(const Array<const Configuration *> &config) {
+      if(!config.size())
+        return;
+      init(*config[0]);
+
+      std::map<const Configuration *, Index> index;
+      for(Index i = 0; i < config.size(); i++)
+        index.insert(std::make_pair(config[i], i));
+      m_bulk_corr = std::make_shared<const Eigen::MatrixXd>(correlations(config, m_clexulator));
+      m_bulk_index = std::make_shared<const std::map<const Configuration *, Index> >(std::move(index));
+    }
+
+    //****************************************************************************************
+    const Correlation &CorrConfigFormatter::_correlations(const Configuration &_config) const {
+      m_corr.resize(m_clexulator.corr_size());
+      if(m_bulk_index) {
+        auto it = m_bulk_index->find(&_config);
+        if(it != m_bulk_index->end()) {
+          for(Index i = 0; i < m_corr.size(); i++)
+            m_corr[i] = (*m_bulk_corr)(i, it->second);
+          return m_corr;
+        }
+      }
+      m_tcorr.resize(m_clexulator.corr_size());
+      calc_correlations(_config.configdof(), _config.get_supercell(), m_clexulator, m_corr.begin(), m_tcorr.data());
+      return m_corr;
+    }
+
     //****************************************************************************************
     bool ClexConfigFormatter::parse_args(const std::string &args) {
       if(m_clex_name.size())
@@ -202,7 +232,7 @@ namespace CASM {
     //****************************************************************************************
 
     void ClexConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
-      _stream << m_eci *correlations(_config, m_clexulator);
+      _stream << m_eci *_correlations(_config);
     }
 
     //****************************************************************************************
@@ -211,17 +241,26 @@ namespace CASM {
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
 
-      _stream << m_eci *correlations(_config, m_clexulator);
+      _stream << m_eci *_correlations(_config);
 
     }
 
     //****************************************************************************************
 
     jsonParser &ClexConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      json = m_eci * correlations(_config, m_clexulator);
+      json = m_eci * _correlations(_config);
       return json;
     }
 
+    //****************************************************************************************
+
+    const Correlation &ClexConfigFormatter::_correlations(const Configuration &_config) const {
+      m_corr.resize(m_clexulator.corr_size());
+      m_tcorr.resize(m_clexulator.corr_size());
+      calc_correlations(_config.configdof(), _config.get_supercell(), m_clexulator, m_corr.begin(), m_tcorr.data());
+      return m_corr;
+    }
+
     //****************************************************************************************
     bool SiteFracConfigFormatter::parse_args(const std::string &args) {
       if(args.size() > 0)
@@ -230,7 +269,8 @@ namespace CASM {
     }
     //****************************************************************************************
     void SiteFracConfigFormatter::init(const Configuration &_tmplt) const {
-      Array<Molecule> struc_molecule = _tmplt.get_primclex().get_prim().get_struc_molecule();
+      const Array<Molecule> &struc_molecule = _tmplt.get_primclex().get_struc_molecule();
+      _tmplt.get_primclex().populate_composition();
       if(m_mol_names.size() == 0) {
         for(Index i = 0; i < struc_molecule.size(); i++) {
           _add_rule(std::vector<Index>({i}));
@@ -310,7 +350,8 @@ namespace CASM {
     //****************************************************************************************
 
     void AtomFracConfigFormatter::init(const Configuration &_tmplt) const {
-      Array<Molecule> struc_molecule = _tmplt.get_primclex().get_prim().get_struc_molecule();
+      const Array<Molecule> &struc_molecule = _tmplt.get_primclex().get_struc_molecule();
+      _tmplt.get_primclex().populate_composition();
       if(m_mol_names.size() == 0) {
         for(Index i = 0; i < struc_molecule.size(); i++) {
           _add_rule(std::vector<Index>({i}));
@@ -395,6 +436,7 @@ namespace CASM {
     //****************************************************************************************
 
     void CompConfigFormatter::init(const Configuration &_tmplt) const {
+      _tmplt.get_primclex().populate_composition();
 
       Index Nind = _tmplt.get_param_composition().size();
       if(_index_rules().size() == 0) {
@@ -1,4 +1,5 @@
 #include <functional>
+#include <sstream>
 #include "casm/casm_io/EigenDataStream.hh"
 #include "casm/clex/ConfigIterator.hh"
 #include "casm/clex/ConfigIO.hh"
@@ -26,12 +27,30 @@ namespace CASM {
       // grabs the name for each row
       hull_props.push_back("configname");
 
+      m_format = ConfigIOParser::parse(hull_props);
+
+      // the hull depends only on the PrimClex, the selection and hull_props
+      std::stringstream key;
+      key << "hull(" << &_tmplt.get_primclex() << "," << m_selection;
+      for(Index i = 0; i < hull_props.size(); i++)
+        key << "," << hull_props[i];
+      key << ")";
+
+      m_hull_data = ConfigIOParser::cache().get<HullData>(key.str(), [&]() {
+        return _make_hull_data(_tmplt);
+      });
+    }
+
+    //****************************************************************************************
+
+    std::shared_ptr<BaseHullConfigFormatter::HullData> BaseHullConfigFormatter::_make_hull_data(const Configuration &_tmplt) const {
+      std::shared_ptr<HullData> data(new HullData());
+
       // setup DataStream
       //    -- fills a matrix so that each row corresponds to a configuration and pushes the confignames into an array
       //    -- columns of matrix correspond to {$extensive_quantity1, $extensive_quantity2, ..., $energy_metric}
       //    -- initialized with DataStram::skipfail -> skip configs that are missing any of the necessary data
       LabeledMatrixXdDataStream mat_wrapper(DataStream::skipfail);
-      m_format = ConfigIOParser::parse(hull_props);
 
       // Cases control which configurations to use for obtaining hull data
       if(m_selection == "all")
@@ -56,48 +75,40 @@ namespace CASM {
           break;
       }
       //std::cout << "compcovar matrix is\n" << compcovar << "\n\n and U matrix is \n" << tsvd.matrixU() << "\n\n";
-      m_projection.resize(rank + 1, numcomps + 1);
-      m_projection << tsvd.matrixU().topRows(rank), Eigen::MatrixXd::Zero(rank, 1),
-                   Eigen::MatrixXd::Zero(1, numcomps), 1.0;
+      data->projection.resize(rank + 1, numcomps + 1);
+      data->projection << tsvd.matrixU().topRows(rank), Eigen::MatrixXd::Zero(rank, 1),
+                       Eigen::MatrixXd::Zero(1, numcomps), 1.0;
 
       //std::cout << "Size before: " << mat_wrapper.matrix().rows() << ", " << mat_wrapper.matrix().cols() << "\n";
 
       // ***The following two lines turn off optimal projection***
       // ***Delete them after convex hull is fixed***
-      m_projection = Eigen::MatrixXd::Identity(numcomps + 1, numcomps + 1);
+      data->projection = Eigen::MatrixXd::Identity(numcomps + 1, numcomps + 1);
       rank = numcomps;
 
-      Eigen::MatrixXd reduced_mat(m_projection * mat_wrapper.matrix().transpose());
+      Eigen::MatrixXd reduced_mat(data->projection * mat_wrapper.matrix().transpose());
       //std::cout << "Size after: " << reduced_mat.rows() << ", " << reduced_mat.cols() << "\n";
-      //std::cout << "reduced_mat is \n" << reduced_mat.transpose() << "\n\n and projection is \n" << m_projection << "\n\n";
-      m_hull.set_verbosity(0);
+      //std::cout << "reduced_mat is \n" << reduced_mat.transpose() << "\n\n and projection is \n" << data->projection << "\n\n";
 
-      //(using check_for_repeats=false doesn't seem to be an improvement)
-      m_hull.reset_points(reduced_mat, true);
-
-      if(!m_hull.calc_CH()) { //calculates hull
+      // the last row is the energy, which is the direction that is down
+      if(!data->hull.reset(reduced_mat.topRows(rank), reduced_mat.row(rank).transpose())) { //calculates hull
         throw std::runtime_error("Failure to construct convex hull from selection " + m_selection
                                  + " for formatted output!\n");
       }
 
-      // define which direction is down
-      Eigen::VectorXd down = Eigen::VectorXd::Zero(rank + 1);
-      down(rank) = -1;
-      m_hull.CH_bottom(down);
-
-
-      /*
-      for(Index i=0; i<m_hull.size(); i++){
-        std::cout << "  i" << i<<":  " << reduced_mat.col(i).transpose() << "   " << mat_wrapper.matrix().row(i) << "   " <<m_hull.pos(i).transpose() << "   " << m_hull.CH_dist_to_hull(m_hull.pos(i)) << "\n";
-        }*/
-
-
       // record names of on-hull configs
-      auto hull_inds = m_hull.CH_verts_indices();
+      const std::vector<Index> &hull_inds = data->hull.vertices();
       for(Index i = 0; i < hull_inds.size(); i++) {
-        m_on_hull[mat_wrapper.labels()[hull_inds[i]]] = true;
+        data->on_hull[mat_wrapper.labels()[hull_inds[i]]] = true;
+      }
+
+      // record distances, so that configurations in the selection need not be evaluated again
+      for(Index i = 0; i < reduced_mat.cols(); i++) {
+        data->hull_dist[mat_wrapper.labels()[i]] =
+          data->hull.dist_to_hull(reduced_mat.col(i).head(rank), reduced_mat(rank, i));
       }
 
+      return data;
     }
 
     //****************************************************************************************
@@ -130,6 +141,14 @@ namespace CASM {
 
     //****************************************************************************************
 
+    double BaseHullConfigFormatter::_hull_dist(const Eigen::MatrixXd &data) const {
+      Eigen::VectorXd point(_projection() * data.transpose());
+      Index rank = point.size() - 1;
+      return _hull().dist_to_hull(point.head(rank), point(rank));
+    }
+
+    //****************************************************************************************
+
     void OnHullConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
       _stream << (_on_hull().find(_config.name()) != _on_hull().cend());
     }
@@ -149,6 +168,23 @@ namespace CASM {
 
     //****************************************************************************************
 
+    bool BaseHullConfigFormatter::_hull_dist(const Configuration &_config, double &result) const {
+      auto it = m_hull_data->hull_dist.find(_config.name());
+      if(it != m_hull_data->hull_dist.end()) {
+        result = it->second;
+        return true;
+      }
+
+      MatrixXdDataStream mat_wrapper;
+      mat_wrapper << _format()(_config);
+      if(mat_wrapper.fail())
+        return false;
+      result = _hull_dist(mat_wrapper.matrix());
+      return true;
+    }
+
+    //****************************************************************************************
+
     bool HullDistConfigFormatter::validate(const Configuration &_config)const {
       return _format().validate(_config);
     }
@@ -156,12 +192,11 @@ namespace CASM {
     //****************************************************************************************
 
     void HullDistConfigFormatter::inject(const Configuration &_config, DataStream &_stream, Index) const {
-      MatrixXdDataStream mat_wrapper;
-      mat_wrapper << _format()(_config);
-      if(mat_wrapper.fail())
+      double dist;
+      if(!_hull_dist(_config, dist))
         _stream << DataStream::failbit << double(NAN);
       else
-        _stream << _hull().CH_dist_to_hull(Eigen::VectorXd(_projection()*mat_wrapper.matrix().transpose()));
+        _stream << dist;
     }
 
     //****************************************************************************************
@@ -170,28 +205,22 @@ namespace CASM {
       _stream.flags(std::ios::showpoint | std::ios::fixed | std::ios::right);
       _stream.precision(8);
 
-      MatrixXdDataStream mat_wrapper;
-      mat_wrapper << _format()(_config);
-      //std::cout << "mat_wrapper.matrix() is " << mat_wrapper.matrix() << "\n";
-      //std::cout << "rotated, is " << (_projection()*mat_wrapper.matrix().transpose()).transpose() << "\n";
-      //std::cout << "projection is \n" << _projection() << "\n";
-      if(mat_wrapper.fail())
+      double dist;
+      if(!_hull_dist(_config, dist))
         _stream << "unknown";
       else
-        _stream << _hull().CH_dist_to_hull(Eigen::VectorXd(_projection()*mat_wrapper.matrix().transpose()));
+        _stream << dist;
     }
 
     //****************************************************************************************
 
     jsonParser &HullDistConfigFormatter::to_json(const Configuration &_config, jsonParser &json)const {
-      MatrixXdDataStream mat_wrapper;
-      mat_wrapper << _format()(_config);
-      if(mat_wrapper.fail())
+      double dist;
+      if(!_hull_dist(_config, dist))
         json = "unknown";
       else
-        json = _hull().CH_dist_to_hull(Eigen::VectorXd(_projection() * mat_wrapper.matrix().transpose()));
+        json = dist;
       return json;
     }
   }
 }
-
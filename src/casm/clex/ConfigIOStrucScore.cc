@@ -1,4 +1,5 @@
 #include <functional>
+#include <iomanip>
 #include <boost/algorithm/string.hpp>
 #include "casm/casm_io/EigenDataStream.hh"
 #include "casm/crystallography/Structure.hh"
@@ -28,8 +29,6 @@ namespace CASM {
           throw std::runtime_error("Attempted to initialize format tag " + name()
                                    + " invalid file path '" + m_prim_path.string() + "'. File does not exist.\n");
         }
-
-        m_altprimclex = PrimClex(Structure(m_prim_path));
       }
       for(Index i = 1; i < splt_vec.size(); ++i) {
         if(splt_vec[i] != "basis_score" && splt_vec[i] != "lattice_score") {
@@ -51,6 +50,20 @@ namespace CASM {
 
     //****************************************************************************************
 
+    void StrucScoreConfigFormatter::init(const Configuration &_tmplt) const {
+      m_altprimclex = ConfigIOParser::cache().get<PrimClex>("struc_score(" + m_prim_path.string() + ")", [&]() {
+        return std::make_shared<PrimClex>(Structure(m_prim_path));
+      });
+
+      std::stringstream key;
+      key << "struc_score(" << &_tmplt.get_primclex() << "," << m_prim_path.string() << "," << std::setprecision(17) << m_lattice_weight << ")";
+      m_scores = ConfigIOParser::cache().get<ScoreMap>(key.str(), []() {
+        return std::make_shared<ScoreMap>();
+      });
+    }
+
+    //****************************************************************************************
+
     bool StrucScoreConfigFormatter::validate(const Configuration &_config) const {
       return fs::exists(_config.calc_properties_path());
     }
@@ -77,8 +90,12 @@ namespace CASM {
     }
 
     //****************************************************************************************
-    std::vector<double> StrucScoreConfigFormatter::_evaluate(const Configuration &_config)const {
-      std::vector<double> result_vec;
+    const std::vector<double> &StrucScoreConfigFormatter::_scores(const Configuration &_config) const {
+      auto it = m_scores->find(_config.name());
+      if(it != m_scores->end())
+        return it->second;
+
+      std::vector<double> scores;
 
       BasicStructure<Site> relaxed_struc;
       ConfigDoF mapped_configdof;
@@ -86,17 +103,25 @@ namespace CASM {
 
       from_json(simple_json(relaxed_struc, "relaxed_"), jsonParser(_config.calc_properties_path()));
 
-      if(!struc_to_configdof(relaxed_struc, m_altprimclex, mapped_configdof, mapped_lat, true, true, TOL, m_lattice_weight)) {
-        for(Index i = 0; i < m_prop_names.size(); i++) {
-          result_vec.push_back(1e9);
-        }
-        return result_vec;
+      if(!struc_to_configdof(relaxed_struc, *m_altprimclex, mapped_configdof, mapped_lat, true, true, TOL, m_lattice_weight)) {
+        scores = std::vector<double>(2, 1e9);
+      }
+      else {
+        scores.push_back(ConfigMapping::basis_cost(mapped_configdof));
+        scores.push_back(ConfigMapping::strain_cost(relaxed_struc.lattice(), mapped_configdof));
       }
+      return (*m_scores)[_config.name()] = scores;
+    }
+
+    //****************************************************************************************
+    std::vector<double> StrucScoreConfigFormatter::_evaluate(const Configuration &_config)const {
+      std::vector<double> result_vec;
+      const std::vector<double> &scores = _scores(_config);
       for(Index i = 0; i < m_prop_names.size(); i++) {
         if(m_prop_names[i] == "basis_score")
-          result_vec.push_back(ConfigMapping::basis_cost(mapped_configdof));
+          result_vec.push_back(scores[0]);
         else if(m_prop_names[i] == "lattice_score")
-          result_vec.push_back(ConfigMapping::strain_cost(relaxed_struc.lattice(), mapped_configdof));
+          result_vec.push_back(scores[1]);
       }
 
       return result_vec;
@@ -3,7 +3,9 @@
 #include "casm/strain/StrainConverter.hh"
 #include "casm/crystallography/Lattice.hh"
 #include "casm/crystallography/LatticeMap.hh"
+#include "casm/crystallography/CoordinateBatch.hh"
 #include "casm/crystallography/SupercellEnumerator.hh"
+#include "casm/misc/Profile.hh"
 
 namespace CASM {
   //*******************************************************************************************
@@ -285,6 +287,8 @@ namespace CASM {
                           double lattice_weight,
                           double vol_tol) {
 
+    ProfileScope prof("struc_to_configdof");
+
     bool valid_mapping(false);
     // If structure's lattice is a supercell of the primitive lattice, then import as ideal_structure
     if(!robust_flag && struc.lattice().is_supercell_of(pclex.get_prim().lattice(), _tol)) {
@@ -555,21 +559,35 @@ namespace CASM {
     //if(cost_matrix.rows()!=scel.num_sites() || cost_matrix.cols()!=scel.num_sites())
     cost_matrix = Eigen::MatrixXd::Constant(scel.num_sites(), scel.num_sites(), inf);
     Index inf_counter;
-    double dist;
+
+    // Fractional coordinates of the ideal supercell sites, relative to the supercell lattice
+    CoordinateBatch ideal_batch(scel.get_real_super_lattice());
+    ideal_batch.reserve(scel.num_sites());
+    for(Index i = 0; i < scel.num_sites(); i++) {
+      ideal_batch.push_back(scel.coord(i));
+    }
+    std::vector<double> dist_sq(scel.num_sites());
+    Array<bool> allowed(scel.basis_size());
+
     // loop through all the sites of the structure
     Index j = 0;
     for(; j < rstruc.basis.size(); j++) {
-      Coordinate current_relaxed_coord(rstruc.basis[j](FRAC), scel.get_real_super_lattice(), FRAC);
-      current_relaxed_coord(CART) += trans(CART);
+      Vector3<double> current_relaxed_coord(ideal_batch.frac_from_cart(ideal_batch.cart_from_frac(rstruc.basis[j](FRAC)) + trans(CART)));
+      ideal_batch.min_image_dist_sq(current_relaxed_coord, dist_sq.data());
+
+      // Check if relaxed atom j is allowed on each sublattice
+      for(Index b = 0; b < scel.basis_size(); b++) {
+        allowed[b] = scel.get_prim().basis[b].contains(rstruc.basis[j].occ_name());
+      }
+
       // loop through all the sites in the supercell
       inf_counter = 0;
       for(Index i = 0; i < scel.num_sites(); i++) {
 
         // Check if relaxed atom j is allowed on site i
         // If so, populate cost_matrix normally
-        if(scel.get_prim().basis[scel.get_b(i)].contains(rstruc.basis[j].occ_name())) {
-          dist = scel.coord(i).min_dist(current_relaxed_coord);
-          cost_matrix(i, j) = dist * dist;
+        if(allowed[scel.get_b(i)]) {
+          cost_matrix(i, j) = dist_sq[i];
         }
         // If not, set cost_matrix (i,j) = inf
         else {
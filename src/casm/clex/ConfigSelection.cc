@@ -1,7 +1,10 @@
 #include "casm/clex/ConfigSelection.hh"
 
+#include <cmath>
+#include <map>
 #include <regex>
 
+#include "casm/system/Parallel.hh"
 #include "casm/clex/Supercell.hh"
 #include "casm/clex/PrimClex.hh"
 #include "casm/clex/ConfigIterator.hh"
@@ -9,20 +12,22 @@
 namespace CASM {
 
   template<>
-  ConfigSelection<false>::ConfigSelection(typename ConfigSelection<false>::PrimClexType &_primclex)
-    : m_primclex(&_primclex) {
-    m_col_headers.clear();
-    for(auto it = _primclex.config_begin(); it != _primclex.config_end(); ++it) {
-      m_config[it->name()] = it->selected();
+  ConfigSelection<false>::ConfigSelection(typename ConfigSelection<false>::PrimClexType &_primclex) {
+    _init(_primclex);
+    m_listed.set();
+    Index ord = 0;
+    for(auto it = _primclex.config_begin(); it != _primclex.config_end(); ++it, ++ord) {
+      m_selected[ord] = it->selected();
     }
   }
 
   template<>
-  ConfigSelection<true>::ConfigSelection(typename ConfigSelection<true>::PrimClexType &_primclex)
-    : m_primclex(&_primclex) {
-    m_col_headers.clear();
-    for(auto it = _primclex.config_cbegin(); it != _primclex.config_cend(); ++it) {
-      m_config[it->name()] = it->selected();
+  ConfigSelection<true>::ConfigSelection(typename ConfigSelection<true>::PrimClexType &_primclex) {
+    _init(_primclex);
+    m_listed.set();
+    Index ord = 0;
+    for(auto it = _primclex.config_cbegin(); it != _primclex.config_cend(); ++it, ++ord) {
+      m_selected[ord] = it->selected();
     }
   }
 
@@ -67,335 +72,530 @@ namespace CASM {
    */
   //***********************************************************
   bool get_selection(const Array<std::string> &criteria, const Configuration &config, bool init_selection) {
+    return SelectionCriteria(criteria, config.get_primclex())(config, init_selection);
+  }
+
+  //***********************************************************
+
+  void get_selection(const SelectionCriteria &criteria, const Array<const Configuration *> &config, Array<bool> &is_selected) {
+
+    Index N = config.size();
+    Index Nchunk = std::max(Index(1), std::min(default_num_threads(), N));
+
+    // each chunk evaluates a contiguous range of configurations, using its own copy of the criteria,
+    // and stops at the first configuration for which the criteria do not evaluate to "1" or "0"
+    Array<Index> failed(Nchunk, N);
+
+    parallel_for(0, Nchunk, [&](Index c) {
+      SelectionCriteria tcriteria(criteria);
+      bool result;
+      for(Index i = (c * N) / Nchunk; i < ((c + 1) * N) / Nchunk; i++) {
+        if(!tcriteria.evaluate(*config[i], is_selected[i], result)) {
+          failed[c] = i;
+          return;
+        }
+        is_selected[i] = result;
+      }
+    }, Nchunk);
+
+    // report the first configuration that could not be evaluated, as would happen serially
+    for(Index c = 0; c < Nchunk; c++) {
+      if(failed[c] < N)
+        criteria(*config[failed[c]], is_selected[failed[c]]);
+    }
+  }
+
+  //***********************************************************
+
+  void set_selection(const SelectionCriteria &criteria, PrimClex &primclex) {
+    Array<const Configuration *> config;
+    Array<bool> is_selected;
+    for(auto it = primclex.config_begin(); it != primclex.config_end(); ++it) {
+      config.push_back(&(*it));
+      is_selected.push_back(it->selected());
+    }
 
-    using namespace ConfigSelection_impl;
+    get_selection(criteria, config, is_selected);
+
+    Index i = 0;
+    for(auto it = primclex.config_begin(); it != primclex.config_end(); ++it, ++i) {
+      it->set_selected(is_selected[i]);
+    }
+  }
+
+  //***********************************************************
+
+  SelectionCriteria::SelectionCriteria(const Array<std::string> &criteria, const PrimClex &primclex) :
+    m_criteria(criteria),
+    m_primclex(&primclex),
+    m_max_depth(0) {
 
     if(criteria.size() == 0) {
-      std::cerr << "Error in Supercell::set_selection(const Array<std::string> &criteria, Configuration &config)" << std::endl;
+      std::cerr << "Error in SelectionCriteria(const Array<std::string> &criteria, const PrimClex &primclex)" << std::endl;
       std::cerr << "  criteria.size() must be > 0." << std::endl;
       exit(1);
     }
 
     // The first 'criteria' should be whether to select or unselect if the expressions comes out as true ("1")
-    bool mk;
     if(criteria[0] == "on")
-      mk = true;
+      m_mk = true;
     else if(criteria[0] == "off")
-      mk = false;
+      m_mk = false;
     else {
-      std::cerr << "Error in Supercell::set_selection(const Array<std::string> &criteria, Configuration &config)" << std::endl;
+      std::cerr << "Error in SelectionCriteria(const Array<std::string> &criteria, const PrimClex &primclex)" << std::endl;
       std::cerr << "  criteria[0] must be \"on\" or \"off\", but you gave \"" << criteria[0] << "\"" << std::endl;
       exit(1);
     }
 
-    std::string q;
-    std::string A, B;
-    Array<std::string> stack;
-
-
-    // If just 'on' or 'off', then select or unselect all
-    if(criteria.size() == 1) {
-      return mk;
-    }
-
-    // Evaluate the expression by operating on the values in the 'criteria' list one by one
-    //   For each value:
-    //     check if it is an operator, if true: evaluate it and add result to stack
-    //     else check if it is a variable, if it is: substitute in the appropriate value
-    //   By the end of the 'criteria' list, the 'stack' should have only one entry which is "1" or "0"
-    stack.clear();
+    static const std::map<std::string, NodeType> operators = {
+      {"NOT", NodeType::NOT}, {"AND", NodeType::AND}, {"OR", NodeType::OR}, {"XOR", NodeType::XOR},
+      {"re", NodeType::RE}, {"rs", NodeType::RS}, {"eq", NodeType::EQ}, {"ne", NodeType::NE},
+      {"lt", NodeType::LT}, {"le", NodeType::LE}, {"gt", NodeType::GT}, {"ge", NodeType::GE},
+      {"add", NodeType::ADD}, {"sub", NodeType::SUB}, {"div", NodeType::DIV}, {"mult", NodeType::MULT},
+      {"pow", NodeType::POW}
+    };
+
+    // Compile the expression, checking that every operator has its arguments
+    //   and that it leaves exactly one value on the stack
+    Index depth = 0;
     for(Index j = 1; j < criteria.size(); j++) {
-      q = criteria[j];
-      if(is_operator(q)) {
-        if(is_unary(q)) {
-          A = stack.back();
-          stack.pop_back();
-          stack.push_back(operate(q, A));
+      const std::string &q = criteria[j];
+      auto op = operators.find(q);
+      if(op != operators.end()) {
+        Index nargs = (op->second == NodeType::NOT) ? 1 : 2;
+        if(depth < nargs) {
+          depth = 0;
+          break;
         }
-        else {
-          B = stack.back();
-          stack.pop_back();
-          A = stack.back();
-          stack.pop_back();
-          stack.push_back(operate(q, A, B));
+
+        Node node(op->second);
+        node.name = q;
+        if((node.type == NodeType::RE || node.type == NodeType::RS) && m_program.back().type == NodeType::LITERAL) {
+          try {
+            node.regex = std::make_shared<std::regex>(m_program.back().value.str);
+          }
+          catch(...) {
+            std::cerr << "Error performing operation: '" << m_program.back().value.str << " " << q << "'." << std::endl;
+            throw;
+          }
         }
+        m_program.push_back(node);
+        depth -= nargs - 1;
       }
       else {
-        stack.push_back(convert_variable(q, config));
+        m_program.push_back(_compile_variable(q));
+        depth++;
+        m_max_depth = std::max(m_max_depth, depth);
       }
     }
 
-    if(stack.size() != 1) {
-      std::cerr << "Error in Supercell::set_selection(const Array<std::string> &criteria, Configuration &config)" << std::endl;
+    if(criteria.size() > 1 && depth != 1) {
+      std::cerr << "Error in SelectionCriteria(const Array<std::string> &criteria, const PrimClex &primclex)" << std::endl;
       std::cerr << "  stack.size() != 1, check your criteria." << std::endl;
-      std::cerr << "  stack: " << stack << std::endl;
       std::cerr << "  criteria: " << criteria << std::endl;
       exit(1);
     }
+  }
 
-    if(stack[0] == "1") {
-      return mk;
-    }
-    else if(stack[0] != "0") {
-      std::cerr << "Error in Supercell::set_selection(const Array<std::string> &criteria, Configuration &config)" << std::endl;
-      std::cerr << "  stack[0]: " << stack[0] << std::endl;
+  //***********************************************************
+
+  bool SelectionCriteria::operator()(const Configuration &config, bool is_selected) const {
+    if(!m_program.size())
+      return m_mk;
+
+    Value result = _evaluate(config);
+    if(_is_one(result))
+      return m_mk;
+    if(!_is_zero(result)) {
+      std::cerr << "Error in SelectionCriteria::operator()(const Configuration &config, bool is_selected)" << std::endl;
+      std::cerr << "  configuration: " << config.name() << std::endl;
+      std::cerr << "  stack[0]: " << _str(result) << std::endl;
       exit(1);
     }
-    return init_selection;
+    return is_selected;
   }
 
-  namespace ConfigSelection_impl {
-
-    //*******************************************************************************
-
-    bool is_operator(const std::string &q) {
-      //std::cout << "is_operator: " << q << std::endl;
-
-      if(q == "NOT")
-        return true;
-      if(q == "AND")
-        return true;
-      if(q == "OR")
-        return true;
-      if(q == "XOR")
-        return true;
-      if(q == "re")
-        return true;
-      if(q == "rs")
-        return true;
-      if(q == "eq")
-        return true;
-      if(q == "ne")
-        return true;
-      if(q == "lt")
-        return true;
-      if(q == "le")
-        return true;
-      if(q == "gt")
-        return true;
-      if(q == "ge")
-        return true;
-      if(q == "add")
-        return true;
-      if(q == "sub")
-        return true;
-      if(q == "div")
-        return true;
-      if(q == "mult")
-        return true;
-      if(q == "pow")
-        return true;
-      return false;
+  //***********************************************************
+
+  bool SelectionCriteria::evaluate(const Configuration &config, bool is_selected, bool &result) const {
+    if(!m_program.size()) {
+      result = m_mk;
+      return true;
     }
 
-    //*******************************************************************************
+    Value val = _evaluate(config);
+    if(_is_one(val)) {
+      result = m_mk;
+      return true;
+    }
+    if(_is_zero(val)) {
+      result = is_selected;
+      return true;
+    }
+    return false;
+  }
 
-    std::string operate(const std::string &q, const std::string &A) {
-      //std::cout << "operate1: " << q << "  A: " << A << std::endl;
+  //***********************************************************
+  /**  Compile variables
+   *
+   *   if q is:
+   *      "scelname", evaluates to config.get_supercell().get_name()
+   *      "configname", evaluates to config.name()
+   *      "scel_size", evaluates to config.get_supercell().volume()
+   *      "is_groundstate", "dist_from_hull", "formation_energy", evaluate to the
+   *        generated or delta property, or "unknown"
+   *      "is_calculated", evaluates to whether all current properties are calculated
+   *      "clex(x)", evaluates to cluster expansion 'x'
+   *      "comp(x)", evaluates to parametric composition 'x'
+   *      "site_frac(x)", evaluates to the site fraction of molecule 'x', including vacancies
+   *      "atom_frac(x)", evaluates to the mole fraction of molecule 'x', excluding vacancies
+   *   else:
+   *      not a variable, evaluates to q
+   */
+  //***********************************************************
+  SelectionCriteria::Node SelectionCriteria::_compile_variable(const std::string &q) {
+
+    const PrimClex &primclex = *m_primclex;
+
+    // check for a variable
+    if(q == "scelname")
+      return Node(NodeType::SCELNAME);
+    if(q == "configname")
+      return Node(NodeType::CONFIGNAME);
+    if(q == "scel_size")
+      return Node(NodeType::SCEL_SIZE);
+    if(q == "is_groundstate")
+      return Node(NodeType::IS_GROUNDSTATE);
+    if(q == "is_calculated")
+      return Node(NodeType::IS_CALCULATED);
+    if(q == "dist_from_hull")
+      return Node(NodeType::DIST_FROM_HULL);
+    if(q == "formation_energy")
+      return Node(NodeType::FORMATION_ENERGY);
+
+    // try matching 'f(x)', returning 'x' in 'arg'
+    std::string arg;
+    auto is_function = [&](const std::string & f) {
+      if(q.size() < f.size() + 2 || q.compare(0, f.size(), f) != 0 || q[f.size()] != '(' || q.back() != ')')
+        return false;
+      arg = q.substr(f.size() + 1, q.size() - f.size() - 2);
+      return true;
+    };
+
+    // scalar cluster expansion property
+    if(is_function("clex")) {
+      Node node(NodeType::CLEX);
+      if(!m_clexulator.initialized())
+        m_clexulator = primclex.global_clexulator();
+      m_eci.push_back(primclex.global_eci(arg));
+      node.index = m_eci.size() - 1;
+      return node;
+    }
 
-      try {
-        if(q == "NOT")
-          return A == "0" ? "1" : "0";
-        throw std::invalid_argument(std::string("  q: ") + q + " is not recognized");
+    // parametric composition
+    if(is_function("comp")) {
+      if(arg.size() != 1) {
+        throw std::runtime_error(
+          std::string("Error in selecting: '") + q + "'.\n" +
+          "  Composition '" + arg + "' is not valid.");
       }
-      catch(...) {
-        std::cerr << "Error performing operation: '" << A << " " << q << "'." << std::endl;
-        throw;
+      int index = ((int) arg[0]) - ((int) 'a');
+      int Nind = primclex.composition_axes().independent_compositions();
+      if(index < 0) {
+        throw std::runtime_error(
+          std::string("Error in selecting: '") + q + "'.\n" +
+          "  Composition '" + arg + "' is not valid.");
+      }
+      if(index >= Nind) {
+        throw std::runtime_error(
+          std::string("Error in selecting: '") + q + "'.\n" +
+          "  looking for '" + arg[0] + "', with composition index: " + std::to_string(index) +
+          "  but, # independent compositions: " + std::to_string(Nind));
       }
+      Node node(NodeType::COMP);
+      node.index = index;
+      return node;
     }
 
-    //*******************************************************************************
-
-    std::string operate(const std::string &q, const std::string &A, const std::string &B) {
-      //std::cout << "operate2: " << q << "  A: " << A << "  B: " << B << std::endl;
-
-      try {
-        if(q == "AND")
-          return (A == "0" || B == "0") ? "0" : "1";
-        if(q == "OR")
-          return (A == "0" && B == "0") ? "0" : "1";
-        if(q == "XOR")
-          return ((A == "0") != (B == "0")) ? "0" : "1";
-        if(q == "re") {
-          std::regex e(B);
-          //std::cout << "A: " << A << "  B: " << B << "  regex_match: " << boost::regex_match(A, e) << std::endl;
-          return std::regex_match(A, e) ? "1" : "0";
-        }
-        if(q == "rs") {
-          std::regex e(B);
-          //std::cout << "A: " << A << "  B: " << B << "  regex_search: " << boost::regex_search(A, e) << std::endl;
-          return std::regex_search(A, e) ? "1" : "0";
+    // site fraction i.e. include vacancies in the count
+    // mole fraction i.e. do not include vacancies in the count
+    bool is_site_frac = is_function("site_frac");
+    if(is_site_frac || is_function("atom_frac")) {
+      const Array<Molecule> &struc_molecule = primclex.get_struc_molecule();
+      for(Index i = 0; i < struc_molecule.size(); i++) {
+        if(struc_molecule[i].name == arg) {
+          Node node(is_site_frac ? NodeType::SITE_FRAC : NodeType::ATOM_FRAC);
+          node.index = i;
+          return node;
         }
-        if(q == "eq")
-          return (A == B) ? "1" : "0";
-        if(q == "ne")
-          return (A != B) ? "1" : "0";
-        if(q == "lt")
-          return (std::stod(A) < std::stod(B)) ? "1" : "0";
-        if(q == "le")
-          return (std::stod(A) <= std::stod(B)) ? "1" : "0";
-        if(q == "gt")
-          return (std::stod(A) > std::stod(B)) ? "1" : "0";
-        if(q == "ge")
-          return (std::stod(A) >= std::stod(B)) ? "1" : "0";
-        if(q == "add")
-          return std::to_string(std::stod(A) + std::stod(B));
-        if(q == "sub")
-          return std::to_string(std::stod(A) - std::stod(B));
-        if(q == "div")
-          return std::to_string(std::stod(A) / std::stod(B));
-        if(q == "mult")
-          return std::to_string(std::stod(A) * std::stod(B));
-        if(q == "pow")
-          return std::to_string(pow(std::stod(A), std::stod(B)));
-        throw std::invalid_argument(std::string("  q: ") + q + " is not recognized");
-      }
-      catch(...) {
-        std::cerr << "Error performing operation: '" << A << " " << B << " " << q << "'." << std::endl;
-        throw;
       }
+      throw std::runtime_error(
+        std::string("Error in selecting: '") + q + "'.\n" +
+        (is_site_frac ? "  Attempting to get site fraction" : "  Attempting to get mole fraction") +
+        ", but could not find atom '" + arg + "'");
+    }
 
+    // else not a variable:
+    Node node(NodeType::LITERAL);
+    node.value = _string(q);
+    try {
+      node.value.num = std::stod(q);
+      node.value.has_num = true;
     }
+    catch(...) {}
+    return node;
+  }
+
+  //***********************************************************
 
-    //*******************************************************************************
+  SelectionCriteria::Value SelectionCriteria::_evaluate(const Configuration &config) const {
 
-    bool is_unary(const std::string &q) {
-      return q == "NOT" ? true : false;
-    }
+    const Supercell &scel = config.get_supercell();
+    const PrimClex &primclex = *m_primclex;
+
+    std::vector<Value> stack;
+    stack.reserve(m_max_depth);
+
+    for(auto it = m_program.cbegin(); it != m_program.cend(); ++it) {
+      const Node &node = *it;
+      switch(node.type) {
+
+      case NodeType::LITERAL:
+        stack.push_back(node.value);
+        break;
 
-    //***********************************************************
-    /**  convert variables
-     *
-     *   if q is:
-     *      "scelname", returns config.get_supercell().get_name()
-     *      "configname", returns config.name()
-     *      the name of a molecule allowed in the prim,
-     *        returns that molecule's 'true_composition'
-     *      "calculated", returns:
-     *        config.calc_properties().contains(get_primclex().get_curr_property().begin(), get_primclex().get_curr_property().end())
-     *   else:
-     *      not a variable, returns q
-     */
-    //***********************************************************
-    std::string convert_variable(const std::string &q, const Configuration &config) {
-
-      const Supercell &scel = config.get_supercell();
-      const PrimClex &primclex = scel.get_primclex();
-
-      // check for a variable
-      if(q == "scelname")
-        return scel.get_name();
-      if(q == "configname")
-        return config.name();
-      if(q == "scel_size")
-        return std::to_string(scel.volume());
-      if(q == "is_groundstate") {
+      case NodeType::SCELNAME:
+        stack.push_back(_string(scel.get_name()));
+        break;
+
+      case NodeType::CONFIGNAME:
+        stack.push_back(_string(config.name()));
+        break;
+
+      case NodeType::SCEL_SIZE:
+        stack.push_back(_int(scel.volume()));
+        break;
+
+      case NodeType::IS_GROUNDSTATE:
         if(!config.generated_properties().contains("is_groundstate")) {
-          return "unknown";
+          stack.push_back(_string("unknown"));
         }
-        bool is_groundstate;
-        config.generated_properties()["is_groundstate"].get(is_groundstate);
-        return is_groundstate ? "1" : "0";
-      }
-      if(q == "is_calculated") {
-        return std::all_of(primclex.get_curr_property().begin(),
-                           primclex.get_curr_property().end(),
+        else {
+          bool is_groundstate;
+          config.generated_properties()["is_groundstate"].get(is_groundstate);
+          stack.push_back(_bool(is_groundstate));
+        }
+        break;
+
+      case NodeType::IS_CALCULATED:
+        stack.push_back(_bool(std::all_of(primclex.get_curr_property().begin(),
+                                          primclex.get_curr_property().end(),
         [&](const std::string & key) {
           return config.calc_properties().contains(key);
-        }) ? "1" : "0";
-      }
-      if(q == "dist_from_hull") {
-        if(!config.generated_properties().contains("dist_from_hull")) {
-          //std::cerr << "WARNING: Configuration " << config.get_path() << std::endl
-          //          << "         Does not have an initialized 'dist_from_hull' field in its generated properties." << std::endl;
-          return "unknown";
-        }
+        })));
+        break;
+
+      case NodeType::DIST_FROM_HULL:
+        if(!config.generated_properties().contains("dist_from_hull"))
+          stack.push_back(_string("unknown"));
         else
-          return config.generated_properties()["dist_from_hull"].get<std::string>();
-      }
-      if(q == "formation_energy") {
-        if(!config.delta_properties().contains("relaxed_energy")) {
-          //std::cerr << "WARNING: Configuration " << config.get_path() << std::endl
-          //          << "         Does not have an initialized 'relaxed_energy' field in its delta properties." << std::endl
-          //          << "         Please verify that all desired properties are specified in the project settings." << std::endl;
-          return "unknown";
-        }
+          stack.push_back(_string(config.generated_properties()["dist_from_hull"].get<std::string>()));
+        break;
+
+      case NodeType::FORMATION_ENERGY:
+        if(!config.delta_properties().contains("relaxed_energy"))
+          stack.push_back(_string("unknown"));
         else
-          return config.delta_properties()["relaxed_energy"].get<std::string>();
+          stack.push_back(_string(config.delta_properties()["relaxed_energy"].get<std::string>()));
+        break;
+
+      case NodeType::CLEX:
+        stack.push_back(_double(m_eci[node.index] * correlations(config, m_clexulator)));
+        break;
+
+      case NodeType::COMP:
+        stack.push_back(_double(config.get_param_composition()[node.index]));
+        break;
+
+      case NodeType::SITE_FRAC:
+        stack.push_back(_double(config.get_true_composition()[node.index]));
+        break;
+
+      case NodeType::ATOM_FRAC:
+        stack.push_back(_double(config.get_composition()[node.index]));
+        break;
+
+      case NodeType::NOT:
+        stack.back() = _bool(_is_zero(stack.back()));
+        break;
+
+      default:
+        Value B = stack.back();
+        stack.pop_back();
+        _binary(node, stack.back(), B);
+        break;
       }
+    }
 
-      // try matching 'clex(clex_name)', 'comp(x)', 'true_comp(x)', 'mol_comp(x)'
-      std::smatch sm;
-
-      // scalar cluster expansion property
-      auto clex_e = std::regex("clex\\((.*)\\)");
-      std::regex_match(q, sm, clex_e);
-      if(sm.size()) {
-        std::string ss = sm[1];
-        Clexulator clexulator = primclex.global_clexulator();
-        ECIContainer eci = primclex.global_eci(ss);
-        return std::to_string(eci * correlations(config, clexulator));
-      }
+    return stack[0];
+  }
 
-      // parametric composition
-      auto comp_e = std::regex("comp\\((.*)\\)");
-      std::regex_match(q, sm, comp_e);
-      if(sm.size()) {
-        std::string ss = sm[1];
-        if(ss.size() > 1) {
-          throw std::runtime_error(
-            std::string("Error in selecting: '") + q + "'.\n" +
-            "  Composition '" + ss + "' is not valid.");
-        }
-        int index = ((int) ss[0]) - ((int) 'a');
-        int Nind = primclex.composition_axes().independent_compositions();
-        if(index < 0) {
-          throw std::runtime_error(
-            std::string("Error in selecting: '") + q + "'.\n" +
-            "  Composition '" + ss + "' is not valid.");
-        }
-        if(index >= Nind) {
-          throw std::runtime_error(
-            std::string("Error in selecting: '") + q + "'.\n" +
-            "  looking for '" + ss[0] + "', with composition index: " + std::to_string(index) +
-            "  but, # independent compositions: " + std::to_string(Nind));
-        }
-        return std::to_string(config.get_param_composition()[index]);
+  //***********************************************************
+
+  void SelectionCriteria::_binary(const Node &node, Value &A, const Value &B) const {
+    try {
+      switch(node.type) {
+      case NodeType::AND:
+        A = _bool(!(_is_zero(A) || _is_zero(B)));
+        return;
+      case NodeType::OR:
+        A = _bool(!(_is_zero(A) && _is_zero(B)));
+        return;
+      case NodeType::XOR:
+        A = _bool(!(_is_zero(A) != _is_zero(B)));
+        return;
+      case NodeType::RE:
+        A = _bool(node.regex ? std::regex_match(_str(A), *node.regex) : std::regex_match(_str(A), std::regex(_str(B))));
+        return;
+      case NodeType::RS:
+        A = _bool(node.regex ? std::regex_search(_str(A), *node.regex) : std::regex_search(_str(A), std::regex(_str(B))));
+        return;
+      case NodeType::EQ:
+        A = _bool(_str(A) == _str(B));
+        return;
+      case NodeType::NE:
+        A = _bool(_str(A) != _str(B));
+        return;
+      case NodeType::LT:
+        A = _bool(_num(A) < _num(B));
+        return;
+      case NodeType::LE:
+        A = _bool(_num(A) <= _num(B));
+        return;
+      case NodeType::GT:
+        A = _bool(_num(A) > _num(B));
+        return;
+      case NodeType::GE:
+        A = _bool(_num(A) >= _num(B));
+        return;
+      case NodeType::ADD:
+        A = _double(_num(A) + _num(B));
+        return;
+      case NodeType::SUB:
+        A = _double(_num(A) - _num(B));
+        return;
+      case NodeType::DIV:
+        A = _double(_num(A) / _num(B));
+        return;
+      case NodeType::MULT:
+        A = _double(_num(A) * _num(B));
+        return;
+      case NodeType::POW:
+        A = _double(pow(_num(A), _num(B)));
+        return;
+      default:
+        throw std::invalid_argument(std::string("  q: ") + node.name + " is not recognized");
       }
+    }
+    catch(...) {
+      std::cerr << "Error performing operation: '" << _str(A) << " " << _str(B) << " " << node.name << "'." << std::endl;
+      throw;
+    }
+  }
 
-      Array<Molecule> struc_molecule = primclex.get_prim().get_struc_molecule();
+  //***********************************************************
 
-      // site fraction i.e. include vacancies in the count
-      auto site_frac_e = std::regex("site_frac\\((.*)\\)");
-      std::regex_match(q, sm, site_frac_e);
-      if(sm.size()) {
-        std::string ss = sm[1];
-        for(int i = 0; i < struc_molecule.size(); i++)
-          if(struc_molecule[i].name == ss) {
-            return std::to_string(config.get_true_composition()[i]);
-          }
-        throw std::runtime_error(
-          std::string("Error in selecting: '") + q + "'.\n" +
-          "  Attempting to get site fraction, but could not find atom '" + ss + "'");
-      }
+  SelectionCriteria::Value SelectionCriteria::_bool(bool val) {
+    Value result;
+    result.type = Value::BOOL;
+    result.num = val ? 1.0 : 0.0;
+    return result;
+  }
 
-      // mole fraction i.e. do not include vacancies in the count
-      auto atom_frac_e = std::regex("atom_frac\\((.*)\\)");
-      std::regex_match(q, sm, atom_frac_e);
-      if(sm.size()) {
-        std::string ss = sm[1];
-        for(int i = 0; i < struc_molecule.size(); i++)
-          if(struc_molecule[i].name == ss)
-            return std::to_string(config.get_composition()[i]);
-        throw std::runtime_error(
-          std::string("Error in selecting: '") + q + "'.\n" +
-          "  Attempting to get mole fraction, but could not find atom '" + ss + "'");
-      }
+  //***********************************************************
+
+  SelectionCriteria::Value SelectionCriteria::_int(long val) {
+    Value result;
+    result.type = Value::INT;
+    result.num = val;
+    return result;
+  }
+
+  //***********************************************************
+
+  SelectionCriteria::Value SelectionCriteria::_double(double val) {
+    Value result;
+    result.type = Value::DOUBLE;
+    result.num = val;
+    return result;
+  }
+
+  //***********************************************************
+
+  SelectionCriteria::Value SelectionCriteria::_string(const std::string &val) {
+    Value result;
+    result.type = Value::STRING;
+    result.str = val;
+    return result;
+  }
+
+  //***********************************************************
 
-      // else not a variable:
-      return q;
+  bool SelectionCriteria::_is_zero(const Value &A) {
+    switch(A.type) {
+    case Value::BOOL:
+    case Value::INT:
+      return A.num == 0.0;
+    case Value::DOUBLE:
+      // std::to_string(double) always has decimal places
+      return false;
+    default:
+      return A.str == "0";
     }
+  }
+
+  //***********************************************************
+
+  bool SelectionCriteria::_is_one(const Value &A) {
+    switch(A.type) {
+    case Value::BOOL:
+    case Value::INT:
+      return A.num == 1.0;
+    case Value::DOUBLE:
+      return false;
+    default:
+      return A.str == "1";
+    }
+  }
 
+  //***********************************************************
+
+  std::string SelectionCriteria::_str(const Value &A) {
+    switch(A.type) {
+    case Value::BOOL:
+      return A.num == 0.0 ? "0" : "1";
+    case Value::INT:
+      return std::to_string(long(A.num));
+    case Value::DOUBLE:
+      return std::to_string(A.num);
+    default:
+      return A.str;
+    }
+  }
+
+  //***********************************************************
+
+  double SelectionCriteria::_num(const Value &A) {
+    switch(A.type) {
+    case Value::BOOL:
+    case Value::INT:
+      return A.num;
+    case Value::DOUBLE:
+      // same as std::stod(std::to_string(A.num)), which rounds to 6 decimal places
+      return std::nearbyint(A.num * 1e6) / 1e6;
+    default:
+      return A.has_num ? A.num : std::stod(A.str);
+    }
   }
 
 }
@@ -1,7 +1,9 @@
 #include "casm/clex/Configuration.hh"
 
+#include <algorithm>
 #include <sstream>
 //#include "casm/misc/Time.hh"
+#include "casm/system/Parallel.hh"
 #include "casm/clex/PrimClex.hh"
 #include "casm/clex/Supercell.hh"
 #include "casm/clex/Clexulator.hh"
@@ -135,6 +137,9 @@ namespace CASM {
   //*********************************************************************************
   void Configuration::set_occupation(const Array<int> &new_occupation) {
     dof_updated = true;
+    m_num_each_molecule.clear();
+    correlations.clear();
+    m_corr_library.reset();
     m_configdof.set_occupation(new_occupation);
     return;
   }
@@ -148,7 +153,91 @@ namespace CASM {
     //}
     //std::cout << "Configuration::set_occ(). i: " << i << " occupation.size(): "<< occupation.size() << "  val: " << val << std::endl;
     dof_updated = true;
-    m_configdof.occ(site_l) = val;
+    correlations.clear();
+    m_corr_library.reset();
+    _set_occ(site_l, val);
+  }
+
+  //*********************************************************************************
+  void Configuration::set_occ(Index site_l, int val, Clexulator &clexulator) {
+    dof_updated = true;
+    if(!_has_correlations(clexulator) || !_has_local_delta_corr(site_l)) {
+      _set_occ(site_l, val);
+      set_correlations(clexulator);
+      return;
+    }
+
+    std::vector<double> delta_corr(clexulator.corr_size());
+    _set_occ(site_l, val, clexulator, delta_corr.data());
+    corr_updated = true;
+  }
+
+  //*********************************************************************************
+  void Configuration::set_occ(const Array<Index> &site_l, const Array<int> &val, Clexulator &clexulator) {
+    assert(site_l.size() == val.size());
+    dof_updated = true;
+    bool local = _has_correlations(clexulator);
+    for(Index i = 0; local && i < site_l.size(); i++)
+      local = _has_local_delta_corr(site_l[i]);
+
+    if(!local) {
+      for(Index i = 0; i < site_l.size(); i++)
+        _set_occ(site_l[i], val[i]);
+      set_correlations(clexulator);
+      return;
+    }
+
+    std::vector<double> delta_corr(clexulator.corr_size());
+    for(Index i = 0; i < site_l.size(); i++)
+      _set_occ(site_l[i], val[i], clexulator, delta_corr.data());
+    corr_updated = true;
+  }
+
+  //*********************************************************************************
+  void Configuration::_set_occ(Index site_l, int val) {
+    int &occ = m_configdof.occ(site_l);
+    if(m_num_each_molecule.size() && occ != val) {
+      const Array<int> &convert = get_primclex().get_struc_molecule_index()[get_b(site_l)];
+      m_num_each_molecule[convert[occ]]--;
+      m_num_each_molecule[convert[val]]++;
+    }
+    occ = val;
+  }
+
+  //*********************************************************************************
+  /// The size is checked as well, in case the correlations were modified after set_correlations
+  bool Configuration::_has_correlations(const Clexulator &clexulator) const {
+    std::shared_ptr<const RuntimeLibrary> lib = m_corr_library.lock();
+    return lib && lib == clexulator.library() && correlations.size() == clexulator.corr_size();
+  }
+
+  //*********************************************************************************
+  /// calc_delta_point_corr assumes that the clusters containing 'site_l' do not contain any of its
+  /// periodic images, which is not the case in supercells smaller than the neighborhood
+  bool Configuration::_has_local_delta_corr(Index site_l) const {
+    const Array<Index> &nlist = get_supercell().get_nlist(site_l);
+    return std::count(nlist.begin(), nlist.end(), site_l) == 1;
+  }
+
+  //*********************************************************************************
+  /// The change in correlations only depends on the neighborhood of 'site_l', so the cost does
+  /// not grow with the supercell size
+  void Configuration::_set_occ(Index site_l, int val, Clexulator &clexulator, double *delta_corr) {
+    int occ_i = occ(site_l);
+    if(occ_i == val)
+      return;
+
+    const Supercell &scel = get_supercell();
+    clexulator.set_config_occ(m_configdof.occupation().begin());
+    clexulator.set_nlist(scel.get_nlist(site_l).begin());
+    clexulator.calc_delta_point_corr(get_b(site_l), occ_i, val, delta_corr);
+
+    // delta_corr is the change in the sum over all unit cells; correlations are per unit cell
+    double scel_vol = scel.volume();
+    for(Index i = 0; i < correlations.size(); i++)
+      correlations[i] += delta_corr[i] / scel_vol;
+
+    _set_occ(site_l, val);
   }
 
   //*********************************************************************************
@@ -235,6 +324,7 @@ namespace CASM {
   //*********************************************************************************
   void Configuration::set_correlations_orbitree(const SiteOrbitree &site_orbitree) {
     corr_updated = true;
+    m_corr_library.reset();
 
     const PrimClex &pc = get_primclex();
 
@@ -275,42 +365,13 @@ namespace CASM {
 
     corr_updated = true;
 
-    const Supercell &scel = get_supercell();
-    //Size of the supercell will be used for normalizing correlations to a per primitive cell value
-    int scel_vol = scel.volume();
-
     correlations.resize(clexulator.corr_size());
-
-    //Inform Clexulator of the bitstring
-
-    //TODO: This will probably get more complicated with displacements and stuff
-    clexulator.set_config_occ(m_configdof.occupation().begin());
-    //mc_clexor.set_config_disp(mc_confdof.m_displacements.begin());   //or whatever
-    //mc_clexor.set_config_strain(mc_confdof.m_strain.begin());   //or whatever
+    m_corr_library = clexulator.library();
 
     //Holds contribution to global correlations from a particular neighborhood
     std::vector<double> tcorr(clexulator.corr_size(), 0.0);
-    std::vector<double> corr(clexulator.corr_size(), 0.0);
 
-    for(int v = 0; v < scel_vol; v++) {
-
-      //Point the Clexulator to the right neighborhood
-      clexulator.set_nlist(scel.get_nlist(v).begin());
-
-      //Fill up contributions
-      clexulator.calc_global_corr_contribution(&tcorr[0]);
-
-      //Add contributions to total correlations
-      for(int i = 0; i < tcorr.size(); i++) {
-        corr[i] += tcorr[i];
-      }
-
-    }
-
-    // normalize by supercell volume
-    for(int i = 0; i < clexulator.corr_size(); i++) {
-      correlations[i] /= (double) scel_vol;
-    }
+    calc_correlations(m_configdof, get_supercell(), clexulator, correlations.begin(), tcorr.data());
 
     return;
   }
@@ -430,9 +491,9 @@ namespace CASM {
 
   //*********************************************************************************
 
-  /*const Correlation &Configuration::get_correlations() const {
+  const Correlation &Configuration::get_correlations() const {
     return correlations;
-    }*/
+  }
 
   //*********************************************************************************
 
@@ -463,9 +524,6 @@ namespace CASM {
 
     Index i;
 
-    // [basis_site][site_occupant_index]
-    Array< Array<int> > convert = get_index_converter(get_prim(), get_prim().get_struc_molecule());
-
     // create an array to count the number of each molecule
     Array< Array<int> > sublat_num_each_molecule;
     for(i = 0; i < get_prim().basis.size(); i++) {
@@ -486,13 +544,13 @@ namespace CASM {
   ReturnArray<double> Configuration::get_composition() const {
 
     // get the number of each molecule type
-    Array<int> num_each_molecule = get_num_each_molecule();
+    Array<int> num_each_molecule = this->num_each_molecule();
 
     /// get the total number of non-vacancy atoms
     int num_atoms = 0;
 
     // need to know which molecules are vacancies
-    Array<Molecule> struc_molecule = get_prim().get_struc_molecule();
+    const Array<Molecule> &struc_molecule = get_primclex().get_struc_molecule();
 
     Index i;
     for(i = 0; i < struc_molecule.size(); i++) {
@@ -517,7 +575,7 @@ namespace CASM {
   ///    composition[ molecule_type ]: molecule_type ordered as prim structure's get_struc_molecule()
   ReturnArray<double> Configuration::get_true_composition() const {
 
-    Array<int> num_each_molecule = get_num_each_molecule();
+    const Array<int> &num_each_molecule = this->num_each_molecule();
 
     // calculate the true_comp (including vacancies) from the number of each molecule
     Array<double> comp;
@@ -530,19 +588,32 @@ namespace CASM {
   //*********************************************************************************
   /// Returns num_each_molecule[ molecule_type], where 'molecule_type' is ordered as Structure::get_struc_molecule()
   ReturnArray<int> Configuration::get_num_each_molecule() const {
+    Array<int> num_each_molecule(this->num_each_molecule());
+    return num_each_molecule;
+  }
 
-    // [basis_site][site_occupant_index]
-    Array< Array<int> > convert = get_index_converter(get_prim(), get_prim().get_struc_molecule());
+  //*********************************************************************************
+  /// Uses the PrimClex lookup table, one sublattice at a time
+  const Array<int> &Configuration::num_each_molecule() const {
+    if(m_num_each_molecule.size())
+      return m_num_each_molecule;
 
-    // create an array to count the number of each molecule
-    Array<int> num_each_molecule(get_prim().get_struc_molecule().size(), 0);
+    // [basis_site][site_occupant_index]
+    const Array< Array<int> > &convert = get_primclex().get_struc_molecule_index();
 
     // count the number of each molecule
-    for(Index i = 0; i < size(); i++) {
-      num_each_molecule[ convert[ get_b(i) ][occ(i)] ]++;
+    Array<int> num_each_molecule(get_primclex().get_struc_molecule().size(), 0);
+    Index V = get_supercell().volume();
+    const Array<int> &occ_list = occupation();
+    for(Index b = 0; b < convert.size(); b++) {
+      const Array<int> &convert_b = convert[b];
+      for(Index l = b * V; l < (b + 1) * V; l++) {
+        num_each_molecule[ convert_b[occ_list[l]] ]++;
+      }
     }
 
-    return num_each_molecule;
+    m_num_each_molecule.swap(num_each_molecule);
+    return m_num_each_molecule;
   }
 
   //*********************************************************************************
@@ -562,28 +633,21 @@ namespace CASM {
   ///   where 'component_type' is ordered as ParamComposition::get_components
   Eigen::VectorXd Configuration::get_num_each_component() const {
 
-    // component order used for param_composition
-    std::vector<std::string> v_components = get_primclex().composition_axes().components();
-
-    // copy to CASM::Array
-    Array<std::string> components;
-    for(auto it = v_components.cbegin(); it != v_components.cend(); ++it) {
-      components.push_back(*it);
-    }
+    // [struc_molecule_index] -> component index
+    const Array<int> &convert = get_primclex().get_component_index();
+    const Array<int> &num_each_molecule = this->num_each_molecule();
 
     // initialize
-    Eigen::VectorXd num_each_component = Eigen::VectorXd::Zero(components.size());
+    Eigen::VectorXd num_each_component = Eigen::VectorXd::Zero(get_primclex().composition_axes().components().size());
 
-    // [basis_site][site_occupant_index]
-    Array< Array<int> > convert = get_index_converter(get_prim(), components);
-
-    // count the number of each component
-    for(Index i = 0; i < size(); i++) {
-      num_each_component[ convert[ get_b(i) ][occ(i)] ] += 1.0;
+    // sum the molecules of each component
+    for(Index i = 0; i < num_each_molecule.size(); i++) {
+      if(convert[i] >= 0)
+        num_each_component[ convert[i] ] += num_each_molecule[i];
     }
 
     // normalize per prim cell
-    for(Index i = 0; i < components.size(); i++) {
+    for(Index i = 0; i < num_each_component.size(); i++) {
       num_each_component[i] /= get_supercell().volume();
     }
 
@@ -713,7 +777,7 @@ namespace CASM {
   void Configuration::print_composition(std::ostream &stream) const {
 
     Array<double> comp = get_composition();
-    Array<Molecule> mol_list = get_prim().get_struc_molecule();
+    const Array<Molecule> &mol_list = get_primclex().get_struc_molecule();
 
     for(Index i = 0; i < mol_list.size(); i++) {
       if(mol_list[i].is_vacancy()) {
@@ -864,6 +928,7 @@ namespace CASM {
       json.get_if(m_source, "source");
       json.get_else(m_selected, "selected", false);
       from_json(m_configdof, json["dof"]);
+      m_num_each_molecule.clear();
     }
   }
 
@@ -873,6 +938,7 @@ namespace CASM {
   ///
   void Configuration::read_corr(const jsonParser &json) {
     json.get_if(correlations, "scalar_correlations");
+    m_corr_library.reset();
   }
 
 
@@ -903,6 +969,8 @@ namespace CASM {
 
     if(json.contains("gen")) {
       from_json(generated, json["gen"]);
+      m_sublat_struct_fact.resize(0, 0);
+      m_struct_fact.resize(0, 0);
     }
 
     delta = calculated - reference;
@@ -1276,14 +1344,14 @@ namespace CASM {
   //--------------------------------------------------------------------------------------------------
   //Structure Factor
   Eigen::VectorXd Configuration::get_struct_fact_intensities() const {
-    Eigen::VectorXd automatic_intensities(get_prim().get_struc_molecule().size());
-    for(int i = 0; i < get_prim().get_struc_molecule().size(); i++)
+    Eigen::VectorXd automatic_intensities(get_primclex().get_struc_molecule().size());
+    for(int i = 0; i < get_primclex().get_struc_molecule().size(); i++)
       automatic_intensities(i) = i;
     return get_struct_fact_intensities(automatic_intensities);
   }
 
   Eigen::VectorXd Configuration::get_struct_fact_intensities(const Eigen::VectorXd &component_intensities) const {
-    Array< Array<int> > convert = get_index_converter(get_prim(), get_prim().get_struc_molecule());
+    const Array< Array<int> > &convert = get_primclex().get_struc_molecule_index();
     Eigen::VectorXd intensities(size());
     for(int i = 0; i < size(); i++) {
       intensities(i) = component_intensities(convert[get_b(i)][occ(i)]);
@@ -1292,40 +1360,28 @@ namespace CASM {
   }
 
   ///  Calculates the sublattice structure factors as:
-  ///       intensities.segment<volume()>(i*volume()) * fourier_matrix = Q.column(i)
+  ///       Q(k,i) = sum_r intensities[i*volume() + l(r)] * exp(-i k r) / volume()
   ///       Q is arranged as: [Q1(k1) Q2(k1) ... Qn(k1)]
   ///                         [Q1(k2) Q2(k2) ... Qn(k2)]
   ///                         ...
   ///                         [Q1(kn) Q2(kn) ... Qn(kn)]
-  ///  Q is called sublat_sf in the code
+  ///  Q is called sublat_sf in the code, see Supercell::sublat_struct_fact
   void Configuration::calc_sublat_struct_fact(const Eigen::VectorXd &intensities) {
-    //std::cout<<"Intensities"<<std::endl<<intensities<<std::endl;
-    Eigen::MatrixXcd sublat_sf(supercell->basis_size(), supercell->fourier_matrix().cols());
-    if(supercell->fourier_matrix().rows() == 0 || supercell->fourier_matrix().cols() == 0) {
+    if(supercell->k_index().size() == 0) {
       std::cerr << "ERROR in Configuration::calc_sublat_struct_fact. Did you "
-                << "forget to initialize a fourier matrix in Supercell?"
+                << "forget to initialize the k-point index in Supercell?"
                 << " Quitting" << std::endl;
       exit(666);
     }
-    //int num_kpoints = supercell->fourier_matrix().cols();
-    int supercell_volume = supercell->volume();
-    for(int i = 0; i < supercell->basis_size(); i++) {
-      Eigen::VectorXd int_segment = intensities.segment(i * supercell_volume, supercell_volume);
-      // std::cout<<"Intensity segment:"<<int_segment.transpose()<<std::endl;
-      // std::cout<<"Fourier:"<<std::endl<<supercell->fourier_matrix()<<std::endl;
-      sublat_sf.row(i) = int_segment.transpose() * supercell->fourier_matrix();
-    }
-    sublat_sf = sublat_sf / double(supercell->volume());
-    // std::cout<<"Sublattice struct factor:"<<std::endl;
-    // std::cout<<sublat_sf.transpose()<<std::endl;
-    generated["sublat_struct_fact"] =  sublat_sf.transpose();
+    m_sublat_struct_fact = supercell->sublat_struct_fact(intensities);
+    generated["sublat_struct_fact"] = m_sublat_struct_fact;
     prop_updated = true;
   }
 
   /// Structure factors are then calculated as S:
   /// S = (Q * m_phase_factor).diagonal().absolute_value()
   /// S is arranged as: [S(k1) S(k2) ... S(kn)]
-  /// In the code: Q is called sublat_sf
+  /// In the code: Q is called sublat_sf, and only the diagonal elements of the product are evaluated
   /// However, it would be useful to have a matrix that contained the coordinates of the k-points
   /// along with the intensities at those points. The matrix that is stored in generated is thus
   /// formatted as:
@@ -1338,16 +1394,11 @@ namespace CASM {
       exit(666);
     }
     calc_sublat_struct_fact(intensities);
-    Eigen::MatrixXcd sublat_sf = generated["sublat_struct_fact"].get<Eigen::MatrixXcd>();
-    //    std::cout<<"Multiplication matrix:"<<std::endl<<sublat_sf*supercell->phase_factor()<<std::endl;
-    Eigen::VectorXcd raw_amplitudes = (sublat_sf * supercell->phase_factor()).diagonal();
-    // std::cout.precision(4);
-    // std::cout<<std::fixed;
-    // std::cout<<"Raw amplitudes:"<<std::endl<<raw_amplitudes.transpose()<<std::endl;
-    Eigen::MatrixXd sf_coords(raw_amplitudes.size(), 4);
-    sf_coords.leftCols(3) = supercell->k_mesh();
-    sf_coords.col(3) = raw_amplitudes.cwiseAbs().transpose() / double(supercell->basis_size());
-    generated["struct_fact"] = sf_coords;
+    Eigen::VectorXcd raw_amplitudes = (m_sublat_struct_fact.array() * supercell->phase_factor().transpose().array()).rowwise().sum();
+    m_struct_fact.resize(raw_amplitudes.size(), 4);
+    m_struct_fact.leftCols(3) = supercell->k_mesh();
+    m_struct_fact.col(3) = raw_amplitudes.cwiseAbs() / double(supercell->basis_size());
+    generated["struct_fact"] = m_struct_fact;
     prop_updated = true;
   }
 
@@ -1359,16 +1410,26 @@ namespace CASM {
     calc_sublat_struct_fact(get_struct_fact_intensities());
   }
 
-  Eigen::MatrixXd Configuration::struct_fact() {
-    if(!generated.contains("struct_fact"))
-      calc_struct_fact();
-    return generated["struct_fact"].get<Eigen::MatrixXd>();
+  /// Uses the values read from generated properties if they have not been calculated
+  const Eigen::MatrixXd &Configuration::struct_fact() {
+    if(m_struct_fact.size() == 0) {
+      if(generated.contains("struct_fact"))
+        m_struct_fact = generated["struct_fact"].get<Eigen::MatrixXd>();
+      else
+        calc_struct_fact();
+    }
+    return m_struct_fact;
   }
 
-  Eigen::MatrixXcd Configuration::sublat_struct_fact() {
-    if(!generated.contains("sublat_struct_fact"))
-      calc_sublat_struct_fact();
-    return generated["sublat_struct_fact"].get<Eigen::MatrixXcd>();
+  /// Uses the values read from generated properties if they have not been calculated
+  const Eigen::MatrixXcd &Configuration::sublat_struct_fact() {
+    if(m_sublat_struct_fact.size() == 0) {
+      if(generated.contains("sublat_struct_fact"))
+        m_sublat_struct_fact = generated["sublat_struct_fact"].get<Eigen::MatrixXcd>();
+      else
+        calc_sublat_struct_fact();
+    }
+    return m_sublat_struct_fact;
   }
 
   /// \brief Returns correlations using 'clexulator'.
@@ -1426,6 +1487,31 @@ namespace CASM {
     */
   }
 
+  //*********************************************************************************
+  /// Configurations are split into contiguous chunks, which keeps the configurations of a Supercell
+  /// together when 'config' is in PrimClex order. Each chunk is evaluated by one thread, using its own
+  /// copy of 'clexulator' and its own scratch space, and writes directly into its columns of the result.
+  ///
+  /// All Supercell neighbor lists must be generated before calling this, as they are only read here.
+  Eigen::MatrixXd correlations(const Array<const Configuration *> &config, const Clexulator &clexulator) {
+
+    Index N = config.size();
+    Index corr_size = clexulator.corr_size();
+    Eigen::MatrixXd corr(corr_size, N);
+
+    Index Nchunk = std::max(Index(1), std::min(default_num_threads(), N));
+
+    parallel_for(0, Nchunk, [&](Index c) {
+      Clexulator tclexulator(clexulator);
+      std::vector<double> tcorr(corr_size, 0.0);
+      for(Index i = (c * N) / Nchunk; i < ((c + 1) * N) / Nchunk; i++) {
+        calc_correlations(config[i]->configdof(), config[i]->get_supercell(), tclexulator, corr.col(i).data(), tcorr.data());
+      }
+    }, Nchunk);
+
+    return corr;
+  }
+
 }
 
 
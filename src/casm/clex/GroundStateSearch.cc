@@ -0,0 +1,296 @@
+#include "casm/clex/GroundStateSearch.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "casm/system/Parallel.hh"
+#include "casm/misc/Profile.hh"
+#include "casm/clex/Supercell.hh"
+#include "casm/clex/Configuration.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+namespace CASM {
+
+  GroundStateHull::GroundStateHull(double tol) :
+    m_tol(tol),
+    m_hull(tol),
+    m_hull_found(false) {}
+
+  //*******************************************************************************************
+
+  bool GroundStateHull::is_candidate(const Eigen::VectorXd &comp, double energy) const {
+    if(m_hull_found) {
+      // anything outside the composition range of the hull extends it
+      if(!m_hull.contains(comp))
+        return true;
+      return m_hull.dist_to_hull(comp, energy) < -m_tol;
+    }
+
+    for(Index i = 0; i < m_candidates.size(); i++) {
+      if((m_candidates[i].comp - comp).norm() < TOL && m_candidates[i].energy <= energy + m_tol)
+        return false;
+    }
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  bool GroundStateHull::insert(const GroundStateCandidate &candidate) {
+    if(!is_candidate(candidate.comp, candidate.energy))
+      return false;
+    m_candidates.push_back(candidate);
+    _update();
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  void GroundStateHull::insert(const GroundStateHull &other) {
+    for(Index i = 0; i < other.size(); i++)
+      insert(other.candidates()[i]);
+  }
+
+  //*******************************************************************************************
+  /// The last candidate is the one just inserted
+  void GroundStateHull::_update() {
+    std::vector<GroundStateCandidate> kept;
+
+    if(_reset_hull()) {
+      for(Index i = 0; i < m_candidates.size(); i++) {
+        if(m_hull.is_vertex(i))
+          kept.push_back(m_candidates[i]);
+      }
+      m_candidates.swap(kept);
+      m_hull_found = _reset_hull();
+      return;
+    }
+
+    // no hull yet: the new candidate replaces those at the same composition
+    const GroundStateCandidate &last = m_candidates.back();
+    for(Index i = 0; i + 1 < m_candidates.size(); i++) {
+      if((m_candidates[i].comp - last.comp).norm() >= TOL)
+        kept.push_back(m_candidates[i]);
+    }
+    kept.push_back(last);
+    m_candidates.swap(kept);
+    m_hull_found = false;
+  }
+
+  //*******************************************************************************************
+
+  bool GroundStateHull::_reset_hull() {
+    Index dim = m_candidates[0].comp.size();
+    Eigen::MatrixXd comp(dim, m_candidates.size());
+    Eigen::VectorXd energy(m_candidates.size());
+    for(Index i = 0; i < m_candidates.size(); i++) {
+      comp.col(i) = m_candidates[i].comp;
+      energy(i) = m_candidates[i].energy;
+    }
+    m_hull = LowerHull(m_tol);
+    return m_hull.reset(comp, energy);
+  }
+
+  //*******************************************************************************************
+
+  namespace GroundStateSearch_impl {
+
+    /// Each supercell is enumerated in at least this many pieces, by fixing the occupants of its last
+    /// sites, so that large supercells are spread over the threads. This does not depend on the number
+    /// of threads, so that neither do the results.
+    const Index min_pieces = 64;
+
+    /// \brief One piece of work: piece 'part' of the occupations of 'scel', or annealing run 'part'
+    struct Task {
+      Index scel;
+      Index part;
+    };
+
+    //*******************************************************************************************
+    /// Insert 'config' into 'hull' if it is a candidate, at the exact energy
+    ///  - correlations of 'config' are recalculated in full if it is inserted, which also removes
+    ///    any round off accumulated by incremental updates
+    void insert_candidate(Configuration &config, Clexulator &clexulator, const GroundStateSearch &search,
+                          const Eigen::VectorXd &comp, double energy, GroundStateHull &hull) {
+      if(!hull.is_candidate(comp, energy))
+        return;
+
+      config.set_correlations(clexulator);
+
+      GroundStateCandidate candidate;
+      candidate.scel = &config.get_supercell();
+      candidate.occupation = config.occupation();
+      candidate.comp = comp;
+      candidate.energy = search.eci * config.get_correlations();
+      hull.insert(candidate);
+    }
+
+    //*******************************************************************************************
+    /// Evaluate every occupation of 'scel' for which the last 'N_fixed' sites have the occupants
+    /// given by 'part', as mixed radix digits
+    void enumerate_piece(Supercell &scel, Index N_fixed, Index part, const GroundStateSearch &search,
+                         GroundStateHull &hull) {
+      Clexulator clexulator(search.clexulator);
+      Array<int> max_occ = scel.max_allowed_occupation();
+      Index N = max_occ.size();
+      Index N_free = N - N_fixed;
+
+      Array<int> occ(N, 0);
+      for(Index l = N_free; l < N; l++) {
+        occ[l] = part % (max_occ[l] + 1);
+        part /= (max_occ[l] + 1);
+      }
+
+      Configuration config(scel);
+      config.set_occupation(occ);
+      config.set_correlations(clexulator);
+      config.num_each_molecule();
+
+      // count through the occupations of the free sites, changing only the sites that carry
+      Array<Index> changed_l;
+      Array<int> changed_val;
+      Index count = 0;
+      while(true) {
+        count++;
+        insert_candidate(config, clexulator, search, config.get_param_composition(),
+                         search.eci * config.get_correlations(), hull);
+
+        changed_l.clear();
+        changed_val.clear();
+        Index l = 0;
+        for(; l < N_free; l++) {
+          int curr = config.occ(l);
+          if(curr < max_occ[l]) {
+            changed_l.push_back(l);
+            changed_val.push_back(curr + 1);
+            break;
+          }
+          if(curr != 0) {
+            changed_l.push_back(l);
+            changed_val.push_back(0);
+          }
+        }
+        if(l == N_free)
+          break;
+        config.set_occ(changed_l, changed_val, clexulator);
+      }
+
+      Profiler::count("occupations evaluated", count);
+    }
+
+    //*******************************************************************************************
+    /// One simulated annealing run in 'scel', using random number stream 'run'
+    void anneal_run(Supercell &scel, Index run, const GroundStateSearch &search, GroundStateHull &hull) {
+      MTRand::uint32 key[3] = {MTRand::uint32(search.seed), MTRand::uint32(scel.get_id()), MTRand::uint32(run)};
+      MTRand mtrand(key, 3);
+
+      Clexulator clexulator(search.clexulator);
+      Array<int> max_occ = scel.max_allowed_occupation();
+      Index N = max_occ.size();
+      Index V = scel.volume();
+
+      // random sublattice compositions: cut [0, V] at random points, then shuffle each sublattice (Fisher-Yates)
+      Array<int> occ;
+      for(Index b = 0; b * V < N; b++) {
+        std::vector<Index> cuts;
+        for(int k = 0; k < max_occ[b * V]; k++)
+          cuts.push_back(mtrand.randInt(V));
+        cuts.push_back(V);
+        std::sort(cuts.begin(), cuts.end());
+        Index prev = 0;
+        for(Index k = 0; k < cuts.size(); k++) {
+          occ.append(Array<int>(cuts[k] - prev, k));
+          prev = cuts[k];
+        }
+        for(Index i = V - 1; i > 0; i--)
+          std::swap(occ[b * V + i], occ[b * V + mtrand.randInt(i)]);
+      }
+
+      Configuration config(scel);
+      config.set_occupation(occ);
+      config.set_correlations(clexulator);
+      config.num_each_molecule();
+
+      // the composition does not change, so only the lowest energy occupation is a candidate
+      Eigen::VectorXd comp = config.get_param_composition();
+      double energy = search.eci * config.get_correlations();
+      double best_energy = energy;
+      Array<int> best_occ = config.occupation();
+
+      Array<Index> swap_l(2);
+      Array<int> swap_val(2);
+      for(Index s = 0; s < search.sweeps; s++) {
+        double frac = (search.sweeps > 1) ? double(s) / (search.sweeps - 1) : 1.0;
+        double beta = 1.0 / (search.kT_init * std::pow(search.kT_final / search.kT_init, frac));
+
+        for(Index attempt = 0; attempt < N; attempt++) {
+          swap_l[0] = mtrand.randInt(N - 1);
+          swap_l[1] = (swap_l[0] / V) * V + mtrand.randInt(V - 1);
+          swap_val[0] = config.occ(swap_l[1]);
+          swap_val[1] = config.occ(swap_l[0]);
+          if(swap_val[0] == swap_val[1])
+            continue;
+
+          config.set_occ(swap_l, swap_val, clexulator);
+          double new_energy = search.eci * config.get_correlations();
+          double dE = (new_energy - energy) * V;
+          if(dE <= 0.0 || mtrand.randExc() < std::exp(-beta * dE)) {
+            energy = new_energy;
+            if(energy < best_energy) {
+              best_energy = energy;
+              best_occ = config.occupation();
+            }
+          }
+          else {
+            std::swap(swap_val[0], swap_val[1]);
+            config.set_occ(swap_l, swap_val, clexulator);
+          }
+        }
+      }
+
+      config.set_occupation(best_occ);
+      insert_candidate(config, clexulator, search, comp, best_energy, hull);
+    }
+
+  }
+
+  //*******************************************************************************************
+
+  GroundStateHull search_ground_states(const Array<Supercell *> &scel, const GroundStateSearch &search) {
+    ProfileScope prof("search_ground_states");
+    using namespace GroundStateSearch_impl;
+
+    // split into tasks, and find how many sites are fixed in each piece of each supercell
+    std::vector<Task> tasks;
+    Array<Index> N_fixed(scel.size(), 0);
+    for(Index i = 0; i < scel.size(); i++) {
+      Index N_parts = search.runs;
+      if(!search.anneal) {
+        Array<int> max_occ = scel[i]->max_allowed_occupation();
+        N_parts = 1;
+        while(N_parts < min_pieces && N_fixed[i] < max_occ.size()) {
+          N_parts *= max_occ[max_occ.size() - 1 - N_fixed[i]] + 1;
+          N_fixed[i]++;
+        }
+      }
+      for(Index p = 0; p < N_parts; p++)
+        tasks.push_back(Task {i, p});
+    }
+
+    std::vector<GroundStateHull> result(tasks.size(), GroundStateHull(search.tol));
+    parallel_for(0, tasks.size(), [&](Index t) {
+      const Task &task = tasks[t];
+      if(search.anneal)
+        anneal_run(*scel[task.scel], task.part, search, result[t]);
+      else
+        enumerate_piece(*scel[task.scel], N_fixed[task.scel], task.part, search, result[t]);
+    });
+
+    // combine in task order
+    GroundStateHull hull(search.tol);
+    for(Index t = 0; t < tasks.size(); t++)
+      hull.insert(result[t]);
+
+    return hull;
+  }
+
+}
@@ -8,6 +8,7 @@
 
 #include "casm/crystallography/Structure.hh"
 #include "casm/clex/PrimClex.hh"
+#include "casm/system/Parallel.hh"
 
 namespace CASM {
 
@@ -168,6 +169,165 @@ namespace CASM {
 
   //---------------------------------------------------------------------------
 
+  namespace ParamComposition_impl {
+
+    //*********************************************************************
+    /// Returns false if the columns 'chosen' of 'directions' are linearly dependent, or if any column
+    /// of 'directions' that lies in their span has a negative coordinate in terms of them.
+    ///
+    /// If a set of spanning end members gives positive parametric compositions, every subset of it
+    /// passes this test, because a direction in the span of the subset has the same coordinates in
+    /// terms of the subset and in terms of the full set.
+    bool is_positive_in_span(const Eigen::MatrixXd &directions, const Array<Index> &chosen) {
+      Eigen::MatrixXd span(directions.rows(), chosen.size());
+      for(Index i = 0; i < chosen.size(); i++)
+        span.col(i) = directions.col(chosen[i]);
+
+      Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(span);
+      if(qr.rank() != chosen.size())
+        return false;
+
+      for(EigenIndex j = 0; j < directions.cols(); j++) {
+        Eigen::VectorXd coord = qr.solve(directions.col(j));
+        if(!almost_zero(Eigen::VectorXd(span * coord - directions.col(j)))) {
+          continue;
+        }
+        for(EigenIndex k = 0; k < coord.size(); k++) {
+          if(coord(k) < 0 && !almost_zero(coord(k)))
+            return false;
+        }
+      }
+      return true;
+    }
+
+    //*********************************************************************
+    /// Depth-first search for sets of 'N_spanning' columns of 'directions' that pass
+    /// is_positive_in_span, rejecting each partial set as soon as it fails.
+    ///
+    /// Column 'pos' is first left out and then chosen, so that the sets are found in the same
+    /// order as Array::next_permute visits the binary-choose arrays [0,...,0,1,...,1].
+    void search_spanning_sets(const Eigen::MatrixXd &directions,
+                              Index N_spanning,
+                              Index pos,
+                              Array<Index> &chosen,
+                              Array< Array<Index> > &result) {
+      if(chosen.size() == N_spanning) {
+        result.push_back(chosen);
+        return;
+      }
+      if(directions.cols() - pos < N_spanning - chosen.size())
+        return;
+
+      search_spanning_sets(directions, N_spanning, pos + 1, chosen, result);
+
+      chosen.push_back(pos);
+      if(is_positive_in_span(directions, chosen))
+        search_spanning_sets(directions, N_spanning, pos + 1, chosen, result);
+      chosen.pop_back();
+    }
+
+    //*********************************************************************
+    /// Returns true if 'v' is a nonnegative combination of the columns of 'generators', found by
+    /// the Lawson-Hanson active set method for nonnegative least squares.
+    ///
+    /// Only returns true after checking that the nonnegative coefficients found reproduce 'v', so
+    /// that an early exit or round-off can only cause a false negative.
+    bool is_nonnegative_combination(const Eigen::MatrixXd &generators, const Eigen::VectorXd &v) {
+      EigenIndex N = generators.cols();
+      if(N == 0)
+        return almost_zero(v);
+
+      Eigen::VectorXd x = Eigen::VectorXd::Zero(N);
+      Array<bool> is_passive(N, false);
+      Index max_iter = 3 * N;
+
+      for(Index iter = 0; iter < max_iter; iter++) {
+        // pick the zero coefficient that most decreases the residual
+        Eigen::VectorXd w = generators.transpose() * (v - generators * x);
+        EigenIndex best = -1;
+        for(EigenIndex j = 0; j < N; j++) {
+          if(!is_passive[j] && w(j) > TOL && (best < 0 || w(j) > w(best)))
+            best = j;
+        }
+        if(best < 0)
+          break;
+        is_passive[best] = true;
+
+        while(true) {
+          // least squares over the passive set
+          Array<EigenIndex> passive;
+          for(EigenIndex j = 0; j < N; j++) {
+            if(is_passive[j])
+              passive.push_back(j);
+          }
+          Eigen::MatrixXd sub(generators.rows(), passive.size());
+          for(Index j = 0; j < passive.size(); j++)
+            sub.col(j) = generators.col(passive[j]);
+          Eigen::VectorXd z_sub = sub.colPivHouseholderQr().solve(v);
+
+          Eigen::VectorXd z = Eigen::VectorXd::Zero(N);
+          bool is_feasible = true;
+          for(Index j = 0; j < passive.size(); j++) {
+            z(passive[j]) = z_sub(j);
+            if(z_sub(j) <= TOL)
+              is_feasible = false;
+          }
+          if(is_feasible) {
+            x = z;
+            break;
+          }
+
+          // step towards z until a coefficient hits zero, and drop it from the passive set
+          double alpha = 1.0;
+          for(Index j = 0; j < passive.size(); j++) {
+            EigenIndex p = passive[j];
+            if(z(p) <= TOL && x(p) - z(p) > TOL)
+              alpha = std::min(alpha, x(p) / (x(p) - z(p)));
+          }
+          x += alpha * (z - x);
+          for(Index j = 0; j < passive.size(); j++) {
+            if(x(passive[j]) <= TOL) {
+              x(passive[j]) = 0.0;
+              is_passive[passive[j]] = false;
+            }
+          }
+        }
+      }
+
+      for(EigenIndex j = 0; j < N; j++) {
+        if(x(j) < 0.0)
+          return false;
+      }
+      return almost_zero(Eigen::VectorXd(generators * x - v));
+    }
+
+    //*********************************************************************
+    /// Returns true if column 'j' of 'directions' is a nonnegative combination of the columns that
+    /// are not positive multiples of it.
+    ///
+    /// Such a direction is never part of an allowed set of spanning end members: if it were, the
+    /// other columns would have nonnegative coordinates in terms of the set, and so could only
+    /// combine to give column 'j' if they were all positive multiples of it.
+    bool is_redundant_direction(const Eigen::MatrixXd &directions, EigenIndex j) {
+      Eigen::VectorXd v = directions.col(j);
+      Array<EigenIndex> others;
+      for(EigenIndex k = 0; k < directions.cols(); k++) {
+        if(k == j)
+          continue;
+        // skip positive multiples of 'v', for which |v.d| == |v||d|
+        double dot = v.dot(directions.col(k));
+        if(dot > 0.0 && almost_zero(dot - v.norm() * directions.col(k).norm()))
+          continue;
+        others.push_back(k);
+      }
+
+      Eigen::MatrixXd generators(directions.rows(), others.size());
+      for(Index k = 0; k < others.size(); k++)
+        generators.col(k) = directions.col(others[k]);
+      return is_nonnegative_combination(generators, v);
+    }
+  }
+
   //*********************************************************************
   /* GENERATE_COMPOSITION_SPACE
 
@@ -177,30 +337,35 @@ namespace CASM {
        - start by finding the rank of the space that user has defined
          in the PRIM
        - pick one of the end_members as the origin. To enumerate all
-         possible axes, we loop through all possible end_members
+         possible axes, we loop through all possible end_members.
+         Each origin is searched independently, in parallel
+       - end members whose direction from the origin is a positive
+         combination of other directions are discarded (see
+         ParamComposition_impl::is_redundant_direction)
        - (rank-1) number of end_members are picked as spanning end
          members from the remaining list of end_members that we get
-         from the PRIM
-       - A composition object is calculated that is then used to
-         calculated the parametric Composition given the current
-         choice of end members and origin. If it results in positive
-         numbers for all the end members that are listed for the PRIM,
-         this set of (origin,spanning end members) is pushed back onto
-         the allowed list of composition axes
-       - The process is repeated for all such unique combinations of
-         (origin, spanning end members)
+         from the PRIM. They are picked one at a time, and a partial
+         set is abandoned as soon as its end members are linearly
+         dependent, or an end member in their span has a negative
+         parametric composition (see ParamComposition_impl::is_positive_in_span).
+         Because all the end members lie on the boundary of the
+         composition polytope, only sets along the edges of the
+         polytope at the origin survive this pruning
+       - A composition object is calculated for each surviving set
+         that is then used to calculated the parametric Composition
+         given the current choice of end members and origin. If it
+         results in positive numbers for all the end members that are
+         listed for the PRIM, this set of (origin,spanning end members)
+         is pushed back onto the allowed list of composition axes
+       - The allowed list is ordered by origin, and then in the order
+         that the binary-choose arrays of spanning end members are
+         permuted
    */
   //*********************************************************************
 
-
   void ParamComposition::generate_composition_space(bool verbose) {
     //Eigen object to do the QR decomposition of the list of prim_end_members
     Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qr(prim_end_members);
-    Eigen::VectorXd torigin; //temp origin
-    Eigen::VectorXd test_comp;
-    Array< Eigen::VectorXd > tspanning; //set of spanning end members
-    bool is_positive; //flag to test for positive composition axes
-    Array<int> priority_index;
 
     // If there is already a set of enumerated spaces for this
     // Composition object
@@ -214,75 +379,55 @@ namespace CASM {
     if(verbose)
       std::cout << "Rank of space : " << rank_of_space << std::endl;
 
-    //This array is used to figure out which of the end members to
-    //select as spanning end members
-    Array<int> binary_choose(prim_end_members.rows() - 1, 0);
-
-    //the priority index is used to pick a set of origin and end
-    //members to span the space
-    for(EigenIndex i = 0; i < prim_end_members.rows(); i++) {
-      priority_index.push_back(i);
-    }
-
-    for(int i = 0; i + 1 < (rank_of_space); i++) {
-      binary_choose[binary_choose.size() - 1 - i] = 1;
-    }
-    if(verbose)
-      std::cout << "Binary choose: " << binary_choose << std::endl;
-
     if(verbose)
       std::cout << "Computing the possible composition axes ... " << std::endl;
 
-    //loop through all the end members and start them off as the origin
-    for(EigenIndex i = 0; i < prim_end_members.rows(); i++) {
-      torigin = prim_end_members.row(i).transpose();
+    Index N_end = prim_end_members.rows();
+    Index N_spanning = std::max(rank_of_space - 1, 0);
 
-      if(verbose)
-        std::cout << "The origin is: " << torigin << std::endl;
+    // allowed[i] holds the allowed composition axes with end member 'i' as the origin
+    Array< Array<ParamComposition> > allowed(N_end);
 
-      //NOTE: priority seems to be a misnomer here, its really the
-      //list of end members that are in contention to be considered as
-      //the set of spanning end members. Consider changing the name
-      Array<int> tpriority = priority_index;
-      tpriority.remove(i); //remove the 'origin' from contention
-      Array<int> tbinary_choose = binary_choose;
+    parallel_for(0, N_end, [&](Index i) {
+      Eigen::VectorXd torigin = prim_end_members.row(i).transpose();
 
-      //loop over all permutations of priority_index and pick rank-1
-      //end members to span the space. Only keep those combinations
-      //that result in positive compositions
-      do {
-        tspanning.clear();
-        Array< Eigen::VectorXi > tvec; //hold the list of end members that are being considered
+      //the list of end members that are in contention to be considered as
+      //the set of spanning end members, and their directions from the origin
+      Eigen::MatrixXd all_directions(prim_end_members.cols(), N_end - 1);
+      for(Index j = 0, c = 0; j < N_end; j++) {
+        if(j == i)
+          continue;
+        all_directions.col(c++) = prim_end_members.row(j).transpose() - torigin;
+      }
 
-        if(verbose)
-          std::cout << "The end members being considered: " << std::endl;
+      // only directions along the edges of the composition polytope at the origin can be chosen
+      Array<EigenIndex> candidates;
+      for(EigenIndex j = 0; j < all_directions.cols(); j++) {
+        if(!ParamComposition_impl::is_redundant_direction(all_directions, j))
+          candidates.push_back(j);
+      }
+      Eigen::MatrixXd directions(prim_end_members.cols(), candidates.size());
+      for(Index j = 0; j < candidates.size(); j++)
+        directions.col(j) = all_directions.col(candidates[j]);
 
-        for(Index j = 0; j < tbinary_choose.size(); j++) {
-          if(tbinary_choose[j] == 1) {
-            tspanning.push_back((prim_end_members.row(tpriority[j]).transpose() - torigin));
-            tvec.push_back(prim_end_members.row(tpriority[j]).transpose().cast<int>());
-          }
-          if(verbose)
-            std::cout << prim_end_members.row(tpriority[j]) << std::endl;
-        }
+      Array<Index> chosen;
+      Array< Array<Index> > spanning_sets;
+      ParamComposition_impl::search_spanning_sets(directions, N_spanning, 0, chosen, spanning_sets);
 
-        if(verbose)
-          std::cout << "---" << std::endl;
+      for(Index s = 0; s < spanning_sets.size(); s++) {
+        Array< Eigen::VectorXd > tspanning; //set of spanning end members
+        for(Index j = 0; j < spanning_sets[s].size(); j++)
+          tspanning.push_back(directions.col(spanning_sets[s][j]));
 
         //initialize a ParamComposition object with these spanning vectors and origin
         ParamComposition tcomp = calc_composition_object(torigin, tspanning);
-        is_positive = true;
+        bool is_positive = true;
 
         //loop through end members and see what the values of the compositions works out to
-        if(verbose)
-          std::cout << "Calculated compositions:" << std::endl;
-
-        for(EigenIndex j = 0; j < prim_end_members.rows(); j++) {
+        for(EigenIndex j = 0; j < prim_end_members.rows() && is_positive; j++) {
           // Calculates the composition value given the previously
           // initialized Composition object
-          test_comp = tcomp.calc(prim_end_members.row(j), NUMBER_ATOMS);
-          if(verbose)
-            std::cout << prim_end_members.row(j) << "  :  " << test_comp << std::endl;
+          Eigen::VectorXd test_comp = tcomp.calc(prim_end_members.row(j), NUMBER_ATOMS);
 
           for(EigenIndex k = 0; k < test_comp.size(); k++) {
             //if the calculated parametric composition value is either
@@ -294,18 +439,20 @@ namespace CASM {
               break;
             }
           }
-          if(!is_positive) {
-            break;
-          }
         }
         if(is_positive) {
-          //push back this composition object, its good!
-          allowed_list.push_back(tcomp);
+          //keep this composition object, its good!
+          allowed[i].push_back(tcomp);
         }
+      }
+    });
 
+    for(Index i = 0; i < N_end; i++) {
+      if(verbose) {
+        std::cout << "The origin is: " << prim_end_members.row(i) << std::endl;
+        std::cout << "  allowed composition axes: " << allowed[i].size() << std::endl;
       }
-      while(tbinary_choose.next_permute());
-      fflush(stdout);
+      allowed_list.append(allowed[i]);
     }
     std::cout << "                                                                                                                          \r";
     fflush(stdout);
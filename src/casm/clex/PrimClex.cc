@@ -7,6 +7,7 @@
 #include "casm/clusterography/jsonClust.hh"
 #include "casm/system/RuntimeLibrary.hh"
 #include "casm/casm_io/SafeOfstream.hh"
+#include "casm/misc/Profile.hh"
 
 
 namespace CASM {
@@ -21,6 +22,7 @@ namespace CASM {
     prim(_prim),
     global_orbitree(_prim.lattice()) {
     //prim.generate_factor_group();
+    _generate_composition_index();
     return;
   };
 
@@ -35,6 +37,8 @@ namespace CASM {
     prim(read_prim(m_dir.prim())),
     global_orbitree(prim.lattice()) {
 
+    ProfileScope prof("PrimClex::PrimClex");
+
     //prim.generate_factor_group();
     bool any_print = false;
 
@@ -71,6 +75,7 @@ namespace CASM {
         m_comp_converter = opt.curr;
       }
     }
+    _generate_composition_index();
 
     // read supercells
     if(fs::is_regular_file(root / "training_data" / "SCEL")) {
@@ -203,6 +208,41 @@ namespace CASM {
     return m_comp_converter;
   }
 
+  //*******************************************************************************************
+  const Array<Molecule> &PrimClex::get_struc_molecule() const {
+    return m_struc_molecule;
+  }
+
+  //*******************************************************************************************
+  const Array< Array<int> > &PrimClex::get_struc_molecule_index() const {
+    return m_struc_molecule_index;
+  }
+
+  //*******************************************************************************************
+  const Array<int> &PrimClex::get_component_index() const {
+    return m_component_index;
+  }
+
+  //*******************************************************************************************
+  void PrimClex::_generate_composition_index() {
+    m_struc_molecule = prim.get_struc_molecule();
+    m_struc_molecule_index = get_index_converter(prim, m_struc_molecule);
+
+    m_component_index = Array<int>(m_struc_molecule.size(), -1);
+    if(!m_has_composition_axes)
+      return;
+
+    std::vector<std::string> components = m_comp_converter.components();
+    for(Index i = 0; i < m_struc_molecule.size(); i++) {
+      for(Index j = 0; j < components.size(); j++) {
+        if(m_struc_molecule[i].name == components[j]) {
+          m_component_index[i] = j;
+          break;
+        }
+      }
+    }
+  }
+
 
 
   // ** Prim and Orbitree accessors **
@@ -269,6 +309,33 @@ namespace CASM {
     return supercell_list[index];
   };
 
+  //*******************************************************************************************
+  std::shared_ptr<SupercellSymInfo> PrimClex::supercell_sym_info(const Matrix3<int> &transf_mat) const {
+    std::vector<int> key;
+    for(int i = 0; i < 3; i++) {
+      for(int j = 0; j < 3; j++)
+        key.push_back(transf_mat(i, j));
+    }
+
+    std::lock_guard<std::mutex> lock(m_supercell_sym_info_mutex);
+
+    // erase the entries of transformation matrices that no Supercell uses any more
+    for(auto it = m_supercell_sym_info.begin(); it != m_supercell_sym_info.end();) {
+      if(it->second.expired())
+        it = m_supercell_sym_info.erase(it);
+      else
+        ++it;
+    }
+
+    std::weak_ptr<SupercellSymInfo> &entry = m_supercell_sym_info[key];
+    std::shared_ptr<SupercellSymInfo> result = entry.lock();
+    if(!result) {
+      result = std::make_shared<SupercellSymInfo>();
+      entry = result;
+    }
+    return result;
+  }
+
   //*******************************************************************************************
   /// access configuration by name (of the form "scellname/[NUMBER]", e.g., ("SCEL1_1_1_1_0_0_0/0")
   const Configuration &PrimClex::configuration(const std::string &configname) const {
@@ -744,6 +811,7 @@ namespace CASM {
    */
   //*******************************************************************************************
   void PrimClex::generate_supercells(int volStart, int volEnd, bool verbose) {
+    ProfileScope prof("PrimClex::generate_supercells");
     Array < Lattice > supercell_lattices;
     prim.lattice().generate_supercells(supercell_lattices, prim.factor_group(), volEnd, volStart);    //point_group?
     for(Index i = 0; i < supercell_lattices.size(); i++) {
@@ -886,6 +954,7 @@ namespace CASM {
 
   //*******************************************************************************************
   void PrimClex::read_supercells(std::istream &stream) {
+    ProfileScope prof("PrimClex::read_supercells");
     // expect a file with format:
     //
     // Supercell Number: 0 Volume: 1
@@ -1002,6 +1071,7 @@ namespace CASM {
    */
   //*******************************************************************************************
   void PrimClex::read_config_list() {
+    ProfileScope prof("PrimClex::read_config_list");
 
     jsonParser json(get_config_list_path());
 
@@ -1072,6 +1142,7 @@ namespace CASM {
 
     m_comp_converter = _converter;
     m_has_composition_axes = true;
+    _generate_composition_index();
 
     // We need some way to make sure param compositions get updated...
     generate_references();
@@ -1316,6 +1387,13 @@ namespace CASM {
     return;
   }
 
+  //*******************************************************************************************
+  void PrimClex::populate_composition() const {
+    for(Index i = 0; i < supercell_list.size(); i++)
+      supercell_list[i].populate_composition();
+    return;
+  }
+
   //*******************************************************************************************
   Clexulator PrimClex::global_clexulator() const {
     if(!m_global_clexulator.initialized()) {
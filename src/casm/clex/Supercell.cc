@@ -10,8 +10,14 @@
 #include "casm/clex/ConfigIterator.hh"
 #include "casm/clex/ConfigEnum.hh"
 #include "casm/clex/ConfigEnumAllOccupations.hh"
+#include "casm/clex/ConfigEnumByComposition.hh"
+#include "casm/clex/ConfigEnumRandom.hh"
 #include "casm/clex/ConfigEnumInterpolation.hh"
 #include "casm/clex/Clexulator.hh"
+#include "casm/crystallography/PeriodicSiteHash.hh"
+#include "casm/misc/FFT.hh"
+#include "casm/misc/Profile.hh"
+#include "casm/system/Parallel.hh"
 
 namespace CASM {
 
@@ -30,19 +36,19 @@ namespace CASM {
   void Supercell::generate_neighbor_list() {
 
     nlists.resize(num_sites());
-
-    //Use the bijk->l map to populate the linear index
-    for(Index i = 0; i < num_sites(); i++) {
-
+    for(Index i = 0; i < num_sites(); i++)
       nlists[i].resize(get_primclex().get_nlist_size());
 
-      for(Index j = 0; j < nlists[i].size(); j++) {
+    //The neighbor at 'delta' of site i = b*volume() + l is find(uccoord(l) + delta), which
+    //does not depend on 'b', so find it once for all 'l' with integer arithmetic
+    for(Index j = 0; j < get_primclex().get_nlist_size(); j++) {
 
-        const UnitCellCoord &delta = get_primclex().get_nlist_uccoord(j);
+      const UnitCellCoord &delta = get_primclex().get_nlist_uccoord(j);
 
-        nlists[i][j] = find(uccoord(i) + delta);
+      Array<Index> translated = m_prim_grid.find_translated(delta);
 
-      }
+      for(Index i = 0; i < num_sites(); i++)
+        nlists[i][j] = delta[0] * volume() + translated[i % volume()];
     }
 
     return;
@@ -98,22 +104,39 @@ namespace CASM {
   /*****************************************************************/
 
   //Given a Site and tolerance, return linear index into Configuration
-  //   This may be slow, first converts Site -> UnitCellCoord,
-  //   then finds UnitCellCoord in config_index_to_bijk
+  //   Uses the spatial hash of Supercell sites, so that only nearby sites are compared.
+  //   If no site is found, falls back to Site -> UnitCellCoord conversion, which reports the error
   Index Supercell::get_linear_index(const Site &site, double tol) const {
-    //std::cout << "site: " << site << "  UCC: " << get_prim().get_unit_cell_coord(site, tol) << std::endl;
+    std::shared_ptr<PeriodicSiteHash> hash = _site_hash(tol);
+    const CoordinateBatch &batch(hash->batch());
+    const Structure &prim(get_prim());
+    Vector3<double> frac(batch.frac_from_cart(site(CART)));
+    double tol_sq = tol * tol;
+    Index l = hash->find_if(frac, [&](Index i) {
+      return batch.min_image_length_sq(batch.frac(i) - frac) < tol_sq
+             && prim.basis[get_b(i)].compare_type(site);
+    });
+    if(l < num_sites()) {
+      return l;
+    }
+
     Site tsite(site);
     tsite.within();
-    return find(get_prim().get_unit_cell_coord(tsite, tol));
+    return find(prim.get_unit_cell_coord(tsite, tol));
   };
 
   /*****************************************************************/
 
   //Given a Coordinate and tolerance, return linear index into Configuration
-  //   This may be slow, first converts Coordinate -> UnitCellCoord,
-  //   then finds UnitCellCoord in config_index_to_bijk
+  //   Uses the spatial hash of Supercell sites, so that only nearby sites are compared.
+  //   If no site is found, falls back to Coordinate -> UnitCellCoord conversion, which reports the error
   Index Supercell::get_linear_index(const Coordinate &coord, double tol) const {
-    //std::cout << "coord: " << coord << "  UCC: " << get_prim().get_unit_cell_coord(coord, tol) << std::endl;
+    std::shared_ptr<PeriodicSiteHash> hash = _site_hash(tol);
+    Index l = hash->find(hash->batch().frac_from_cart(coord(CART)), tol);
+    if(l < num_sites()) {
+      return l;
+    }
+
     Coordinate tcoord(coord);
     tcoord.within();
     return find(get_prim().get_unit_cell_coord(tcoord, tol));
@@ -121,12 +144,38 @@ namespace CASM {
 
   /*****************************************************************/
 
+  std::shared_ptr<PeriodicSiteHash> Supercell::_site_hash(double tol) const {
+    std::shared_ptr<PeriodicSiteHash> hash = std::atomic_load(&m_site_hash);
+    if(hash && tol <= hash->tol()) {
+      return hash;
+    }
+
+    hash = std::make_shared<PeriodicSiteHash>(real_super_lattice, std::max(tol, TOL));
+    hash->reserve(num_sites());
+    for(Index l = 0; l < num_sites(); l++) {
+      hash->push_back(coord(l));
+    }
+    std::atomic_store(&m_site_hash, hash);
+    return hash;
+  }
+
+  /*****************************************************************/
+
   Index Supercell::find(const UnitCellCoord &bijk) const {
     return bijk[0] * volume() + m_prim_grid.find(bijk);
   }
 
   /*****************************************************************/
 
+  ReturnArray<Index> Supercell::find(const Array<UnitCellCoord> &bijk) const {
+    Array<Index> result = m_prim_grid.find(bijk);
+    for(Index i = 0; i < bijk.size(); i++)
+      result[i] += bijk[i][0] * volume();
+    return result;
+  }
+
+  /*****************************************************************/
+
   Coordinate Supercell::coord(const UnitCellCoord &bijk) const {
     Coordinate tcoord(m_prim_grid.coord(bijk, SCEL));
     tcoord(CART) += (*primclex).get_prim().basis[bijk[0]](CART);
@@ -202,10 +251,37 @@ namespace CASM {
 
   /*****************************************************************/
 
+  SupercellSymInfo::~SupercellSymInfo() {
+    if(perm_symrep_ID != Index(-1) && factor_group.size() && factor_group[0].has_valid_master())
+      factor_group[0].master_group().remove_representation(perm_symrep_ID);
+  }
+
+  /*****************************************************************/
+
+  SupercellSymInfo &Supercell::_sym_info() const {
+    if(!m_sym_info)
+      m_sym_info = (*primclex).supercell_sym_info(transf_mat);
+    return *m_sym_info;
+  }
+
+  /*****************************************************************/
+
   const SymGroup &Supercell::factor_group() const {
-    if(!m_factor_group.size())
+    if(!_sym_info().factor_group.size())
       generate_factor_group();
-    return m_factor_group;
+    return _sym_info().factor_group;
+  }
+
+  /*****************************************************************/
+
+  // The permutation representation may have been made by another Supercell with the same
+  // transf_mat, in which case m_prim_grid still needs the integer arithmetic for factor_group()
+  Index Supercell::permutation_symrep_ID() const {
+    if(_sym_info().perm_symrep_ID == Index(-1))
+      generate_permutations();
+    else if(m_prim_grid.op_group() != &factor_group())
+      m_prim_grid.set_op_group(factor_group());
+    return _sym_info().perm_symrep_ID;
   }
 
   /*****************************************************************/
@@ -216,16 +292,14 @@ namespace CASM {
   }
   /*****************************************************************/
 
-  // PrimGrid populates translation permutations if needed
-  const Permutation &Supercell::translation_permute(Index i) const {
+  Permutation Supercell::translation_permute(Index i) const {
     return m_prim_grid.translation_permutation(i);
   }
 
   /*****************************************************************/
 
-  // PrimGrid populates translation permutations if needed
-  const Array<Permutation> &Supercell::translation_permute() const {
-    return m_prim_grid.translation_permutations();
+  ReturnArray<Permutation> Supercell::translation_permute() const {
+    return m_prim_grid.make_translation_permutations(basis_size());
   }
 
   /*****************************************************************/
@@ -299,11 +373,13 @@ namespace CASM {
       }
     }
 
+    Profiler::count("configurations added", config_list.size() - N_existing);
   }
 
   //*******************************************************************************
 
   void Supercell::enumerate_all_occupation_configurations() {
+    ProfileScope prof("Supercell::enumerate_all_occupation_configurations");
     Configuration init_config(*this), final_config(*this);
 
     init_config.set_occupation(Array<int>(num_sites(), 0));
@@ -316,6 +392,55 @@ namespace CASM {
 
   //*******************************************************************************
 
+  void Supercell::enumerate_composition_configurations(const Array<Array<int> > &sublat_num_each) {
+    ProfileScope prof("Supercell::enumerate_composition_configurations");
+    Configuration init_config(*this);
+    init_config.set_occupation(Array<int>(num_sites(), 0));
+
+    ConfigEnumByComposition<Configuration> enumerator(init_config, sublat_num_each, permute_begin(), permute_end());
+    add_enumerated_configurations(enumerator);
+
+  }
+
+  //*******************************************************************************
+
+  Index Supercell::sample_configurations(const RandomSampling &sampling, Index N_samples, unsigned long seed, Index N_streams) {
+    ProfileScope prof("Supercell::sample_configurations");
+
+    // generate the factor group and its permutations before the streams share them
+    permute_begin();
+
+    std::vector<std::vector<Configuration> > samples(N_streams);
+    parallel_for(0, N_streams, [&](Index s) {
+      MTRand::uint32 key[3] = {MTRand::uint32(seed), MTRand::uint32(get_id()), MTRand::uint32(s)};
+      MTRand mtrand(key, 3);
+
+      Configuration init_config(*this);
+      init_config.set_occupation(Array<int>(num_sites(), 0));
+
+      Index N = N_samples / N_streams + (s < N_samples % N_streams ? 1 : 0);
+      ConfigEnumRandom<Configuration> enumerator(init_config, *this, sampling, N, mtrand);
+      PermuteIterator it_canon;
+      for(auto it = enumerator.begin(); it != enumerator.end(); ++it) {
+        samples[s].push_back(it->canonical_form(permute_begin(), permute_end(), it_canon));
+        samples[s].back().set_source(it.source());
+      }
+    });
+
+    // add in stream order, so that config ids are reproducible
+    Index N_existing = config_list.size();
+    Index index;
+    for(Index s = 0; s < N_streams; s++) {
+      for(Index i = 0; i < samples[s].size(); i++)
+        add_canon_config(samples[s][i], index);
+    }
+
+    Profiler::count("configurations added", config_list.size() - N_existing);
+    return config_list.size() - N_existing;
+  }
+
+  //*******************************************************************************
+
   void Supercell::enumerate_interpolated_configurations(Supercell::config_const_iterator initial, Supercell::config_const_iterator final,
                                                         long Nstep, long begin_delta, long end_delta) {
 
@@ -765,7 +890,7 @@ namespace CASM {
     recip_prim_lattice(RHS.recip_prim_lattice),
     m_prim_grid((*primclex).get_prim().lattice(), real_super_lattice, (*primclex).get_prim().basis.size()),
     recip_grid(recip_prim_lattice, (*primclex).get_prim().lattice().get_reciprocal()),
-    m_perm_symrep_ID(-1),
+    m_sym_info(RHS.m_sym_info),
     name(RHS.name),
     nlists(RHS.nlists),
     config_list(RHS.config_list),
@@ -782,7 +907,6 @@ namespace CASM {
     recip_prim_lattice(real_super_lattice.get_reciprocal()),
     m_prim_grid((*primclex).get_prim().lattice(), real_super_lattice, (*primclex).get_prim().basis.size()),
     recip_grid(recip_prim_lattice, (*primclex).get_prim().lattice().get_reciprocal()),
-    m_perm_symrep_ID(-1),
     transf_mat(transf_mat_init) {
     scaling = 1.0;
     generate_name();
@@ -798,7 +922,6 @@ namespace CASM {
     recip_prim_lattice(real_super_lattice.get_reciprocal()),
     m_prim_grid((*primclex).get_prim().lattice(), real_super_lattice, (*primclex).get_prim().basis.size()),
     recip_grid(recip_prim_lattice, (*primclex).get_prim().lattice().get_reciprocal()),
-    m_perm_symrep_ID(-1),
     transf_mat(primclex->calc_transf_mat(superlattice)) {
     /*std::cerr << "IN SUPERCELL CONSTRUCTOR:\n"
               << "transf_mat is\n" << transf_mat << '\n'
@@ -831,8 +954,6 @@ namespace CASM {
     real_super_lattice.print(stream);
     Array<int> vacancies;
 
-    Array<Molecule> struc_molecule = get_prim().get_struc_molecule();
-
     //declare hash
     std::map<std::string, std::vector<int> > uccHash;
     // declare hash iterator (for comparisons in the loop)
@@ -1352,7 +1473,7 @@ namespace CASM {
         return std::to_string(config.get_param_composition()[index]);
       }
 
-      Array<Molecule> struc_molecule = (*primclex).get_prim().get_struc_molecule();
+      const Array<Molecule> &struc_molecule = (*primclex).get_struc_molecule();
 
       // 'true' composition i.e. include vacancies in the count
       auto true_comp_e = std::regex("true_comp\\((.*)\\)");
@@ -1388,19 +1509,23 @@ namespace CASM {
   //***********************************************************
 
   void Supercell::generate_factor_group()const {
-    real_super_lattice.find_invariant_subgroup(get_prim().factor_group(), m_factor_group);
-    m_factor_group.set_lattice(real_super_lattice, CART);
+    SymGroup &fg = _sym_info().factor_group;
+    real_super_lattice.find_invariant_subgroup(get_prim().factor_group(), fg);
+    fg.set_lattice(real_super_lattice, CART);
     return;
   }
 
   //***********************************************************
 
   void Supercell::generate_permutations()const {
-    if(m_perm_symrep_ID != Index(-1)) {
+    ProfileScope prof("Supercell::generate_permutations");
+    Index &perm_symrep_ID = _sym_info().perm_symrep_ID;
+    if(perm_symrep_ID != Index(-1)) {
       std::cerr << "WARNING: In Supercell::generate_permutations(), but permutations data already exists.\n"
                 << "         It will be overwritten.\n";
+      get_prim().factor_group().remove_representation(perm_symrep_ID);
     }
-    m_perm_symrep_ID = m_prim_grid.make_permutation_representation(factor_group(), get_prim().basis_permutation_symrep_ID());
+    perm_symrep_ID = m_prim_grid.make_permutation_representation(factor_group(), get_prim().basis_permutation_symrep_ID());
     //m_trans_permute = m_prim_grid.make_translation_permutations(basis_size()); <--moved to PrimGrid
 
     /*
@@ -1739,46 +1864,75 @@ namespace CASM {
     return is_commensurate;
   }
 
-  void Supercell::generate_fourier_matrix() {
-    generate_fourier_matrix(real_coordinates(), recip_coordinates(), true);
+  void Supercell::generate_kpoint_index() {
+    generate_kpoint_index(recip_coordinates(), true);
   }
 
-  void Supercell::generate_fourier_matrix(const Eigen::MatrixXd &real_coordinates, const Eigen::MatrixXd &recip_coordinates) {
-    generate_fourier_matrix(real_coordinates, recip_coordinates, false);
+  void Supercell::generate_kpoint_index(const Eigen::MatrixXd &recip_coordinates) {
+    generate_kpoint_index(recip_coordinates, false);
   }
 
-  void Supercell::generate_fourier_matrix(const Eigen::MatrixXd &real_coordinates, const Eigen::MatrixXd &recip_coordinates, const bool &override) {
-    //Validate the input matrices
-    if((real_coordinates.cols() != 3) || recip_coordinates.cols() != 3) {
-      std::cerr << "ERROR in generate_fourier_matrix, your matrices are incorrectly initialized" << std::endl;
+  void Supercell::generate_kpoint_index(const Eigen::MatrixXd &recip_coordinates, const bool &override) {
+    //Validate the input matrix
+    if(recip_coordinates.cols() != 3) {
+      std::cerr << "ERROR in generate_kpoint_index, your matrix is incorrectly initialized" << std::endl;
       std::cerr << "QUITTING" << std::endl;
       exit(666);
     }
     //Check if m_k_mesh is already full
     if(m_k_mesh.rows() != 0 || m_k_mesh.cols() != 0) {
-      std::cerr << "WARNING in Supercell::generate_fourier_matrix. You already have a k-mesh in this Supercell"
+      std::cerr << "WARNING in Supercell::generate_kpoint_index. You already have a k-mesh in this Supercell"
                 << " It will be overwritten" << std::endl;
     }
     m_k_mesh = recip_coordinates;
-    // Setup the size of _fourier_matrix which is only the -i*r*k'
-    Eigen::MatrixXcd _fourier_matrix(real_coordinates.rows(), m_k_mesh.rows());
-    std::complex<double> pre_factor(0, -1);
-    _fourier_matrix = pre_factor * real_coordinates * m_k_mesh.transpose();
-    //Exponentiate every element of _fourier matrix and store in m_fourier_matrix
-    m_fourier_matrix = _fourier_matrix.array().exp();
-    //Find all those k-point that are not commensurate with this supercell and
-    // set those columns of the fourier_matrix to be zeros
-    Array<bool> is_commensurate(recip_coordinates.rows(), true);
-    if(!override) {
-      is_commensurate = is_commensurate_kpoint(recip_coordinates);
-      for(int i = 0; i < m_fourier_matrix.cols(); i++) {
-        if(!is_commensurate[i]) {
-          m_fourier_matrix.col(i) = Eigen::MatrixXcd::Zero(m_fourier_matrix.rows(), 1);
+
+    // Columns of 'generators' are r_j = prim_lattice*U.col(j), the translations along the SNF axes
+    Matrix3<double> lat_vectors = get_prim().lattice().coord_trans(FRAC);
+    Eigen::Matrix3d generators;
+    for(int i = 0; i < 3; i++) {
+      for(int j = 0; j < 3; j++) {
+        generators(i, j) = 0.0;
+        for(int n = 0; n < 3; n++)
+          generators(i, j) += lat_vectors(i, n) * m_prim_grid.matrixU()(n, j);
+      }
+    }
+
+    //Find the FFT index of each k-point, or -1 for the k-points that are not commensurate with this supercell
+    m_k_index.resize(m_k_mesh.rows());
+    Array<bool> is_commensurate(m_k_mesh.rows(), true);
+    for(int i = 0; i < m_k_mesh.rows(); i++) {
+      Index stride = 1;
+      m_k_index[i] = 0;
+      for(int j = 0; j < 3; j++) {
+        int S = m_prim_grid.S(j);
+        double n_j = S * m_k_mesh.row(i).dot(generators.col(j)) / (2.0 * M_PI);
+        if(std::abs(round(n_j) - n_j) > TOL) {
+          is_commensurate[i] = false;
+          break;
         }
+        m_k_index[i] += (((Index(round(n_j)) % S) + S) % S) * stride;
+        stride *= S;
+      }
+      if(!is_commensurate[i])
+        m_k_index[i] = -1;
+    }
+
+    //With override, the incommensurate k-points are not zeroed, and their phases are stored to sum directly
+    m_incommensurate_k.clear();
+    for(int i = 0; override && i < m_k_mesh.rows(); i++) {
+      if(!is_commensurate[i])
+        m_incommensurate_k.push_back(i);
+    }
+    m_incommensurate_fourier.resize(volume(), m_incommensurate_k.size());
+    if(m_incommensurate_k.size()) {
+      Eigen::MatrixXd real_coords = real_coordinates();
+      std::complex<double> pre_factor(0, -1);
+      for(Index c = 0; c < m_incommensurate_k.size(); c++) {
+        Eigen::VectorXd kr = real_coords * m_k_mesh.row(m_incommensurate_k[c]).transpose();
+        m_incommensurate_fourier.col(c) = (pre_factor * kr).array().exp();
       }
     }
     generate_phase_factor((*primclex).shift_vectors(), is_commensurate, override);
-    //    std::cout<<"Fourier Matrix:"<<std::endl<<m_fourier_matrix<<std::endl;
   }
 
   void Supercell::generate_phase_factor(const Eigen::MatrixXd &shift_vectors, const Array<bool> &is_commensurate, const bool &override) {
@@ -1799,9 +1953,34 @@ namespace CASM {
     //std::cout<<"Phase factors:"<<std::endl<<m_phase_factor<<std::endl;
   }
 
+  /// Each sublattice is transformed with one fft_3d over the Smith normal form grid, so the cost is
+  /// O(V log V) per sublattice, and the elements at the k-points of k_mesh() are picked out using m_k_index.
+  /// Incommensurate k-points, kept only with override, are summed directly in O(V) each.
+  Eigen::MatrixXcd Supercell::sublat_struct_fact(const Eigen::VectorXd &intensities) const {
+    ProfileScope prof("Supercell::sublat_struct_fact");
+    Index V = volume();
+    int S[3] = {m_prim_grid.S(0), m_prim_grid.S(1), m_prim_grid.S(2)};
+    Eigen::MatrixXcd sublat_sf = Eigen::MatrixXcd::Zero(m_k_index.size(), basis_size());
+    std::vector<std::complex<double> > grid(V);
+    for(Index b = 0; b < basis_size(); b++) {
+      for(Index l = 0; l < V; l++)
+        grid[l] = intensities(b * V + l);
+      fft_3d(grid.data(), S);
+      for(Index i = 0; i < m_k_index.size(); i++) {
+        if(m_k_index[i] >= 0)
+          sublat_sf(i, b) = grid[m_k_index[i]] / double(V);
+      }
+      for(Index c = 0; c < m_incommensurate_k.size(); c++) {
+        std::complex<double> sum = (m_incommensurate_fourier.col(c).array() * intensities.segment(b * V, V).array()).sum();
+        sublat_sf(m_incommensurate_k[c], b) = sum / double(V);
+      }
+    }
+    return sublat_sf;
+  }
+
   void Supercell::populate_structure_factor() {
-    if(m_fourier_matrix.rows() == 0 || m_fourier_matrix.cols() == 0 || m_phase_factor.rows() == 0 || m_phase_factor.cols() == 0) {
-      generate_fourier_matrix();
+    if(m_k_index.size() == 0 || m_phase_factor.rows() == 0 || m_phase_factor.cols() == 0) {
+      generate_kpoint_index();
     }
     for(Index i = 0; i < config_list.size(); i++) {
       populate_structure_factor(i);
@@ -1810,13 +1989,22 @@ namespace CASM {
   }
 
   void Supercell::populate_structure_factor(const Index &config_index) {
-    if(m_fourier_matrix.rows() == 0 || m_fourier_matrix.cols() == 0 || m_phase_factor.rows() == 0 || m_phase_factor.cols() == 0) {
-      generate_fourier_matrix();
+    if(m_k_index.size() == 0 || m_phase_factor.rows() == 0 || m_phase_factor.cols() == 0) {
+      generate_kpoint_index();
     }
     config_list[config_index].calc_struct_fact();
     return;
   }
 
+  //*******************************************************************************************
+  /// Each Configuration only writes its own count, so the configurations can be counted in parallel
+  void Supercell::populate_composition() const {
+    ProfileScope prof("Supercell::populate_composition");
+    parallel_for(0, config_list.size(), [&](Index i) {
+      config_list[i].num_each_molecule();
+    });
+  }
+
 
 }
 
@@ -0,0 +1,84 @@
+#include "casm/clusterography/ClusterKey.hh"
+
+#include <algorithm>
+
+#include "casm/crystallography/Coordinate.hh"
+
+namespace CASM {
+
+  void ClusterKey::canonicalize(bool periodic) {
+    _sort(m_val);
+    if(!periodic || !size())
+      return;
+
+    // after sorting, the first site has the smallest basis index, so the smallest key
+    // has one of the sites on that basis index at the front
+    std::vector<long> best, tval(m_val.size());
+    for(Index s = 0; s < size() && m_val[4 * s] == m_val[0]; s++) {
+      for(Index i = 0; i < size(); i++) {
+        tval[4 * i] = m_val[4 * i];
+        for(Index j = 1; j < 4; j++) {
+          tval[4 * i + j] = m_val[4 * i + j] - m_val[4 * s + j];
+        }
+      }
+      _sort(tval);
+      if(!best.size() || tval < best)
+        best = tval;
+    }
+    m_val.swap(best);
+  }
+
+  //*******************************************************************************************
+
+  std::size_t ClusterKey::hash() const {
+    // FNV-1a, one long at a time
+    std::size_t result = 14695981039346656037ULL;
+    for(Index i = 0; i < m_val.size(); i++) {
+      result ^= std::size_t(m_val[i]);
+      result *= 1099511628211ULL;
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  void ClusterKey::_sort(std::vector<long> &val) {
+    // insertion sort on (b, i, j, k) tuples; clusters are small
+    long tmp[4];
+    Index N = val.size() / 4;
+    for(Index s = 1; s < N; s++) {
+      Index t = s;
+      while(t > 0 && std::lexicographical_compare(val.begin() + 4 * t, val.begin() + 4 * t + 4,
+                                                  val.begin() + 4 * (t - 1), val.begin() + 4 * t)) {
+        std::copy(val.begin() + 4 * t, val.begin() + 4 * t + 4, tmp);
+        std::copy(val.begin() + 4 * (t - 1), val.begin() + 4 * t, val.begin() + 4 * t);
+        std::copy(tmp, tmp + 4, val.begin() + 4 * (t - 1));
+        t--;
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  Vector3<double> ClusterKeyMaker::cart(Index b, const Vector3<int> &ijk) const {
+    Vector3<double> frac(basis_frac(b));
+    for(int i = 0; i < 3; i++)
+      frac[i] += ijk[i];
+    return m_hash.batch().cart_from_frac(frac);
+  }
+
+  //*******************************************************************************************
+
+  bool ClusterKeyMaker::find(const Coordinate &site, Index &b, Vector3<int> &ijk) const {
+    Vector3<double> frac(m_hash.batch().frac_from_cart(site(CART)));
+    b = m_hash.find(frac, m_hash.tol());
+    if(b == size())
+      return false;
+
+    Vector3<double> bfrac(basis_frac(b));
+    for(int i = 0; i < 3; i++)
+      ijk[i] = round(frac[i] - bfrac[i]);
+    return true;
+  }
+
+}
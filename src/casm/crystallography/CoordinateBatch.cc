@@ -0,0 +1,218 @@
+#include "casm/crystallography/CoordinateBatch.hh"
+
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/Coordinate.hh"
+
+namespace CASM {
+
+  CoordinateBatch::CoordinateBatch(const Lattice &home) {
+    _set_home(home);
+  }
+
+  //*******************************************************************************************
+
+  void CoordinateBatch::_set_home(const Lattice &home) {
+    const Matrix3<double> &L(home.lat_column_mat());
+    const Matrix3<double> &invL(home.inv_lat_column_mat());
+    for(int i = 0; i < 3; i++) {
+      for(int j = 0; j < 3; j++) {
+        m_lat[3 * i + j] = L(i, j);
+        m_inv_lat[3 * i + j] = invL(i, j);
+      }
+    }
+
+    // G(i,j) = dot(L.col(i), L.col(j))
+    int ind[6][2] = {{0, 0}, {1, 1}, {2, 2}, {0, 1}, {0, 2}, {1, 2}};
+    for(int n = 0; n < 6; n++) {
+      m_metric[n] = 0.0;
+      for(int k = 0; k < 3; k++) {
+        m_metric[n] += m_lat[3 * k + ind[n][0]] * m_lat[3 * k + ind[n][1]];
+      }
+    }
+  }
+
+  //*******************************************************************************************
+
+  void CoordinateBatch::clear() {
+    for(int i = 0; i < 3; i++)
+      m_frac[i].clear();
+    m_type.clear();
+  }
+
+  //*******************************************************************************************
+
+  void CoordinateBatch::reserve(Index N) {
+    for(int i = 0; i < 3; i++)
+      m_frac[i].reserve(N);
+    m_type.reserve(N);
+  }
+
+  //*******************************************************************************************
+
+  void CoordinateBatch::push_back(const Vector3<double> &frac, Index type) {
+    for(int i = 0; i < 3; i++)
+      m_frac[i].push_back(frac[i]);
+    m_type.push_back(type);
+  }
+
+  //*******************************************************************************************
+
+  void CoordinateBatch::push_back(const Coordinate &coord, Index type) {
+    push_back(frac_from_cart(coord(CART)), type);
+  }
+
+  //*******************************************************************************************
+
+  void CoordinateBatch::set(Index i, const Vector3<double> &frac) {
+    for(int k = 0; k < 3; k++)
+      m_frac[k][i] = frac[k];
+  }
+
+  //*******************************************************************************************
+
+  Vector3<double> CoordinateBatch::frac(Index i) const {
+    return Vector3<double>(m_frac[0][i], m_frac[1][i], m_frac[2][i]);
+  }
+
+  //*******************************************************************************************
+
+  bool CoordinateBatch::has_home(const Lattice &home) const {
+    const Matrix3<double> &L(home.lat_column_mat());
+    for(int i = 0; i < 3; i++) {
+      for(int j = 0; j < 3; j++) {
+        if(m_lat[3 * i + j] != L(i, j))
+          return false;
+      }
+    }
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  Vector3<double> CoordinateBatch::frac_from_cart(const Vector3<double> &cart) const {
+    Vector3<double> result;
+    for(int i = 0; i < 3; i++) {
+      result[i] = m_inv_lat[3 * i] * cart[0] + m_inv_lat[3 * i + 1] * cart[1] + m_inv_lat[3 * i + 2] * cart[2];
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  Vector3<double> CoordinateBatch::cart_from_frac(const Vector3<double> &frac) const {
+    Vector3<double> result;
+    for(int i = 0; i < 3; i++) {
+      result[i] = m_lat[3 * i] * frac[0] + m_lat[3 * i + 1] * frac[1] + m_lat[3 * i + 2] * frac[2];
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  double CoordinateBatch::length_sq(const Vector3<double> &dfrac) const {
+    const double *G = m_metric;
+    return G[0] * dfrac[0] * dfrac[0] + G[1] * dfrac[1] * dfrac[1] + G[2] * dfrac[2] * dfrac[2]
+           + 2.0 * (G[3] * dfrac[0] * dfrac[1] + G[4] * dfrac[0] * dfrac[2] + G[5] * dfrac[1] * dfrac[2]);
+  }
+
+  //*******************************************************************************************
+
+  double CoordinateBatch::min_image_length_sq(const Vector3<double> &dfrac) const {
+    return length_sq(Vector3<double>(_wrap(dfrac[0]), _wrap(dfrac[1]), _wrap(dfrac[2])));
+  }
+
+  //*******************************************************************************************
+
+  void CoordinateBatch::dist_sq(const Vector3<double> &pos, double *dist_sq) const {
+    const double G0(m_metric[0]), G1(m_metric[1]), G2(m_metric[2]);
+    const double G3(2.0 * m_metric[3]), G4(2.0 * m_metric[4]), G5(2.0 * m_metric[5]);
+    const double p0(pos[0]), p1(pos[1]), p2(pos[2]);
+    const double *x(m_frac[0].data()), *y(m_frac[1].data()), *z(m_frac[2].data());
+    const Index N(size());
+
+    for(Index i = 0; i < N; i++) {
+      double d0 = x[i] - p0;
+      double d1 = y[i] - p1;
+      double d2 = z[i] - p2;
+      dist_sq[i] = G0 * d0 * d0 + G1 * d1 * d1 + G2 * d2 * d2 + G3 * d0 * d1 + G4 * d0 * d2 + G5 * d1 * d2;
+    }
+  }
+
+  //*******************************************************************************************
+
+  void CoordinateBatch::min_image_dist_sq(const Vector3<double> &pos, double *dist_sq) const {
+    const double G0(m_metric[0]), G1(m_metric[1]), G2(m_metric[2]);
+    const double G3(2.0 * m_metric[3]), G4(2.0 * m_metric[4]), G5(2.0 * m_metric[5]);
+    const double p0(pos[0]), p1(pos[1]), p2(pos[2]);
+    const double *x(m_frac[0].data()), *y(m_frac[1].data()), *z(m_frac[2].data());
+    const Index N(size());
+
+    for(Index i = 0; i < N; i++) {
+      double d0 = x[i] - p0;
+      double d1 = y[i] - p1;
+      double d2 = z[i] - p2;
+      d0 -= std::floor(d0 + 0.5);
+      d1 -= std::floor(d1 + 0.5);
+      d2 -= std::floor(d2 + 0.5);
+      dist_sq[i] = G0 * d0 * d0 + G1 * d1 * d1 + G2 * d2 * d2 + G3 * d0 * d1 + G4 * d0 * d2 + G5 * d1 * d2;
+    }
+  }
+
+  //*******************************************************************************************
+
+  Index CoordinateBatch::find(const Vector3<double> &pos, double tol, Index type) const {
+    double dist;
+    return find(pos, tol, type, dist);
+  }
+
+  //*******************************************************************************************
+
+  Index CoordinateBatch::find(const Vector3<double> &pos, double tol, Index type, double &dist) const {
+    m_dist_sq.resize(size());
+    min_image_dist_sq(pos, m_dist_sq.data());
+
+    double tol_sq = tol * tol;
+    for(Index i = 0; i < size(); i++) {
+      if(m_dist_sq[i] < tol_sq && (!valid_index(type) || m_type[i] == type)) {
+        dist = std::sqrt(m_dist_sq[i]);
+        return i;
+      }
+    }
+    return size();
+  }
+
+  //*******************************************************************************************
+
+  Index CoordinateBatch::nearest(const Vector3<double> &pos, double &dist) const {
+    m_dist_sq.resize(size());
+    min_image_dist_sq(pos, m_dist_sq.data());
+
+    Index best = size();
+    for(Index i = 0; i < size(); i++) {
+      if(best == size() || m_dist_sq[i] < m_dist_sq[best])
+        best = i;
+    }
+    if(best < size())
+      dist = std::sqrt(m_dist_sq[best]);
+    return best;
+  }
+
+  //*******************************************************************************************
+
+  bool CoordinateBatch::match(const CoordinateBatch &other, const Vector3<double> &shift, double tol,
+                              Array<Index> &perm, double &max_error) const {
+    perm.resize(size());
+    max_error = 0.0;
+    double dist;
+    for(Index i = 0; i < size(); i++) {
+      Vector3<double> pos(m_frac[0][i] + shift[0], m_frac[1][i] + shift[1], m_frac[2][i] + shift[2]);
+      perm[i] = other.find(pos, tol, m_type[i], dist);
+      if(perm[i] == other.size())
+        return false;
+      if(dist > max_error)
+        max_error = dist;
+    }
+    return true;
+  }
+
+}
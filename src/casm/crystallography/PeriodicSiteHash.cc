@@ -0,0 +1,162 @@
+#include "casm/crystallography/PeriodicSiteHash.hh"
+
+#include <algorithm>
+
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/Coordinate.hh"
+
+namespace CASM {
+
+  PeriodicSiteHash::PeriodicSiteHash() :
+    m_batch(Lattice()), m_tol(TOL) {
+    _set_home(Lattice());
+    _rebin();
+  }
+
+  //*******************************************************************************************
+
+  PeriodicSiteHash::PeriodicSiteHash(const Lattice &home, double tol) :
+    m_batch(home), m_tol(tol) {
+    _set_home(home);
+    _rebin();
+  }
+
+  //*******************************************************************************************
+
+  void PeriodicSiteHash::_set_home(const Lattice &home) {
+    // the spacing between lattice planes normal to lattice direction 'k' is 1/|row k of inverse lattice matrix|
+    const Matrix3<double> &inv_lat(home.inv_lat_column_mat());
+    for(int k = 0; k < 3; k++) {
+      m_height[k] = 1.0 / std::sqrt(inv_lat(k, 0) * inv_lat(k, 0) + inv_lat(k, 1) * inv_lat(k, 1) + inv_lat(k, 2) * inv_lat(k, 2));
+    }
+    m_vol = std::abs(home.vol());
+  }
+
+  //*******************************************************************************************
+
+  void PeriodicSiteHash::_rebin() {
+
+    // Choose about one bin per position, subject to the constraint that bins must be
+    // at least 'tol' wide (plus a small margin for round-off)
+    m_capacity = std::max(size(), Index(8));
+    double density = (m_vol > 0.0) ? double(m_capacity) / m_vol : 0.0;
+    Index tot = 1;
+    for(int k = 0; k < 3; k++) {
+      double max_N = std::floor(m_height[k] / (1.01 * m_tol));
+      double target = std::ceil(m_height[k] * std::cbrt(density));
+      m_N[k] = int(std::max(1.0, std::min(std::min(target, max_N), double(m_capacity))));
+      tot *= m_N[k];
+
+      m_offset[k].assign(1, 0);
+      if(m_N[k] > 1)
+        m_offset[k].push_back(1);
+      if(m_N[k] > 2)
+        m_offset[k].push_back(-1);
+    }
+
+    m_bin.assign(tot, std::vector<Index>());
+    for(Index i = 0; i < size(); i++) {
+      m_bin[_bin_index(m_batch.frac(i))].push_back(i);
+    }
+  }
+
+  //*******************************************************************************************
+
+  void PeriodicSiteHash::clear() {
+    m_batch.clear();
+    _rebin();
+  }
+
+  //*******************************************************************************************
+
+  void PeriodicSiteHash::push_back(const Vector3<double> &frac, Index type) {
+    m_batch.push_back(frac, type);
+    if(size() > 2 * m_capacity) {
+      _rebin();
+    }
+    else {
+      m_bin[_bin_index(frac)].push_back(size() - 1);
+    }
+  }
+
+  //*******************************************************************************************
+
+  void PeriodicSiteHash::push_back(const Coordinate &coord, Index type) {
+    push_back(m_batch.frac_from_cart(coord(CART)), type);
+  }
+
+  //*******************************************************************************************
+
+  Index PeriodicSiteHash::find(const Vector3<double> &frac, double tol, Index type) const {
+    double tol_sq = tol * tol;
+    const CoordinateBatch &batch(m_batch);
+    return find_if(frac, [&](Index i) {
+      return (!valid_index(type) || batch.type(i) == type)
+             && batch.min_image_length_sq(batch.frac(i) - frac) < tol_sq;
+    });
+  }
+
+  //*******************************************************************************************
+
+  bool PeriodicSiteHash::match(const CoordinateBatch &sites, const Vector3<double> &shift, double tol, double &max_error) const {
+    max_error = 0.0;
+    if(sites.size() != size())
+      return false;
+
+    for(Index i = 0; i < sites.size(); i++) {
+      Vector3<double> pos(sites.frac(i) + shift);
+      Index j = find(pos, tol, sites.type(i));
+      if(j == size())
+        return false;
+      double dist = std::sqrt(m_batch.min_image_length_sq(m_batch.frac(j) - pos));
+      if(dist > max_error)
+        max_error = dist;
+    }
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  void PeriodicSiteHash::find_translations(const CoordinateBatch &sites, double tol,
+                                           Array<Vector3<double> > &trans, Array<double> &max_error,
+                                           bool first_only) const {
+    trans.clear();
+    max_error.clear();
+    if(!size() || sites.size() != size())
+      return;
+
+    // number of hashed positions with each type label
+    std::vector<Index> count;
+    for(Index i = 0; i < size(); i++) {
+      if(m_batch.type(i) >= Index(count.size()))
+        count.resize(m_batch.type(i) + 1, 0);
+      count[m_batch.type(i)]++;
+    }
+
+    Index rare = -1;
+    for(Index t = 0; t < Index(count.size()); t++) {
+      if(count[t] && (!valid_index(rare) || count[t] < count[rare]))
+        rare = t;
+    }
+
+    Index ref = 0;
+    while(m_batch.type(ref) != rare)
+      ref++;
+
+    Vector3<double> ref_frac(m_batch.frac(ref));
+    double error;
+    for(Index b = 0; b < sites.size(); b++) {
+      if(sites.type(b) != rare)
+        continue;
+
+      Vector3<double> shift(ref_frac - sites.frac(b));
+      if(match(sites, shift, tol, error)) {
+        trans.push_back(shift);
+        max_error.push_back(error);
+        if(first_only)
+          return;
+      }
+    }
+  }
+
+}
@@ -8,11 +8,12 @@
 #include "casm/crystallography/Coordinate.hh"
 #include "casm/crystallography/UnitCellCoord.hh"
 
+#include "casm/symmetry/SymGroup.hh"
 #include "casm/symmetry/SymGroupRep.hh"
 #include "casm/symmetry/SymPermutation.hh"
 
 namespace CASM {
-  PrimGrid::PrimGrid(const Lattice &p_lat, const Lattice &s_lat, Index NB) {
+  PrimGrid::PrimGrid(const Lattice &p_lat, const Lattice &s_lat, Index NB) : m_op_group(NULL) {
     m_lat[PRIM] = &p_lat;
     m_lat[SCEL] = &s_lat;
 
@@ -67,6 +68,8 @@ namespace CASM {
     Smat(2, 2) = m_N_vol / Smat(2, 2);
     m_plane_mat = V.inverse() * Smat * m_U.inverse();
 
+    _generate_index_tables();
+
     /*
     std::cerr << "trans_mat is:\n" << m_trans_mat << "\n\nplane_mat is:\n" << m_plane_mat << "\n\n";
 
@@ -84,7 +87,7 @@ namespace CASM {
 
   //**********************************************************************************************
   // Constructor for forcing specific choice of 'U' matrix.  Use only in very specific cases (such as applying symmetry to a PrimGrid
-  PrimGrid::PrimGrid(const Lattice &p_lat, const Lattice &s_lat, const Matrix3<int> &U, const Matrix3<int> &Smat, Index NB) : m_U(U) {
+  PrimGrid::PrimGrid(const Lattice &p_lat, const Lattice &s_lat, const Matrix3<int> &U, const Matrix3<int> &Smat, Index NB) : m_U(U), m_op_group(NULL) {
     m_lat[PRIM] = &p_lat;
     m_lat[SCEL] = &s_lat;
 
@@ -119,6 +122,8 @@ namespace CASM {
 
     m_plane_mat = m_trans_mat.adjugate();
 
+    _generate_index_tables();
+
     /*
     std::cerr << "trans_mat is:\n" << m_trans_mat << "\n\nplane_mat is:\n" << m_plane_mat << "\n\n";
 
@@ -160,11 +165,27 @@ namespace CASM {
 
   //**********************************************************************************************
 
-  Index PrimGrid::find(const UnitCellCoord &bijk) const {
+  /// Translational equivalents of 'bijk' differ by trans_mat*x = U*S*V*x, for integer x, so
+  /// their canonical coordinates invU*ijk differ by S*V*x and are equal after mapping within bounds.
+  /// This avoids the m_plane_mat and m_trans_mat multiplications of get_within()
+
+  ReturnArray<Index> PrimGrid::find(const Array<UnitCellCoord> &bijk) const {
+    Array<Index> result;
+    result.reserve(bijk.size());
+    for(Index i = 0; i < bijk.size(); i++)
+      result.push_back(_mnp_index(_mnp(bijk[i])));
+    return result;
+  }
 
-    UnitCellCoord bmnp = to_canonical(get_within(bijk));
+  //**********************************************************************************************
 
-    return bmnp[1] + bmnp[2] * m_stride[0] + bmnp[3] * m_stride[1];
+  ReturnArray<Index> PrimGrid::find_translated(const UnitCellCoord &delta) const {
+    Vector3<int> delta_mnp = _mnp(delta);
+    Array<Index> result;
+    result.reserve(size());
+    for(Index l = 0; l < size(); l++)
+      result.push_back(_mnp_index(_mnp(l) + delta_mnp));
+    return result;
   }
 
   //**********************************************************************************************
@@ -227,21 +248,11 @@ namespace CASM {
 
   //**********************************************************************************************
 
-  UnitCellCoord PrimGrid::uccoord(Index i)const {
-    assert(i >= 0 && i < m_N_vol && "PrimGrid::uccoord(Index i) -> index 'i' out of range!");
-
-    UnitCellCoord bmnp(-1,
-                       (i % m_stride[1]) % m_stride[0],
-                       (i % m_stride[1]) / m_stride[0],
-                       i / m_stride[1]);
-    return from_canonical(bmnp);
-  }
-
-  //**********************************************************************************************
 
   Index PrimGrid::make_permutation_representation(const SymGroup &group, Index basis_permute_ID)const {
 
     Index perm_rep_ID = group.make_empty_representation();
+    set_op_group(group);
     Array<UnitCellCoord> const *b_permute;
     Matrix3<int> frac_ijk, frac_mnp;
     UnitCellCoord bmnp_shift;
@@ -339,6 +350,16 @@ namespace CASM {
     }
     return perms;
   }
+
+  //**********************************************************************************************
+
+  Permutation PrimGrid::translation_permutation(Index l) const {
+    Array<Index> ipermute(m_NB * size());
+    for(Index i = 0; i < ipermute.size(); i++)
+      ipermute[i] = translation_permute_ind(l, i);
+    return Permutation(ipermute);
+  }
+
   // private functions:
 
   //**********************************************************************************************
@@ -370,9 +391,110 @@ namespace CASM {
     return get_within(bijk);
   };
 
+  //**********************************************************************************************
+
+  void PrimGrid::_generate_index_tables() {
+    m_uccoords.clear();
+    m_uccoords.reserve(m_N_vol);
+    for(Index l = 0; l < m_N_vol; l++) {
+      Vector3<int> mnp = _mnp(l);
+      m_uccoords.push_back(from_canonical(UnitCellCoord(-1, mnp[0], mnp[1], mnp[2])));
+    }
+
+    m_site_mnp.clear();
+    m_site_mnp.reserve(m_NB * m_N_vol);
+    for(Index i = 0; i < m_NB * m_N_vol; i++)
+      m_site_mnp.push_back(_mnp(i % m_N_vol));
+  }
+
   //==============================================================================================
   SymOp PrimGrid::sym_op(Index l) const {
     return SymOp(coord(l, PRIM));
   }
-}
 
+  //**********************************************************************************************
+
+  SymGroup const *PrimGrid::op_group() const {
+    if(m_op_group && m_op_group->size() == m_op_mnp.size())
+      return m_op_group;
+    return NULL;
+  }
+
+  //**********************************************************************************************
+
+  void PrimGrid::set_op_group(const SymGroup &group) const {
+    m_op_group = &group;
+    m_op_mnp.clear();
+    m_op_cart.clear();
+    m_op_tau.clear();
+    m_prod_trans.clear();
+    m_inv_trans.clear();
+
+    m_op_mnp.reserve(group.size());
+    m_op_cart.reserve(group.size());
+    m_op_tau.reserve(group.size());
+    for(Index ng = 0; ng < group.size(); ng++) {
+      SymOp op(group[ng]);
+      op.set_lattice(*(m_lat[PRIM]), CART);
+      m_op_mnp.push_back(m_invU * round(op.get_matrix(FRAC)) * m_U);
+      m_op_cart.push_back(op.get_matrix(CART));
+      const Vector3<double> &tau(op.tau()(CART));
+      m_op_tau.push_back(Eigen::Vector3d(tau[0], tau[1], tau[2]));
+    }
+  }
+
+  //**********************************************************************************************
+
+  Index PrimGrid::_lattice_trans(const Eigen::Vector3d &from, const Eigen::Vector3d &to) const {
+    Eigen::Vector3d frac = Eigen::Matrix3d(m_lat[PRIM]->inv_lat_column_mat()) * (to - from);
+    Vector3<int> ijk(int(round(frac[0])), int(round(frac[1])), int(round(frac[2])));
+    return _mnp_index(m_invU * ijk);
+  }
+
+  //**********************************************************************************************
+  /// For operations (R1, tau1) and (R2, tau2), the product has translation tau1 + R1*tau2, which
+  /// differs from the translation of the corresponding operation in m_op_group by a primitive lattice translation
+
+  void PrimGrid::_calc_prod_trans() const {
+    Index N = m_op_mnp.size();
+    if(m_prod_trans.size() == N * N)
+      return;
+
+    m_prod_trans = Array<Index>(N * N, -1);
+    if(!op_group())
+      return;
+
+    for(Index ng1 = 0; ng1 < N; ng1++) {
+      for(Index ng2 = 0; ng2 < N; ng2++) {
+        Index ng12 = m_op_group->ind_prod(ng1, ng2);
+        if(!valid_index(ng12))
+          continue;
+        Eigen::Vector3d tau = m_op_tau[ng1] + m_op_cart[ng1] * m_op_tau[ng2];
+        m_prod_trans[ng1 * N + ng2] = _lattice_trans(m_op_tau[ng12], tau);
+      }
+    }
+  }
+
+  //**********************************************************************************************
+  /// The inverse of operation (R, tau) has translation -R.inverse()*tau, which differs from the
+  /// translation of the corresponding operation in m_op_group by a primitive lattice translation
+
+  void PrimGrid::_calc_inv_trans() const {
+    Index N = m_op_mnp.size();
+    if(m_inv_trans.size() == N)
+      return;
+
+    m_inv_trans = Array<Index>(N, -1);
+    if(!op_group())
+      return;
+
+    for(Index ng = 0; ng < N; ng++) {
+      Index ng_inv = m_op_group->ind_inverse(ng);
+      if(!valid_index(ng_inv))
+        continue;
+      Eigen::Vector3d tau = -(m_op_cart[ng_inv] * m_op_tau[ng]);
+      m_inv_trans[ng] = _lattice_trans(m_op_tau[ng_inv], tau);
+    }
+  }
+
+}
@@ -1,4 +1,5 @@
 #include "casm/crystallography/Site.hh"
+#include "casm/crystallography/Lattice.hh"
 
 #include "casm/basis_set/FunctionVisitor.hh"
 
@@ -583,6 +584,13 @@ namespace CASM {
 
   //*******************************************************************************************
 
+  const Lattice &Site::_type_prototype_lattice() {
+    static Lattice m_type_prototype_lattice;
+    return m_type_prototype_lattice;
+  }
+
+  //*******************************************************************************************
+
   Index Site::_type_ID() const {
     if(!valid_index(m_type_ID)) {
       for(m_type_ID = 0; m_type_ID < _type_prototypes().size(); m_type_ID++) {
@@ -593,6 +601,7 @@ namespace CASM {
       //print_occ(std::cout);
       //std::cout << " : TYPE_ID-> " << m_type_ID << "\n";
       _type_prototypes().push_back(*this);
+      _type_prototypes().back().set_lattice(_type_prototype_lattice(), CART);
     }
     return m_type_ID;
   }
@@ -974,19 +974,18 @@ namespace CASM {
       //loop over prim_grid points
       for(i = 0; i < prim_grid.size(); i++) {
 
-        //push back translated basis site of prim onto superstructure basis
-        basis.push_back(prim.basis[j] + prim_grid.coord(i, PRIM));
+        //translated basis site of prim
+        Site tsite(prim.basis[j] + prim_grid.coord(i, PRIM));
 
-        //reset lattice for most recent superstructure Site
+        //reset lattice for the translated site
         //set_lattice() converts fractional coordinates to be compatible with new lattice
-        basis.back().set_lattice(lattice());
+        tsite.set_lattice(lattice());
 
-        basis.back().within();
-        for(Index k = 0; k < basis.size() - 1; k++) {
-          if(basis[k].compare(basis.back(), map_tol)) {
-            basis.pop_back();
-            break;
-          }
+        tsite.within();
+
+        //push back onto superstructure basis, unless an equivalent site is already there
+        if(find(tsite, map_tol) == basis.size()) {
+          basis.push_back(tsite);
         }
       }
     }
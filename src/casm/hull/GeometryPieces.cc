@@ -1,30 +1,16 @@
 #include "casm/hull/GeometryPieces.hh"
 
-#include "casm/BP_C++/BP_Geo.hh"
-#include "casm/BP_C++/BP_Vec.hh"
+#include <algorithm>
+#include <cmath>
 
+#include "casm/hull/LowerHull.hh"
 #include "casm/container/Array.hh"
 #include "casm/casm_io/jsonParser.hh"
 
 namespace CASM {
 
   /**
-   * The following is a horrendous piece of code I'm using to avoid #include nightmares
-   * that show up trying to define the appropriate to_json/from_json for BP::BP_Vec.
-   * The plan right now is to eventually move away from BP::Geo to qHull, so this
-   * will disappear on the long run.
-   */
-
-  Array<int> BP_to_CASM(const BP::BP_Vec<int> &value) {
-    Array<int> casmfied;
-    for(Index i = 0; i < value.size(); i++) {
-      casmfied.push_back(value[i]);
-    }
-    return casmfied;
-  }
-
-  /**
-     * Given a Geo object (presumably a hull for your groundstates) this
+     * Given a LowerHull (presumably a hull for your groundstates) this
      * will return a jsonParser object that has the relevant information
      * to plot 0K phase diagrams in composition and chemical potential space.
      * Includes
@@ -50,47 +36,37 @@ namespace CASM {
      * is done relative to one of the components this routine can be changed
      * to account for this. For now, what this routine returns is
      * purely geometrical information.
+     *
+     * Positions and normals are given as (energy, composition...). Vertices are
+     * numbered by their order in LowerHull::vertices().
      */
 
-  jsonParser hull_data(BP::Geo &hull) {
-    //accessors in Geo aren't const
-    //BP::Geo hull = ghull;
-
-    //There's probably some sort of check that should go here that
-    //makes sure your hull object isn't messed up.
+  jsonParser hull_data(const LowerHull &hull) {
 
     jsonParser hull_info;
 
     //First figure out the normal and rank
-    hull_info["rank"] = hull.get_dim();
+    hull_info["rank"] = hull.dim() + 1;
 
     //State tolerance
-    hull_info["tolerance"] = hull.get_Geo_tol();
+    hull_info["tolerance"] = hull.tol();
 
     //How many facets and points?
-    hull_info["num_facets"] = hull.CH_facets_size();
-    hull_info["num_vertices"] = hull.CH_verts_size();
+    hull_info["num_facets"] = hull.facets_size();
+    hull_info["num_vertices"] = hull.vertices().size();
 
     //Place to store all facets
     Array<jsonParser> facet_info_list;
     //loop over facets
-    for(int f = 0; f < hull.CH_facets_size(); f++) {
-      //make sublist of properties
-      jsonParser facet_info = facet_data(hull, f);
-      facet_info_list.push_back(facet_info);
-
-      //store all the info you just found
-      //hull_info[facetname]=facet_info;
+    for(Index f = 0; f < hull.facets_size(); f++) {
+      facet_info_list.push_back(facet_data(hull, f));
     }
 
     //Place to store all vertices
     Array<jsonParser> vertex_info_list;
-    //BP::BP_Vec<int> vertex_indices=hull.CH_verts_indices();
     //loop over vertices
-    for(int v = 0; v < hull.CH_verts_size(); v++) {
-      //jsonParser vertex_info=vertex_data(hull,vertex_indices[v]);
-      jsonParser vertex_info = vertex_data(hull, v);
-      vertex_info_list.push_back(vertex_info);
+    for(Index v = 0; v < hull.vertices().size(); v++) {
+      vertex_info_list.push_back(vertex_data(hull, v));
     }
 
     hull_info["facets"] = facet_info_list;
@@ -99,34 +75,63 @@ namespace CASM {
   }
 
   /**
-   * Returns info of just one facet of the hull Geo object specified by index.
+   * Returns info of just one facet of the hull specified by index.
    * (See hull data for how the layout is)
    */
 
-  jsonParser facet_data(BP::Geo &hull, int findex) {
+  jsonParser facet_data(const LowerHull &hull, Index findex) {
     jsonParser facet_info;
+    Index rank = hull.dim() + 1;
 
     //Store index
     facet_info["findex"] = findex;
-    //Get the normal vector
-    Eigen::VectorXd normal = hull.CH_facets_norm(findex);
-    normal.normalize(); //Not done by default for some reason
-    facet_info["normal"] = normal;
-    //Get the area
-    facet_info["area"] = hull.CH_facets_area(findex);
 
-    //Include vertex info
-    facet_info["vertices"] = BP_to_CASM(hull.CH_facets_nborverts(findex));
+    //Get the normal vector, energy first
+    Eigen::VectorXd normal(rank);
+    normal(0) = hull.facet_normal(findex)(hull.dim());
+    normal.tail(hull.dim()) = hull.facet_normal(findex).head(hull.dim());
+    facet_info["normal"] = normal;
 
-    //Get indices for neighboring facets FIX THIS
-    facet_info["neighboring_facets"] = BP_to_CASM(hull.CH_facets_nborfacets(findex));
+    //Get the area, from the edge vectors of the facet
+    const std::vector<Index> &verts = hull.facet(findex);
+    Eigen::MatrixXd edges(rank, verts.size() - 1);
+    for(Index j = 1; j < verts.size(); j++) {
+      edges(0, j - 1) = hull.energy(verts[j]) - hull.energy(verts[0]);
+      edges.col(j - 1).tail(hull.dim()) = hull.comp(verts[j]) - hull.comp(verts[0]);
+    }
+    double fact = 1;
+    for(Index i = 2; i < verts.size(); i++)
+      fact *= i;
+    facet_info["area"] = std::sqrt(std::abs((edges.transpose() * edges).determinant())) / fact;
+
+    //Include vertex info, as indices into the list of vertices
+    Array<Index> vindex;
+    for(Index j = 0; j < verts.size(); j++) {
+      vindex.push_back(std::lower_bound(hull.vertices().begin(), hull.vertices().end(), verts[j]) - hull.vertices().begin());
+    }
+    facet_info["vertices"] = vindex;
+
+    //Neighboring facets share all but one vertex
+    Array<Index> nbor_facets;
+    for(Index f = 0; f < hull.facets_size(); f++) {
+      if(f == findex)
+        continue;
+      Index shared = 0;
+      for(Index j = 0; j < verts.size(); j++) {
+        if(std::find(hull.facet(f).begin(), hull.facet(f).end(), verts[j]) != hull.facet(f).end())
+          shared++;
+      }
+      if(shared + 1 == verts.size())
+        nbor_facets.push_back(f);
+    }
+    facet_info["neighboring_facets"] = nbor_facets;
 
     //Figure out intercepts
     //for any point v on a facet with normal n we have n.v=const
-    BP::BP_Vec<int> vertex_indices = hull.CH_facets_nborverts(findex);
-    Eigen::VectorXd v = hull.CH_verts_pos(vertex_indices[0]); //I can't imagine not having a vertex, but maybe add a check?
+    Eigen::VectorXd v(rank);
+    v(0) = hull.energy(verts[0]);
+    v.tail(hull.dim()) = hull.comp(verts[0]);
     double k = v.dot(normal);
-    int rank = hull.get_dim();
 
     //If the intercept occurs at a point on the facet x, we have x=0,0,1,0,x_E (example) and we want x_E
     double normE = normal(0);
@@ -134,7 +139,7 @@ namespace CASM {
 
     //first member of vector is the energy, so stop one before that. This loop finds intercepts for all
     //the specified (independent) components
-    for(int i = 1; i < rank; i++) {
+    for(Index i = 1; i < rank; i++) {
       double intercept = (k - normal(i)) / normE;
       intercepts.push_back(intercept);
     }
@@ -147,27 +152,40 @@ namespace CASM {
   }
 
   /**
-   * Returns info of just one vertex of the hull Geo object specified by index.
+   * Returns info of just one vertex of the hull specified by index.
    * (See hull data for how the layout is)
    */
 
-  jsonParser vertex_data(BP::Geo &hull, int vindex) {
+  jsonParser vertex_data(const LowerHull &hull, Index vindex) {
     jsonParser vertex_info;
+    Index p = hull.vertices()[vindex];
 
     //Store index
     vertex_info["vindex"] = vindex;
-    //Get position of vertex
-    vertex_info["position"] = hull.CH_verts_pos(vindex);
-
-    //Get indices for neighboring vertices
-    vertex_info["neighboring_vertices"] = BP_to_CASM(hull.CH_verts_nborverts(vindex));
 
-    //Get indices for neighboring facets
-    vertex_info["neighboring_facets"] = BP_to_CASM(hull.CH_verts_nborfacets(vindex));
+    //Get position of vertex, energy first
+    Eigen::VectorXd pos(hull.dim() + 1);
+    pos(0) = hull.energy(p);
+    pos.tail(hull.dim()) = hull.comp(p);
+    vertex_info["position"] = pos;
+
+    //Get indices for neighboring vertices and facets
+    Array<Index> nbor_verts;
+    Array<Index> nbor_facets;
+    for(Index f = 0; f < hull.facets_size(); f++) {
+      const std::vector<Index> &verts = hull.facet(f);
+      if(std::find(verts.begin(), verts.end(), p) == verts.end())
+        continue;
+      nbor_facets.push_back(f);
+      for(Index j = 0; j < verts.size(); j++) {
+        Index v = std::lower_bound(hull.vertices().begin(), hull.vertices().end(), verts[j]) - hull.vertices().begin();
+        if(verts[j] != p && !nbor_verts.contains(v))
+          nbor_verts.push_back(v);
+      }
+    }
+    vertex_info["neighboring_vertices"] = nbor_verts;
+    vertex_info["neighboring_facets"] = nbor_facets;
 
-    //Check to see what facets this vertex is on
-    //vertex_info["facets"]=BP_to_CASM(hull.CH_verts_nborfacets(index));
     return vertex_info;
   }
 }
-
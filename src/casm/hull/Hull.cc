@@ -1,5 +1,6 @@
 #include "casm/hull/Hull.hh"
 
+#include <algorithm>
 #include <vector>
 
 #include "casm/hull/GeometryPieces.hh"
@@ -48,7 +49,7 @@ namespace CASM {
     //some energies might not be set. We keep track of the configurations that have relaxed_energy
     std::vector<ConfigSelectionIterator<false, false> > valid_config;
 
-    BP::Geo hull;
+    LowerHull hull;
 
     //We should have the tolerance set in .casmroot
     //std::cerr << "WARNING in PrimClex::update_hull_props" << std::endl;
@@ -57,13 +58,9 @@ namespace CASM {
     //hull.set_Geo_tol(geo_tol);
     bool hull_found = populate_convex_hull(hull, begin, end, std::back_inserter(valid_config));
 
-    //All configurations have the same size parametric composition vector (right?). +1 for the energy row.
-    Index rows = begin->get_param_composition().size() + 1;
     //The columns correspond to the number of configurations;
     Index cols = valid_config.size();
 
-    BP::BP_Vec<int> hull_indices;     //Perhaps we can generalize BP_Vec into a CASM::stable_array?
-
     if(hull_found) {
 
 
@@ -72,29 +69,22 @@ namespace CASM {
         it->clear_hull_data();
       }
 
-      //Set value to -1 to only get bottom of hull. It's what happens in EnergySet::calc_hull
-      Eigen::VectorXd bottom_vector = Eigen::VectorXd::Zero(rows);
-      bottom_vector(0) = -1;
-      hull.CH_bottom(bottom_vector);
-      hull_indices = hull.CH_verts_indices();
       hulljson = hull_data(hull);
 
       //Go through the configurations and set delta properties for is_groundstate and dist_from_hull
       for(Index i = 0; i < cols; i++) {
 
         //Determine if configuration i is groundstate or not
-        bool is_groundstate = false;
-        ulint vertex_col_index;
+        bool is_groundstate = hull.is_vertex(i);
 
-        if(hull_indices.find_first(i, vertex_col_index)) {
-          is_groundstate = true;
+        if(is_groundstate) {
           //Add the config name to the jsonParser that has the hull info
-          hulljson["vertices"][vertex_col_index]["name"] = valid_config[i].name();
-
+          Index vertex_index = std::lower_bound(hull.vertices().begin(), hull.vertices().end(), i) - hull.vertices().begin();
+          hulljson["vertices"][vertex_index]["name"] = valid_config[i].name();
         }
 
         //Calculate distance from the hull for configuration i
-        double dist_from_hull = hull.CH_dist_to_hull(i);
+        double dist_from_hull = hull.dist_to_hull(i);
 
         //set distance from hull and whether it's a groundstate or not
         valid_config[i]->set_hull_data(is_groundstate, dist_from_hull);
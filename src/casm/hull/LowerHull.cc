@@ -0,0 +1,465 @@
+#include "casm/hull/LowerHull.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+#include "casm/BP_C++/BP_Geo.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+namespace CASM {
+
+  const double LowerHull::comp_bin = 1e-8;
+
+  const double LowerHull::locate_tol = 1e-9;
+
+  const double LowerHull::joggle = 1e-9;
+
+  const Index LowerHull::sample_size = 1000;
+
+  //*******************************************************************************************
+
+  LowerHull::LowerHull(double tol) :
+    m_tol(tol), m_dim(0) {}
+
+  //*******************************************************************************************
+
+  bool LowerHull::reset(const Eigen::MatrixXd &comp, const Eigen::VectorXd &energy) {
+    m_dim = comp.rows();
+    m_comp.assign(comp.data(), comp.data() + comp.size());
+    m_energy.assign(energy.data(), energy.data() + energy.size());
+
+    std::vector<Index> all(size());
+    for(Index i = 0; i < size(); i++)
+      all[i] = i;
+    return _build(_lowest_by_comp(all));
+  }
+
+  //*******************************************************************************************
+
+  bool LowerHull::insert(const Eigen::VectorXd &comp, double energy) {
+    if(size() == 0)
+      m_dim = comp.size();
+    m_comp.insert(m_comp.end(), comp.data(), comp.data() + m_dim);
+    m_energy.push_back(energy);
+    m_is_vertex.push_back(false);
+
+    Index i = size() - 1;
+    if(m_facets.size()) {
+      // a point on or above the hull, within its composition range, does not change it
+      Index f = _locate(comp);
+      if(f >= 0 && energy - m_facets[f].plane(comp) >= -m_tol)
+        return true;
+
+      std::vector<Index> candidates(m_vertices);
+      candidates.push_back(i);
+      return _build(_lowest_by_comp(candidates));
+    }
+
+    std::vector<Index> all(size());
+    for(Index j = 0; j < size(); j++)
+      all[j] = j;
+    return _build(_lowest_by_comp(all));
+  }
+
+  //*******************************************************************************************
+
+  Eigen::VectorXd LowerHull::facet_normal(Index f) const {
+    Eigen::VectorXd n(m_dim + 1);
+    n.head(m_dim) = m_facets[f].gradient;
+    n(m_dim) = -1.0;
+    return n.normalized();
+  }
+
+  //*******************************************************************************************
+
+  double LowerHull::hull_energy(const Eigen::VectorXd &comp) const {
+    Index f = _locate(comp);
+    if(f >= 0)
+      return m_facets[f].plane(comp);
+
+    // outside the hull's composition range: the hull is the maximum of the facet planes
+    double result = -std::numeric_limits<double>::infinity();
+    for(Index i = 0; i < m_facets.size(); i++)
+      result = std::max(result, m_facets[i].plane(comp));
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  double LowerHull::dist_to_hull(Index i) const {
+    if(m_is_vertex[i])
+      return 0.0;
+    return std::abs(dist_to_hull(comp(i), energy(i)));
+  }
+
+  //*******************************************************************************************
+
+  double LowerHull::Facet::min_bary(const Eigen::VectorXd &comp, Index &k) const {
+    double first = 1.0;
+    double result = std::numeric_limits<double>::infinity();
+    for(EigenIndex r = 0; r < inv.rows(); r++) {
+      double b = 0.0;
+      for(EigenIndex c = 0; c < inv.cols(); c++)
+        b += inv(r, c) * (comp(c) - origin(c));
+      first -= b;
+      if(b < result) {
+        result = b;
+        k = r + 1;
+      }
+    }
+    if(first < result) {
+      result = first;
+      k = 0;
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  std::vector<Index> LowerHull::_lowest_by_comp(const std::vector<Index> &indices) const {
+    return _lowest_by_cell(indices,
+                           Eigen::VectorXd::Constant(m_dim, -0.5 * comp_bin),
+                           Eigen::VectorXd::Constant(m_dim, comp_bin));
+  }
+
+  //*******************************************************************************************
+
+  /// Sorts the points by cell, and then by energy, and keeps the first point in each cell
+  std::vector<Index> LowerHull::_lowest_by_cell(const std::vector<Index> &indices,
+                                                const Eigen::VectorXd &origin,
+                                                const Eigen::VectorXd &width) const {
+    std::vector<long> key(m_dim * indices.size());
+    for(Index i = 0; i < indices.size(); i++) {
+      for(Index j = 0; j < m_dim; j++) {
+        double x = m_comp[m_dim * indices[i] + j] - origin(j);
+        key[m_dim * i + j] = (width(j) > 0.0) ? long(std::floor(x / width(j))) : 0;
+      }
+    }
+
+    auto same_cell = [&](Index a, Index b) {
+      return std::equal(key.begin() + m_dim * a, key.begin() + m_dim * (a + 1), key.begin() + m_dim * b);
+    };
+
+    std::vector<Index> order(indices.size());
+    for(Index i = 0; i < order.size(); i++)
+      order[i] = i;
+    std::sort(order.begin(), order.end(), [&](Index a, Index b) {
+      if(!same_cell(a, b)) {
+        return std::lexicographical_compare(key.begin() + m_dim * a, key.begin() + m_dim * (a + 1),
+                                            key.begin() + m_dim * b, key.begin() + m_dim * (b + 1));
+      }
+      return m_energy[indices[a]] < m_energy[indices[b]];
+    });
+
+    std::vector<Index> result;
+    for(Index i = 0; i < order.size(); i++) {
+      if(i == 0 || !same_cell(order[i - 1], order[i]))
+        result.push_back(indices[order[i]]);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  bool LowerHull::_build(const std::vector<Index> &candidates) {
+    if(m_dim > 1 && candidates.size() > 4 * sample_size)
+      return _build_hull(_prune(candidates));
+    return _build_hull(candidates);
+  }
+
+  //*******************************************************************************************
+
+  /// Builds the hull of the lowest energy candidate in each cell of a grid over the composition
+  /// range, refined until about 'sample_size' cells are occupied. A vertex of the full hull is
+  /// below the hull of any subset of the other points, so only the vertices of the sample hull
+  /// and the candidates that are not above it need to be kept.
+  std::vector<Index> LowerHull::_prune(const std::vector<Index> &candidates) {
+    Eigen::VectorXd min = comp(candidates[0]);
+    Eigen::VectorXd max = min;
+    for(Index i = 1; i < candidates.size(); i++) {
+      min = min.cwiseMin(comp(candidates[i]));
+      max = max.cwiseMax(comp(candidates[i]));
+    }
+
+    std::vector<Index> sample;
+    for(double bins = std::ceil(std::pow(double(sample_size), 1.0 / m_dim));
+        sample.size() < sample_size / 2; bins *= 2)
+      sample = _lowest_by_cell(candidates, min, (max - min) / bins);
+
+    if(!_build_hull(sample))
+      return candidates;
+
+    std::vector<Index> result;
+    for(Index i = 0; i < candidates.size(); i++) {
+      Index p = candidates[i];
+      if(m_is_vertex[p]) {
+        result.push_back(p);
+        continue;
+      }
+      Index f = _locate(comp(p));
+      if(f < 0 || m_energy[p] - m_facets[f].plane(comp(p)) < m_tol)
+        result.push_back(p);
+    }
+    return result;
+  }
+
+  //*******************************************************************************************
+
+  bool LowerHull::_build_hull(const std::vector<Index> &candidates) {
+    m_facets.clear();
+    m_vertices.clear();
+    m_is_vertex.assign(size(), false);
+    m_seeds.clear();
+
+    if(m_dim == 0)
+      return false;
+
+    bool found = (m_dim == 1) ? _build_chain(candidates) : _build_geo(candidates);
+    if(!found || !m_facets.size()) {
+      m_facets.clear();
+      return false;
+    }
+
+    for(Index f = 0; f < m_facets.size(); f++) {
+      for(Index j = 0; j < m_facets[f].verts.size(); j++)
+        m_is_vertex[m_facets[f].verts[j]] = true;
+    }
+    for(Index i = 0; i < size(); i++) {
+      if(m_is_vertex[i])
+        m_vertices.push_back(i);
+    }
+
+    _connect();
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  /// Andrew's monotone chain, lower half only
+  bool LowerHull::_build_chain(std::vector<Index> candidates) {
+    std::sort(candidates.begin(), candidates.end(), [&](Index a, Index b) {
+      if(m_comp[a] != m_comp[b])
+        return m_comp[a] < m_comp[b];
+      return m_energy[a] < m_energy[b];
+    });
+
+    // remove the middle point unless it is more than 'tol' below the line through its neighbors
+    std::vector<Index> chain;
+    for(Index i = 0; i < candidates.size(); i++) {
+      Index p = candidates[i];
+      while(chain.size() >= 2) {
+        Index o = chain[chain.size() - 2];
+        Index a = chain.back();
+        double cross = (m_comp[a] - m_comp[o]) * (m_energy[p] - m_energy[o])
+                       - (m_energy[a] - m_energy[o]) * (m_comp[p] - m_comp[o]);
+        double len = std::hypot(m_comp[p] - m_comp[o], m_energy[p] - m_energy[o]);
+        if(cross > m_tol * len)
+          break;
+        chain.pop_back();
+      }
+      chain.push_back(p);
+    }
+
+    // the last point may be above another at the same composition
+    while(chain.size() >= 2 && m_comp[chain.back()] - m_comp[chain[chain.size() - 2]] < comp_bin)
+      chain.pop_back();
+
+    for(Index i = 1; i < chain.size(); i++)
+      _add_facet(std::vector<Index>({chain[i - 1], chain[i]}));
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  bool LowerHull::_build_geo(const std::vector<Index> &candidates) {
+    if(candidates.size() < m_dim + 2)
+      return false;
+
+    // candidates have distinct compositions, so checking for repeats is unnecessary
+    Eigen::MatrixXd pts(m_dim + 1, candidates.size());
+    for(Index i = 0; i < candidates.size(); i++) {
+      pts.col(i).head(m_dim) = comp(candidates[i]);
+      pts(m_dim, i) = energy(candidates[i]);
+    }
+
+    // An apex above the centroid, higher than any facet plane can be there, hides the points
+    // that are not near the lower hull, so BP::Geo does not construct the upper hull.
+    double scale = (pts.rowwise().maxCoeff() - pts.rowwise().minCoeff()).maxCoeff();
+    Eigen::VectorXd apex = pts.rowwise().mean();
+    apex(m_dim) = pts.row(m_dim).maxCoeff() + scale;
+
+    // BP::Geo starts from the first points that are not coplanar, which may be nearly so. Put the
+    // apex, and then each point furthest from the span of those before it, first, so that the
+    // starting simplex is well conditioned. If the compositions do not span the composition space,
+    // neither do these.
+    std::vector<Index> order(candidates.size());
+    for(Index i = 0; i < order.size(); i++)
+      order[i] = i;
+    Eigen::MatrixXd basis(m_dim + 1, m_dim + 1);
+    for(Index k = 0; k < m_dim + 1; k++) {
+      double max_dist = -1.0;
+      Index max_i = k;
+      Eigen::VectorXd max_v;
+      for(Index i = k; i < order.size(); i++) {
+        Eigen::VectorXd v = pts.col(order[i]) - apex;
+        v -= basis.leftCols(k) * (basis.leftCols(k).transpose() * v);
+        if(v.norm() > max_dist) {
+          max_dist = v.norm();
+          max_i = i;
+          max_v = v;
+        }
+      }
+      if(max_dist < (m_dim + 2) * m_tol)
+        return false;
+      basis.col(k) = max_v / max_dist;
+      std::swap(order[k], order[max_i]);
+    }
+
+    Index apex_col = 0;
+    Eigen::MatrixXd m(m_dim + 1, candidates.size() + 1);
+    m.col(apex_col) = apex;
+    for(Index i = 0; i < order.size(); i++)
+      m.col(i + 1) = pts.col(order[i]);
+
+    // Points on the boundary of the composition range lie in vertical facets of the full hull,
+    // which BP::Geo can not construct if many are coplanar. The compositions are joggled, with a
+    // fixed seed, so that BP::Geo finds the facets of points in general position; the facet
+    // planes are then calculated from the unperturbed points, and vertical slivers are discarded.
+    MTRand mtrand(1u);
+    for(Index i = 1; i < m.cols(); i++) {
+      for(Index j = 0; j < m_dim; j++)
+        m(j, i) += joggle * scale * (2.0 * mtrand.rand() - 1.0);
+    }
+
+    BP::Geo geo;
+    geo.set_verbosity(0);
+    geo.set_Geo_tol(m_tol);
+    geo.reset_points(m, false);
+    if(!geo.calc_CH())
+      return false;
+
+    Eigen::VectorXd down = Eigen::VectorXd::Zero(m_dim + 1);
+    down(m_dim) = -1;
+    geo.CH_bottom(down);
+
+    BP::BP_Vec<int> vert_indices = geo.CH_verts_indices();
+    std::vector<Index> verts;
+    for(int f = 0; f < geo.CH_facets_size(); f++) {
+      BP::BP_Vec<int> nbor = geo.CH_facets_nborverts(f);
+      verts.clear();
+      for(Index j = 0; j < nbor.size(); j++) {
+        Index col = vert_indices[nbor[j]];
+        if(col == apex_col)
+          break;
+        verts.push_back(candidates[order[col - 1]]);
+      }
+      if(verts.size() == nbor.size())
+        _add_facet(verts);
+    }
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  bool LowerHull::_add_facet(const std::vector<Index> &verts) {
+    if(verts.size() < m_dim + 1)
+      return false;
+
+    Facet facet;
+    facet.verts = verts;
+    facet.origin = comp(verts[0]);
+
+    Eigen::MatrixXd edges(m_dim, m_dim);
+    Eigen::VectorXd rise(m_dim);
+    for(Index j = 0; j < m_dim; j++) {
+      edges.col(j) = comp(verts[j + 1]) - facet.origin;
+      rise(j) = energy(verts[j + 1]) - energy(verts[0]);
+    }
+
+    Eigen::FullPivLU<Eigen::MatrixXd> lu(edges);
+    lu.setThreshold(comp_bin);
+    if(!lu.isInvertible())
+      return false;
+
+    facet.inv = lu.inverse();
+    facet.gradient = facet.inv.transpose() * rise;
+    facet.offset = energy(verts[0]) - facet.gradient.dot(facet.origin);
+
+    facet.center = facet.origin;
+    for(Index j = 1; j < verts.size(); j++)
+      facet.center += comp(verts[j]);
+    facet.center /= double(verts.size());
+
+    m_facets.push_back(facet);
+    return true;
+  }
+
+  //*******************************************************************************************
+
+  void LowerHull::_connect() {
+    // facets sharing all vertices but one are neighbors
+    std::map<std::vector<Index>, std::pair<Index, Index> > ridges;
+    std::vector<Index> key;
+    for(Index f = 0; f < m_facets.size(); f++) {
+      Facet &facet = m_facets[f];
+      facet.nbors.assign(facet.verts.size(), -1);
+      for(Index k = 0; k < facet.verts.size(); k++) {
+        key = facet.verts;
+        key.erase(key.begin() + k);
+        std::sort(key.begin(), key.end());
+        auto res = ridges.insert(std::make_pair(key, std::make_pair(f, k)));
+        if(!res.second) {
+          facet.nbors[k] = res.first->second.first;
+          m_facets[res.first->second.first].nbors[res.first->second.second] = f;
+        }
+      }
+    }
+
+    // about sqrt(N) evenly spaced seeds, so that walks are short
+    Index step = std::max(Index(1), Index(std::sqrt(double(m_facets.size()))));
+    for(Index f = 0; f < m_facets.size(); f += step)
+      m_seeds.push_back(f);
+  }
+
+  //*******************************************************************************************
+
+  /// Start from the seed facet with the closest center, and step to the neighbor opposite the
+  /// vertex with the most negative barycentric coordinate until 'comp' is inside. Because the
+  /// projection of the lower hull is a regular triangulation, this walk does not cycle; if it
+  /// does not finish, all facets are checked.
+  Index LowerHull::_locate(const Eigen::VectorXd &comp) const {
+    if(!m_facets.size())
+      return -1;
+
+    Index f = m_seeds[0];
+    double best = std::numeric_limits<double>::infinity();
+    for(Index i = 0; i < m_seeds.size(); i++) {
+      double d = (m_facets[m_seeds[i]].center - comp).squaredNorm();
+      if(d < best) {
+        best = d;
+        f = m_seeds[i];
+      }
+    }
+
+    // the walk stops at a ridge without a neighbor, which is on the boundary of the projection
+    // of the hull, or next to a sliver facet that was discarded, so then all facets are checked
+    Index k;
+    for(Index step = 0; step < m_facets.size(); step++) {
+      if(m_facets[f].min_bary(comp, k) >= -locate_tol)
+        return f;
+      f = m_facets[f].nbors[k];
+      if(f < 0)
+        break;
+    }
+
+    for(f = 0; f < m_facets.size(); f++) {
+      if(m_facets[f].min_bary(comp, k) >= -locate_tol)
+        return f;
+    }
+    return -1;
+  }
+
+}
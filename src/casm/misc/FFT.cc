@@ -0,0 +1,131 @@
+#include "casm/misc/FFT.hh"
+
+#include <cmath>
+
+namespace CASM {
+
+  namespace FFT_impl {
+
+    /// Prime factors larger than this use Bluestein's algorithm instead of a direct O(p^2) DFT
+    const Index max_direct_prime = 32;
+
+    Index smallest_prime_factor(Index n) {
+      for(Index p = 2; p * p <= n; p++) {
+        if(n % p == 0)
+          return p;
+      }
+      return n;
+    }
+
+    std::complex<double> twiddle(Index k, Index n) {
+      return std::polar(1.0, -2.0 * M_PI * double(k % n) / double(n));
+    }
+
+    void transform(const std::complex<double> *in, Index n, Index stride, std::complex<double> *out);
+
+    //*******************************************************************************************
+    /// out[k] = sum_j in[j*stride] * exp(-2*pi*i*j*k/n), for prime 'n', using a circular convolution of
+    /// power of 2 length
+    void bluestein(const std::complex<double> *in, Index n, Index stride, std::complex<double> *out) {
+      Index M = 1;
+      while(M < 2 * n - 1)
+        M *= 2;
+
+      // chirp w[k] = exp(-i*pi*k^2/n), with k^2 taken mod 2n to keep the argument small
+      std::vector<std::complex<double> > w(n);
+      for(Index k = 0; k < n; k++)
+        w[k] = std::polar(1.0, -M_PI * double((k * k) % (2 * n)) / double(n));
+
+      std::vector<std::complex<double> > a(M, 0.0), b(M, 0.0), A(M), B(M);
+      for(Index k = 0; k < n; k++)
+        a[k] = in[k * stride] * w[k];
+      b[0] = std::conj(w[0]);
+      for(Index k = 1; k < n; k++)
+        b[k] = b[M - k] = std::conj(w[k]);
+
+      transform(a.data(), M, 1, A.data());
+      transform(b.data(), M, 1, B.data());
+
+      // inverse transform of A*B, as conj(fft(conj(A*B)))/M
+      for(Index k = 0; k < M; k++)
+        a[k] = std::conj(A[k] * B[k]);
+      transform(a.data(), M, 1, A.data());
+
+      for(Index k = 0; k < n; k++)
+        out[k] = w[k] * std::conj(A[k]) / double(M);
+    }
+
+    //*******************************************************************************************
+    /// out[k] = sum_j in[j*stride] * exp(-2*pi*i*j*k/n), decimating in time by the smallest prime factor
+    void transform(const std::complex<double> *in, Index n, Index stride, std::complex<double> *out) {
+      if(n == 1) {
+        out[0] = in[0];
+        return;
+      }
+
+      Index p = smallest_prime_factor(n);
+      if(p == n) {
+        if(n > max_direct_prime) {
+          bluestein(in, n, stride, out);
+          return;
+        }
+        for(Index k = 0; k < n; k++) {
+          std::complex<double> sum(0.0, 0.0);
+          for(Index j = 0; j < n; j++)
+            sum += in[j * stride] * twiddle(j * k, n);
+          out[k] = sum;
+        }
+        return;
+      }
+
+      // transform the 'p' interleaved subsequences of length m into out[r*m, (r+1)*m)
+      Index m = n / p;
+      for(Index r = 0; r < p; r++)
+        transform(in + r * stride, m, stride * p, out + r * m);
+
+      // combine: X[k + q*m] = sum_r exp(-2*pi*i*r*(k + q*m)/n) * X_r[k]
+      std::vector<std::complex<double> > sub(p);
+      for(Index k = 0; k < m; k++) {
+        for(Index r = 0; r < p; r++)
+          sub[r] = out[r * m + k] * twiddle(r * k, n);
+        for(Index q = 0; q < p; q++) {
+          std::complex<double> sum(sub[0]);
+          for(Index r = 1; r < p; r++)
+            sum += sub[r] * twiddle(r * q, p);
+          out[q * m + k] = sum;
+        }
+      }
+    }
+
+  }
+
+  //*******************************************************************************************
+
+  void fft(std::complex<double> *data, Index n, Index stride) {
+    if(n <= 1)
+      return;
+    std::vector<std::complex<double> > out(n);
+    FFT_impl::transform(data, n, stride, out.data());
+    for(Index k = 0; k < n; k++)
+      data[k * stride] = out[k];
+  }
+
+  //*******************************************************************************************
+
+  void fft_3d(std::complex<double> *data, const int S[3]) {
+    Index stride[3] = {1, S[0], Index(S[0]) * S[1]};
+    Index N = stride[2] * S[2];
+
+    // transform along each axis in turn; 'l' runs over the starting points of the lines along 'axis'
+    for(int axis = 0; axis < 3; axis++) {
+      if(S[axis] == 1)
+        continue;
+      for(Index l = 0; l < N; l++) {
+        if((l / stride[axis]) % S[axis] != 0)
+          continue;
+        fft(data + l, S[axis], stride[axis]);
+      }
+    }
+  }
+
+}
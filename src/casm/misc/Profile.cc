@@ -0,0 +1,208 @@
+#include "casm/misc/Profile.hh"
+
+#include <chrono>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include "casm/CASM_global_definitions.hh"
+#include "casm/casm_io/jsonParser.hh"
+
+namespace CASM {
+
+  namespace Profiler_impl {
+
+    typedef std::chrono::steady_clock clock;
+
+    /// A timer, with its counters and child timers
+    struct Node {
+
+      Node(const std::string &_name) :
+        name(_name), time(0.0), calls(0) {}
+
+      /// The child named '_name', which is added if it does not exist yet
+      Node *child(const std::string &_name) {
+        for(auto it = children.begin(); it != children.end(); ++it) {
+          if((*it)->name == _name)
+            return it->get();
+        }
+        children.push_back(std::unique_ptr<Node>(new Node(_name)));
+        return children.back().get();
+      }
+
+      std::string name;
+
+      /// total wall time, in seconds
+      double time;
+
+      long calls;
+
+      /// in order of first use
+      std::vector<std::pair<std::string, long> > counters;
+
+      /// in order of first use
+      std::vector<std::unique_ptr<Node> > children;
+
+    };
+
+    /// An active ProfileScope
+    struct Frame {
+      Node *node;
+      clock::time_point start;
+    };
+
+    /// Protects the tree, which may be updated from several threads
+    std::mutex &tree_mutex() {
+      static std::mutex m;
+      return m;
+    }
+
+    Node &root() {
+      static Node r("total");
+      return r;
+    }
+
+    clock::time_point &root_start() {
+      static clock::time_point t;
+      return t;
+    }
+
+    /// The active scopes of this thread, innermost last
+    std::vector<Frame> &stack() {
+      static thread_local std::vector<Frame> s;
+      return s;
+    }
+
+    Node &current() {
+      return stack().empty() ? root() : *stack().back().node;
+    }
+
+    /// Set the time of the root node to the time since profiling was enabled
+    void update_root() {
+      root().time = std::chrono::duration<double>(clock::now() - root_start()).count();
+      root().calls = 1;
+    }
+
+    void print(const Node &node, const Node *parent, Index depth, std::ostream &sout) {
+      std::string label = std::string(2 * depth, ' ') + node.name;
+      sout << std::left << std::setw(60) << label << std::right
+           << std::setw(12) << std::setprecision(4) << node.time
+           << std::setw(12) << node.calls;
+      if(parent != nullptr && parent->time > 0.0)
+        sout << std::setw(10) << std::setprecision(1) << 100.0 * node.time / parent->time;
+      sout << "\n";
+
+      for(auto it = node.counters.begin(); it != node.counters.end(); ++it) {
+        label = std::string(2 * depth + 2, ' ') + "# " + it->first;
+        sout << std::left << std::setw(72) << label << std::right
+             << std::setw(12) << it->second << "\n";
+      }
+
+      for(auto it = node.children.begin(); it != node.children.end(); ++it)
+        print(**it, &node, depth + 1, sout);
+    }
+
+    jsonParser &to_json(const Node &node, jsonParser &json) {
+      json = jsonParser::object();
+      json["name"] = node.name;
+      json["time"] = node.time;
+      json["calls"] = node.calls;
+      json["counters"] = jsonParser::object();
+      for(auto it = node.counters.begin(); it != node.counters.end(); ++it)
+        json["counters"][it->first] = it->second;
+      json["children"] = jsonParser::array(node.children.size());
+      for(Index i = 0; i < node.children.size(); i++)
+        to_json(*node.children[i], json["children"][i]);
+      return json;
+    }
+
+  }
+
+  bool Profiler::m_enabled = false;
+
+  //*******************************************************************************************
+
+  void Profiler::enable(bool _enabled) {
+    using namespace Profiler_impl;
+    std::lock_guard<std::mutex> lock(tree_mutex());
+    if(_enabled) {
+      root() = Node("total");
+      root_start() = clock::now();
+    }
+    m_enabled = _enabled;
+  }
+
+  //*******************************************************************************************
+
+  void Profiler::start(const std::string &name) {
+    using namespace Profiler_impl;
+    Frame frame;
+    {
+      std::lock_guard<std::mutex> lock(tree_mutex());
+      frame.node = current().child(name);
+    }
+    frame.start = clock::now();
+    stack().push_back(frame);
+  }
+
+  //*******************************************************************************************
+
+  void Profiler::stop() {
+    using namespace Profiler_impl;
+    clock::time_point end = clock::now();
+    Frame frame = stack().back();
+    stack().pop_back();
+
+    std::lock_guard<std::mutex> lock(tree_mutex());
+    frame.node->time += std::chrono::duration<double>(end - frame.start).count();
+    frame.node->calls++;
+  }
+
+  //*******************************************************************************************
+
+  void Profiler::count(const std::string &name, long n) {
+    using namespace Profiler_impl;
+    if(!m_enabled)
+      return;
+
+    std::lock_guard<std::mutex> lock(tree_mutex());
+    std::vector<std::pair<std::string, long> > &counters = current().counters;
+    for(auto it = counters.begin(); it != counters.end(); ++it) {
+      if(it->first == name) {
+        it->second += n;
+        return;
+      }
+    }
+    counters.push_back(std::make_pair(name, n));
+  }
+
+  //*******************************************************************************************
+
+  void Profiler::print(std::ostream &sout) {
+    using namespace Profiler_impl;
+    std::lock_guard<std::mutex> lock(tree_mutex());
+    update_root();
+
+    std::stringstream ss;
+    ss << std::fixed;
+    ss << "-- Profile --\n";
+    ss << std::left << std::setw(60) << "name" << std::right
+       << std::setw(12) << "time (s)"
+       << std::setw(12) << "calls"
+       << std::setw(10) << "% parent" << "\n";
+    Profiler_impl::print(root(), nullptr, 0, ss);
+    sout << ss.str() << std::flush;
+  }
+
+  //*******************************************************************************************
+
+  jsonParser &Profiler::to_json(jsonParser &json) {
+    using namespace Profiler_impl;
+    std::lock_guard<std::mutex> lock(tree_mutex());
+    update_root();
+    return Profiler_impl::to_json(root(), json);
+  }
+
+}
@@ -9,7 +9,6 @@ namespace CASM {
   PermuteIterator::PermuteIterator(const PermuteIterator &iter) :
     m_fg_permute_rep(iter.m_fg_permute_rep),
     m_prim_grid(iter.m_prim_grid),
-    m_trans_permute(&(m_prim_grid->translation_permutations())),
     m_factor_group_index(iter.m_factor_group_index),
     m_translation_index(iter.m_translation_index) {
 
@@ -21,7 +20,6 @@ namespace CASM {
                                    Index _translation_index) :
     m_fg_permute_rep(_fg_permute_rep),
     m_prim_grid(&_prim_grid),
-    m_trans_permute(&(m_prim_grid->translation_permutations())),
     m_factor_group_index(_factor_group_index),
     m_translation_index(_translation_index) {
   }
@@ -66,22 +64,33 @@ namespace CASM {
   }
 
   /// Return the translation permutation being pointed at
-  const Permutation &PermuteIterator::translation_permute() const {
-    return m_trans_permute->at(m_translation_index);
+  Permutation PermuteIterator::translation_permute() const {
+    return m_prim_grid->translation_permutation(m_translation_index);
   }
 
   SymOp PermuteIterator::sym_op()const {
     return (*m_prim_grid).sym_op(m_translation_index) * m_fg_permute_rep.sym_op(m_factor_group_index);
   }
 
+  Eigen::Matrix3d PermuteIterator::sym_op_matrix() const {
+    // translations don't change the point operation
+    if(_has_op_arithmetic())
+      return m_prim_grid->op_matrix(m_factor_group_index);
+    return m_fg_permute_rep.sym_op(m_factor_group_index).get_matrix(CART);
+  }
+
+  bool PermuteIterator::_has_op_arithmetic() const {
+    return m_prim_grid->op_group() == &m_fg_permute_rep.head_group();
+  }
+
   Index PermuteIterator::permute_ind(Index i) const {
-    return factor_group_permute()[ translation_permute()[i] ];
+    return factor_group_permute()[ m_prim_grid->translation_permute_ind(m_translation_index, i) ];
   }
 
   /// Return after_array[i], given i and before_array
   template<typename T>
   const T &PermuteIterator::permute_by_bit(Index i, const Array<T> &before_array) const {
-    return before_array[ factor_group_permute()[ translation_permute()[i] ] ];
+    return before_array[ permute_ind(i) ];
   }
 
   bool PermuteIterator::operator==(const PermuteIterator &iter) {
@@ -100,7 +109,7 @@ namespace CASM {
   // prefix ++PermuteIterator
   PermuteIterator &PermuteIterator::operator++() {
     m_translation_index++;
-    if(m_translation_index == m_trans_permute->size()) {
+    if(m_translation_index == m_prim_grid->size()) {
       m_translation_index = 0;
       m_factor_group_index++;
     }
@@ -118,7 +127,7 @@ namespace CASM {
   PermuteIterator &PermuteIterator::operator--() {
     if(m_translation_index == 0) {
       m_factor_group_index--;
-      m_translation_index = m_trans_permute->size();
+      m_translation_index = m_prim_grid->size();
     }
     m_translation_index--;
     return *this;
@@ -138,12 +147,24 @@ namespace CASM {
     return it;
   }
 
-  // Might be able to do this in a faster way, but would be much harder to understand
   PermuteIterator PermuteIterator::inverse() const {
     PermuteIterator it(*this);
     // Finding the inverse factor_group operation is straightforward
     it.m_factor_group_index = m_fg_permute_rep.ind_inverse(factor_group_index());
 
+    // If *this is T*F, with translation T and factor group operation F, its inverse is
+    //   F.inverse()*T.inverse() = (F.inverse()*T.inverse()*F)*F.inverse()
+    // and F.inverse() differs from the factor group operation at it.m_factor_group_index by a lattice translation
+    if(_has_op_arithmetic()) {
+      Index trans = m_prim_grid->inverse_trans(factor_group_index());
+      if(valid_index(trans)) {
+        it.m_translation_index = m_prim_grid->trans_sum(m_prim_grid->op_trans(it.m_factor_group_index,
+                                                                              m_prim_grid->trans_inverse(translation_index())),
+                                                        trans);
+        return it;
+      }
+    }
+
     // Easiest way to get the new translation is just to compare the tau of the
     // inverse of the 'total' sym_op (described by *this), to the inverse of the
     // untranslated symop (described by m_fg_permute_rep.sym_op(it.m_factor_group_index))
@@ -159,6 +180,18 @@ namespace CASM {
     // Finding the inverse factor_group operation is straightforward
     it.m_factor_group_index = m_fg_permute_rep.ind_prod(factor_group_index(), RHS.factor_group_index());
 
+    // (T1*F1)*(T2*F2) = T1*(F1*T2*F1.inverse())*(F1*F2), and F1*F2 differs from the factor group
+    // operation at it.m_factor_group_index by a lattice translation
+    if(_has_op_arithmetic()) {
+      Index trans = m_prim_grid->prod_trans(factor_group_index(), RHS.factor_group_index());
+      if(valid_index(trans)) {
+        it.m_translation_index = m_prim_grid->trans_sum(m_prim_grid->trans_sum(translation_index(),
+                                                                               m_prim_grid->op_trans(factor_group_index(), RHS.translation_index())),
+                                                        trans);
+        return it;
+      }
+    }
+
     // Easiest way to get the new translation is just to compare the tau of the
     // 'total' sym_op (described by (*this).sym_op()*RHS.sym_op()), to the
     // untranslated symop product (described by m_fg_permute_rep.sym_op(it.factor_group_index()))
@@ -184,7 +217,6 @@ namespace CASM {
   void swap(PermuteIterator &a, PermuteIterator &b) {
     std::swap(a.m_fg_permute_rep, b.m_fg_permute_rep);
     std::swap(a.m_prim_grid, b.m_prim_grid);
-    std::swap(a.m_trans_permute, b.m_trans_permute);
     std::swap(a.m_factor_group_index, b.m_factor_group_index);
     std::swap(a.m_translation_index, b.m_translation_index);
   }
@@ -1,5 +1,7 @@
 #include "casm/symmetry/SymGroup.hh"
 
+#include <climits>
+
 #include "casm/external/Eigen/CASM_AddOns"
 
 #include "casm/container/Counter.hh"
@@ -230,6 +232,18 @@ namespace CASM {
     return rep_array.back()->get_ID();
   }
 
+  //***************************************************
+
+  void MasterSymGroup::remove_representation(Index i) const {
+    for(Index j = 0; j < rep_array.size(); j++) {
+      if(rep_array[j]->get_ID() == i) {
+        delete rep_array[j];
+        rep_array.remove(j);
+        return;
+      }
+    }
+  }
+
   //***************************************************
   SymGroupRep const *MasterSymGroup::representation(Index i) const {
     for(Index j = 0; j < rep_array.size(); j++) {
@@ -316,6 +330,8 @@ namespace CASM {
   void SymGroup::clear_tables() {
     multi_table.clear();
     alt_multi_table.clear();
+    m_prod_table.clear();
+    m_inv_table.clear();
     conjugacy_classes.clear();
     class_names.clear();
     index2conjugacy_class.clear();
@@ -2911,7 +2927,12 @@ namespace CASM {
   //***************************************************
 
   Index SymGroup::ind_inverse(Index i) const {
-    if(get_alt_multi_table().size() != size() || !valid_index(i) || i >= size())
+    if(!valid_index(i) || i >= size())
+      return -1;
+    if(calc_dense_inv_table())
+      return m_inv_table[i] == USHRT_MAX ? -1 : Index(m_inv_table[i]);
+
+    if(get_alt_multi_table().size() != size())
       return -1;
     //std::cout << "Inside ind_inverse. 'i' is " << i << " and alt_multi_table size is " << alt_multi_table.size() << "\n";
     return alt_multi_table[i][0];
@@ -2920,13 +2941,19 @@ namespace CASM {
   //***************************************************
 
   Index SymGroup::ind_prod(Index i, Index j) const {
-    if(get_multi_table().size() != size()
-       || !valid_index(i) || i >= size()
+    if(!valid_index(i) || i >= size()
        || !valid_index(j) || j >= size()) {
 
       return -1;
 
     }
+    if(calc_dense_prod_table()) {
+      unsigned short k = m_prod_table[i * size() + j];
+      return k == USHRT_MAX ? -1 : Index(k);
+    }
+
+    if(get_multi_table().size() != size())
+      return -1;
     //std::cout << "Inside ind_prod. 'i' is " << i << " and j is " << j << " and multi_table size is " << multi_table.size() << "\n";
     return multi_table[i][j];
   }
@@ -3007,6 +3034,8 @@ namespace CASM {
   void SymGroup::invalidate_multi_tables() const {
     multi_table.resize(size(), Array<Index>(size(), -1));
     alt_multi_table.resize(size(), Array<Index>(size(), -1));
+    m_prod_table.clear();
+    m_inv_table.clear();
 
   }
 
@@ -3090,17 +3119,26 @@ namespace CASM {
           //Returning a table of all 1's seems to make the most sense. This will prevent weird recursion from happening.
           multi_table.resize(size(), Array<Index>(size(), -1));
           //multi_table.clear();
+
+          // at(i) * at(j) may use ind_prod(), so the dense tables are reset after multi_table is finished
+          m_prod_table.clear();
+          m_inv_table.clear();
           return false;
         }
       }
     }
 
+    // at(i) * at(j) may use ind_prod(), so the dense tables are reset after multi_table is finished
+    m_prod_table.clear();
+    m_inv_table.clear();
     return true;
 
   }
 
   //***************************************************
   void SymGroup::calc_alt_multi_table() const {
+    m_inv_table.clear();
+
     //by calling get_multi_table(), we ensure that multi_table is populated
     alt_multi_table.resize(get_multi_table().size());
 
@@ -3130,6 +3168,46 @@ namespace CASM {
 
   }
 
+  //***************************************************
+  /// Fill m_prod_table from multi_table, if not yet filled.
+  /// Returns false if operation indices don't fit in unsigned short
+
+  bool SymGroup::calc_dense_prod_table() const {
+    if(size() >= USHRT_MAX)
+      return false;
+    if(m_prod_table.size() == size() * size())
+      return true;
+
+    get_multi_table();
+    m_prod_table.assign(size() * size(), USHRT_MAX);
+    for(Index i = 0; i < multi_table.size() && i < size(); i++) {
+      for(Index j = 0; j < multi_table[i].size() && j < size(); j++) {
+        if(valid_index(multi_table[i][j]) && multi_table[i][j] < size())
+          m_prod_table[i * size() + j] = multi_table[i][j];
+      }
+    }
+    return true;
+  }
+
+  //***************************************************
+  /// Fill m_inv_table from alt_multi_table, if not yet filled.
+  /// Returns false if operation indices don't fit in unsigned short
+
+  bool SymGroup::calc_dense_inv_table() const {
+    if(size() >= USHRT_MAX)
+      return false;
+    if(m_inv_table.size() == size())
+      return true;
+
+    get_alt_multi_table();
+    m_inv_table.assign(size(), USHRT_MAX);
+    for(Index i = 0; i < alt_multi_table.size() && i < size(); i++) {
+      if(alt_multi_table[i].size() && valid_index(alt_multi_table[i][0]) && alt_multi_table[i][0] < size())
+        m_inv_table[i] = alt_multi_table[i][0];
+    }
+    return true;
+  }
+
   //***************************************************
 
   Index SymGroup::find(const SymOp &test_op) const {
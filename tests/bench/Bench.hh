@@ -0,0 +1,56 @@
+#ifndef CASM_Bench_HH
+#define CASM_Bench_HH
+
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace CASM {
+
+  namespace Bench {
+
+    /// \brief The function that is timed
+    ///
+    /// Returns the number of items processed per call (configurations, bytes, ...), which is used
+    /// to report throughput
+    typedef std::function<long ()> Kernel;
+
+    /// \brief A benchmark
+    ///
+    /// 'setup' is called once, untimed, and returns the Kernel to time. Setup and Kernel must be
+    /// deterministic (use a fixed seed for random data), so that results are comparable between runs.
+    struct Case {
+      std::string name;
+      std::string description;
+      std::function<Kernel ()> setup;
+    };
+
+    /// \brief All registered benchmarks, in order of registration
+    std::vector<Case> &registry();
+
+    /// \brief Register a benchmark, at static initialization:
+    /// \code
+    /// static Bench::Register reg("misc/hungarian_method/64", "64x64 random cost matrix", []() {
+    ///   ... // setup
+    ///   return Bench::Kernel([ = ]() { ...; return 1; });
+    /// });
+    /// \endcode
+    struct Register {
+      Register(const std::string &name, const std::string &description, const std::function<Kernel ()> &setup) {
+        Case c;
+        c.name = name;
+        c.description = description;
+        c.setup = setup;
+        registry().push_back(c);
+      }
+    };
+
+    /// \brief Directory with the sample structures used by the unit tests
+    inline std::string testdir() {
+      return "tests/unit/crystallography";
+    }
+
+  }
+}
+
+#endif
@@ -0,0 +1,152 @@
+/// CASM benchmarks
+///
+/// Usage, from the top-level directory (as 'scons bench' does):
+///   tests/bench/bin/casm_bench [--out bench.json] [--filter substring] [--min-time seconds] [--list]
+///
+/// Each benchmark is set up once and then its kernel is called repeatedly. Calls are grouped in
+/// samples of at least 'min-time'/20 seconds, and samples are collected until 'min-time' seconds
+/// have passed. The minimum, median and mean time per call are printed and written as JSON.
+/// Output to std::cout during setup and timing is discarded.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <time.h>
+
+#include "casm/casm_io/jsonParser.hh"
+#include "casm/version/version.hh"
+
+#include "Bench.hh"
+
+using namespace CASM;
+
+namespace CASM {
+  namespace Bench {
+
+    std::vector<Case> &registry() {
+      static std::vector<Case> cases;
+      return cases;
+    }
+
+    /// Time 'kernel', and return the results as JSON
+    jsonParser run(const Case &c, const Kernel &kernel, double min_time) {
+      typedef std::chrono::steady_clock clock;
+
+      auto time_calls = [&](long reps, long & items) {
+        items = 0;
+        clock::time_point start = clock::now();
+        for(long r = 0; r < reps; r++)
+          items += kernel();
+        return std::chrono::duration<double>(clock::now() - start).count();
+      };
+
+      // warm up, and find how many calls make a sample
+      long items;
+      long reps = 1;
+      double t = time_calls(reps, items);
+      while(t < min_time / 20.0 && reps < (1L << 30)) {
+        reps *= 2;
+        t = time_calls(reps, items);
+      }
+      long items_per_call = items / reps;
+
+      std::vector<double> samples;
+      double total = 0.0;
+      while(total < min_time || samples.size() < 3) {
+        t = time_calls(reps, items);
+        samples.push_back(t / reps);
+        total += t;
+      }
+
+      std::vector<double> sorted(samples);
+      std::sort(sorted.begin(), sorted.end());
+      double median = sorted[sorted.size() / 2];
+      if(sorted.size() % 2 == 0)
+        median = 0.5 * (median + sorted[sorted.size() / 2 - 1]);
+      double mean = total / (reps * samples.size());
+
+      jsonParser json;
+      json["name"] = c.name;
+      json["description"] = c.description;
+      json["samples"] = samples.size();
+      json["calls_per_sample"] = reps;
+      json["time_min"] = sorted.front();
+      json["time_median"] = median;
+      json["time_mean"] = mean;
+      json["items_per_call"] = items_per_call;
+      json["items_per_second"] = items_per_call / median;
+      return json;
+    }
+
+  }
+}
+
+int main(int argc, char *argv[]) {
+
+  std::string out = "bench.json";
+  std::string filter;
+  double min_time = 1.0;
+  bool list = false;
+
+  for(int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if(arg == "--out" && i + 1 < argc)
+      out = argv[++i];
+    else if(arg == "--filter" && i + 1 < argc)
+      filter = argv[++i];
+    else if(arg == "--min-time" && i + 1 < argc)
+      min_time = std::atof(argv[++i]);
+    else if(arg == "--list")
+      list = true;
+    else {
+      std::cerr << "Usage: casm_bench [--out bench.json] [--filter substring] [--min-time seconds] [--list]\n";
+      return 1;
+    }
+  }
+
+  const std::vector<Bench::Case> &cases = Bench::registry();
+
+  if(list) {
+    for(auto it = cases.begin(); it != cases.end(); ++it)
+      std::cout << std::left << std::setw(50) << it->name << it->description << "\n";
+    return 0;
+  }
+
+  jsonParser results;
+  time_t now = time(nullptr);
+  char date[64];
+  strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+  results["casm_version"] = version();
+  results["date"] = std::string(date);
+  results["min_time"] = min_time;
+  results["benchmarks"].put_array();
+
+  std::cout << std::left << std::setw(50) << "name" << std::right
+            << std::setw(14) << "median (s)"
+            << std::setw(14) << "min (s)"
+            << std::setw(16) << "items/s" << "\n";
+
+  for(auto it = cases.begin(); it != cases.end(); ++it) {
+    if(it->name.find(filter) == std::string::npos)
+      continue;
+
+    // silence progress messages while setting up and timing
+    std::streambuf *coutbuf = std::cout.rdbuf(nullptr);
+    Bench::Kernel kernel = it->setup();
+    jsonParser json = Bench::run(*it, kernel, min_time);
+    std::cout.rdbuf(coutbuf);
+    results["benchmarks"].push_back(json);
+
+    std::cout << std::left << std::setw(50) << it->name << std::right << std::scientific << std::setprecision(4)
+              << std::setw(14) << json["time_median"].get<double>()
+              << std::setw(14) << json["time_min"].get<double>()
+              << std::setw(16) << json["items_per_second"].get<double>() << "\n" << std::flush;
+  }
+
+  results.write(out);
+  std::cout << "\nWrote: " << out << "\n";
+
+  return 0;
+}
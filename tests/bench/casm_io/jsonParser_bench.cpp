@@ -0,0 +1,58 @@
+#include "../Bench.hh"
+
+/// What is being benchmarked:
+#include "casm/casm_io/jsonParser.hh"
+
+/// What is being used to benchmark it:
+#include <sstream>
+#include "casm/clex/PrimClex.hh"
+#include "casm/clusterography/jsonClust.hh"
+
+using namespace CASM;
+
+namespace CASM {
+  namespace Bench {
+
+    /// A 'clust.json' document, as written by 'casm bset', for the FCC conventional cell with pairs,
+    /// triplets and quadruplets
+    jsonParser bench_clust_json() {
+      Structure prim(fs::path(testdir()) / "PRIM2");
+      prim.fill_occupant_bases('o');
+
+      jsonParser bspecs;
+      bspecs["orbit_branch_specs"]["2"]["max_length"] = 6.01;
+      bspecs["orbit_branch_specs"]["3"]["max_length"] = 4.01;
+      bspecs["orbit_branch_specs"]["4"]["max_length"] = 4.01;
+
+      SiteOrbitree tree = make_orbitree(prim, bspecs);
+      tree.collect_basis_info(prim);
+      tree.generate_clust_bases();
+
+      jsonParser json;
+      to_json(jsonHelper(tree, prim), json);
+      return json;
+    }
+
+    Register reg_json_write("casm_io/jsonParser::print", "clust.json for the FCC conventional cell, items are bytes", []() {
+      jsonParser json = bench_clust_json();
+      return Kernel([json]() {
+        std::stringstream ss;
+        json.print(ss);
+        return long(ss.str().size());
+      });
+    });
+
+    Register reg_json_read("casm_io/jsonParser::read", "clust.json for the FCC conventional cell, items are bytes", []() {
+      std::stringstream ss;
+      bench_clust_json().print(ss);
+      std::string str = ss.str();
+      return Kernel([str]() {
+        std::istringstream in(str);
+        jsonParser json;
+        json.read(in);
+        return long(str.size());
+      });
+    });
+
+  }
+}
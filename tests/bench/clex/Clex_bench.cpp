@@ -0,0 +1,176 @@
+#include "../Bench.hh"
+
+/// What is being benchmarked:
+#include "casm/clex/Configuration.hh"
+#include "casm/clex/ConfigDoF.hh"
+#include "casm/clex/ConfigEnumAllOccupations.hh"
+#include "casm/clex/Clexulator.hh"
+
+/// What is being used to benchmark it:
+#include <boost/filesystem.hpp>
+#include "casm/clex/PrimClex.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+namespace CASM {
+  namespace Bench {
+
+    /// \brief Ternary FCC (PRIM1) with pair, triplet and quadruplet clusters, its Clexulator, and
+    ///        supercells up to volume 8
+    ///
+    /// The Clexulator is written and compiled in 'tests/bench/clex' the first time it is used.
+    struct ClexFixture {
+
+      ClexFixture() :
+        prim(fs::path(testdir()) / "PRIM1"),
+        tree(prim.lattice()),
+        primclex(nullptr) {
+
+        jsonParser bspecs;
+        bspecs["orbit_branch_specs"]["2"]["max_length"] = 6.01;
+        bspecs["orbit_branch_specs"]["3"]["max_length"] = 4.01;
+        bspecs["orbit_branch_specs"]["4"]["max_length"] = 4.01;
+
+        prim.fill_occupant_bases('o');
+        tree = make_orbitree(prim, bspecs);
+        tree.collect_basis_info(prim);
+        tree.generate_clust_bases();
+        expand_nlist(prim, tree, nlist);
+
+        fs::path dir("tests/bench/clex");
+        std::string name("bench_Clexulator");
+        fs::remove(dir / (name + ".o"));
+        fs::remove(dir / (name + ".so"));
+        fs::ofstream outfile(dir / (name + ".cc"));
+        print_clexulator(prim, tree, nlist, name, outfile);
+        outfile.close();
+
+        clexulator = Clexulator(name,
+                                dir,
+                                RuntimeLibrary::default_compile_options() + " --std=c++11 -Iinclude",
+                                RuntimeLibrary::default_so_options() + " -lboost_filesystem -lboost_system");
+
+        primclex = new PrimClex(prim);
+        primclex->set_prim_nlist(nlist);
+        primclex->generate_supercells(1, 8, false);
+        primclex->generate_supercell_nlists();
+      }
+
+      /// The volume 'vol' supercell with the largest factor group
+      Supercell &supercell(Index vol) {
+        Supercell *result = nullptr;
+        for(Index i = 0; i < primclex->get_supercell_list().size(); i++) {
+          Supercell &scel = primclex->get_supercell(i);
+          if(scel.volume() != vol)
+            continue;
+          if(result == nullptr || scel.factor_group().size() > result->factor_group().size())
+            result = &scel;
+        }
+        return *result;
+      }
+
+      /// 'N' random configurations in 'scel'
+      std::vector<Configuration> random_configs(Supercell &scel, Index N, MTRand &mtrand) {
+        std::vector<Configuration> configs;
+        Array<int> max_occ = scel.max_allowed_occupation();
+        for(Index n = 0; n < N; n++) {
+          Array<int> occ(scel.num_sites());
+          for(Index l = 0; l < occ.size(); l++)
+            occ[l] = mtrand.randInt(max_occ[l]);
+          Configuration config(scel);
+          config.set_occupation(occ);
+          configs.push_back(config);
+        }
+        return configs;
+      }
+
+      Structure prim;
+      SiteOrbitree tree;
+      Array<UnitCellCoord> nlist;
+      Clexulator clexulator;
+
+      /// not deleted, because Supercell and Configuration refer to it until exit
+      PrimClex *primclex;
+
+    };
+
+    ClexFixture &clex_fixture() {
+      static ClexFixture f;
+      return f;
+    }
+
+    Register reg_is_canonical("clex/ConfigDoF::is_canonical", "256 random configurations, FCC ternary, volume 8 supercell", []() {
+      ClexFixture &f = clex_fixture();
+      Supercell &scel = f.supercell(8);
+      MTRand mtrand(1);
+      std::vector<Configuration> configs = f.random_configs(scel, 256, mtrand);
+      return Kernel([&scel, configs]() {
+        for(auto it = configs.begin(); it != configs.end(); ++it)
+          it->configdof().is_canonical(scel.permute_begin(), scel.permute_end());
+        return long(configs.size());
+      });
+    });
+
+    Register reg_enum_all_occ("clex/ConfigEnumAllOccupations", "all configurations in volume 6 supercells, FCC ternary", []() {
+      ClexFixture &f = clex_fixture();
+      std::vector<Supercell *> scels;
+      for(Index i = 0; i < f.primclex->get_supercell_list().size(); i++) {
+        if(f.primclex->get_supercell(i).volume() == 6)
+          scels.push_back(&f.primclex->get_supercell(i));
+      }
+      return Kernel([scels]() {
+        long n = 0;
+        for(auto it = scels.begin(); it != scels.end(); ++it) {
+          Supercell &scel = **it;
+          Configuration init_config(scel), final_config(scel);
+          init_config.set_occupation(Array<int>(scel.num_sites(), 0));
+          final_config.set_occupation(scel.max_allowed_occupation());
+          ConfigEnumAllOccupations<Configuration> enumerator(init_config, final_config, scel.permute_begin(), scel.permute_end());
+          for(auto e_it = enumerator.begin(); e_it != enumerator.end(); ++e_it)
+            n++;
+        }
+        return n;
+      });
+    });
+
+    Register reg_set_correlations("clex/Configuration::set_correlations", "256 random configurations, FCC ternary, volume 8 supercell", []() {
+      ClexFixture &f = clex_fixture();
+      MTRand mtrand(1);
+      std::shared_ptr<std::vector<Configuration> > configs(
+        new std::vector<Configuration>(f.random_configs(f.supercell(8), 256, mtrand)));
+      Clexulator clexulator(f.clexulator);
+      return Kernel([configs, clexulator]() mutable {
+        for(auto it = configs->begin(); it != configs->end(); ++it)
+          it->set_correlations(clexulator);
+        return long(configs->size());
+      });
+    });
+
+    Register reg_delta_point_corr("clex/Clexulator::calc_delta_point_corr", "every site and occupant change, FCC ternary, volume 8 supercell", []() {
+      ClexFixture &f = clex_fixture();
+      Supercell &scel = f.supercell(8);
+      MTRand mtrand(1);
+      Configuration config = f.random_configs(scel, 1, mtrand)[0];
+      Clexulator clexulator(f.clexulator);
+      std::vector<double> corr(clexulator.corr_size(), 0.0);
+      Array<int> max_occ = scel.max_allowed_occupation();
+      return Kernel([&scel, config, clexulator, corr, max_occ]() mutable {
+        long n = 0;
+        clexulator.set_config_occ(config.occupation().begin());
+        for(Index l = 0; l < scel.num_sites(); l++) {
+          clexulator.set_nlist(scel.get_nlist(l).begin());
+          int occ_i = config.occupation()[l];
+          for(int occ_f = 0; occ_f <= max_occ[l]; occ_f++) {
+            if(occ_f == occ_i)
+              continue;
+            clexulator.calc_delta_point_corr(scel.get_b(l), occ_i, occ_f, corr.data());
+            n++;
+          }
+        }
+        return n;
+      });
+    });
+
+  }
+}
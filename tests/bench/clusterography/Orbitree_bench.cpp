@@ -0,0 +1,44 @@
+#include "../Bench.hh"
+
+/// What is being benchmarked:
+#include "casm/clusterography/Orbitree.hh"
+
+/// What is being used to benchmark it:
+#include "casm/clex/PrimClex.hh"
+
+using namespace CASM;
+
+namespace CASM {
+  namespace Bench {
+
+    /// Orbit branch specs of pairs, triplets and quadruplets, as in a 'bspecs.json' file
+    jsonParser bench_bspecs(double pair, double triplet, double quad) {
+      jsonParser bspecs;
+      bspecs["orbit_branch_specs"]["2"]["max_length"] = pair;
+      bspecs["orbit_branch_specs"]["3"]["max_length"] = triplet;
+      bspecs["orbit_branch_specs"]["4"]["max_length"] = quad;
+      return bspecs;
+    }
+
+    Kernel orbitree_kernel(const Structure &_prim, const jsonParser &bspecs) {
+      std::shared_ptr<Structure> prim(new Structure(_prim));
+      prim->factor_group();
+      return Kernel([prim, bspecs]() {
+        SiteOrbitree tree = make_orbitree(*prim, bspecs);
+        long Norbits = 0;
+        for(Index i = 0; i < tree.size(); i++)
+          Norbits += tree[i].size();
+        return Norbits;
+      });
+    }
+
+    Register reg_orbitree_prim1("clusterography/generate_orbitree/PRIM1", "FCC, pairs to 6.01, triplets and quadruplets to 4.01, items are orbits", []() {
+      return orbitree_kernel(Structure(fs::path(testdir()) / "PRIM1"), bench_bspecs(6.01, 4.01, 4.01));
+    });
+
+    Register reg_orbitree_prim2("clusterography/generate_orbitree/PRIM2", "FCC conventional cell, 4 sites, same cluster specs, items are orbits", []() {
+      return orbitree_kernel(Structure(fs::path(testdir()) / "PRIM2"), bench_bspecs(6.01, 4.01, 4.01));
+    });
+
+  }
+}
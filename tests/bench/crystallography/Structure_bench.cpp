@@ -0,0 +1,61 @@
+#include "../Bench.hh"
+
+/// What is being benchmarked:
+#include "casm/crystallography/Structure.hh"
+#include "casm/crystallography/LatticeMap.hh"
+
+/// What is being used to benchmark it:
+#include "casm/clex/PrimClex.hh"
+
+using namespace CASM;
+
+namespace CASM {
+  namespace Bench {
+
+    Kernel factor_group_kernel(const Structure &struc) {
+      return Kernel([struc]() {
+        struc.generate_factor_group();
+        return long(struc.factor_group().size());
+      });
+    }
+
+    Register reg_fg_prim1("crystallography/generate_factor_group/PRIM1", "FCC, 1 site", []() {
+      return factor_group_kernel(Structure(fs::path(testdir()) / "PRIM1"));
+    });
+
+    Register reg_fg_prim2("crystallography/generate_factor_group/PRIM2", "FCC conventional cell, 4 sites", []() {
+      return factor_group_kernel(Structure(fs::path(testdir()) / "PRIM2"));
+    });
+
+    Register reg_fg_prim2_super("crystallography/generate_factor_group/PRIM2_222", "FCC conventional cell, 2x2x2 supercell, 32 sites", []() {
+      Structure prim(fs::path(testdir()) / "PRIM2");
+      Eigen::Matrix3i T = 2 * Eigen::Matrix3i::Identity();
+      return factor_group_kernel(prim.create_superstruc(make_supercell(prim.lattice(), T)));
+    });
+
+    Register reg_best_strain_mapping("crystallography/LatticeMap::best_strain_mapping", "FCC 2x2x2 supercell onto a strained, rotated copy", []() {
+      Structure prim(fs::path(testdir()) / "PRIM1");
+      Eigen::Matrix3i T;
+      T << 2, 0, 0,
+      1, 2, 0,
+      0, 1, 2;
+      Lattice ideal = make_supercell(prim.lattice(), T);
+
+      // stretch, shear and rotate
+      Eigen::Matrix3d F;
+      F << 1.03, 0.02, 0.00,
+      0.02, 0.98, 0.01,
+      0.00, 0.01, 1.01;
+      Eigen::Matrix3d R(Eigen::AngleAxisd(0.3, Eigen::Vector3d(1.0, 2.0, 3.0).normalized()));
+      Lattice strained(Eigen::Matrix3d(R * F * Eigen::Matrix3d(ideal.lat_column_mat())));
+
+      Index num_atoms = prim.basis.size() * 8;
+      return Kernel([ideal, strained, num_atoms]() {
+        LatticeMap lattice_map(ideal, strained, num_atoms, TOL, 2);
+        lattice_map.best_strain_mapping();
+        return long(1);
+      });
+    });
+
+  }
+}
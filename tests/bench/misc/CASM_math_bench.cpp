@@ -0,0 +1,38 @@
+#include "../Bench.hh"
+
+/// What is being benchmarked:
+#include "casm/misc/CASM_math.hh"
+
+/// What is being used to benchmark it:
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+namespace CASM {
+  namespace Bench {
+
+    /// Assignment problems like those of structure mapping: 'N' sites, distances in [0, 1)
+    Kernel hungarian_kernel(Index N) {
+      MTRand mtrand(1);
+      Eigen::MatrixXd cost(N, N);
+      for(Index i = 0; i < N; i++) {
+        for(Index j = 0; j < N; j++)
+          cost(i, j) = mtrand.randExc();
+      }
+      return Kernel([cost]() {
+        std::vector<Index> assignment;
+        hungarian_method(cost, assignment, TOL);
+        return long(1);
+      });
+    }
+
+    Register reg_hungarian_16("misc/hungarian_method/16", "16x16 random cost matrix", []() {
+      return hungarian_kernel(16);
+    });
+
+    Register reg_hungarian_64("misc/hungarian_method/64", "64x64 random cost matrix", []() {
+      return hungarian_kernel(64);
+    });
+
+  }
+}
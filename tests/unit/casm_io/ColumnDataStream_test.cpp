@@ -0,0 +1,193 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/casm_io/ColumnDataStream.hh"
+
+/// What is being used to test it:
+#include <cstring>
+#include <sstream>
+#include "casm/clex/ConfigIO.hh"
+#include "../clex/TestPrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// A column read back from the binary columnar format
+  struct ReadColumn {
+    std::uint64_t type;
+    std::string name;
+    std::vector<double> d;
+    std::vector<std::int64_t> l;
+    std::vector<char> c;
+    std::vector<std::string> s;
+  };
+
+  std::uint64_t read_u64(const std::string &bytes, std::uint64_t pos) {
+    std::uint64_t val;
+    std::memcpy(&val, bytes.data() + pos, 8);
+    return val;
+  }
+
+  std::uint64_t padded(std::uint64_t N) {
+    return (N + 7) / 8 * 8;
+  }
+
+  /// Read the file written by ColumnDataStream::write, checking the layout as it goes
+  std::vector<ReadColumn> read_columns(const std::string &bytes, std::uint64_t &rows) {
+    BOOST_REQUIRE(bytes.size() >= 32);
+    BOOST_REQUIRE_EQUAL(bytes.substr(0, 8), "CASMCOLS");
+    BOOST_CHECK_EQUAL(read_u64(bytes, 8), 1);
+    rows = read_u64(bytes, 16);
+    std::vector<ReadColumn> result(read_u64(bytes, 24));
+
+    // column data starts after the descriptors, and the columns are contiguous
+    std::uint64_t pos = 32;
+    std::uint64_t first_offset = 0, end = 0;
+    for(ReadColumn &col : result) {
+      col.type = read_u64(bytes, pos);
+      std::uint64_t offset = read_u64(bytes, pos + 8);
+      std::uint64_t size = read_u64(bytes, pos + 16);
+      std::uint64_t name_size = read_u64(bytes, pos + 24);
+      col.name = bytes.substr(pos + 32, name_size);
+      pos += 32 + padded(name_size);
+
+      if(end == 0)
+        first_offset = offset;
+      else
+        BOOST_CHECK_EQUAL(offset, end);
+      BOOST_CHECK_EQUAL(offset % 8, 0);
+      BOOST_REQUIRE(offset + size <= bytes.size());
+
+      const char *data = bytes.data() + offset;
+      switch(col.type) {
+      case ColumnDataStream::DOUBLE:
+        BOOST_CHECK_EQUAL(size, 8 * rows);
+        col.d.resize(rows);
+        std::memcpy(col.d.data(), data, 8 * rows);
+        break;
+      case ColumnDataStream::LONG:
+        BOOST_CHECK_EQUAL(size, 8 * rows);
+        col.l.resize(rows);
+        std::memcpy(col.l.data(), data, 8 * rows);
+        break;
+      case ColumnDataStream::BOOL:
+      case ColumnDataStream::CHAR:
+        BOOST_CHECK_EQUAL(size, padded(rows));
+        col.c.assign(data, data + rows);
+        break;
+      case ColumnDataStream::STRING: {
+        std::uint64_t D = read_u64(bytes, offset);
+        std::vector<std::uint64_t> begin(D + 1);
+        for(std::uint64_t i = 0; i <= D; i++)
+          begin[i] = read_u64(bytes, offset + 8 + 8 * i);
+        std::uint64_t chars = offset + 8 + 8 * (D + 1);
+        std::uint64_t codes = chars + padded(begin[D]);
+        BOOST_CHECK_EQUAL(size, codes + padded(4 * rows) - offset);
+        for(std::uint64_t r = 0; r < rows; r++) {
+          std::uint32_t code;
+          std::memcpy(&code, bytes.data() + codes + 4 * r, 4);
+          BOOST_REQUIRE(code < D);
+          col.s.push_back(bytes.substr(chars + begin[code], begin[code + 1] - begin[code]));
+        }
+        break;
+      }
+      default:
+        BOOST_ERROR("unknown column type " << col.type);
+      }
+      end = offset + size;
+    }
+    if(result.size()) {
+      BOOST_CHECK_EQUAL(first_offset, pos);
+      BOOST_CHECK_EQUAL(end, bytes.size());
+    }
+    return result;
+  }
+
+  std::vector<ReadColumn> write_and_read(const ColumnDataStream &data, std::uint64_t &rows) {
+    std::stringstream ss;
+    data.write(ss);
+    return read_columns(ss.str(), rows);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ColumnDataStreamTest)
+
+BOOST_AUTO_TEST_CASE(StreamTest) {
+  ColumnDataStream data(DataStream::skipfail);
+  data.set_col_names({"name", "count"});
+
+  // long values are accepted by a double column, and bool values by a long column
+  data << std::string("a") << long(1) << 0.5 << true << 'x' << DataStream::endl;
+  data << std::string("bb") << true << 1.5 << false << 'y' << DataStream::endl;
+  data << std::string("failed") << long(3) << 2.5 << true << 'z' << DataStream::failbit << DataStream::endl;
+  data << std::string("a") << long(-4) << long(7) << true << 'w' << DataStream::endl;
+
+  BOOST_CHECK_EQUAL(data.rows(), 3);
+  BOOST_CHECK_EQUAL(data.cols(), 5);
+  BOOST_CHECK_EQUAL(data.type(0), ColumnDataStream::STRING);
+  BOOST_CHECK_EQUAL(data.type(2), ColumnDataStream::DOUBLE);
+  BOOST_CHECK_EQUAL(data.col_name(1), "count");
+  BOOST_CHECK_EQUAL(data.col_name(4), "col(4)");
+
+  std::uint64_t rows;
+  std::vector<ReadColumn> cols = write_and_read(data, rows);
+  BOOST_REQUIRE_EQUAL(rows, 3);
+  BOOST_REQUIRE_EQUAL(cols.size(), 5);
+
+  BOOST_CHECK_EQUAL(cols[0].name, "name");
+  BOOST_CHECK(cols[0].s == std::vector<std::string>({"a", "bb", "a"}));
+  BOOST_CHECK(cols[1].l == std::vector<std::int64_t>({1, 1, -4}));
+  BOOST_CHECK(cols[2].d == std::vector<double>({0.5, 1.5, 7.0}));
+  BOOST_CHECK(cols[3].c == std::vector<char>({1, 0, 1}));
+  BOOST_CHECK_EQUAL(cols[4].name, "col(4)");
+  BOOST_CHECK(cols[4].c == std::vector<char>({'x', 'y', 'w'}));
+
+  // mismatched types and non-rectangular rows are errors
+  BOOST_CHECK_THROW(data << 1.0, std::runtime_error);
+  ColumnDataStream ragged;
+  ragged << 1.0 << 2.0 << DataStream::endl;
+  ragged << 1.0;
+  BOOST_CHECK_THROW(ragged.newline(), std::runtime_error);
+
+  // no rows
+  std::vector<ReadColumn> empty = write_and_read(ColumnDataStream(), rows);
+  BOOST_CHECK_EQUAL(rows, 0);
+  BOOST_CHECK_EQUAL(empty.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FormatterTest) {
+  test::TestPrimClex proj(2);
+  PrimClex &primclex = proj.primclex();
+
+  // as 'casm query -o file.bin' writes it
+  DataFormatter<Configuration> formatter(ConfigIOParser::parse(std::vector<std::string>({"configname", "scel_size", "selected", "comp"})));
+  ColumnDataStream data;
+  data.set_col_names(formatter.col_header(*primclex.config_cbegin()));
+  formatter.stream_inject(primclex.config_cbegin(), primclex.config_cend(), data);
+
+  std::uint64_t rows;
+  std::vector<ReadColumn> cols = write_and_read(data, rows);
+  BOOST_REQUIRE_EQUAL(cols.size(), 5);
+  BOOST_CHECK_EQUAL(cols[0].type, ColumnDataStream::STRING);
+  BOOST_CHECK_EQUAL(cols[1].type, ColumnDataStream::LONG);
+  BOOST_CHECK_EQUAL(cols[2].type, ColumnDataStream::BOOL);
+  BOOST_CHECK_EQUAL(cols[3].type, ColumnDataStream::DOUBLE);
+  BOOST_CHECK_EQUAL(cols[3].name, "comp(a)");
+  BOOST_CHECK_EQUAL(cols[4].name, "comp(b)");
+
+  Index r = 0;
+  for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it, ++r) {
+    BOOST_REQUIRE(r < rows);
+    BOOST_CHECK_EQUAL(cols[0].s[r], it->name());
+    BOOST_CHECK_EQUAL(cols[1].l[r], it->get_supercell().volume());
+    BOOST_CHECK_EQUAL(bool(cols[2].c[r]), it->selected());
+    BOOST_CHECK_EQUAL(cols[3].d[r], it->get_param_composition()[0]);
+    BOOST_CHECK_EQUAL(cols[4].d[r], it->get_param_composition()[1]);
+  }
+  BOOST_CHECK_EQUAL(r, rows);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
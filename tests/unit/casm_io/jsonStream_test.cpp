@@ -0,0 +1,252 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/casm_io/jsonStream.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+#include "casm/casm_io/jsonParser.hh"
+#include "casm/external/json_spirit/json_spirit_reader_template.h"
+#include "casm/external/json_spirit/json_spirit_writer_template.h"
+
+using namespace CASM;
+
+namespace {
+
+  /// Records the events as text
+  class RecordHandler : public jsonHandler {
+  public:
+    std::vector<std::string> events;
+
+    void null_value() {
+      events.push_back("null");
+    }
+    void bool_value(bool val) {
+      events.push_back(val ? "true" : "false");
+    }
+    void int_value(std::int64_t val) {
+      events.push_back("int " + std::to_string(val));
+    }
+    void uint_value(std::uint64_t val) {
+      events.push_back("uint " + std::to_string(val));
+    }
+    void double_value(double val) {
+      std::stringstream ss;
+      ss.precision(17);
+      ss << "double " << val;
+      events.push_back(ss.str());
+    }
+    void string_value(const std::string &val) {
+      events.push_back("string " + val);
+    }
+    void begin_object() {
+      events.push_back("{");
+    }
+    void key(const std::string &name) {
+      events.push_back("key " + name);
+    }
+    void end_object() {
+      events.push_back("}");
+    }
+    void begin_array() {
+      events.push_back("[");
+    }
+    void end_array() {
+      events.push_back("]");
+    }
+  };
+
+  /// JSON documents covering the value types, nesting, escapes, comments and whitespace
+  std::vector<std::string> documents() {
+    return {
+      "{}",
+      "[]",
+      "  42  ",
+      "\"text\"",
+      "{\"a\" : 1, \"b\" : [1, 2.5, -3e2, true, false, null], \"c\" : {\"d\" : \"e\"}}",
+      "[[1, [2, [3, []]]], {\"x\" : {}}, -0.0, 1.5E-3, 18446744073709551615, -9223372036854775808]",
+      "// comment\n{ /* block\n comment */ \"tab\\tnew\\nline\" : \"quote\\\" slash\\\\ \\/ \\u00e9 \\u0041\" }",
+      "{\n  \"name\" : \"SCEL1_1_1_1_0_0_0/0\",\n  \"corr\" : [ 1.000000000000, 0.333333333333, -0.5 ]\n}\ntrailing content is ignored"
+    };
+  }
+
+  json_spirit::mValue read_tree(const std::string &text) {
+    std::stringstream ss(text);
+    json_spirit::mValue value;
+    jsonTreeHandler handler(value);
+    BOOST_CHECK(jsonReader::read(ss, handler));
+    return value;
+  }
+
+  json_spirit::mValue read_tree_json_spirit(const std::string &text) {
+    std::stringstream ss(text);
+    json_spirit::mValue value;
+    BOOST_CHECK(json_spirit::read_stream(ss, value));
+    return value;
+  }
+
+  /// Equal, except that doubles may differ in the last digit, because json_spirit does not round
+  /// them correctly
+  bool equivalent(const json_spirit::mValue &A, const json_spirit::mValue &B) {
+    if(A.type() != B.type())
+      return false;
+    switch(A.type()) {
+    case json_spirit::real_type:
+      return std::abs(A.get_real() - B.get_real()) <= 1e-15 * std::abs(A.get_real());
+    case json_spirit::array_type: {
+      const json_spirit::mArray &a = A.get_array(), &b = B.get_array();
+      if(a.size() != b.size())
+        return false;
+      for(Index i = 0; i < a.size(); i++) {
+        if(!equivalent(a[i], b[i]))
+          return false;
+      }
+      return true;
+    }
+    case json_spirit::obj_type: {
+      const json_spirit::mObject &a = A.get_obj(), &b = B.get_obj();
+      if(a.size() != b.size())
+        return false;
+      for(auto it = a.begin(), it_b = b.begin(); it != a.end(); ++it, ++it_b) {
+        if(it->first != it_b->first || !equivalent(it->second, it_b->second))
+          return false;
+      }
+      return true;
+    }
+    default:
+      return A == B;
+    }
+  }
+
+  std::string write(const json_spirit::mValue &value, unsigned int indent = 2, unsigned int prec = 12) {
+    std::stringstream ss;
+    jsonWriter writer(ss, indent, prec);
+    writer.value(value);
+    writer.flush();
+    return ss.str();
+  }
+
+  std::string write_json_spirit(const json_spirit::mValue &value, unsigned int indent = 2, unsigned int prec = 12) {
+    std::stringstream ss;
+    json_spirit::write_stream(value, ss, indent, prec, json_spirit::pretty_print | json_spirit::single_line_arrays);
+    return ss.str();
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(jsonStreamTest)
+
+BOOST_AUTO_TEST_CASE(ReadEventsTest) {
+  std::string text = "{\"a\" : [1, -2, 2.5, 18446744073709551615], \"b\" : {\"c\" : null, \"d\" : \"e\\nf\"}, \"g\" : true}";
+  RecordHandler handler;
+  jsonReader reader(text.c_str(), text.c_str() + text.size());
+  reader.parse(handler);
+
+  std::vector<std::string> expected = {
+    "{", "key a", "[", "int 1", "int -2", "double 2.5", "uint 18446744073709551615", "]",
+    "key b", "{", "key c", "null", "key d", "string e\nf", "}", "key g", "true", "}"
+  };
+  BOOST_CHECK(handler.events == expected);
+}
+
+BOOST_AUTO_TEST_CASE(ReadTest) {
+  // the tree is the same as json_spirit builds
+  for(const std::string &text : documents())
+    BOOST_CHECK_MESSAGE(equivalent(read_tree(text), read_tree_json_spirit(text)), text);
+
+  // doubles are correctly rounded
+  BOOST_CHECK_EQUAL(read_tree("0.333333333333").get_real(), std::strtod("0.333333333333", nullptr));
+  BOOST_CHECK_EQUAL(read_tree("-1.0000000000000002e-7").get_real(), std::strtod("-1.0000000000000002e-7", nullptr));
+
+  // invalid input
+  std::vector<std::string> invalid = {"", "{", "[1, 2", "{\"a\" 1}", "{\"a\" : }", "[1,]", "tru", "\"unterminated", "{1 : 2}"};
+  for(const std::string &text : invalid) {
+    std::stringstream ss(text);
+    json_spirit::mValue value;
+    jsonTreeHandler handler(value);
+    BOOST_CHECK_MESSAGE(!jsonReader::read(ss, handler), text);
+  }
+
+  // errors report the position
+  std::string text = "{\n  \"a\" : [1, 2,, 3]\n}";
+  RecordHandler handler;
+  jsonReader reader(text.c_str(), text.c_str() + text.size());
+  try {
+    reader.parse(handler);
+    BOOST_ERROR("expected std::runtime_error");
+  }
+  catch(std::runtime_error &e) {
+    BOOST_CHECK(std::string(e.what()).find("line 2") != std::string::npos);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(WriteTest) {
+  // the text is the same as json_spirit writes, for several indents and precisions
+  for(const std::string &text : documents()) {
+    json_spirit::mValue value = read_tree_json_spirit(text);
+    BOOST_CHECK_EQUAL(write(value), write_json_spirit(value));
+    BOOST_CHECK_EQUAL(write(value, 4, 6), write_json_spirit(value, 4, 6));
+    BOOST_CHECK_EQUAL(write(value, 0, 3), write_json_spirit(value, 0, 3));
+
+    // round trip
+    BOOST_CHECK(equivalent(read_tree(write(value, 2, 17)), value));
+  }
+
+  // values built with jsonParser, including the force_row, force_column and
+  // remove_trailing_zeros options
+  jsonParser json;
+  json["matrix"] = Eigen::MatrixXd::Identity(3, 3);
+  json["vector"] = Eigen::Vector3d(0.1, 1e-20, 12345.678);
+  json["big"] = 1e300;
+  json["small"] = -1e-300;
+  json["int"] = -7;
+  json["list"].put_array();
+  json["list"].push_back("a");
+  json["list"].push_back(jsonParser::object());
+  json["list"].push_back(false);
+  json["row"] = std::vector<double>(3, 1.0);
+  json["row"].set_force_row();
+  json["col"] = std::vector<double>(2, 2.5);
+  json["col"].set_force_column();
+  json["trimmed"] = 1.25;
+  json["trimmed"].set_remove_trailing_zeros();
+  BOOST_CHECK_EQUAL(write(json), write_json_spirit(json));
+
+  std::stringstream ss;
+  json.print(ss);
+  BOOST_CHECK_EQUAL(ss.str(), write_json_spirit(json));
+
+  // writing with the streaming interface
+  std::stringstream stream;
+  {
+    jsonWriter writer(stream);
+    writer.begin_object();
+    writer.key("corr").begin_array();
+    writer.value(1.0).value(0.5).value(-0.25);
+    writer.end_array();
+    writer.key("name").value("SCEL1_1_1_1_0_0_0/0");
+    writer.key("nothing").null_value();
+    writer.key("selected").value(true);
+    writer.end_object();
+  }
+  jsonParser expected;
+  expected["name"] = "SCEL1_1_1_1_0_0_0/0";
+  expected["corr"] = std::vector<double>({1.0, 0.5, -0.25});
+  expected["selected"] = true;
+  expected["nothing"].put_null();
+  BOOST_CHECK_EQUAL(stream.str(), write_json_spirit(expected));
+
+  // fixed notation
+  char buf[400];
+  char *end = jsonWriter::format_fixed(-1.5, 3, buf);
+  BOOST_CHECK_EQUAL(std::string(buf, end), "-1.500");
+  end = jsonWriter::format_fixed(1e20, 2, buf);
+  BOOST_CHECK_EQUAL(std::string(buf, end), "100000000000000000000.00");
+  end = jsonWriter::format_fixed(0.0, 0, buf);
+  BOOST_CHECK_EQUAL(std::string(buf, end), "0.");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/Configuration.hh"
+
+/// What is being used to test it:
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+#include "TestPrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// Count the molecules of 'config' by name, one site at a time
+  Array<int> count_by_name(const Configuration &config) {
+    const Array<Molecule> &struc_molecule = config.get_primclex().get_prim().get_struc_molecule();
+    Array<int> result(struc_molecule.size(), 0);
+    for(Index l = 0; l < config.size(); l++) {
+      Index i = 0;
+      while(struc_molecule[i].name != config.get_mol(l).name)
+        i++;
+      result[i]++;
+    }
+    return result;
+  }
+
+  /// Check the cached counts, and the compositions derived from them, against counting by name
+  void check_composition(const Configuration &config) {
+    const PrimClex &primclex = config.get_primclex();
+    Array<int> expected = count_by_name(config);
+    BOOST_CHECK(config.num_each_molecule() == expected);
+    BOOST_CHECK(config.get_num_each_molecule() == expected);
+
+    std::vector<std::string> components = primclex.composition_axes().components();
+    Eigen::VectorXd n = Eigen::VectorXd::Zero(components.size());
+    for(Index i = 0; i < expected.size(); i++) {
+      for(Index c = 0; c < components.size(); c++) {
+        if(components[c] == primclex.get_struc_molecule()[i].name)
+          n[c] = double(expected[i]) / config.get_supercell().volume();
+      }
+    }
+    BOOST_CHECK(config.get_num_each_component().isApprox(n));
+    BOOST_CHECK(config.get_param_composition().isApprox(primclex.composition_axes().param_composition(n)));
+
+    Array<double> comp = config.get_composition();
+    for(Index i = 0; i < expected.size(); i++)
+      BOOST_CHECK_CLOSE(comp[i], double(expected[i]) / config.size(), 1e-10);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(CompositionTest)
+
+BOOST_AUTO_TEST_CASE(LookupTest) {
+  test::TestPrimClex proj(1);
+  const PrimClex &primclex = proj.primclex();
+  const Structure &prim = primclex.get_prim();
+
+  // the cached tables agree with the prim and the composition axes
+  Array<Molecule> struc_molecule = prim.get_struc_molecule();
+  BOOST_REQUIRE_EQUAL(primclex.get_struc_molecule().size(), struc_molecule.size());
+  for(Index i = 0; i < struc_molecule.size(); i++)
+    BOOST_CHECK_EQUAL(primclex.get_struc_molecule()[i].name, struc_molecule[i].name);
+
+  BOOST_REQUIRE_EQUAL(primclex.get_struc_molecule_index().size(), prim.basis.size());
+  for(Index b = 0; b < prim.basis.size(); b++) {
+    for(Index occ = 0; occ < prim.basis[b].site_occupant().size(); occ++) {
+      int i = primclex.get_struc_molecule_index()[b][occ];
+      BOOST_CHECK_EQUAL(struc_molecule[i].name, prim.basis[b].site_occupant()[occ].name);
+    }
+  }
+
+  std::vector<std::string> components = primclex.composition_axes().components();
+  for(Index i = 0; i < struc_molecule.size(); i++) {
+    int c = primclex.get_component_index()[i];
+    BOOST_REQUIRE(c >= 0);
+    BOOST_CHECK_EQUAL(components[c], struc_molecule[i].name);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(CountTest) {
+  test::TestPrimClex proj(4);
+  PrimClex &primclex = proj.primclex();
+
+  // counted in parallel, then read from the cache
+  primclex.populate_composition();
+  for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it)
+    check_composition(*it);
+
+  // the cache follows occupation changes
+  MTRand mtrand(31u);
+  Configuration config(*primclex.config_cbegin());
+  for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it) {
+    if(it->size() > config.size())
+      config = *it;
+  }
+  for(Index t = 0; t < 50; t++) {
+    Index l = mtrand.randInt(config.size() - 1);
+    config.set_occ(l, mtrand.randInt(2));
+    check_composition(config);
+  }
+
+  Array<int> occ(config.size(), 1);
+  config.set_occupation(occ);
+  check_composition(config);
+  BOOST_CHECK_EQUAL(config.num_each_molecule()[primclex.get_struc_molecule_index()[0][1]], config.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,138 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigEnumByComposition.hh"
+
+/// What is being used to test it:
+#include <set>
+#include "TestPrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  typedef std::set<std::vector<int> > OccSet;
+
+  /// 'result[b][occ]', the number of sites of sublattice 'b' with occupant 'occ'
+  Array<Array<int> > sublat_num_each(const Array<int> &occ, Index N_sublat, Index N_occ) {
+    Array<Array<int> > result(N_sublat, Array<int>(N_occ, 0));
+    Index volume = occ.size() / N_sublat;
+    for(Index i = 0; i < occ.size(); i++)
+      result[i / volume][occ[i]]++;
+    return result;
+  }
+
+  /// The occupations visited by ConfigEnumByComposition
+  OccSet enumerated(Supercell &scel, const Array<Array<int> > &num_each) {
+    Configuration init_config(scel);
+    init_config.set_occupation(Array<int>(scel.num_sites(), 0));
+    ConfigEnumByComposition<Configuration> enumerator(init_config, num_each, scel.permute_begin(), scel.permute_end());
+
+    OccSet result;
+    for(auto it = enumerator.begin(); it != enumerator.end(); ++it) {
+      const Array<int> &occ = it->occupation();
+      BOOST_CHECK(result.insert(std::vector<int>(occ.begin(), occ.end())).second);
+    }
+    return result;
+  }
+
+  /// The enumerated configurations of 'scel' that have an equivalent with the sublattice
+  /// compositions 'num_each'
+  OccSet expected(const Supercell &scel, const Array<Array<int> > &num_each) {
+    OccSet result;
+    for(Index c = 0; c < scel.get_config_list().size(); c++) {
+      const Array<int> &occ = scel.get_config(c).occupation();
+      Array<int> image(occ.size());
+      for(auto it = scel.permute_begin(); it != scel.permute_end(); ++it) {
+        for(Index i = 0; i < occ.size(); i++)
+          image[i] = occ[it.permute_ind(i)];
+        if(sublat_num_each(image, num_each.size(), num_each[0].size()) == num_each) {
+          result.insert(std::vector<int>(occ.begin(), occ.end()));
+          break;
+        }
+      }
+    }
+    return result;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ConfigEnumByCompositionTest)
+
+BOOST_AUTO_TEST_CASE(SingleSublatticeTest) {
+  test::TestPrimClex proj(4);
+  PrimClex &primclex = proj.primclex();
+
+  // every composition of each supercell together visits each enumerated configuration once
+  for(Index s = 0; s < primclex.get_supercell_list().size(); s++) {
+    Supercell &scel = primclex.get_supercell(s);
+    int V = scel.volume();
+    Index total = 0;
+    for(int nB = 0; nB <= V; nB++) {
+      for(int nC = 0; nB + nC <= V; nC++) {
+        Array<Array<int> > num_each(1, Array<int>(3, 0));
+        num_each[0][0] = V - nB - nC;
+        num_each[0][1] = nB;
+        num_each[0][2] = nC;
+
+        OccSet result = enumerated(scel, num_each);
+        BOOST_CHECK(result == expected(scel, num_each));
+        total += result.size();
+      }
+    }
+    BOOST_CHECK_EQUAL(total, scel.get_config_list().size());
+
+    // nothing new is added to a supercell that already has all of its configurations
+    Index N_configs = scel.get_config_list().size();
+    Array<Array<int> > num_each(1, Array<int>(3, 0));
+    num_each[0][0] = V;
+    scel.enumerate_composition_configurations(num_each);
+    BOOST_CHECK_EQUAL(scel.get_config_list().size(), N_configs);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SublatticeTest) {
+  // the conventional FCC cell: four sublattices, which are exchanged by symmetry
+  PrimClex primclex(Structure(fs::path("tests/unit/crystallography/PRIM2")));
+  primclex.generate_supercells(1, 2, false);
+  primclex.enumerate_all_configurations();
+
+  for(Index s = 0; s < primclex.get_supercell_list().size(); s++) {
+    Supercell &scel = primclex.get_supercell(s);
+    int V = scel.volume();
+
+    // compositions preserved by every operation, and compositions that some operations
+    // exchange with other sublattices
+    std::vector<std::vector<std::vector<int> > > cases = {
+      {{V, 0, 0}, {V, 0, 0}, {V, 0, 0}, {V, 0, 0}},
+      {{0, V, 0}, {V, 0, 0}, {V, 0, 0}, {0, 0, V}},
+      {{V - 1, 1, 0}, {V, 0, 0}, {0, V - 1, 1}, {0, 0, V}},
+      {{V - 1, 0, 1}, {V - 1, 1, 0}, {V, 0, 0}, {V, 0, 0}}
+    };
+    for(const auto &c : cases) {
+      Array<Array<int> > num_each;
+      bool mixed = false;
+      for(const auto &sublat : c) {
+        num_each.push_back(Array<int>());
+        for(int n : sublat) {
+          num_each.back().push_back(n);
+          mixed = mixed || (n != 0 && n != V);
+        }
+      }
+      OccSet result = enumerated(scel, num_each);
+      BOOST_CHECK(result == expected(scel, num_each));
+
+      // only occupations that differ within a sublattice are primitive in larger supercells
+      if(V == 1 || mixed)
+        BOOST_CHECK(result.size() > 0);
+    }
+
+    // counts that do not fill each sublattice enumerate nothing
+    Array<Array<int> > bad(4, Array<int>(3, 0));
+    bad[0][0] = V + 1;
+    BOOST_CHECK(enumerated(scel, bad).empty());
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,199 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigEnumRandom.hh"
+
+/// What is being used to test it:
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <set>
+#include "TestPrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  typedef std::map<std::vector<int>, Index> OccCount;
+
+  /// Number of times each occupation is drawn
+  OccCount sample(Supercell &scel, const RandomSampling &sampling, Index N_samples, MTRand &mtrand) {
+    Configuration init_config(scel);
+    init_config.set_occupation(Array<int>(scel.num_sites(), 0));
+    ConfigEnumRandom<Configuration> enumerator(init_config, scel, sampling, N_samples, mtrand);
+
+    OccCount result;
+    Index N = 0;
+    for(auto it = enumerator.begin(); it != enumerator.end(); ++it, ++N) {
+      const Array<int> &occ = it->occupation();
+      result[std::vector<int>(occ.begin(), occ.end())]++;
+    }
+    BOOST_CHECK_EQUAL(N, N_samples);
+    return result;
+  }
+
+  /// Fraction of the sites, over all samples, with each occupant
+  std::vector<double> site_frac(const OccCount &count, int N_occ) {
+    std::vector<double> result(N_occ, 0.0);
+    Index total = 0;
+    for(const auto &value : count) {
+      for(int occ : value.first)
+        result[occ] += value.second;
+      total += value.first.size() * value.second;
+    }
+    for(double &x : result)
+      x /= total;
+    return result;
+  }
+
+  /// The first supercell of volume 'V'
+  Supercell &supercell(PrimClex &primclex, Index V) {
+    for(Index s = 0; s < primclex.get_supercell_list().size(); s++) {
+      if(primclex.get_supercell(s).volume() == V)
+        return primclex.get_supercell(s);
+    }
+    throw std::runtime_error("no supercell of the requested volume");
+  }
+
+  /// The names and occupations of every configuration, in order
+  std::vector<std::pair<std::string, std::vector<int> > > config_list(const PrimClex &primclex) {
+    std::vector<std::pair<std::string, std::vector<int> > > result;
+    for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it)
+      result.push_back(std::make_pair(it->name(), std::vector<int>(it->occupation().begin(), it->occupation().end())));
+    return result;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ConfigEnumRandomTest)
+
+BOOST_AUTO_TEST_CASE(UniformTest) {
+  test::TestPrimClex proj(2);
+  MTRand mtrand(17u);
+
+  // each site is occupied independently and uniformly: all 9 occupations of 2 sites are equally likely
+  Supercell &scel = supercell(proj.primclex(), 2);
+  Index N_samples = 18000;
+  OccCount count = sample(scel, RandomSampling(), N_samples, mtrand);
+  BOOST_CHECK_EQUAL(count.size(), 9);
+  for(const auto &value : count)
+    BOOST_CHECK_CLOSE(double(value.second), N_samples / 9.0, 10.0);
+
+  // fixed sublattice counts: both arrangements of one A and one C
+  RandomSampling fixed;
+  fixed.sublat_num_each.push_back(Array<int>(3, 0));
+  fixed.sublat_num_each[0][0] = 1;
+  fixed.sublat_num_each[0][2] = 1;
+  count = sample(scel, fixed, 4000, mtrand);
+  BOOST_CHECK_EQUAL(count.size(), 2);
+  BOOST_CHECK_CLOSE(double(count[std::vector<int>({0, 2})]), 2000.0, 10.0);
+  BOOST_CHECK_CLOSE(double(count[std::vector<int>({2, 0})]), 2000.0, 10.0);
+
+  // sublattice counts that do not fill the supercell
+  fixed.sublat_num_each[0][1] = 1;
+  BOOST_CHECK_THROW(sample(scel, fixed, 1, mtrand), std::runtime_error);
+
+  // Monte Carlo sampling requires a Clexulator
+  RandomSampling mc;
+  mc.kT = 0.1;
+  BOOST_CHECK_THROW(sample(scel, mc, 1, mtrand), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(MonteCarloTest) {
+  test::TestPrimClex proj(4);
+  PrimClex &primclex = proj.primclex();
+
+  // ECI on the point functions only, so that each site is independent, with energy eps[occ]
+  fs::path eci_path = fs::temp_directory_path() / fs::unique_path("casm_unit_test_eci_%%%%-%%%%");
+  {
+    fs::ofstream file(eci_path);
+    for(int i = 0; i < 7; i++)
+      file << "header\n";
+    file << "0.05 0.05 1\n";
+    file << "-0.1 -0.1 2\n";
+  }
+  RandomSampling mc;
+  mc.kT = 0.05;
+  mc.sweeps = 2;
+  mc.clexulator = proj.clexulator();
+  mc.eci = ECIContainer(eci_path);
+  fs::remove(eci_path);
+
+  std::vector<double> eps;
+  Supercell &unit = supercell(primclex, 1);
+  for(int occ = 0; occ < 3; occ++) {
+    Configuration config(unit);
+    config.set_occupation(Array<int>(1, occ));
+    eps.push_back(mc.eci * correlations(config, mc.clexulator));
+  }
+  BOOST_CHECK(eps[0] != eps[1] && eps[1] != eps[2]);
+
+  // the occupants of a site have Boltzmann probabilities
+  std::vector<double> expected;
+  double Z = 0.0;
+  for(int occ = 0; occ < 3; occ++) {
+    expected.push_back(std::exp(-eps[occ] / mc.kT));
+    Z += expected.back();
+  }
+  for(double &p : expected)
+    p /= Z;
+
+  MTRand mtrand(19u);
+  Supercell &scel = supercell(primclex, 4);
+  std::vector<double> result = site_frac(sample(scel, mc, 4000, mtrand), 3);
+  for(int occ = 0; occ < 3; occ++)
+    BOOST_CHECK_SMALL(result[occ] - expected[occ], 0.02);
+
+  // swap moves keep the sublattice counts
+  mc.sublat_num_each.push_back(Array<int>(3, 0));
+  mc.sublat_num_each[0][0] = 2;
+  mc.sublat_num_each[0][1] = 1;
+  mc.sublat_num_each[0][2] = 1;
+  OccCount count = sample(scel, mc, 500, mtrand);
+  BOOST_CHECK_EQUAL(count.size(), 12);
+  for(const auto &value : count) {
+    BOOST_CHECK_EQUAL(std::count(value.first.begin(), value.first.end(), 0), 2);
+    BOOST_CHECK_EQUAL(std::count(value.first.begin(), value.first.end(), 1), 1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SampleConfigurationsTest) {
+  // samples depend on the seed and the number of streams, but not on the number of threads
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  const char *env = std::getenv("CASM_NUM_THREADS");
+  std::string prev = env ? env : "";
+
+  std::vector<std::vector<std::pair<std::string, std::vector<int> > > > results;
+  for(std::string threads : {"1", "3", "3"}) {
+    setenv("CASM_NUM_THREADS", threads.c_str(), 1);
+    PrimClex primclex(prim);
+    primclex.generate_supercells(3, 3, false);
+
+    Index seed = results.size() < 2 ? 23 : 29;
+    Index N_added = 0;
+    for(Index s = 0; s < primclex.get_supercell_list().size(); s++)
+      N_added += primclex.get_supercell(s).sample_configurations(RandomSampling(), 20, seed, 4);
+    results.push_back(config_list(primclex));
+    BOOST_CHECK_EQUAL(N_added, results.back().size());
+
+    // the added configurations are canonical and distinct
+    std::set<std::pair<std::string, std::vector<int> > > distinct;
+    for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it) {
+      BOOST_CHECK(it->is_canonical(it->get_supercell().permute_begin(), it->get_supercell().permute_end()));
+      distinct.insert(std::make_pair(it->get_supercell().get_name(), std::vector<int>(it->occupation().begin(), it->occupation().end())));
+    }
+    BOOST_CHECK_EQUAL(distinct.size(), results.back().size());
+  }
+  if(env)
+    setenv("CASM_NUM_THREADS", prev.c_str(), 1);
+  else
+    unsetenv("CASM_NUM_THREADS");
+
+  BOOST_CHECK(results[0].size() > 0);
+  BOOST_CHECK(results[0] == results[1]);
+  BOOST_CHECK(results[1] != results[2]);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,195 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigSelection.hh"
+
+/// What is being used to test it:
+#include <functional>
+#include <sstream>
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+#include "TestPrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// configuration name -> selected, for the configurations in the selection
+  typedef std::map<std::string, bool> SelectionMap;
+
+  template<bool IsConst>
+  SelectionMap to_map(const ConfigSelection<IsConst> &selection) {
+    SelectionMap result;
+    for(auto it = selection.config_cbegin(); it != selection.config_cend(); ++it)
+      result[it.name()] = it.selected();
+    return result;
+  }
+
+  /// A selection of about 70% of the configurations, about half of them selected
+  ConfigSelection<false> random_selection(PrimClex &primclex, MTRand &mtrand, SelectionMap &expected) {
+    ConfigSelection<false> selection(primclex);
+    expected.clear();
+    for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it) {
+      if(mtrand.rand() < 0.3)
+        BOOST_CHECK_EQUAL(selection.erase(it->name()), 1);
+      else {
+        bool is_selected = mtrand.rand() < 0.5;
+        selection.set_selected(it->name(), is_selected);
+        expected[it->name()] = is_selected;
+      }
+    }
+    BOOST_CHECK(to_map(selection) == expected);
+    return selection;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ConfigSelectionTest)
+
+BOOST_AUTO_TEST_CASE(ConstructTest) {
+  test::TestPrimClex proj(3);
+  PrimClex &primclex = proj.primclex();
+
+  Index N = 0, Nselected = 0;
+  for(auto it = primclex.config_begin(); it != primclex.config_end(); ++it, ++N) {
+    it->set_selected(N % 4 == 0);
+    Nselected += it->selected();
+  }
+
+  // all configurations, in PrimClex order
+  ConfigSelection<false> selection(primclex);
+  BOOST_CHECK_EQUAL(selection.size(), N);
+  BOOST_CHECK_EQUAL(selection.selected_size(), Nselected);
+  auto config_it = primclex.config_cbegin();
+  for(auto it = selection.config_begin(); it != selection.config_end(); ++it, ++config_it) {
+    BOOST_CHECK_EQUAL(it.name(), config_it->name());
+    BOOST_CHECK_EQUAL(&(*it), &(*config_it));
+    BOOST_CHECK_EQUAL(it.selected(), config_it->selected());
+    BOOST_CHECK(selection.find(config_it->name()) == it);
+    BOOST_CHECK_EQUAL(selection.selected(config_it->name()), config_it->selected());
+  }
+  BOOST_CHECK(config_it == primclex.config_cend());
+
+  Index count = 0;
+  for(auto it = selection.selected_config_cbegin(); it != selection.selected_config_cend(); ++it, ++count)
+    BOOST_CHECK(it->selected());
+  BOOST_CHECK_EQUAL(count, Nselected);
+
+  auto last = selection.config_end();
+  --last;
+  BOOST_CHECK_EQUAL(last.ordinal(), N - 1);
+
+  // names that do not exist are not found
+  BOOST_CHECK(selection.find("SCEL1_1_1_1_0_0_0/100") == selection.config_end());
+  BOOST_CHECK(selection.find("SCEL100_1_1_1_0_0_0/0") == selection.config_end());
+  BOOST_CHECK(selection.find("not_a_config") == selection.config_end());
+  BOOST_CHECK(!selection.selected("not_a_config"));
+
+  // insert, erase
+  std::string name = primclex.config_cbegin()->name();
+  BOOST_CHECK(!selection.insert(std::make_pair(name, false)).second);
+  BOOST_CHECK_EQUAL(selection.erase(name), 1);
+  BOOST_CHECK_EQUAL(selection.erase(name), 0);
+  BOOST_CHECK(selection.find(name) == selection.config_end());
+  BOOST_CHECK_EQUAL(selection.size(), N - 1);
+  BOOST_CHECK(selection.insert(std::make_pair(name, true)).second);
+  BOOST_CHECK(selection.selected(name));
+  BOOST_CHECK_EQUAL(selection.size(), N);
+
+  ConstConfigSelection const_selection(static_cast<const PrimClex &>(primclex));
+  BOOST_CHECK(to_map(const_selection) == to_map(ConfigSelection<false>(primclex)));
+}
+
+BOOST_AUTO_TEST_CASE(SetAlgebraTest) {
+  test::TestPrimClex proj(4);
+  PrimClex &primclex = proj.primclex();
+  MTRand mtrand(11u);
+
+  // the bitset operations agree with the same operations on maps of names
+  for(Index t = 0; t < 5; t++) {
+    SelectionMap A_map, B_map;
+    ConfigSelection<false> A = random_selection(primclex, mtrand, A_map);
+    ConfigSelection<false> B = random_selection(primclex, mtrand, B_map);
+
+    auto combine = [&](std::function<bool(bool, bool)> op) {
+      SelectionMap result(A_map);
+      for(const auto &value : B_map) {
+        auto it = A_map.find(value.first);
+        result[value.first] = op(it != A_map.end() && it->second, value.second);
+      }
+      for(auto &value : result) {
+        if(!B_map.count(value.first))
+          value.second = op(value.second, false);
+      }
+      return result;
+    };
+
+    ConfigSelection<false> C(A);
+    C &= B;
+    BOOST_CHECK(to_map(C) == combine([](bool a, bool b) {
+      return a && b;
+    }));
+
+    C = A;
+    C |= B;
+    BOOST_CHECK(to_map(C) == combine([](bool a, bool b) {
+      return a || b;
+    }));
+
+    C = A;
+    C ^= B;
+    SelectionMap expected = combine([](bool a, bool b) {
+      return a != b;
+    });
+    BOOST_CHECK(to_map(C) == expected);
+    BOOST_CHECK_EQUAL(C.size(), expected.size());
+    BOOST_CHECK_EQUAL(C.selected_size(), std::count_if(expected.begin(), expected.end(), [](const std::pair<const std::string, bool> &value) {
+      return value.second;
+    }));
+
+    C.flip();
+    for(auto &value : expected)
+      value.second = !value.second;
+    BOOST_CHECK(to_map(C) == expected);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(IOTest) {
+  test::TestPrimClex proj(3);
+  PrimClex &primclex = proj.primclex();
+  MTRand mtrand(13u);
+
+  SelectionMap expected;
+  ConfigSelection<false> selection = random_selection(primclex, mtrand, expected);
+
+  // json round trip
+  jsonParser json;
+  selection.to_json(json);
+  BOOST_CHECK_EQUAL(json.size(), expected.size());
+  ConfigSelection<false> from_json(primclex);
+  from_json.from_json(json);
+  BOOST_CHECK(to_map(from_json) == expected);
+
+  selection.to_json(json, true);
+  BOOST_CHECK_EQUAL(json.size(), selection.selected_size());
+
+  // csv round trip
+  std::stringstream ss;
+  selection.print(ss);
+  ConfigSelection<false> from_csv(primclex);
+  from_csv.read(ss);
+  for(const auto &value : expected)
+    BOOST_CHECK_EQUAL(from_csv.selected(value.first), value.second);
+
+  // set_selection with criteria
+  Array<std::string> criteria;
+  criteria.push_back("on");
+  criteria.push_back("scel_size");
+  criteria.push_back("1");
+  criteria.push_back("eq");
+  set_selection(SelectionCriteria(criteria, primclex), selection);
+  for(auto it = selection.config_cbegin(); it != selection.config_cend(); ++it)
+    BOOST_CHECK_EQUAL(it.selected(), expected[it.name()] || it->get_supercell().volume() == 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,191 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/Configuration.hh"
+
+/// What is being used to test it:
+#include <cstdlib>
+#include <algorithm>
+#include <sstream>
+#include "casm/clex/ConfigIO.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+#include "TestPrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// Every configuration of 'primclex', in order
+  Array<const Configuration *> config_list(const PrimClex &primclex) {
+    Array<const Configuration *> result;
+    for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it)
+      result.push_back(&(*it));
+    return result;
+  }
+
+  /// Check the columns of 'corr' against the correlations of each configuration, found one at a time
+  void check_bulk(const Eigen::MatrixXd &corr, const Array<const Configuration *> &config, Clexulator &clexulator) {
+    BOOST_REQUIRE_EQUAL(corr.rows(), clexulator.corr_size());
+    BOOST_REQUIRE_EQUAL(corr.cols(), config.size());
+    for(Index i = 0; i < config.size(); i++) {
+      Correlation expected = correlations(*config[i], clexulator);
+      for(Index j = 0; j < expected.size(); j++)
+        BOOST_CHECK_SMALL(corr(j, i) - expected[j], 1e-12);
+    }
+  }
+
+  /// Check the correlations maintained by 'config' against a full recalculation
+  void check_incremental(const Configuration &config, Clexulator &clexulator) {
+    Correlation expected = correlations(config, clexulator);
+    BOOST_REQUIRE_EQUAL(config.get_correlations().size(), expected.size());
+    for(Index j = 0; j < expected.size(); j++)
+      BOOST_CHECK_SMALL(config.get_correlations()[j] - expected[j], 1e-10);
+  }
+
+  /// A Configuration of 'scel' with random occupants
+  Configuration random_config(Supercell &scel, MTRand &mtrand) {
+    Configuration config(scel);
+    Array<int> occ(scel.num_sites());
+    for(Index l = 0; l < occ.size(); l++)
+      occ[l] = mtrand.randInt(2);
+    config.set_occupation(occ);
+    return config;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(CorrelationsTest)
+
+BOOST_AUTO_TEST_CASE(BulkTest) {
+  test::TestPrimClex proj(4);
+  Clexulator clexulator = proj.clexulator();
+  Array<const Configuration *> config = config_list(proj.primclex());
+  BOOST_REQUIRE(config.size() > 0);
+
+  // the empty point cluster function is one for every configuration
+  Eigen::MatrixXd corr = correlations(config, clexulator);
+  check_bulk(corr, config, clexulator);
+  for(Index i = 0; i < config.size(); i++)
+    BOOST_CHECK_CLOSE(corr(0, i), 1.0, 1e-10);
+
+  // with more threads than configurations, in another order, and with repeats
+  const char *env = std::getenv("CASM_NUM_THREADS");
+  std::string prev = env ? env : "";
+  for(std::string threads : {"1", "3", "64"}) {
+    setenv("CASM_NUM_THREADS", threads.c_str(), 1);
+    Array<const Configuration *> subset;
+    for(Index i = config.size(); i > 0; i -= 7)
+      subset.push_back(config[i - 1]);
+    subset.push_back(config[0]);
+    subset.push_back(config[0]);
+    check_bulk(correlations(subset, clexulator), subset, clexulator);
+    check_bulk(correlations(config, clexulator), config, clexulator);
+  }
+  if(env)
+    setenv("CASM_NUM_THREADS", prev.c_str(), 1);
+  else
+    unsetenv("CASM_NUM_THREADS");
+
+  // no configurations
+  corr = correlations(Array<const Configuration *>(), clexulator);
+  BOOST_CHECK_EQUAL(corr.rows(), clexulator.corr_size());
+  BOOST_CHECK_EQUAL(corr.cols(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(FormatterTest) {
+  test::TestPrimClex proj(3);
+  PrimClex &primclex = proj.primclex();
+  Clexulator clexulator = proj.clexulator();
+  Array<const Configuration *> config = config_list(primclex);
+
+  // precomputing the correlations of some of the configurations does not change the output
+  Array<const Configuration *> subset;
+  for(Index i = 0; i < config.size(); i += 2)
+    subset.push_back(config[i]);
+
+  auto print = [&](const DataFormatter<Configuration> &formatter) {
+    std::stringstream ss;
+    ss << formatter(primclex.config_cbegin(), primclex.config_cend());
+    return ss.str();
+  };
+  DataFormatter<Configuration> formatter(ConfigIO::corr(clexulator));
+  DataFormatter<Configuration> bulk_formatter(ConfigIO::corr(clexulator, subset));
+  std::string expected = print(formatter);
+  BOOST_CHECK_EQUAL(print(bulk_formatter), expected);
+
+  // the precomputed correlations are printed, rather than evaluated again
+  Configuration &changed = *primclex.config_begin();
+  Array<int> occ(changed.size(), 1);
+  changed.set_occupation(occ);
+  BOOST_CHECK(print(formatter) != expected);
+  BOOST_CHECK_EQUAL(print(bulk_formatter), expected);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalTest) {
+  test::TestPrimClex proj(2);
+  PrimClex &primclex = proj.primclex();
+  Clexulator clexulator = proj.clexulator();
+  MTRand mtrand(47u);
+
+  // supercells larger than the neighborhood, where the changes are found locally, and the small
+  // supercells, where the correlations are found in full
+  Eigen::Matrix3i cube, sheared;
+  cube << 4, 0, 0, 0, 4, 0, 0, 0, 4;
+  sheared << 3, 1, 0, 0, 4, 1, 1, 0, 4;
+  primclex.add_supercell(make_supercell(primclex.get_prim().lattice(), cube));
+  primclex.add_supercell(make_supercell(primclex.get_prim().lattice(), sheared));
+  primclex.generate_supercell_nlists();
+
+  for(Index s = 0; s < primclex.get_supercell_list().size(); s++) {
+    Supercell &scel = primclex.get_supercell(s);
+    if(scel.volume() > 2) {
+      const Array<Index> &nlist = scel.get_nlist(0);
+      BOOST_REQUIRE_EQUAL(std::count(nlist.begin(), nlist.end(), Index(0)), 1);
+    }
+
+    // changing the occupation without a Clexulator clears the correlations
+    Configuration config = random_config(scel, mtrand);
+    config.set_correlations(clexulator);
+    config.set_occ(0, 2);
+    BOOST_CHECK_EQUAL(config.get_correlations().size(), 0);
+
+    // without correlations, they are found in full
+    config.set_occ(0, 1, clexulator);
+    check_incremental(config, clexulator);
+
+    // copies of 'clexulator' share its library, so they update the same correlations
+    Clexulator copy(clexulator);
+    BOOST_CHECK(copy.library() == clexulator.library());
+    config.set_occ(0, 0, copy);
+    check_incremental(config, clexulator);
+
+    // one site at a time, including changes to the current occupant
+    for(Index t = 0; t < 100; t++) {
+      config.set_occ(mtrand.randInt(scel.num_sites() - 1), mtrand.randInt(2), clexulator);
+      check_incremental(config, clexulator);
+    }
+
+    // batches of neighboring sites, with repeats
+    for(Index t = 0; t < 20; t++) {
+      Index l = mtrand.randInt(scel.num_sites() - 1);
+      const Array<Index> &nlist = scel.get_nlist(l);
+      Array<Index> sites;
+      Array<int> occ;
+      for(Index i = 0; i < 6; i++) {
+        sites.push_back(nlist[mtrand.randInt(nlist.size() - 1)]);
+        occ.push_back(mtrand.randInt(2));
+      }
+      sites.push_back(sites[0]);
+      occ.push_back((occ[0] + 1) % 3);
+      config.set_occ(sites, occ, clexulator);
+      for(Index i = 0; i < sites.size(); i++) {
+        if(std::find(sites.begin() + i + 1, sites.end(), sites[i]) == sites.end())
+          BOOST_CHECK_EQUAL(config.occ(sites[i]), occ[i]);
+      }
+      check_incremental(config, clexulator);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
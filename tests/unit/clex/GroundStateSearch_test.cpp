@@ -0,0 +1,188 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/GroundStateSearch.hh"
+
+/// What is being used to test it:
+#include <cstdlib>
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+#include "TestPrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  /// Random ECI for every basis function
+  ECIContainer random_eci(Index corr_size, MTRand &mtrand) {
+    fs::path eci_path = fs::temp_directory_path() / fs::unique_path("casm_unit_test_eci_%%%%-%%%%");
+    {
+      fs::ofstream file(eci_path);
+      for(int i = 0; i < 7; i++)
+        file << "header\n";
+      for(Index i = 0; i < corr_size; i++) {
+        double value = 0.2 * mtrand.rand() - 0.1;
+        file << value << " " << value << " " << i << "\n";
+      }
+    }
+    ECIContainer eci(eci_path);
+    fs::remove(eci_path);
+    return eci;
+  }
+
+  Array<Supercell *> supercell_list(PrimClex &primclex) {
+    Array<Supercell *> result;
+    for(Index s = 0; s < primclex.get_supercell_list().size(); s++)
+      result.push_back(&primclex.get_supercell(s));
+    return result;
+  }
+
+  /// The lower hull of all the enumerated configurations
+  LowerHull brute_force_hull(const PrimClex &primclex, const GroundStateSearch &search) {
+    Clexulator clexulator(search.clexulator);
+    std::vector<Eigen::VectorXd> comp;
+    std::vector<double> energy;
+    for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it) {
+      comp.push_back(it->get_param_composition());
+      energy.push_back(search.eci * correlations(*it, clexulator));
+    }
+    Eigen::MatrixXd comp_mat(comp[0].size(), comp.size());
+    for(Index i = 0; i < comp.size(); i++)
+      comp_mat.col(i) = comp[i];
+
+    LowerHull hull(search.tol);
+    BOOST_REQUIRE(hull.reset(comp_mat, Eigen::Map<Eigen::VectorXd>(energy.data(), energy.size())));
+    return hull;
+  }
+
+  /// The candidates have the composition and energy of their occupation
+  void check_candidates(const GroundStateHull &result, const GroundStateSearch &search) {
+    Clexulator clexulator(search.clexulator);
+    for(const GroundStateCandidate &candidate : result.candidates()) {
+      Configuration config(*candidate.scel);
+      config.set_occupation(candidate.occupation);
+      BOOST_CHECK(almost_equal(config.get_param_composition(), candidate.comp, 1e-10));
+      BOOST_CHECK_SMALL(search.eci * correlations(config, clexulator) - candidate.energy, 1e-10);
+    }
+  }
+
+  std::vector<std::pair<Supercell *, std::vector<int> > > occupations(const GroundStateHull &result) {
+    std::vector<std::pair<Supercell *, std::vector<int> > > occ;
+    for(const GroundStateCandidate &candidate : result.candidates())
+      occ.push_back(std::make_pair(candidate.scel, std::vector<int>(candidate.occupation.begin(), candidate.occupation.end())));
+    return occ;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(GroundStateSearchTest)
+
+BOOST_AUTO_TEST_CASE(GroundStateHullTest) {
+  // points along one composition axis, as (comp, energy)
+  std::vector<std::pair<double, double> > points = {
+    {0.5, 0.0}, {0.5, -0.1}, {0.5, 0.05}, {0.0, 0.0}, {1.0, 0.0}, {0.25, -0.02}, {0.75, -0.1}, {0.25, -0.08}
+  };
+
+  GroundStateHull hull;
+  auto candidate = [&](Index i) {
+    GroundStateCandidate result;
+    result.scel = nullptr;
+    result.occupation = Array<int>(1, int(i));
+    result.comp = Eigen::VectorXd::Constant(1, points[i].first);
+    result.energy = points[i].second;
+    return result;
+  };
+
+  // until there is a hull, only the lowest candidate at each composition is kept
+  BOOST_CHECK(hull.insert(candidate(0)));
+  BOOST_CHECK(hull.insert(candidate(1)));
+  BOOST_CHECK(!hull.insert(candidate(2)));
+  BOOST_CHECK_EQUAL(hull.size(), 1);
+  BOOST_CHECK_EQUAL(hull.candidates()[0].occupation[0], 1);
+  BOOST_CHECK(!hull.hull_found());
+
+  // then only the hull vertices
+  BOOST_CHECK(hull.insert(candidate(3)));
+  BOOST_CHECK(hull.insert(candidate(4)));
+  BOOST_CHECK(hull.hull_found());
+  BOOST_CHECK(!hull.is_candidate(candidate(5).comp, candidate(5).energy));
+  BOOST_CHECK(!hull.insert(candidate(5)));
+  BOOST_CHECK(hull.insert(candidate(6)));
+  BOOST_CHECK(hull.insert(candidate(7)));
+
+  std::vector<int> kept;
+  for(const GroundStateCandidate &c : hull.candidates())
+    kept.push_back(c.occupation[0]);
+  BOOST_CHECK(kept == std::vector<int>({1, 3, 4, 6, 7}));
+  BOOST_CHECK_EQUAL(hull.size(), 5);
+
+  // combining hulls
+  GroundStateHull other;
+  other.insert(hull);
+  BOOST_CHECK_EQUAL(other.size(), hull.size());
+}
+
+BOOST_AUTO_TEST_CASE(ExhaustiveTest) {
+  test::TestPrimClex proj(4);
+  PrimClex &primclex = proj.primclex();
+  MTRand mtrand(53u);
+
+  GroundStateSearch search;
+  search.clexulator = proj.clexulator();
+  search.eci = random_eci(search.clexulator.corr_size(), mtrand);
+  LowerHull expected = brute_force_hull(primclex, search);
+
+  // the same hull as all the enumerated configurations, whatever the number of threads
+  const char *env = std::getenv("CASM_NUM_THREADS");
+  std::string prev = env ? env : "";
+  std::vector<GroundStateHull> results;
+  for(std::string threads : {"1", "3"}) {
+    setenv("CASM_NUM_THREADS", threads.c_str(), 1);
+    results.push_back(search_ground_states(supercell_list(primclex), search));
+  }
+  if(env)
+    setenv("CASM_NUM_THREADS", prev.c_str(), 1);
+  else
+    unsetenv("CASM_NUM_THREADS");
+  BOOST_CHECK(occupations(results[0]) == occupations(results[1]));
+
+  const GroundStateHull &result = results[0];
+  BOOST_REQUIRE(result.hull_found());
+  check_candidates(result, search);
+
+  // the hulls are equal, though points within the tolerance of a facet may be vertices of either one
+  BOOST_CHECK(result.size() > 2);
+  for(const GroundStateCandidate &candidate : result.candidates())
+    BOOST_CHECK_SMALL(expected.dist_to_hull(candidate.comp, candidate.energy), 1e-8);
+  for(Index i : expected.vertices())
+    BOOST_CHECK_SMALL(result.hull().dist_to_hull(expected.comp(i), expected.energy(i)), 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(AnnealTest) {
+  test::TestPrimClex proj(4);
+  PrimClex &primclex = proj.primclex();
+  MTRand mtrand(59u);
+
+  GroundStateSearch search;
+  search.clexulator = proj.clexulator();
+  search.eci = random_eci(search.clexulator.corr_size(), mtrand);
+  search.anneal = true;
+  search.runs = 10;
+  search.sweeps = 20;
+  search.seed = 7;
+  LowerHull expected = brute_force_hull(primclex, search);
+
+  // annealing finds occupations on or above the hull, reproducibly for a given seed
+  GroundStateHull result = search_ground_states(supercell_list(primclex), search);
+  BOOST_CHECK(result.size() > 0);
+  check_candidates(result, search);
+  for(const GroundStateCandidate &candidate : result.candidates())
+    BOOST_CHECK(expected.dist_to_hull(candidate.comp, candidate.energy) > -1e-8);
+
+  BOOST_CHECK(occupations(search_ground_states(supercell_list(primclex), search)) == occupations(result));
+  search.seed = 8;
+  GroundStateHull other = search_ground_states(supercell_list(primclex), search);
+  check_candidates(other, search);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,195 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ParamComposition.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+namespace {
+
+  /// Write a PRIM with one site per entry of 'occupants', and read it back
+  Structure make_prim(const std::vector<std::string> &occupants) {
+    fs::path prim_path = fs::temp_directory_path() / fs::unique_path("casm_unit_test_PRIM_%%%%-%%%%");
+    {
+      fs::ofstream file(prim_path);
+      file << "test prim\n1.0\n4.0 0.0 0.0\n0.0 4.0 0.0\n0.0 0.0 4.0\n" << occupants.size() << "\nD\n";
+      for(Index i = 0; i < occupants.size(); i++)
+        file << 0.5 * (i % 2) << " " << 0.5 * ((i / 2) % 2) << " " << 0.5 * (i / 4) << " " << occupants[i] << "\n";
+    }
+    Structure prim(prim_path);
+    fs::remove(prim_path);
+    return prim;
+  }
+
+  ParamComposition make_param_comp(const Structure &prim) {
+    ParamComposition param_comp(prim);
+    param_comp.generate_components();
+    param_comp.generate_sublattice_map();
+    param_comp.generate_prim_end_members();
+    return param_comp;
+  }
+
+  /// The composition axes found by trying every set of rank-1 spanning end members for each origin,
+  /// after generate_composition_space has set the rank
+  Array<ParamComposition> exhaustive_composition_space(ParamComposition &param_comp) {
+    const Eigen::MatrixXd &end_members = param_comp.get_prim_end_members();
+    Index N_end = end_members.rows();
+    Index rank = param_comp.get_rank_of_space();
+
+    Array<ParamComposition> result;
+    for(Index i = 0; i < N_end; i++) {
+      Eigen::VectorXd torigin = end_members.row(i).transpose();
+      Array<int> binary_choose(N_end - 1, 0);
+      for(Index j = 0; j + 1 < rank; j++)
+        binary_choose[binary_choose.size() - 1 - j] = 1;
+
+      do {
+        Array<Eigen::VectorXd> tspanning;
+        for(Index j = 0, c = 0; j < N_end; j++) {
+          if(j == i)
+            continue;
+          if(binary_choose[c++])
+            tspanning.push_back(end_members.row(j).transpose() - torigin);
+        }
+
+        ParamComposition tcomp = param_comp.calc_composition_object(torigin, tspanning);
+        bool is_positive = true;
+        for(Index j = 0; j < N_end && is_positive; j++) {
+          Eigen::VectorXd test_comp = tcomp.calc(end_members.row(j), NUMBER_ATOMS);
+          for(EigenIndex k = 0; k < test_comp.size(); k++) {
+            if((test_comp(k) < 0 && !almost_zero(test_comp(k))) || std::isnan(test_comp(k)))
+              is_positive = false;
+          }
+        }
+        if(is_positive)
+          result.push_back(tcomp);
+      }
+      while(binary_choose.next_permute());
+    }
+    return result;
+  }
+
+  /// Check that generate_composition_space finds the same axes, in the same order, as the exhaustive search
+  void check_composition_space(const Structure &prim) {
+    ParamComposition param_comp = make_param_comp(prim);
+    param_comp.generate_composition_space();
+    const Array<ParamComposition> &result = param_comp.get_allowed_list();
+    Array<ParamComposition> expected = exhaustive_composition_space(param_comp);
+
+    BOOST_CHECK(expected.size() > 0);
+    BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+    for(Index i = 0; i < result.size(); i++) {
+      BOOST_CHECK(almost_equal(result[i].get_origin(), expected[i].get_origin()));
+      BOOST_REQUIRE_EQUAL(result[i].get_spanning_end_members().size(), expected[i].get_spanning_end_members().size());
+      for(Index j = 0; j < result[i].get_spanning_end_members().size(); j++)
+        BOOST_CHECK(almost_equal(result[i].get_spanning_end_members()[j], expected[i].get_spanning_end_members()[j]));
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ParamCompositionTest)
+
+BOOST_AUTO_TEST_CASE(NonnegativeCombinationTest) {
+  using ParamComposition_impl::is_nonnegative_combination;
+  MTRand mtrand(37u);
+
+  // no generators: only the zero vector
+  BOOST_CHECK(is_nonnegative_combination(Eigen::MatrixXd(3, 0), Eigen::VectorXd::Zero(3)));
+  BOOST_CHECK(!is_nonnegative_combination(Eigen::MatrixXd(3, 0), Eigen::VectorXd::Ones(3)));
+
+  for(Index t = 0; t < 50; t++) {
+    Index dim = 2 + mtrand.randInt(3);
+    Index N = 1 + mtrand.randInt(6);
+
+    // generators with a positive first coordinate, so that the cone is pointed
+    Eigen::MatrixXd generators(dim, N);
+    for(Index j = 0; j < N; j++) {
+      generators(0, j) = 0.5 + mtrand.rand();
+      for(Index k = 1; k < dim; k++)
+        generators(k, j) = 2.0 * mtrand.rand() - 1.0;
+    }
+
+    // nonnegative combinations, including ones with zero coefficients
+    Eigen::VectorXd x(N);
+    for(Index j = 0; j < N; j++)
+      x(j) = mtrand.randInt(2) ? mtrand.rand() : 0.0;
+    BOOST_CHECK(is_nonnegative_combination(generators, generators * x));
+
+    // the negative of a nonzero combination lies outside the cone, as does a vector leaving the span
+    x(mtrand.randInt(N - 1)) = 1.0;
+    BOOST_CHECK(!is_nonnegative_combination(generators, -generators * x));
+    if(N < dim) {
+      Eigen::FullPivHouseholderQR<Eigen::MatrixXd> qr(generators);
+      Eigen::MatrixXd Q = qr.matrixQ();
+      BOOST_CHECK(!is_nonnegative_combination(generators, generators * x + Q.col(dim - 1)));
+    }
+  }
+
+  // in the span, but needing a negative coefficient
+  Eigen::MatrixXd generators(2, 2);
+  generators << 1, 1,
+             0, 1;
+  BOOST_CHECK(is_nonnegative_combination(generators, Eigen::Vector2d(2.0, 1.0)));
+  BOOST_CHECK(!is_nonnegative_combination(generators, Eigen::Vector2d(0.0, 1.0)));
+  BOOST_CHECK(!is_nonnegative_combination(generators, Eigen::Vector2d(1.0, -0.5)));
+}
+
+BOOST_AUTO_TEST_CASE(RedundantDirectionTest) {
+  using ParamComposition_impl::is_redundant_direction;
+
+  // the diagonal of a square is redundant, the edges are not
+  Eigen::MatrixXd directions(2, 3);
+  directions << 1, 0, 1,
+             0, 1, 1;
+  BOOST_CHECK(!is_redundant_direction(directions, 0));
+  BOOST_CHECK(!is_redundant_direction(directions, 1));
+  BOOST_CHECK(is_redundant_direction(directions, 2));
+
+  // positive multiples along an edge do not make each other redundant
+  directions << 1, 2, 0,
+             0, 0, 1;
+  for(EigenIndex j = 0; j < 3; j++)
+    BOOST_CHECK(!is_redundant_direction(directions, j));
+
+  // the partial sets found agree with checking each full set
+  directions.resize(3, 4);
+  directions << 1, 0, 0, 1,
+             0, 1, 0, 1,
+             0, 0, 1, -1;
+  Array<Index> chosen;
+  Array< Array<Index> > spanning_sets;
+  ParamComposition_impl::search_spanning_sets(directions, 2, 0, chosen, spanning_sets);
+  Array<int> binary_choose(4, 0);
+  binary_choose[2] = binary_choose[3] = 1;
+  Index s = 0;
+  do {
+    Array<Index> set;
+    for(Index j = 0; j < 4; j++) {
+      if(binary_choose[j])
+        set.push_back(j);
+    }
+    if(ParamComposition_impl::is_positive_in_span(directions, set)) {
+      BOOST_REQUIRE(s < spanning_sets.size());
+      BOOST_CHECK(spanning_sets[s++] == set);
+    }
+  }
+  while(binary_choose.next_permute());
+  BOOST_CHECK_EQUAL(s, spanning_sets.size());
+}
+
+BOOST_AUTO_TEST_CASE(CompositionSpaceTest) {
+  // one and several sublattices, with and without vacancies
+  check_composition_space(Structure(fs::path("tests/unit/crystallography/PRIM1")));
+  check_composition_space(Structure(fs::path("tests/unit/crystallography/PRIM2")));
+  check_composition_space(make_prim({"A B", "B C Va"}));
+  check_composition_space(make_prim({"A B C", "A B", "C Va"}));
+  check_composition_space(make_prim({"A B C D", "A Va", "B Va", "C D"}));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
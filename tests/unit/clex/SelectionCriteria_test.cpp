@@ -0,0 +1,126 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/ConfigSelection.hh"
+
+/// What is being used to test it:
+#include "TestPrimClex.hh"
+
+using namespace CASM;
+
+namespace {
+
+  SelectionCriteria make_criteria(const std::vector<std::string> &criteria, const PrimClex &primclex) {
+    Array<std::string> result;
+    for(const std::string &q : criteria)
+      result.push_back(q);
+    return SelectionCriteria(result, primclex);
+  }
+
+  /// Check that 'criteria' sets each configuration selected when 'expected' is true, and leaves it unchanged otherwise
+  template<typename ExpectedFunction>
+  void check_criteria(const std::vector<std::string> &criteria, PrimClex &primclex, ExpectedFunction expected) {
+    SelectionCriteria compiled = make_criteria(criteria, primclex);
+    for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it) {
+      bool result;
+      BOOST_CHECK(compiled.evaluate(*it, false, result));
+      BOOST_CHECK_EQUAL(result, expected(*it));
+      BOOST_CHECK(compiled.evaluate(*it, true, result));
+      BOOST_CHECK_EQUAL(result, true);
+      BOOST_CHECK_EQUAL(compiled(*it, false), expected(*it));
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(SelectionCriteriaTest)
+
+BOOST_AUTO_TEST_CASE(VariablesTest) {
+  test::TestPrimClex proj(3);
+  PrimClex &primclex = proj.primclex();
+  BOOST_REQUIRE(primclex.config_cbegin() != primclex.config_cend());
+
+  check_criteria({"on", "scel_size", "2", "eq"}, primclex, [](const Configuration & config) {
+    return config.get_supercell().volume() == 2;
+  });
+
+  check_criteria({"on", "scelname", "SCEL3_.*", "re"}, primclex, [](const Configuration & config) {
+    return config.get_supercell().volume() == 3;
+  });
+
+  check_criteria({"on", "configname", "/1$", "rs"}, primclex, [](const Configuration & config) {
+    return config.name().substr(config.name().size() - 2) == "/1";
+  });
+
+  std::string name = primclex.config_cbegin()->name();
+  check_criteria({"on", "configname", name, "ne", "NOT"}, primclex, [&](const Configuration & config) {
+    return config.name() == name;
+  });
+
+  check_criteria({"on", "comp(a)", "0.4", "gt", "comp(b)", "0.4", "lt", "AND"}, primclex, [](const Configuration & config) {
+    return config.get_param_composition()[0] > 0.4 && config.get_param_composition()[1] < 0.4;
+  });
+
+  // site and atom fractions are the same without vacancies
+  check_criteria({"on", "site_frac(B)", "atom_frac(C)", "add", "0.5", "ge", "scel_size", "1", "eq", "OR"}, primclex,
+  [](const Configuration & config) {
+    return config.get_composition()[1] + config.get_composition()[2] >= 0.5 || config.get_supercell().volume() == 1;
+  });
+
+  check_criteria({"on", "comp(a)", "2", "pow", "comp(b)", "2", "mult", "sub", "0.0", "le"}, primclex, [](const Configuration & config) {
+    Eigen::VectorXd comp = config.get_param_composition();
+    return comp[0] * comp[0] <= 2.0 * comp[1] + 1e-9;
+  });
+
+  // empty criteria select everything, "off" unselects
+  check_criteria({"on"}, primclex, [](const Configuration & config) {
+    return true;
+  });
+  SelectionCriteria off = make_criteria({"off", "scel_size", "1", "eq"}, primclex);
+  for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it) {
+    BOOST_CHECK_EQUAL(off(*it, true), it->get_supercell().volume() != 1);
+    BOOST_CHECK_EQUAL(off(*it, false), false);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(EvaluateTest) {
+  test::TestPrimClex proj(2);
+  PrimClex &primclex = proj.primclex();
+  const Configuration &config = *primclex.config_cbegin();
+
+  // properties that are not known, and values that are not "0" or "1", are not selection states
+  bool result = true;
+  BOOST_CHECK(!make_criteria({"on", "is_groundstate"}, primclex).evaluate(config, false, result));
+  BOOST_CHECK(!make_criteria({"on", "comp(a)", "1", "add"}, primclex).evaluate(config, false, result));
+  BOOST_CHECK(make_criteria({"on", "is_groundstate", "unknown", "eq"}, primclex).evaluate(config, false, result));
+  BOOST_CHECK_EQUAL(result, true);
+
+  // unknown compositions and molecules are errors
+  BOOST_CHECK_THROW(make_criteria({"on", "comp(c)", "0", "eq"}, primclex), std::runtime_error);
+  BOOST_CHECK_THROW(make_criteria({"on", "atom_frac(Va)", "0", "eq"}, primclex), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ParallelTest) {
+  test::TestPrimClex proj(4);
+  PrimClex &primclex = proj.primclex();
+
+  Array<const Configuration *> config;
+  Array<bool> is_selected;
+  for(auto it = primclex.config_cbegin(); it != primclex.config_cend(); ++it) {
+    config.push_back(&*it);
+    is_selected.push_back(config.size() % 3 == 0);
+  }
+  BOOST_REQUIRE(config.size() > 100);
+
+  // the parallel evaluation agrees with evaluating each configuration in order
+  SelectionCriteria criteria = make_criteria({"off", "comp(a)", "comp(b)", "sub", "0.1", "gt", "scelname", "SCEL4_.*", "re", "AND"}, primclex);
+  Array<bool> expected(is_selected);
+  for(Index i = 0; i < config.size(); i++)
+    expected[i] = criteria(*config[i], is_selected[i]);
+
+  get_selection(criteria, config, is_selected);
+  BOOST_CHECK(is_selected == expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,101 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clex/PrimClex.hh"
+
+/// What is being used to test it:
+#include "casm/system/Parallel.hh"
+
+using namespace CASM;
+
+namespace {
+
+  Matrix3<int> make_transf_mat(int a, int b, int c, int d) {
+    Eigen::Matrix3i T;
+    T << a, b, 0,
+    0, c, d,
+    0, 0, 1;
+    return Matrix3<int>(T);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(SupercellSymInfoTest)
+
+BOOST_AUTO_TEST_CASE(SharingTest) {
+  PrimClex primclex(Structure(fs::path("tests/unit/crystallography/PRIM1")));
+  primclex.generate_supercells(1, 4, false);
+
+  for(Index s = 0; s < primclex.get_supercell_list().size(); s++) {
+    const Supercell &scel = primclex.get_supercell(s);
+    std::shared_ptr<SupercellSymInfo> sym_info = primclex.supercell_sym_info(scel.get_transf_mat());
+    BOOST_CHECK(primclex.supercell_sym_info(scel.get_transf_mat()) == sym_info);
+
+    // a temporary Supercell with the same transformation matrix uses the same symmetry data, and
+    // leaves it in place for the Supercells that remain
+    Index symrep_ID;
+    {
+      Supercell tmp(&primclex, scel.get_real_super_lattice());
+      symrep_ID = tmp.permutation_symrep_ID();
+      BOOST_CHECK(&tmp.factor_group() == &sym_info->factor_group);
+      BOOST_CHECK_EQUAL(symrep_ID, sym_info->perm_symrep_ID);
+      BOOST_CHECK_EQUAL(scel.permutation_symrep_ID(), symrep_ID);
+      BOOST_CHECK(&scel.factor_group() == &tmp.factor_group());
+    }
+    BOOST_CHECK(primclex.get_prim().factor_group().representation(symrep_ID) != NULL);
+    for(Index i = 0; i < scel.factor_group().size(); i++)
+      BOOST_CHECK(scel.factor_group_permute(i).perm_array().size() == scel.num_sites());
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ExpiryTest) {
+  PrimClex primclex(Structure(fs::path("tests/unit/crystallography/PRIM1")));
+
+  // when the last Supercell using it is destroyed, the symmetry data, and its permutation
+  // representation, are released
+  Matrix3<int> T = make_transf_mat(2, 1, 3, 1);
+  std::weak_ptr<SupercellSymInfo> weak;
+  Index symrep_ID;
+  {
+    Supercell tmp(&primclex, T);
+    symrep_ID = tmp.permutation_symrep_ID();
+    weak = primclex.supercell_sym_info(T);
+    BOOST_CHECK(primclex.get_prim().factor_group().representation(symrep_ID) != NULL);
+  }
+  BOOST_CHECK(weak.expired());
+  BOOST_CHECK(primclex.get_prim().factor_group().representation(symrep_ID) == NULL);
+
+  // and are generated again when needed
+  std::shared_ptr<SupercellSymInfo> sym_info = primclex.supercell_sym_info(T);
+  BOOST_CHECK_EQUAL(sym_info->perm_symrep_ID, Index(-1));
+  BOOST_CHECK_EQUAL(sym_info->factor_group.size(), 0);
+  Supercell tmp(&primclex, T);
+  BOOST_CHECK(&tmp.factor_group() == &sym_info->factor_group);
+  BOOST_CHECK(tmp.factor_group().size() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(ThreadTest) {
+  PrimClex primclex(Structure(fs::path("tests/unit/crystallography/PRIM1")));
+
+  // concurrent lookups of held transformation matrices find the held symmetry data, while lookups of
+  // other transformation matrices create and release entries
+  std::vector<std::shared_ptr<SupercellSymInfo> > held;
+  for(int a = 1; a <= 3; a++)
+    held.push_back(primclex.supercell_sym_info(make_transf_mat(a, 0, 1, 0)));
+
+  Index N = 20000;
+  std::vector<std::shared_ptr<SupercellSymInfo> > found(N);
+  std::vector<char> other_found(N, 0);
+  parallel_for(0, N, [&](Index i) {
+    found[i] = primclex.supercell_sym_info(make_transf_mat(i % 3 + 1, 0, 1, 0));
+    other_found[i] = primclex.supercell_sym_info(make_transf_mat(4, i % 13, 2, i % 11)) != nullptr;
+  }, 4);
+
+  for(Index i = 0; i < N; i++) {
+    BOOST_CHECK(found[i] == held[i % 3]);
+    BOOST_CHECK(other_found[i]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,135 @@
+#ifndef CASM_TestPrimClex_HH
+#define CASM_TestPrimClex_HH
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "casm/clex/PrimClex.hh"
+#include "casm/clex/ConfigIterator.hh"
+#include "casm/clex/Clexulator.hh"
+#include "casm/clex/CompositionConverter.hh"
+#include "casm/clusterography/jsonClust.hh"
+
+namespace CASM {
+
+  namespace test {
+
+    namespace fs = boost::filesystem;
+
+    /// \brief Occupation basis functions, with pairs out to 3rd nearest neighbors and nearest neighbor triplets
+    inline jsonParser FCC_ternary_bspecs() {
+      jsonParser bspecs;
+      bspecs["basis_functions"]["site_basis_functions"] = "occupation";
+      bspecs["orbit_branch_specs"]["2"]["max_length"] = 4.01;
+      bspecs["orbit_branch_specs"]["3"]["max_length"] = 3.01;
+      return bspecs;
+    }
+
+    /// \brief An in-memory PrimClex for the FCC ternary prim in "tests/unit/crystallography/PRIM1"
+    ///
+    /// - Composition axes: origin "A", end members "B" and "C"
+    /// - Supercells of volume 1 to 'max_vol', and all of their occupation configurations
+    /// - Files written by the PrimClex, and the Clexulator, go in a temporary directory, which is
+    ///   removed on destruction
+    ///
+    /// Must be constructed with the source root as the current working directory, like the other
+    /// unit tests.
+    class TestPrimClex {
+
+    public:
+
+      explicit TestPrimClex(int max_vol) :
+        m_prim(fs::path("tests/unit/crystallography/PRIM1")),
+        m_dir(fs::temp_directory_path() / fs::unique_path("casm_unit_test_%%%%-%%%%-%%%%")) {
+
+        fs::create_directories(m_dir);
+        m_cwd = fs::current_path();
+        fs::current_path(m_dir);
+
+        m_primclex.reset(new PrimClex(m_prim));
+
+        // set the composition axes before there are any configurations, which would need references
+        std::vector<std::string> components = {"A", "B", "C"};
+        Eigen::VectorXd origin(3);
+        origin << 1.0, 0.0, 0.0;
+        Eigen::MatrixXd end_members(3, 2);
+        end_members << 0.0, 0.0,
+                    1.0, 0.0,
+                    0.0, 1.0;
+        m_primclex->set_composition_axes(CompositionConverter(components.begin(), components.end(), origin, end_members));
+
+        m_primclex->generate_supercells(1, max_vol, false);
+        m_primclex->enumerate_all_configurations();
+
+        fs::current_path(m_cwd);
+      }
+
+      ~TestPrimClex() {
+        // destroy the PrimClex, and the Clexulator libraries, before removing the files
+        m_clexulator = Clexulator();
+        m_primclex.reset();
+        boost::system::error_code ec;
+        fs::remove_all(m_dir, ec);
+      }
+
+      PrimClex &primclex() {
+        return *m_primclex;
+      }
+
+      /// \brief A copy of the Clexulator for FCC_ternary_bspecs()
+      ///
+      /// - The first call generates the basis set, sets the PrimClex and Supercell neighbor lists,
+      ///   and compiles the Clexulator, as 'casm bset' and 'casm corr' do
+      Clexulator clexulator() {
+        if(!m_clexulator.initialized())
+          _make_clexulator();
+        return m_clexulator;
+      }
+
+    private:
+
+      void _make_clexulator() {
+        std::string name = "test_FCC_ternary_Clexulator";
+
+        Structure prim(m_prim);
+        jsonParser bspecs = FCC_ternary_bspecs();
+        prim.fill_occupant_bases(bspecs["basis_functions"]["site_basis_functions"].get<std::string>()[0]);
+        SiteOrbitree tree = make_orbitree(prim, bspecs);
+        tree.collect_basis_info(prim);
+        tree.generate_clust_bases();
+
+        jsonParser clust_json;
+        to_json(jsonHelper(tree, prim), clust_json).write(m_dir / "clust.json");
+
+        Array<UnitCellCoord> nlist;
+        expand_nlist(prim, tree, nlist);
+
+        fs::ofstream outfile(m_dir / (name + ".cc"));
+        print_clexulator(prim, tree, nlist, name, outfile);
+        outfile.close();
+
+        m_primclex->read_global_orbitree(m_dir / "clust.json");
+        m_primclex->generate_full_nlist();
+        m_primclex->generate_supercell_nlists();
+
+        m_clexulator = Clexulator(name,
+                                  m_dir,
+                                  RuntimeLibrary::default_compile_options() + " --std=c++11 -I" + fs::absolute("include").string(),
+                                  RuntimeLibrary::default_so_options() + " -lboost_filesystem -lboost_system");
+      }
+
+      Structure m_prim;
+      fs::path m_dir;
+      fs::path m_cwd;
+      std::unique_ptr<PrimClex> m_primclex;
+      Clexulator m_clexulator;
+
+    };
+
+  }
+}
+
+#endif
@@ -0,0 +1,103 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/clusterography/ClusterKey.hh"
+
+/// What is being used to test it:
+#include "casm/crystallography/Structure.hh"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(ClusterKeyTest)
+
+BOOST_AUTO_TEST_CASE(CanonicalizeTest) {
+  ClusterKey A, B, C;
+  A.push_back(0, Vector3<int>(0, 0, 0));
+  A.push_back(2, Vector3<int>(1, 0, -1));
+  A.push_back(1, Vector3<int>(0, 1, 0));
+
+  // the same sites, translated by (2,-3,1), in a different order
+  B.push_back(1, Vector3<int>(2, -2, 1));
+  B.push_back(0, Vector3<int>(2, -3, 1));
+  B.push_back(2, Vector3<int>(3, -3, 0));
+
+  // a different cluster
+  C.push_back(0, Vector3<int>(0, 0, 0));
+  C.push_back(2, Vector3<int>(1, 0, 0));
+  C.push_back(1, Vector3<int>(0, 1, 0));
+
+  BOOST_CHECK_EQUAL(A.size(), 3);
+
+  // local clusters are only sorted
+  ClusterKey A_local(A), B_local(B);
+  A_local.canonicalize(false);
+  B_local.canonicalize(false);
+  BOOST_CHECK(!(A_local == B_local));
+
+  A.canonicalize(true);
+  B.canonicalize(true);
+  C.canonicalize(true);
+  BOOST_CHECK(A == B);
+  BOOST_CHECK_EQUAL(A.hash(), B.hash());
+  BOOST_CHECK(!(A == C));
+  BOOST_CHECK((A < C) != (C < A));
+
+  // canonicalize is idempotent
+  ClusterKey A2(A);
+  A2.canonicalize(true);
+  BOOST_CHECK(A2 == A);
+
+  ClusterKeySet set;
+  set.insert(A);
+  set.insert(B);
+  set.insert(C);
+  BOOST_CHECK_EQUAL(set.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(KeyMakerTest) {
+  Structure prim(fs::path("tests/unit/crystallography/PRIM2"));
+  ClusterKeyMaker maker(prim.basis, prim.lattice());
+  BOOST_CHECK_EQUAL(maker.size(), prim.basis.size());
+
+  // every lattice translation of every basis site is found
+  Index b;
+  Vector3<int> ijk;
+  for(Index tb = 0; tb < prim.basis.size(); tb++) {
+    Vector3<int> tijk(1, -2, 3);
+    Coordinate site(maker.cart(tb, tijk), prim.lattice(), CART);
+    BOOST_CHECK(maker.find(site, b, ijk));
+    BOOST_CHECK_EQUAL(b, tb);
+    BOOST_CHECK(ijk == tijk);
+    BOOST_CHECK(site(FRAC).is_equal(maker.basis_frac(b) + Vector3<double>(1.0, -2.0, 3.0), 1e-8));
+  }
+  BOOST_CHECK(!maker.find(Coordinate(Vector3<double>(0.1, 0.2, 0.3), prim.lattice(), FRAC), b, ijk));
+
+  // clusters related by a lattice translation have the same key
+  Array<Coordinate> clust, translated, other;
+  clust.push_back(Coordinate(maker.cart(0, Vector3<int>(0, 0, 0)), prim.lattice(), CART));
+  clust.push_back(Coordinate(maker.cart(3, Vector3<int>(0, 1, 0)), prim.lattice(), CART));
+  for(Index i = clust.size(); i > 0; i--) {
+    Coordinate tcoord(clust[i - 1]);
+    tcoord(FRAC) += Vector3<double>(-1.0, 2.0, 5.0);
+    translated.push_back(tcoord);
+  }
+  other.push_back(clust[0]);
+  other.push_back(Coordinate(maker.cart(3, Vector3<int>(1, 1, 0)), prim.lattice(), CART));
+
+  ClusterKey key, tkey, okey;
+  BOOST_CHECK(maker.make_key(clust, key, true));
+  BOOST_CHECK(maker.make_key(translated, tkey, true));
+  BOOST_CHECK(maker.make_key(other, okey, true));
+  BOOST_CHECK(key == tkey);
+  BOOST_CHECK(!(key == okey));
+
+  BOOST_CHECK(maker.make_key(clust, key, false));
+  BOOST_CHECK(maker.make_key(translated, tkey, false));
+  BOOST_CHECK(!(key == tkey));
+
+  other.push_back(Coordinate(Vector3<double>(0.1, 0.2, 0.3), prim.lattice(), FRAC));
+  BOOST_CHECK(!maker.make_key(other, okey, true));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
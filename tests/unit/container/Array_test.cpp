@@ -0,0 +1,223 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/container/Array.hh"
+
+/// What is being used to test it:
+#include <string>
+#include <vector>
+
+using namespace CASM;
+
+namespace {
+
+  /// Counts the copies, moves and live objects of an element type that is not trivially copyable
+  struct Tracked {
+    static int live;
+    static int copies;
+    static int moves;
+
+    static void reset_counts() {
+      copies = 0;
+      moves = 0;
+    }
+
+    std::string value;
+
+    Tracked(const std::string &_value = "") : value(_value) {
+      live++;
+    }
+
+    Tracked(const std::string &_prefix, int _n) : value(_prefix + std::to_string(_n)) {
+      live++;
+    }
+
+    Tracked(const Tracked &RHS) : value(RHS.value) {
+      live++;
+      copies++;
+    }
+
+    Tracked(Tracked &&RHS) : value(std::move(RHS.value)) {
+      live++;
+      moves++;
+    }
+
+    Tracked &operator=(const Tracked &RHS) {
+      value = RHS.value;
+      copies++;
+      return *this;
+    }
+
+    Tracked &operator=(Tracked &&RHS) {
+      value = std::move(RHS.value);
+      moves++;
+      return *this;
+    }
+
+    ~Tracked() {
+      live--;
+    }
+
+    bool operator==(const Tracked &RHS) const {
+      return value == RHS.value;
+    }
+  };
+
+  int Tracked::live = 0;
+  int Tracked::copies = 0;
+  int Tracked::moves = 0;
+
+  /// A trivially copyable element type, which uses the memcpy paths
+  struct Pod {
+    int i;
+    double d;
+
+    bool operator==(const Pod &RHS) const {
+      return i == RHS.i && d == RHS.d;
+    }
+  };
+
+  template<typename T>
+  bool same(const Array<T> &A, const std::vector<T> &B) {
+    if(A.size() != B.size())
+      return false;
+    for(Index i = 0; i < A.size(); i++) {
+      if(!(A[i] == B[i]))
+        return false;
+    }
+    return true;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(ArrayTest)
+
+BOOST_AUTO_TEST_CASE(TrivialTest) {
+  static_assert(std::is_trivially_copyable<Pod>::value, "Pod must be trivially copyable");
+
+  // every mutator agrees with std::vector
+  Array<Pod> A;
+  std::vector<Pod> B;
+  for(int i = 0; i < 1000; i++) {
+    A.push_back(Pod({i, 0.5 * i}));
+    B.push_back(Pod({i, 0.5 * i}));
+  }
+  BOOST_CHECK(same(A, B));
+
+  A.remove(10);
+  B.erase(B.begin() + 10);
+  A.pop_back();
+  B.pop_back();
+  BOOST_CHECK(same(A, B));
+
+  A.reserve(5000);
+  BOOST_CHECK(same(A, B));
+
+  Array<Pod> C(A);
+  BOOST_CHECK(C == A);
+  C.append(A);
+  B.insert(B.end(), B.begin(), B.end());
+  BOOST_CHECK(same(C, B));
+
+  // assignment to an Array with less, and with more, capacity
+  Array<Pod> small(2, Pod({-1, -1.0}));
+  small = C;
+  BOOST_CHECK(small == C);
+  C = A;
+  BOOST_CHECK(C == A);
+
+  Array<int> ints(3, 7);
+  ints.resize(5, 1);
+  BOOST_CHECK_EQUAL(ints.size(), 5);
+  BOOST_CHECK_EQUAL(ints[4], 1);
+  ints.resize(0);
+  BOOST_CHECK_EQUAL(ints.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(MoveTest) {
+  Tracked::live = 0;
+  {
+    Array<Tracked> A;
+
+    // rvalues are moved in, and growth moves, rather than copies, the existing elements
+    Tracked::reset_counts();
+    for(int i = 0; i < 100; i++)
+      A.push_back(Tracked("a", i));
+    for(int i = 0; i < 100; i++)
+      A.emplace_back("b", i);
+    BOOST_CHECK_EQUAL(Tracked::copies, 0);
+    BOOST_CHECK_EQUAL(A.size(), 200);
+    BOOST_CHECK_EQUAL(A[99].value, "a99");
+    BOOST_CHECK_EQUAL(A[199].value, "b99");
+
+    // growing by 1.5x relocates each element about twice, on average
+    BOOST_CHECK(Tracked::moves < 100 + 3 * 200);
+
+    // moving an Array transfers the storage
+    Tracked::reset_counts();
+    const Tracked *data = A.begin();
+    Array<Tracked> B(std::move(A));
+    BOOST_CHECK_EQUAL(B.begin(), data);
+    BOOST_CHECK_EQUAL(A.size(), 0);
+    BOOST_CHECK_EQUAL(Tracked::copies + Tracked::moves, 0);
+
+    // the elements of the target are destroyed
+    Array<Tracked> C(3, Tracked("c"));
+    C = std::move(B);
+    BOOST_CHECK_EQUAL(C.begin(), data);
+    BOOST_CHECK_EQUAL(C.size(), 200);
+    BOOST_CHECK_EQUAL(B.size(), 0);
+    BOOST_CHECK_EQUAL(Tracked::live, 200);
+
+    // a moved-from Array is usable
+    B.push_back(Tracked("d"));
+    BOOST_CHECK_EQUAL(B.size(), 1);
+
+    // copies copy each element once
+    Tracked::reset_counts();
+    Array<Tracked> D(C);
+    BOOST_CHECK_EQUAL(Tracked::copies, 200);
+    BOOST_CHECK(D == C);
+
+    // removal moves the following elements down
+    Tracked::reset_counts();
+    D.remove(0);
+    BOOST_CHECK_EQUAL(Tracked::copies, 0);
+    BOOST_CHECK_EQUAL(D[0].value, "a1");
+    BOOST_CHECK_EQUAL(D.size(), 199);
+  }
+  BOOST_CHECK_EQUAL(Tracked::live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(AliasTest) {
+  // pushing back an element of the same Array, when the storage must grow
+  Array<std::string> A;
+  A.push_back("first");
+  for(int i = 0; i < 50; i++)
+    A.push_back(A[0]);
+  for(int i = 0; i < A.size(); i++)
+    BOOST_CHECK_EQUAL(A[i], "first");
+
+  Array<Tracked> B;
+  B.emplace_back("x");
+  for(int i = 0; i < 50; i++)
+    B.push_back(B.back());
+  BOOST_CHECK_EQUAL(B.size(), 51);
+  BOOST_CHECK_EQUAL(B.back().value, "x");
+
+  // appending an Array to itself
+  Array<int> C;
+  for(int i = 0; i < 10; i++)
+    C.push_back(i);
+  C.append(C);
+  BOOST_CHECK_EQUAL(C.size(), 20);
+  for(int i = 0; i < 20; i++)
+    BOOST_CHECK_EQUAL(C[i], i % 10);
+
+  // self-assignment
+  C = C;
+  BOOST_CHECK_EQUAL(C.size(), 20);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
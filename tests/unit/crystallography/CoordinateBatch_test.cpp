@@ -0,0 +1,113 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/crystallography/CoordinateBatch.hh"
+
+/// What is being used to test it:
+#include "casm/crystallography/Lattice.hh"
+#include "casm/crystallography/Coordinate.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+namespace {
+
+  /// A skewed lattice, so that the metric tensor has off-diagonal terms
+  Lattice test_lattice() {
+    return Lattice(Vector3<double>(3.0, 0.0, 0.0),
+                   Vector3<double>(1.0, 2.5, 0.0),
+                   Vector3<double>(0.5, 0.7, 4.0));
+  }
+
+  Vector3<double> random_frac(MTRand &mtrand) {
+    return Vector3<double>(3.0 * mtrand.rand() - 1.0, 3.0 * mtrand.rand() - 1.0, 3.0 * mtrand.rand() - 1.0);
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(CoordinateBatchTest)
+
+BOOST_AUTO_TEST_CASE(DistanceTest) {
+  Lattice lat = test_lattice();
+  MTRand mtrand(5u);
+
+  CoordinateBatch batch(lat);
+  Array<Coordinate> coords;
+  for(Index i = 0; i < 20; i++) {
+    Vector3<double> f = random_frac(mtrand);
+    batch.push_back(f);
+    coords.push_back(Coordinate(f, lat, FRAC));
+  }
+  BOOST_CHECK_EQUAL(batch.size(), 20);
+
+  for(Index t = 0; t < 10; t++) {
+    Vector3<double> f = random_frac(mtrand);
+    Coordinate pos(f, lat, FRAC);
+
+    std::vector<double> d(batch.size()), min_d(batch.size());
+    batch.dist_sq(f, d.data());
+    batch.min_image_dist_sq(f, min_d.data());
+    for(Index i = 0; i < batch.size(); i++) {
+      BOOST_CHECK_CLOSE(std::sqrt(d[i]), coords[i].dist(pos), 1e-8);
+      BOOST_CHECK_CLOSE(std::sqrt(min_d[i]), coords[i].min_dist(pos), 1e-8);
+    }
+  }
+
+  // conversions round trip, and agree with Coordinate
+  Vector3<double> f(0.1, -0.2, 0.35);
+  Coordinate pos(f, lat, FRAC);
+  BOOST_CHECK(batch.cart_from_frac(f).is_equal(pos(CART), 1e-10));
+  BOOST_CHECK(batch.frac_from_cart(pos(CART)).is_equal(f, 1e-10));
+}
+
+BOOST_AUTO_TEST_CASE(FindTest) {
+  Lattice lat = test_lattice();
+  CoordinateBatch batch(lat);
+  batch.push_back(Vector3<double>(0.0, 0.0, 0.0), 0);
+  batch.push_back(Vector3<double>(0.5, 0.5, 0.5), 1);
+  batch.push_back(Vector3<double>(0.25, 0.25, 0.25), 0);
+
+  // periodic images are found
+  BOOST_CHECK_EQUAL(batch.find(Vector3<double>(1.0, -2.0, 3.0), 1e-5), 0);
+  BOOST_CHECK_EQUAL(batch.find(Vector3<double>(-0.5, 1.5, 0.5 + 1e-7), 1e-5), 1);
+  BOOST_CHECK_EQUAL(batch.find(Vector3<double>(0.1, 0.1, 0.1), 1e-5), batch.size());
+
+  // type labels restrict the search
+  BOOST_CHECK_EQUAL(batch.find(Vector3<double>(0.5, 0.5, 0.5), 1e-5, 0), batch.size());
+  BOOST_CHECK_EQUAL(batch.find(Vector3<double>(0.5, 0.5, 0.5), 1e-5, 1), 1);
+
+  double dist;
+  BOOST_CHECK_EQUAL(batch.nearest(Vector3<double>(1.26, 0.25, -0.75), dist), 2);
+  BOOST_CHECK_CLOSE(dist, batch.cart_from_frac(Vector3<double>(0.01, 0.0, 0.0)).length(), 1e-6);
+
+  CoordinateBatch empty(lat);
+  BOOST_CHECK_EQUAL(empty.nearest(Vector3<double>(0.0, 0.0, 0.0), dist), 0);
+}
+
+BOOST_AUTO_TEST_CASE(MatchTest) {
+  Lattice lat = test_lattice();
+  CoordinateBatch A(lat), B(lat);
+  A.push_back(Vector3<double>(0.0, 0.0, 0.0), 0);
+  A.push_back(Vector3<double>(0.5, 0.0, 0.0), 1);
+  A.push_back(Vector3<double>(0.0, 0.5, 0.0), 1);
+
+  // B is A translated by 'shift', in a different order
+  Vector3<double> shift(0.1, 0.2, 0.3);
+  B.push_back(A.frac(2) + shift, 1);
+  B.push_back(A.frac(0) + shift, 0);
+  B.push_back(A.frac(1) + shift - Vector3<double>(1.0, 0.0, 0.0), 1);
+
+  Array<Index> perm;
+  double max_error;
+  BOOST_CHECK(A.match(B, shift, 1e-5, perm, max_error));
+  BOOST_CHECK_EQUAL(perm[0], 1);
+  BOOST_CHECK_EQUAL(perm[1], 2);
+  BOOST_CHECK_EQUAL(perm[2], 0);
+  BOOST_CHECK_SMALL(max_error, 1e-8);
+
+  // the translation that maps the type 0 site onto a type 1 site does not match
+  BOOST_CHECK(!A.match(B, shift + Vector3<double>(0.5, 0.0, 0.0), 1e-5, perm, max_error));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/crystallography/PeriodicSiteHash.hh"
+
+/// What is being used to test it:
+#include "casm/crystallography/Structure.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(PeriodicSiteHashTest)
+
+BOOST_AUTO_TEST_CASE(FindTest) {
+  Lattice lat(Vector3<double>(3.0, 0.0, 0.0),
+              Vector3<double>(1.0, 2.5, 0.0),
+              Vector3<double>(0.5, 0.7, 4.0));
+  double tol = 1e-4;
+  PeriodicSiteHash hash(lat, tol);
+
+  // enough positions that the hash is rebinned as it grows
+  MTRand mtrand(7u);
+  CoordinateBatch batch(lat);
+  for(Index i = 0; i < 500; i++) {
+    Vector3<double> f(mtrand.rand(), mtrand.rand(), mtrand.rand());
+    hash.push_back(f, i % 3);
+    batch.push_back(f, i % 3);
+  }
+  BOOST_CHECK_EQUAL(hash.size(), 500);
+
+  // the hash agrees with a linear search, for periodic images, and near misses
+  for(Index i = 0; i < batch.size(); i++) {
+    Vector3<double> image = batch.frac(i) + Vector3<double>(-1.0, 2.0, 1.0);
+    BOOST_CHECK_EQUAL(hash.find(image, tol), batch.find(image, tol));
+    BOOST_CHECK_EQUAL(hash.find(image, tol, i % 3), i);
+    BOOST_CHECK_EQUAL(hash.find(image, tol, (i + 1) % 3), batch.find(image, tol, (i + 1) % 3));
+
+    Vector3<double> near = image + Vector3<double>(0.5 * tol / 3.0, 0.0, 0.0);
+    BOOST_CHECK_EQUAL(hash.find(near, tol), batch.find(near, tol));
+  }
+  for(Index t = 0; t < 100; t++) {
+    Vector3<double> f(mtrand.rand(), mtrand.rand(), mtrand.rand());
+    BOOST_CHECK_EQUAL(hash.find(f, tol), batch.find(f, tol));
+  }
+
+  // find_if returns the smallest index satisfying the predicate
+  Vector3<double> f0 = batch.frac(10);
+  BOOST_CHECK_EQUAL(hash.find_if(f0, [](Index i) {
+    return i == 10;
+  }), 10);
+  BOOST_CHECK_EQUAL(hash.find_if(f0, [](Index i) {
+    return false;
+  }), hash.size());
+
+  hash.clear();
+  BOOST_CHECK_EQUAL(hash.size(), 0);
+  BOOST_CHECK_EQUAL(hash.find(f0, tol), 0);
+}
+
+BOOST_AUTO_TEST_CASE(TranslationsTest) {
+  // FCC conventional cell: 4 translations map the basis onto itself
+  Lattice lat(Vector3<double>(4.0, 0.0, 0.0),
+              Vector3<double>(0.0, 4.0, 0.0),
+              Vector3<double>(0.0, 0.0, 4.0));
+  PeriodicSiteHash hash(lat, 1e-5);
+  CoordinateBatch sites(lat);
+  Vector3<double> pos[4] = {Vector3<double>(0.0, 0.0, 0.0), Vector3<double>(0.5, 0.5, 0.0),
+                            Vector3<double>(0.5, 0.0, 0.5), Vector3<double>(0.0, 0.5, 0.5)
+                           };
+  for(Index i = 0; i < 4; i++) {
+    hash.push_back(pos[i]);
+    sites.push_back(pos[i]);
+  }
+
+  Array<Vector3<double> > trans;
+  Array<double> max_error;
+  hash.find_translations(sites, 1e-5, trans, max_error);
+  BOOST_CHECK_EQUAL(trans.size(), 4);
+
+  double err;
+  for(Index i = 0; i < trans.size(); i++)
+    BOOST_CHECK(hash.match(sites, trans[i], 1e-5, err));
+  BOOST_CHECK(!hash.match(sites, Vector3<double>(0.5, 0.0, 0.0), 1e-5, err));
+
+  hash.find_translations(sites, 1e-5, trans, max_error, true);
+  BOOST_CHECK_EQUAL(trans.size(), 1);
+
+  // with one site labeled differently, only the zero translation remains
+  PeriodicSiteHash typed(lat, 1e-5);
+  CoordinateBatch typed_sites(lat);
+  for(Index i = 0; i < 4; i++) {
+    typed.push_back(pos[i], i == 0);
+    typed_sites.push_back(pos[i], i == 0);
+  }
+  typed.find_translations(typed_sites, 1e-5, trans, max_error);
+  BOOST_CHECK_EQUAL(trans.size(), 1);
+  BOOST_CHECK_SMALL(trans[0].length(), 1e-8);
+}
+
+BOOST_AUTO_TEST_CASE(StructureFindTest) {
+  Structure prim(fs::path("tests/unit/crystallography/PRIM2"));
+  // large enough that the hash has many bins, and not every site is a candidate
+  Structure struc = prim.create_superstruc(Lattice(4.0 * prim.lattice()[0], 4.0 * prim.lattice()[1], 4.0 * prim.lattice()[2]));
+  BOOST_CHECK_EQUAL(struc.basis.size(), 256);
+
+  for(Index i = 0; i < struc.basis.size(); i++)
+    BOOST_CHECK_EQUAL(struc.find(struc.basis[i]), i);
+
+  Site shifted(struc.basis[3]);
+  shifted(FRAC) += Vector3<double>(1.0, -1.0, 2.0);
+  BOOST_CHECK_EQUAL(struc.find(shifted), 3);
+
+  // sites appended to basis are found
+  Site extra(Coordinate(Vector3<double>(0.1, 0.1, 0.1), struc.lattice(), FRAC), "A");
+  struc.basis.push_back(extra);
+  BOOST_CHECK_EQUAL(struc.find(extra), 256);
+
+  // reordering the basis in place is detected
+  Index version = struc.basis.version();
+  for(Index i = 0; i < struc.basis.size() / 2; i++)
+    struc.basis.swap_elem(i, struc.basis.size() - 1 - i);
+  BOOST_CHECK(struc.basis.version() != version);
+  for(Index i = 0; i < struc.basis.size(); i++)
+    BOOST_CHECK_EQUAL(struc.find(struc.basis[i]), i);
+
+  // moving a site in place is detected
+  Site moved(struc.basis[7]);
+  moved(FRAC) += Vector3<double>(0.01, 0.02, 0.03);
+  struc.basis[7] = moved;
+  BOOST_CHECK_EQUAL(struc.find(moved), 7);
+
+  // removing sites is detected
+  struc.basis.remove(0);
+  for(Index i = 0; i < struc.basis.size(); i++)
+    BOOST_CHECK_EQUAL(struc.find(struc.basis[i]), i);
+  BOOST_CHECK_EQUAL(struc.find(extra), struc.basis.size());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
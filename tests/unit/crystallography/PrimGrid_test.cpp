@@ -0,0 +1,122 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/crystallography/PrimGrid.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include "casm/clex/PrimClex.hh"
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+namespace {
+
+  UnitCellCoord random_uccoord(Index N_basis, int range, MTRand &mtrand) {
+    return UnitCellCoord(mtrand.randInt(N_basis - 1),
+                         mtrand.randInt(2 * range) - range,
+                         mtrand.randInt(2 * range) - range,
+                         mtrand.randInt(2 * range) - range);
+  }
+
+  /// The linear index 'l' for which ijk - uccoord(l) is a lattice translation of the supercell,
+  /// found by searching
+  Index brute_find(const PrimGrid &grid, const Eigen::Matrix3i &transf_mat, const UnitCellCoord &bijk) {
+    Eigen::Matrix3d inv_transf_mat = transf_mat.cast<double>().inverse();
+    for(Index l = 0; l < grid.size(); l++) {
+      const UnitCellCoord &uc = grid.uccoord(l);
+      Eigen::Vector3d diff(bijk[1] - uc[1], bijk[2] - uc[2], bijk[3] - uc[3]);
+      Eigen::Vector3d x = inv_transf_mat * diff;
+      if(almost_zero(x(0) - std::round(x(0)), 1e-8) &&
+         almost_zero(x(1) - std::round(x(1)), 1e-8) &&
+         almost_zero(x(2) - std::round(x(2)), 1e-8))
+        return l;
+    }
+    return grid.size();
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(PrimGridTest)
+
+BOOST_AUTO_TEST_CASE(FindTest) {
+  Structure prim(fs::path("tests/unit/crystallography/PRIM1"));
+  MTRand mtrand(41u);
+
+  // diagonal, sheared and non-diagonal Smith normal forms
+  std::vector<Eigen::Matrix3i> transf_mats(4);
+  transf_mats[0] << 1, 0, 0, 0, 1, 0, 0, 0, 1;
+  transf_mats[1] << 2, 0, 0, 0, 3, 0, 0, 0, 1;
+  transf_mats[2] << 1, 1, 0, 0, 2, 1, 1, 0, 3;
+  transf_mats[3] << 2, 1, 0, 0, 3, 1, 1, 0, 2;
+
+  for(const Eigen::Matrix3i &T : transf_mats) {
+    PrimGrid grid(prim.lattice(), make_supercell(prim.lattice(), T));
+    BOOST_REQUIRE_EQUAL(grid.size(), std::abs(T.determinant()));
+
+    // the table of UnitCellCoords is found again, one at a time and all at once
+    BOOST_CHECK_EQUAL(grid.uccoords().size(), grid.size());
+    Array<Index> found = grid.find(grid.uccoords());
+    for(Index l = 0; l < grid.size(); l++) {
+      BOOST_CHECK_EQUAL(grid.uccoords()[l][0], -1);
+      BOOST_CHECK_EQUAL(grid.find(grid.uccoord(l)), l);
+      BOOST_CHECK_EQUAL(found[l], l);
+    }
+
+    // arbitrary UnitCellCoords, far outside the supercell
+    Array<UnitCellCoord> bijk;
+    for(Index i = 0; i < 200; i++)
+      bijk.push_back(random_uccoord(1, 20, mtrand));
+    found = grid.find(bijk);
+    BOOST_REQUIRE_EQUAL(found.size(), bijk.size());
+    for(Index i = 0; i < bijk.size(); i++) {
+      BOOST_CHECK_EQUAL(found[i], brute_find(grid, T, bijk[i]));
+      BOOST_CHECK_EQUAL(grid.find(bijk[i]), found[i]);
+      BOOST_CHECK_EQUAL(grid.find(grid.coord(bijk[i], PRIM)), found[i]);
+    }
+
+    // translating every UnitCellCoord at once
+    for(Index t = 0; t < 10; t++) {
+      UnitCellCoord delta = random_uccoord(1, 5, mtrand);
+      Array<Index> translated = grid.find_translated(delta);
+      BOOST_REQUIRE_EQUAL(translated.size(), grid.size());
+      for(Index l = 0; l < grid.size(); l++)
+        BOOST_CHECK_EQUAL(translated[l], brute_find(grid, T, grid.uccoord(l) + delta));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(NeighborListTest) {
+  // several basis sites, so that the sublattice offsets of Supercell::find are tested
+  Structure prim(fs::path("tests/unit/crystallography/PRIM2"));
+  PrimClex primclex(prim);
+  MTRand mtrand(43u);
+
+  Array<UnitCellCoord> prim_nlist;
+  for(Index i = 0; i < 30; i++)
+    prim_nlist.push_back(random_uccoord(prim.basis.size(), 3, mtrand));
+  primclex.set_prim_nlist(prim_nlist);
+  primclex.generate_supercells(1, 3, false);
+  primclex.generate_supercell_nlists();
+
+  for(Index s = 0; s < primclex.get_supercell_list().size(); s++) {
+    const Supercell &scel = primclex.get_supercell(s);
+
+    // the neighbor list agrees with finding each neighbor's coordinate
+    for(Index i = 0; i < scel.num_sites(); i++) {
+      Array<UnitCellCoord> neighbors;
+      for(Index j = 0; j < prim_nlist.size(); j++)
+        neighbors.push_back(scel.uccoord(i) + prim_nlist[j]);
+      Array<Index> found = scel.find(neighbors);
+      BOOST_REQUIRE_EQUAL(scel.get_nlist(i).size(), prim_nlist.size());
+      for(Index j = 0; j < prim_nlist.size(); j++) {
+        BOOST_CHECK_EQUAL(scel.get_nlist_l(i, j), scel.get_linear_index(scel.coord(neighbors[j])));
+        BOOST_CHECK_EQUAL(found[j], scel.get_nlist_l(i, j));
+        BOOST_CHECK_EQUAL(scel.find(neighbors[j]), found[j]);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
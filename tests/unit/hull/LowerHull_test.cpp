@@ -0,0 +1,298 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/hull/LowerHull.hh"
+
+/// What is being used to test it:
+#include <functional>
+#include <limits>
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+namespace {
+
+  /// Random compositions in the unit simplex, including its corners, with energies that are
+  /// concave on average so that many points are on the hull
+  void random_points(Index dim, Index N, MTRand &mtrand, Eigen::MatrixXd &comp, Eigen::VectorXd &energy) {
+    comp = Eigen::MatrixXd::Zero(dim, N);
+    energy.resize(N);
+    for(Index i = 0; i < N; i++) {
+      if(i > 0 && i <= dim) {
+        comp(i - 1, i) = 1.0;
+      }
+      else if(i > dim) {
+        // uniform in the simplex: sorted uniform variates
+        std::vector<double> x(dim + 1, 1.0);
+        for(Index j = 0; j < dim; j++)
+          x[j] = mtrand.rand();
+        std::sort(x.begin(), x.end() - 1);
+        double prev = 0.0;
+        for(Index j = 0; j < dim; j++) {
+          comp(j, i) = x[j] - prev;
+          prev = x[j];
+        }
+      }
+      double mix = 0.0, last = 1.0 - comp.col(i).sum();
+      for(Index j = 0; j < dim; j++)
+        mix += comp(j, i) * (1.0 - comp(j, i) - last);
+      energy(i) = -mix + 0.05 * mtrand.rand();
+    }
+  }
+
+  /// Points on a line in composition space, with energies linear along it, followed by the
+  /// corners of the unit simplex and random points with higher energies
+  void collinear_points(Index dim, Index N, MTRand &mtrand, Eigen::MatrixXd &comp, Eigen::VectorXd &energy) {
+    Index k = dim + 3;
+    comp = Eigen::MatrixXd::Zero(dim, k + N);
+    energy.resize(k + N);
+    Eigen::VectorXd dir(dim);
+    for(Index j = 0; j < dim; j++)
+      dir(j) = mtrand.rand() / dim;
+    for(Index i = 0; i < k; i++) {
+      comp.col(i) = Eigen::VectorXd::Constant(dim, 0.1) + mtrand.rand() * dir;
+      energy(i) = -0.2 * comp.col(i).sum();
+    }
+    for(Index i = k; i < k + N; i++) {
+      if(i - k < dim)
+        comp(i - k, i) = 1.0;
+      else if(i - k > dim) {
+        for(Index j = 0; j < dim; j++)
+          comp(j, i) = mtrand.rand() / dim;
+      }
+      energy(i) = 0.05 * mtrand.rand();
+    }
+  }
+
+  /// Hull energy at 'x', by brute force over all simplices of the points other than 'skip'
+  double brute_hull_energy(const Eigen::MatrixXd &comp, const Eigen::VectorXd &energy, const Eigen::VectorXd &x, Index skip) {
+    Index dim = comp.rows();
+    Index N = comp.cols();
+    double result = std::numeric_limits<double>::infinity();
+
+    std::vector<Index> s(dim + 1);
+    std::function<void(Index, Index)> choose = [&](Index k, Index begin) {
+      if(k == dim + 1) {
+        Eigen::MatrixXd A(dim, dim);
+        for(Index j = 0; j < dim; j++)
+          A.col(j) = comp.col(s[j + 1]) - comp.col(s[0]);
+        Eigen::FullPivLU<Eigen::MatrixXd> lu(A);
+        if(lu.rank() < dim)
+          return;
+        Eigen::VectorXd b = lu.solve(x - comp.col(s[0]));
+        if(b.minCoeff() < -1e-12 || b.sum() > 1.0 + 1e-12)
+          return;
+        double e = energy(s[0]);
+        for(Index j = 0; j < dim; j++)
+          e += b(j) * (energy(s[j + 1]) - energy(s[0]));
+        result = std::min(result, e);
+        return;
+      }
+      for(Index i = begin; i < N; i++) {
+        if(i == skip)
+          continue;
+        s[k] = i;
+        choose(k + 1, i + 1);
+      }
+    };
+    choose(0, 0);
+    return result;
+  }
+
+  /// Every facet is a supporting plane: no point is below it, and its vertices are on it.
+  /// Together with contains(), this shows the facets are the lower hull.
+  void check_supporting(const LowerHull &hull) {
+    for(Index f = 0; f < hull.facets_size(); f++) {
+      Eigen::VectorXd n = hull.facet_normal(f);
+      BOOST_CHECK(n(hull.dim()) < 0.0);
+      const std::vector<Index> &verts = hull.facet(f);
+      BOOST_CHECK_EQUAL(verts.size(), hull.dim() + 1);
+      Eigen::VectorXd p0(hull.dim() + 1);
+      p0 << hull.comp(verts[0]), hull.energy(verts[0]);
+      double max_below = -std::numeric_limits<double>::infinity();
+      for(Index i = 0; i < hull.size(); i++) {
+        Eigen::VectorXd p(hull.dim() + 1);
+        p << hull.comp(i), hull.energy(i);
+        double h = n.dot(p - p0);
+        max_below = std::max(max_below, h);
+        if(std::find(verts.begin(), verts.end(), i) != verts.end())
+          BOOST_CHECK_SMALL(h, 1e-10);
+      }
+      BOOST_CHECK_MESSAGE(max_below < 1e-10, "a point is " << max_below << " below facet " << f);
+    }
+    for(Index i = 0; i < hull.size(); i++) {
+      BOOST_CHECK(hull.contains(hull.comp(i)));
+      BOOST_CHECK(hull.dist_to_hull(i) >= 0.0);
+      BOOST_CHECK(hull.dist_to_hull(hull.comp(i), hull.energy(i)) > -1e-10);
+    }
+  }
+
+  /// Compare with the brute force hull
+  void check_brute_force(const LowerHull &hull, const Eigen::MatrixXd &comp, const Eigen::VectorXd &energy, MTRand &mtrand) {
+    for(Index i = 0; i < comp.cols(); i++) {
+      double others = brute_hull_energy(comp, energy, comp.col(i), i);
+      BOOST_CHECK_EQUAL(hull.is_vertex(i), energy(i) < others);
+      double expected = std::max(0.0, energy(i) - brute_hull_energy(comp, energy, comp.col(i), -1));
+      BOOST_CHECK_SMALL(hull.dist_to_hull(i) - expected, 1e-10);
+    }
+    for(Index t = 0; t < 20; t++) {
+      Eigen::VectorXd x = Eigen::VectorXd::Zero(comp.rows());
+      for(Index j = 0; j < comp.rows(); j++)
+        x(j) = mtrand.rand() / comp.rows();
+      BOOST_CHECK_SMALL(hull.hull_energy(x) - brute_hull_energy(comp, energy, x, -1), 1e-10);
+    }
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(LowerHullTest)
+
+BOOST_AUTO_TEST_CASE(BinaryTest) {
+  MTRand mtrand(3u);
+  Eigen::MatrixXd comp;
+  Eigen::VectorXd energy;
+  random_points(1, 200, mtrand, comp, energy);
+
+  // repeated compositions: only the lowest energy can be a vertex
+  comp(0, 150) = comp(0, 20);
+  energy(150) = energy(20) - 0.01;
+  comp(0, 151) = comp(0, 21);
+  energy(151) = energy(21) + 0.01;
+
+  LowerHull hull;
+  BOOST_REQUIRE(hull.reset(comp, energy));
+  BOOST_CHECK(!hull.is_vertex(20));
+  BOOST_CHECK(!hull.is_vertex(151));
+  BOOST_CHECK(hull.is_vertex(0));
+  BOOST_CHECK(hull.is_vertex(1));
+  BOOST_CHECK_EQUAL(hull.facets_size(), hull.vertices().size() - 1);
+  check_supporting(hull);
+  check_brute_force(hull, comp, energy, mtrand);
+}
+
+BOOST_AUTO_TEST_CASE(TernaryTest) {
+  MTRand mtrand(5u);
+  Eigen::MatrixXd comp;
+  Eigen::VectorXd energy;
+  random_points(2, 40, mtrand, comp, energy);
+
+  LowerHull hull;
+  BOOST_REQUIRE(hull.reset(comp, energy));
+  BOOST_CHECK(hull.vertices().size() > 3);
+  check_supporting(hull);
+  check_brute_force(hull, comp, energy, mtrand);
+
+  // outside the composition range
+  Eigen::VectorXd x(2);
+  x << 1.0, 1.0;
+  BOOST_CHECK(!hull.contains(x));
+
+  // points that do not span the composition space
+  Eigen::MatrixXd line(2, 4);
+  line << 0.0, 0.25, 0.5, 1.0,
+       0.0, 0.25, 0.5, 1.0;
+  BOOST_CHECK(!hull.reset(line, Eigen::Vector4d(0.0, -1.0, -0.5, 0.0)));
+}
+
+BOOST_AUTO_TEST_CASE(QuaternaryTest) {
+  MTRand mtrand(7u);
+  Eigen::MatrixXd comp;
+  Eigen::VectorXd energy;
+  random_points(3, 25, mtrand, comp, energy);
+
+  LowerHull hull;
+  BOOST_REQUIRE(hull.reset(comp, energy));
+  check_supporting(hull);
+  check_brute_force(hull, comp, energy, mtrand);
+}
+
+BOOST_AUTO_TEST_CASE(DegenerateTest) {
+  // the first points are collinear, and must not be used to start the hull in BP::Geo
+  MTRand mtrand(17u);
+  for(Index dim = 2; dim <= 3; dim++) {
+    for(Index t = 0; t < 10; t++) {
+      Eigen::MatrixXd comp;
+      Eigen::VectorXd energy;
+      collinear_points(dim, 8, mtrand, comp, energy);
+
+      LowerHull hull(1e-10);
+      BOOST_REQUIRE(hull.reset(comp, energy));
+      check_supporting(hull);
+
+      // the collinear points between the ends of the line are on the hull, and may be vertices of
+      // its facets
+      for(Index i = 0; i < comp.cols(); i++) {
+        double expected = energy(i) - brute_hull_energy(comp, energy, comp.col(i), -1);
+        if(energy(i) < brute_hull_energy(comp, energy, comp.col(i), i) - hull.tol())
+          BOOST_CHECK(hull.is_vertex(i));
+        if(hull.is_vertex(i))
+          BOOST_CHECK_SMALL(expected, 1e-10);
+        BOOST_CHECK_SMALL(hull.dist_to_hull(i) - expected, 1e-10);
+      }
+    }
+  }
+
+  // quaternary points in a plane do not span the composition space
+  Eigen::MatrixXd plane(3, 6);
+  plane << 0.0, 1.0, 0.0, 0.5, 0.25, 0.2,
+        0.0, 0.0, 1.0, 0.5, 0.25, 0.3,
+        0.0, 0.0, 0.0, 0.0, 0.0, 0.0;
+  Eigen::VectorXd plane_energy(6);
+  plane_energy << 0.0, 0.0, 0.0, -0.1, -0.2, -0.05;
+  LowerHull hull;
+  BOOST_CHECK(!hull.reset(plane, plane_energy));
+
+  // nor do nearly coplanar ones
+  plane.row(2) << 0.0, 0.0, 0.0, 1e-15, 0.0, -1e-15;
+  BOOST_CHECK(!hull.reset(plane, plane_energy));
+}
+
+BOOST_AUTO_TEST_CASE(PruneTest) {
+  // enough points that candidates are pruned before BP::Geo
+  MTRand mtrand(9u);
+  Eigen::MatrixXd comp;
+  Eigen::VectorXd energy;
+  random_points(2, 6000, mtrand, comp, energy);
+
+  LowerHull hull;
+  BOOST_REQUIRE(hull.reset(comp, energy));
+  check_supporting(hull);
+
+  // the same hull as from the vertices alone
+  LowerHull vertices_hull;
+  Eigen::MatrixXd vcomp(2, hull.vertices().size());
+  Eigen::VectorXd venergy(hull.vertices().size());
+  for(Index i = 0; i < hull.vertices().size(); i++) {
+    vcomp.col(i) = hull.comp(hull.vertices()[i]);
+    venergy(i) = hull.energy(hull.vertices()[i]);
+  }
+  BOOST_REQUIRE(vertices_hull.reset(vcomp, venergy));
+  BOOST_CHECK_EQUAL(vertices_hull.vertices().size(), hull.vertices().size());
+  BOOST_CHECK_EQUAL(vertices_hull.facets_size(), hull.facets_size());
+}
+
+BOOST_AUTO_TEST_CASE(InsertTest) {
+  MTRand mtrand(13u);
+  Eigen::MatrixXd comp;
+  Eigen::VectorXd energy;
+  random_points(2, 60, mtrand, comp, energy);
+
+  // inserting the points one at a time gives the same hull as all at once
+  LowerHull all;
+  BOOST_REQUIRE(all.reset(comp, energy));
+
+  LowerHull inserted;
+  for(Index i = 0; i < comp.cols(); i++) {
+    // the first three points are the corners, so the hull exists once there are four
+    bool result = inserted.insert(comp.col(i), energy(i));
+    BOOST_CHECK_EQUAL(result, i >= 3);
+  }
+  BOOST_CHECK(inserted.vertices() == all.vertices());
+  BOOST_CHECK_EQUAL(inserted.facets_size(), all.facets_size());
+  for(Index i = 0; i < comp.cols(); i++)
+    BOOST_CHECK_SMALL(inserted.dist_to_hull(i) - all.dist_to_hull(i), 1e-10);
+  check_supporting(inserted);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,112 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/misc/FFT.hh"
+
+/// What is being used to test it:
+#include <cmath>
+#include "casm/external/MersenneTwister/MersenneTwister.h"
+
+using namespace CASM;
+
+namespace {
+
+  typedef std::complex<double> complex;
+
+  std::vector<complex> random_values(Index n, MTRand &mtrand) {
+    std::vector<complex> result(n);
+    for(Index i = 0; i < n; i++)
+      result[i] = complex(2.0 * mtrand.rand() - 1.0, 2.0 * mtrand.rand() - 1.0);
+    return result;
+  }
+
+  /// The DFT by its definition, O(n^2)
+  std::vector<complex> naive_dft(const std::vector<complex> &data) {
+    Index n = data.size();
+    std::vector<complex> result(n, 0.0);
+    for(Index k = 0; k < n; k++) {
+      for(Index j = 0; j < n; j++)
+        result[k] += data[j] * std::polar(1.0, -2.0 * M_PI * double((j * k) % n) / double(n));
+    }
+    return result;
+  }
+
+  double max_diff(const std::vector<complex> &A, const std::vector<complex> &B) {
+    double result = 0.0;
+    for(Index i = 0; i < A.size(); i++)
+      result = std::max(result, std::abs(A[i] - B[i]));
+    return result;
+  }
+
+}
+
+BOOST_AUTO_TEST_SUITE(FFTTest)
+
+BOOST_AUTO_TEST_CASE(OneDimensionTest) {
+  MTRand mtrand(5u);
+
+  // every length up to 70, including the primes above 32 that use Bluestein's algorithm, and
+  // composite lengths with large prime factors
+  std::vector<Index> lengths;
+  for(Index n = 1; n <= 70; n++)
+    lengths.push_back(n);
+  for(Index n : {97, 128, 2 * 37, 3 * 53, 37 * 41, 1000, 1031})
+    lengths.push_back(n);
+
+  for(Index n : lengths) {
+    std::vector<complex> data = random_values(n, mtrand);
+    std::vector<complex> expected = naive_dft(data);
+    fft(data.data(), n);
+    BOOST_CHECK_MESSAGE(max_diff(data, expected) < 1e-12 * n, "n = " << n << ", error = " << max_diff(data, expected));
+  }
+
+  // strided data, leaving the other values unchanged
+  Index n = 43, stride = 3;
+  std::vector<complex> data = random_values(n * stride, mtrand);
+  std::vector<complex> original(data);
+  std::vector<complex> line(n);
+  for(Index i = 0; i < n; i++)
+    line[i] = data[1 + i * stride];
+  std::vector<complex> expected = naive_dft(line);
+  fft(data.data() + 1, n, stride);
+  for(Index i = 0; i < n * stride; i++) {
+    if(i % stride == 1)
+      BOOST_CHECK_SMALL(std::abs(data[i] - expected[i / stride]), 1e-10);
+    else
+      BOOST_CHECK_EQUAL(data[i], original[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ThreeDimensionTest) {
+  MTRand mtrand(7u);
+
+  std::vector<std::vector<int> > shapes = {{1, 1, 1}, {2, 3, 5}, {4, 1, 37}, {6, 6, 1}, {1, 41, 2}, {3, 4, 4}};
+  for(const std::vector<int> &S : shapes) {
+    Index N = S[0] * S[1] * S[2];
+    std::vector<complex> data = random_values(N, mtrand);
+
+    // by the definition, with the PrimGrid layout
+    std::vector<complex> expected(N, 0.0);
+    for(int n0 = 0; n0 < S[0]; n0++) {
+      for(int n1 = 0; n1 < S[1]; n1++) {
+        for(int n2 = 0; n2 < S[2]; n2++) {
+          complex &sum = expected[n0 + n1 * S[0] + n2 * S[0] * S[1]];
+          for(int m0 = 0; m0 < S[0]; m0++) {
+            for(int m1 = 0; m1 < S[1]; m1++) {
+              for(int m2 = 0; m2 < S[2]; m2++) {
+                double phase = double(m0 * n0) / S[0] + double(m1 * n1) / S[1] + double(m2 * n2) / S[2];
+                sum += data[m0 + m1 * S[0] + m2 * S[0] * S[1]] * std::polar(1.0, -2.0 * M_PI * phase);
+              }
+            }
+          }
+        }
+      }
+    }
+
+    fft_3d(data.data(), S.data());
+    BOOST_CHECK_MESSAGE(max_diff(data, expected) < 1e-10, "S = " << S[0] << " " << S[1] << " " << S[2]);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
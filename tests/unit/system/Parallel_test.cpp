@@ -0,0 +1,64 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+/// What is being tested:
+#include "casm/system/Parallel.hh"
+
+/// What is being used to test it:
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+using namespace CASM;
+
+BOOST_AUTO_TEST_SUITE(ParallelTest)
+
+BOOST_AUTO_TEST_CASE(ParallelForTest) {
+  for(Index num_threads = 1; num_threads <= 5; num_threads++) {
+    std::vector<Index> result(103, -1);
+    parallel_for(3, 100, [&](Index i) {
+      result[i] = i * i;
+    }, num_threads);
+
+    for(Index i = 0; i < result.size(); i++)
+      BOOST_CHECK_EQUAL(result[i], (i >= 3 && i < 100) ? i * i : -1);
+  }
+
+  // empty range, and more threads than work
+  std::atomic<Index> count(0);
+  parallel_for(5, 5, [&](Index i) {
+    count++;
+  }, 4);
+  BOOST_CHECK_EQUAL(count.load(), 0);
+  parallel_for(0, 2, [&](Index i) {
+    count++;
+  }, 8);
+  BOOST_CHECK_EQUAL(count.load(), 2);
+
+  BOOST_CHECK(default_num_threads() >= 1);
+}
+
+BOOST_AUTO_TEST_CASE(ExceptionTest) {
+  // the exception for the smallest i is rethrown in the calling thread, whatever the number of threads
+  for(Index num_threads = 1; num_threads <= 5; num_threads++) {
+    std::atomic<Index> count(0);
+    std::string what;
+    try {
+      parallel_for(0, 1000, [&](Index i) {
+        count++;
+        if(i == 37 || i == 38 || i == 500)
+          throw std::runtime_error(std::to_string(i));
+      }, num_threads);
+    }
+    catch(std::runtime_error &e) {
+      what = e.what();
+    }
+    BOOST_CHECK_EQUAL(what, "37");
+
+    // every i before the first exception is evaluated, and the loop stops early
+    BOOST_CHECK(count.load() >= 38);
+    BOOST_CHECK(count.load() < 1000);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()